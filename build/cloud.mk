@@ -6,6 +6,7 @@ CLOUD_SERVER_SOURCES = \
 	$(SRC)/Cloud/Thermal.cpp \
 	$(SRC)/Cloud/Data.cpp \
 	$(SRC)/Cloud/Sender.cpp \
+	$(SRC)/Cloud/TrafficSnapshot.cpp \
 	$(SRC)/Cloud/Main.cpp
 CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
 $(eval $(call link-program,xcsoar-cloud-server,CLOUD_SERVER))
@@ -203,7 +203,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Renderer/HorizonRenderer.cpp \
 	$(SRC)/Renderer/GradientRenderer.cpp \
 	$(SRC)/Renderer/GlassRenderer.cpp \
-	$(SRC)/Renderer/TransparentRendererCache.cpp \
+	$(SRC)/Renderer/MapLayerCache.cpp \
 	$(SRC)/Renderer/LabelBlock.cpp \
 	$(SRC)/Renderer/TextInBox.cpp \
 	$(SRC)/Renderer/TraceHistoryRenderer.cpp \
@@ -234,6 +234,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/FLARM/List.cpp \
 	$(SRC)/FLARM/FlarmNetRecord.cpp \
 	$(SRC)/FLARM/FlarmNetDatabase.cpp \
+	$(SRC)/FLARM/FlarmNetBinary.cpp \
 	$(SRC)/FLARM/FlarmNetReader.cpp \
 	$(SRC)/FLARM/Traffic.cpp \
 	$(SRC)/FLARM/Calculations.cpp \
@@ -248,6 +249,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
 	$(SRC)/Logger/LoggerImpl.cpp \
+	$(SRC)/Logger/LoggerThread.cpp \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
 	$(SRC)/IGC/IGCString.cpp \
@@ -347,6 +349,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspacePolygonCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
 	$(SRC)/Renderer/AirspaceLabelRenderer.cpp \
@@ -361,6 +364,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Renderer/TrackLineRenderer.cpp \
 	$(SRC)/Renderer/TrafficRenderer.cpp \
 	$(SRC)/Renderer/TrailRenderer.cpp \
+	$(SRC)/Renderer/TrailVertexBuffer.cpp \
 	$(SRC)/Renderer/UnitSymbolRenderer.cpp \
 	$(SRC)/Renderer/WaypointListRenderer.cpp \
 	$(SRC)/Renderer/WaypointIconRenderer.cpp \
@@ -7,6 +7,7 @@ python: $(call name-to-so,xcsoar)
 PYTHON_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/IGC/IGCFix.cpp \
+	$(SRC)/TransponderCode.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(SRC)/Computer/CirclingComputer.cpp \
@@ -51,7 +52,7 @@ PYTHON_SOURCES = \
 	$(SRC)/NMEA/Aircraft.cpp
 PYTHON_LDADD = $(DEBUG_REPLAY_LDADD)
 PYTHON_LDLIBS = $(shell python3-config --ldflags)
-PYTHON_DEPENDS = CONTEST WAYPOINT UTIL ZZIP GEO MATH TIME
+PYTHON_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST WAYPOINT UTIL ZZIP GEO MATH TIME
 PYTHON_CPPFLAGS = $(shell python3-config --includes) \
 	-I$(TEST_SRC_DIR) -Wno-write-strings
 PYTHON_NO_LIB_PREFIX = y
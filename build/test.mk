@@ -86,10 +86,11 @@ TEST_NAMES = \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestPackedRTree TestGeoBounds TestGeoClip \
+	TestFlatHashMap TestDaryHeap \
 	TestLogger TestGRecord TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
-	TestFlarmNet \
+	TestFlarmNet TestTrafficList \
 	TestColorRamp TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
@@ -188,7 +189,7 @@ TEST_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAirspaceParser.cpp
 TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE UNITS ZZIP GEO MATH UTIL UNITS
+TEST_AIRSPACE_PARSER_DEPENDS = IO OS THREAD AIRSPACE UNITS ZZIP GEO MATH UTIL UNITS
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
 TEST_DATE_TIME_SOURCES = \
@@ -403,11 +404,22 @@ TEST_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/Id.cpp \
 	$(SRC)/FLARM/FlarmNetRecord.cpp \
 	$(SRC)/FLARM/FlarmNetDatabase.cpp \
+	$(SRC)/FLARM/FlarmNetBinary.cpp \
+	$(SRC)/FLARM/OgnDdbReader.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestFlarmNet.cpp
 TEST_FLARM_NET_DEPENDS = IO OS MATH UTIL
 $(eval $(call link-program,TestFlarmNet,TEST_FLARM_NET))
 
+TEST_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/FLARM/Id.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficList.cpp
+TEST_TRAFFIC_LIST_DEPENDS = MATH FMT UTIL
+$(eval $(call link-program,TestTrafficList,TEST_TRAFFIC_LIST))
+
 TEST_GEO_CLIP_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoClip.cpp
@@ -617,6 +629,24 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_FLAT_HASH_MAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlatHashMap.cpp
+TEST_FLAT_HASH_MAP_DEPENDS = UTIL
+$(eval $(call link-program,TestFlatHashMap,TEST_FLAT_HASH_MAP))
+
+TEST_DARY_HEAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDaryHeap.cpp
+TEST_DARY_HEAP_DEPENDS = UTIL
+$(eval $(call link-program,TestDaryHeap,TEST_DARY_HEAP))
+
+TEST_PACKED_RTREE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPackedRTree.cpp
+TEST_PACKED_RTREE_DEPENDS = UTIL
+$(eval $(call link-program,TestPackedRTree,TEST_PACKED_RTREE))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -625,12 +655,14 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Logger/LoggerFRecord.cpp \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
+	$(SRC)/Logger/LoggerThread.cpp \
 	$(SRC)/util/MD5.cpp \
 	$(SRC)/Version.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestLogger.cpp
-TEST_LOGGER_DEPENDS = IO OS GEO MATH UTIL UNITS
+TEST_LOGGER_DEPENDS = IO OS THREAD GEO MATH UTIL UNITS
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
 TEST_GRECORD_SOURCES = \
@@ -714,6 +746,12 @@ DEBUG_PROGRAM_NAMES = \
 	FlightTable \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkTrafficList \
+	BenchmarkAbortTask \
+	BenchmarkGlideComputer \
+	BenchmarkCloudThermals \
+	BenchmarkCloudTraffic \
+	BenchmarkRoutePlanner \
 	DumpTextInflate \
 	DumpHexColor \
 	RunXMLParser \
@@ -730,7 +768,7 @@ DEBUG_PROGRAM_NAMES = \
 	lxn2igc \
 	DebugDisplay \
 	TaskInfo DumpTaskFile \
-	DumpFlarmNet \
+	DumpFlarmNet CompileFlarmNet \
 	RunRepositoryParser \
 	NearestWaypoints \
 	RunKalmanFilter1d \
@@ -879,6 +917,58 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/FLARM/Id.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTrafficList.cpp
+BENCHMARK_TRAFFIC_LIST_DEPENDS = FMT UTIL
+$(eval $(call link-program,BenchmarkTrafficList,BENCHMARK_TRAFFIC_LIST))
+
+BENCHMARK_ABORT_TASK_SOURCES = \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/Operation/ConsoleOperationEnvironment.cpp \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAbortTask.cpp
+BENCHMARK_ABORT_TASK_LDADD = $(FAKE_LIBS)
+BENCHMARK_ABORT_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINTFILE OPERATION IO OS THREAD ZZIP GEO MATH TIME UTIL
+$(eval $(call link-program,BenchmarkAbortTask,BENCHMARK_ABORT_TASK))
+
+BENCHMARK_CLOUD_THERMALS_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/Cloud/Serialiser.cpp \
+	$(SRC)/Cloud/Thermal.cpp \
+	$(TEST_SRC_DIR)/BenchmarkCloudThermals.cpp
+BENCHMARK_CLOUD_THERMALS_DEPENDS = IO OS GEO MATH UTIL
+$(eval $(call link-program,BenchmarkCloudThermals,BENCHMARK_CLOUD_THERMALS))
+
+BENCHMARK_CLOUD_TRAFFIC_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Server.cpp \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/Cloud/Serialiser.cpp \
+	$(SRC)/Cloud/Client.cpp \
+	$(SRC)/Cloud/Sender.cpp \
+	$(SRC)/Cloud/TrafficSnapshot.cpp \
+	$(TEST_SRC_DIR)/BenchmarkCloudTraffic.cpp
+BENCHMARK_CLOUD_TRAFFIC_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
+$(eval $(call link-program,BenchmarkCloudTraffic,BENCHMARK_CLOUD_TRAFFIC))
+
+BENCHMARK_ROUTE_PLANNER_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(SRC)/Formatter/AirspaceFormatter.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/Printing.cpp \
+	$(TEST_SRC_DIR)/AirspacePrinting.cpp \
+	$(TEST_SRC_DIR)/harness_airspace.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/BenchmarkRoutePlanner.cpp
+BENCHMARK_ROUTE_PLANNER_DEPENDS = TERRAIN OPERATION IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkRoutePlanner,BENCHMARK_ROUTE_PLANNER))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1169,7 +1259,7 @@ RUN_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/FakeLanguage.cpp \
 	$(TEST_SRC_DIR)/RunAirspaceParser.cpp
 RUN_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE IO OS ZZIP GEO MATH UTIL UNITS
+RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE IO OS THREAD ZZIP GEO MATH UTIL UNITS
 $(eval $(call link-program,RunAirspaceParser,RUN_AIRSPACE_PARSER))
 
 ENUMERATE_PORTS_SOURCES = \
@@ -1644,7 +1734,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/GeoBitmapRenderer.cpp \
-	$(SRC)/Renderer/TransparentRendererCache.cpp \
+	$(SRC)/Renderer/MapLayerCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
 	$(SRC)/Renderer/BackgroundRenderer.cpp \
 	$(SRC)/LocalPath.cpp \
@@ -1662,6 +1752,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspacePolygonCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
 	$(SRC)/Renderer/AirspaceLabelRenderer.cpp \
@@ -1671,6 +1762,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/TrackLineRenderer.cpp \
 	$(SRC)/Renderer/TrafficRenderer.cpp \
 	$(SRC)/Renderer/TrailRenderer.cpp \
+	$(SRC)/Renderer/TrailVertexBuffer.cpp \
 	$(SRC)/Renderer/WaypointIconRenderer.cpp \
 	$(SRC)/Renderer/WaypointRenderer.cpp \
 	$(SRC)/Renderer/WaypointRendererSettings.cpp \
@@ -2066,8 +2158,9 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Renderer/GeoBitmapRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspacePolygonCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
-	$(SRC)/Renderer/TransparentRendererCache.cpp \
+	$(SRC)/Renderer/MapLayerCache.cpp \
 	$(SRC)/Renderer/GradientRenderer.cpp \
 	$(SRC)/Renderer/ChartRenderer.cpp \
 	$(SRC)/Renderer/TaskRenderer.cpp \
@@ -2075,6 +2168,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Renderer/OZRenderer.cpp \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/TrailRenderer.cpp \
+	$(SRC)/Renderer/TrailVertexBuffer.cpp \
 	$(SRC)/MapWindow/MapCanvas.cpp \
 	$(SRC)/MapWindow/StencilMapCanvas.cpp \
 	$(SRC)/Units/Units.cpp \
@@ -2160,6 +2254,44 @@ RUN_ANALYSIS_DEPENDS = \
 	ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+BENCHMARK_GLIDE_COMPUTER_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/Operation/ConsoleOperationEnvironment.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/BenchmarkGlideComputer.cpp
+BENCHMARK_GLIDE_COMPUTER_DEPENDS = \
+	TERRAIN \
+	DRIVER \
+	OPERATION \
+	LIBCOMPUTER LIBNMEA ASYNC IO \
+	OS THREAD \
+	CONTEST TASKFILE ROUTE GLIDE \
+	WAYPOINT WAYPOINTFILE \
+	ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
+$(eval $(call link-program,BenchmarkGlideComputer,BENCHMARK_GLIDE_COMPUTER))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
@@ -2376,10 +2508,22 @@ DUMP_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/Id.cpp \
 	$(SRC)/FLARM/FlarmNetRecord.cpp \
 	$(SRC)/FLARM/FlarmNetDatabase.cpp \
+	$(SRC)/FLARM/FlarmNetBinary.cpp \
 	$(TEST_SRC_DIR)/DumpFlarmNet.cpp
 DUMP_FLARM_NET_DEPENDS = IO OS MATH UTIL
 $(eval $(call link-program,DumpFlarmNet,DUMP_FLARM_NET))
 
+COMPILE_FLARM_NET_SOURCES = \
+	$(SRC)/FLARM/FlarmNetReader.cpp \
+	$(SRC)/FLARM/OgnDdbReader.cpp \
+	$(SRC)/FLARM/Id.cpp \
+	$(SRC)/FLARM/FlarmNetRecord.cpp \
+	$(SRC)/FLARM/FlarmNetDatabase.cpp \
+	$(SRC)/FLARM/FlarmNetBinary.cpp \
+	$(TEST_SRC_DIR)/CompileFlarmNet.cpp
+COMPILE_FLARM_NET_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,CompileFlarmNet,COMPILE_FLARM_NET))
+
 IGC2NMEA_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
@@ -7,27 +7,59 @@
 #include "io/BufferedLineReader.hpp"
 #include "system/Args.hpp"
 #include "Operation/Operation.hpp"
+#include "util/Exception.hxx"
+#include "AirspaceCompare.hpp"
+
+#include <cstdlib>
+#include <optional>
+#include <string>
 
 #include <stdio.h>
 #include <tchar.h>
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
 
-int
-LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+/**
+ * @return the error message or std::nullopt on success
+ */
+static std::optional<std::string>
+Parse(Airspaces &airspaces, std::span<const std::byte> data, bool parallel,
+      std::size_t chunk_size=OPENAIR_CHUNK_SIZE)
 {
-  Airspaces airspaces;
-
   try {
-    MemoryReader mr{{(const std::byte *)data, size}};
+    MemoryReader mr{data};
     BufferedReader br{mr};
 
-    ParseAirspaceFile(airspaces, br);
+    ParseAirspaceFile(airspaces, br, parallel, chunk_size);
   } catch (...) {
-    return EXIT_FAILURE;
+    return GetFullMessage(std::current_exception());
   }
 
+  return std::nullopt;
+}
+
+int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  const std::span<const std::byte> input{(const std::byte *)data, size};
+
+  /* a small chunk size splits the input into several chunks, so the
+     chunk boundaries are exercised, too */
+  Airspaces airspaces, chunked, sequential;
+  const auto error = Parse(airspaces, input, true);
+  const auto chunked_error = Parse(chunked, input, true, 64);
+  const auto sequential_error = Parse(sequential, input, false);
+
   airspaces.Optimise();
+  chunked.Optimise();
+  sequential.Optimise();
+
+  /* the parallel parser must behave exactly like the line-by-line
+     parser */
+  if (error != sequential_error || chunked_error != sequential_error ||
+      !IsSameAirspaces(airspaces, sequential) ||
+      !IsSameAirspaces(chunked, sequential))
+    abort();
 
-  return EXIT_SUCCESS;
+  return error ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -3,6 +3,7 @@
 
 #include <Python.h>
 #include <structmember.h> /* required for PyMemberDef */
+#undef RESTRICTED /* clashes with AirspaceClass::RESTRICTED */
 
 #include "Airspaces.hpp"
 #include "Flight.hpp"
@@ -16,11 +17,15 @@
 #include "Engine/Airspace/AirspaceAltitude.hpp"
 #include "Engine/Navigation/Aircraft.hpp"
 #include "NMEA/Aircraft.hpp"
+#include "Atmosphere/Pressure.hpp"
 #include "util/tstring.hpp"
 #include "util/Macros.hpp"
+#include "util/ByteOrder.hxx"
 
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 static constexpr AirspaceClassStringCouple airspace_class_strings[] = {
   { "CLASSA", CLASSA },
@@ -53,6 +58,9 @@ xcsoar_Airspaces_new(PyTypeObject *type,
   self = (Pyxcsoar_Airspaces *)type->tp_alloc(type, 0);
 
   self->airspace_database = new Airspaces();
+  self->airspace_indices =
+    new std::unordered_map<const AbstractAirspace *, unsigned>();
+  self->busy = 0;
 
   return (PyObject*) self;
 }
@@ -60,10 +68,27 @@ xcsoar_Airspaces_new(PyTypeObject *type,
 void xcsoar_Airspaces_dealloc(Pyxcsoar_Airspaces *self) {
   /* destructor */
   delete self->airspace_database;
+  delete self->airspace_indices;
 
   Py_TYPE(self)->tp_free((Pyxcsoar_Airspaces*)self);
 }
 
+/**
+ * Raise an exception if a findIntrusionsBulk() call in another
+ * thread is reading the database.
+ */
+static bool
+CheckNotBusy(const Pyxcsoar_Airspaces *self)
+{
+  if (self->busy > 0) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "Airspaces is in use by findIntrusionsBulk()");
+    return false;
+  }
+
+  return true;
+}
+
 PyObject* xcsoar_Airspaces_addPolygon(Pyxcsoar_Airspaces *self, PyObject *args) {
   PyObject *py_points = nullptr,
            *py_name = nullptr,
@@ -172,15 +197,26 @@ PyObject* xcsoar_Airspaces_addPolygon(Pyxcsoar_Airspaces *self, PyObject *args)
     return nullptr;
   }
 
+  if (!CheckNotBusy(self))
+    return nullptr;
+
   /* Create airspace and save it into the database */
   auto as = std::make_shared<AirspacePolygon>(points);
   as->SetProperties(std::move(name), type, {}, base, top);
+  self->airspace_indices->emplace(as.get(),
+                                  self->airspace_indices->size());
   self->airspace_database->Add(std::move(as));
 
   Py_RETURN_NONE;
 }
 
 PyObject* xcsoar_Airspaces_optimise(Pyxcsoar_Airspaces *self) {
+  if (!CheckNotBusy(self))
+    return nullptr;
+
+  /* resolve FL boundaries to altitudes; there is no QNH, so the
+     altitudes passed to the queries are pressure altitudes */
+  self->airspace_database->SetFlightLevels(AtmosphericPressure::Standard());
   self->airspace_database->Optimise();
 
   Py_RETURN_NONE;
@@ -258,10 +294,230 @@ PyObject* xcsoar_Airspaces_findIntrusions(Pyxcsoar_Airspaces *self, PyObject *ar
   return py_result;
 }
 
+/**
+ * Copy a column of doubles from a Python object.  Objects implementing
+ * the buffer protocol with native doubles (e.g. numpy.float64 arrays,
+ * array.array('d')) are copied in one go; any other sequence is
+ * converted item by item.
+ */
+static bool
+ReadDoubleColumn(PyObject *py_column, const char *name,
+                 std::vector<double> &column)
+{
+  if (PyObject_CheckBuffer(py_column)) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(py_column, &view,
+                           PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+      return false;
+
+    const char *format = view.format != nullptr ? view.format : "B";
+    if (*format == '@' || *format == '=' ||
+        (*format == '<' && IsLittleEndian()) ||
+        ((*format == '>' || *format == '!') && IsBigEndian()))
+      ++format;
+
+    if (strcmp(format, "d") != 0 || view.itemsize != sizeof(double)) {
+      PyBuffer_Release(&view);
+      PyErr_Format(PyExc_TypeError, "%s: buffer does not contain doubles",
+                   name);
+      return false;
+    }
+
+    column.resize(view.len / sizeof(double));
+    memcpy(column.data(), view.buf, column.size() * sizeof(double));
+    PyBuffer_Release(&view);
+    return true;
+  }
+
+  PyObject *py_sequence = PySequence_Fast(py_column, name);
+  if (py_sequence == nullptr)
+    return false;
+
+  const Py_ssize_t n = PySequence_Fast_GET_SIZE(py_sequence);
+  column.resize(n);
+
+  for (Py_ssize_t i = 0; i < n; ++i) {
+    column[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(py_sequence, i));
+    if (column[i] == -1 && PyErr_Occurred() != nullptr) {
+      Py_DECREF(py_sequence);
+      return false;
+    }
+  }
+
+  Py_DECREF(py_sequence);
+  return true;
+}
+
+/**
+ * Create an array.array object with a copy of the given values.
+ */
+template<typename T>
+static PyObject *
+NewArray(const char *typecode, const std::vector<T> &values)
+{
+  PyObject *py_array_module = PyImport_ImportModule("array");
+  if (py_array_module == nullptr)
+    return nullptr;
+
+  PyObject *py_bytes =
+    PyBytes_FromStringAndSize((const char *)values.data(),
+                              values.size() * sizeof(T));
+  if (py_bytes == nullptr) {
+    Py_DECREF(py_array_module);
+    return nullptr;
+  }
+
+  PyObject *py_array = PyObject_CallMethod(py_array_module, "array", "sO",
+                                           typecode, py_bytes);
+  Py_DECREF(py_bytes);
+  Py_DECREF(py_array_module);
+  return py_array;
+}
+
+PyObject* xcsoar_Airspaces_findIntrusionsBulk(Pyxcsoar_Airspaces *self, PyObject *args, PyObject *kwargs) {
+  PyObject *py_times = nullptr,
+           *py_longitudes = nullptr,
+           *py_latitudes = nullptr,
+           *py_altitudes = nullptr,
+           *py_altitudes_agl = nullptr;
+
+  static char *kwlist[] = {"times", "longitudes", "latitudes", "altitudes",
+                           "altitudes_agl", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|O", kwlist,
+                                   &py_times, &py_longitudes, &py_latitudes,
+                                   &py_altitudes, &py_altitudes_agl)) {
+    return nullptr;
+  }
+
+  std::vector<double> times, longitudes, latitudes, altitudes, altitudes_agl;
+
+  if (!ReadDoubleColumn(py_times, "times", times) ||
+      !ReadDoubleColumn(py_longitudes, "longitudes", longitudes) ||
+      !ReadDoubleColumn(py_latitudes, "latitudes", latitudes) ||
+      !ReadDoubleColumn(py_altitudes, "altitudes", altitudes) ||
+      (py_altitudes_agl != nullptr && py_altitudes_agl != Py_None &&
+       !ReadDoubleColumn(py_altitudes_agl, "altitudes_agl", altitudes_agl)))
+    return nullptr;
+
+  const std::size_t n = times.size();
+  if (longitudes.size() != n || latitudes.size() != n ||
+      altitudes.size() != n ||
+      (!altitudes_agl.empty() && altitudes_agl.size() != n)) {
+    PyErr_SetString(PyExc_ValueError, "Columns differ in length");
+    return nullptr;
+  }
+
+  std::vector<unsigned> result_indices;
+  std::vector<double> result_entry_times, result_exit_times;
+
+  /* the database is only read from here on, and the Python objects
+     are not touched, so other threads may run meanwhile; addPolygon()
+     and optimise() refuse to modify this object while it is busy */
+  ++self->busy;
+  Py_BEGIN_ALLOW_THREADS
+
+  const Airspaces &database = *self->airspace_database;
+  const auto &indices = *self->airspace_indices;
+
+  /* the entry time of each airspace the aircraft is currently in */
+  std::vector<double> entry_times(indices.size());
+
+  /* sorted lists of the airspaces the aircraft is in at the current
+     and at the previous fix */
+  std::vector<unsigned> inside, last_inside, changed;
+  double last_time = 0;
+
+  AircraftState aircraft;
+  aircraft.Reset();
+
+  for (std::size_t i = 0; i < n; ++i) {
+    /* NaN may be used to mask invalid fixes */
+    if (!std::isfinite(times[i]) || !std::isfinite(longitudes[i]) ||
+        !std::isfinite(latitudes[i]) || !std::isfinite(altitudes[i]))
+      continue;
+
+    aircraft.location = GeoPoint(Angle::Degrees(longitudes[i]),
+                                 Angle::Degrees(latitudes[i]));
+    if (!aircraft.location.Check())
+      continue;
+
+    aircraft.altitude = altitudes[i];
+    /* like ToAircraftState(): 0 if the height above terrain is
+       unknown */
+    aircraft.altitude_agl =
+      !altitudes_agl.empty() && std::isfinite(altitudes_agl[i])
+      ? altitudes_agl[i]
+      : 0.;
+
+    inside.clear();
+    for (const auto &airspace : database.QueryInside(aircraft))
+      if (auto j = indices.find(&airspace.GetAirspace()); j != indices.end())
+        inside.push_back(j->second);
+    std::sort(inside.begin(), inside.end());
+
+    /* airspaces which were entered */
+    changed.clear();
+    std::set_difference(inside.begin(), inside.end(),
+                        last_inside.begin(), last_inside.end(),
+                        std::back_inserter(changed));
+    for (const unsigned index : changed)
+      entry_times[index] = times[i];
+
+    /* airspaces which were left; the exit time is the last fix
+       inside */
+    changed.clear();
+    std::set_difference(last_inside.begin(), last_inside.end(),
+                        inside.begin(), inside.end(),
+                        std::back_inserter(changed));
+    for (const unsigned index : changed) {
+      result_indices.push_back(index);
+      result_entry_times.push_back(entry_times[index]);
+      result_exit_times.push_back(last_time);
+    }
+
+    std::swap(inside, last_inside);
+    last_time = times[i];
+  }
+
+  /* close the periods which last until the end of the flight */
+  for (const unsigned index : last_inside) {
+    result_indices.push_back(index);
+    result_entry_times.push_back(entry_times[index]);
+    result_exit_times.push_back(last_time);
+  }
+
+  Py_END_ALLOW_THREADS
+  --self->busy;
+
+  PyObject *py_indices = NewArray("I", result_indices),
+           *py_entry_times = py_indices != nullptr
+             ? NewArray("d", result_entry_times)
+             : nullptr,
+           *py_exit_times = py_entry_times != nullptr
+             ? NewArray("d", result_exit_times)
+             : nullptr;
+
+  if (py_exit_times == nullptr) {
+    Py_XDECREF(py_indices);
+    Py_XDECREF(py_entry_times);
+    return nullptr;
+  }
+
+  return Py_BuildValue("(NNN)", py_indices, py_entry_times, py_exit_times);
+}
+
 PyMethodDef xcsoar_Airspaces_methods[] = {
   {"addPolygon", (PyCFunction)xcsoar_Airspaces_addPolygon, METH_VARARGS, "Add a airspace polygon."},
   {"optimise", (PyCFunction)xcsoar_Airspaces_optimise, METH_NOARGS, "Optimise airspace database."},
   {"findIntrusions", (PyCFunction)xcsoar_Airspaces_findIntrusions, METH_VARARGS, "Check flight for airspace intrusions."},
+  {"findIntrusionsBulk", (PyCFunction)xcsoar_Airspaces_findIntrusionsBulk, METH_VARARGS | METH_KEYWORDS,
+   "findIntrusionsBulk(times, longitudes, latitudes, altitudes, altitudes_agl=None)\n\n"
+   "Check columnar fixes for airspace intrusions.  The columns are sequences or\n"
+   "buffers (e.g. numpy arrays) of doubles; fixes containing NaN are skipped.\n"
+   "Returns the tuple (indices, entry_times, exit_times) of array.array objects,\n"
+   "one item per intrusion, ordered by exit time.  The index refers to the order\n"
+   "of the addPolygon() calls, the times are copied from the times column."},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -8,9 +8,24 @@
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Engine/Airspace/AirspaceClass.hpp"
 
+#include <unordered_map>
+
 /* xcsoar.Airspaces methods */
 struct Pyxcsoar_Airspaces {
   PyObject_HEAD Airspaces *airspace_database;
+
+  /**
+   * Maps each airspace to its index, i.e. the order of the
+   * addPolygon() calls.  This is what findIntrusionsBulk() returns.
+   */
+  std::unordered_map<const AbstractAirspace *, unsigned> *airspace_indices;
+
+  /**
+   * The number of findIntrusionsBulk() calls which are reading the
+   * database with the GIL released.  Only accessed while holding
+   * the GIL.
+   */
+  unsigned busy;
 };
 
 struct AirspaceClassStringCouple
@@ -25,5 +40,6 @@ void xcsoar_Airspaces_dealloc(Pyxcsoar_Airspaces *self);
 PyObject* xcsoar_Airspaces_addPolygon(Pyxcsoar_Airspaces *self, PyObject *args);
 PyObject* xcsoar_Airspaces_optimise(Pyxcsoar_Airspaces *self);
 PyObject* xcsoar_Airspaces_findIntrusions(Pyxcsoar_Airspaces *self, PyObject *args);
+PyObject* xcsoar_Airspaces_findIntrusionsBulk(Pyxcsoar_Airspaces *self, PyObject *args, PyObject *kwargs);
 
 bool Airspaces_init(PyObject* m);
@@ -5,6 +5,7 @@
 
 #include <Python.h>
 #include <structmember.h> /* required for PyMemberDef */
+#undef RESTRICTED /* clashes with AirspaceClass::RESTRICTED */
 
 #include "PythonGlue.hpp"
 #include "Flight/Flight.hpp"
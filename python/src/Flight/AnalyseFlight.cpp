@@ -6,6 +6,7 @@
 #include "Engine/Trace/Trace.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Contest/ContestManager.hpp"
+#include "thread/Parallel.hpp"
 #include "Math/Angle.hpp"
 #include "time/BrokenDateTime.hpp"
 #include "Computer/CirclingComputer.hpp"
@@ -134,6 +135,7 @@ SolveContest(Contest contest,
              const unsigned max_iterations, const unsigned max_tree_size)
 {
   ContestManager manager(contest, full_trace, triangle_trace, sprint_trace);
+  manager.SetThreads(GetProcessorCount());
   manager.SolveExhaustive(max_iterations, max_tree_size);
   return manager.GetStats();
 }
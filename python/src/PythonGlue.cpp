@@ -3,6 +3,7 @@
 
 #include <Python.h>
 #include <structmember.h> /* required for PyMemberDef */
+#undef RESTRICTED /* clashes with AirspaceClass::RESTRICTED */
 #include <datetime.h>
 
 #include "PythonGlue.hpp"
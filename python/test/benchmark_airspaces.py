@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+
+# Benchmark for xcsoar.Airspaces.findIntrusionsBulk()
+#
+# Loads an OpenAir file (e.g. a national airspace file) and checks a
+# number of flights against it.  The flights are either loaded from
+# IGC files or generated randomly around the airspaces.
+# Prints the throughput of the bulk query, single-threaded and with a
+# thread pool (the query releases the GIL).
+
+import xcsoar
+import argparse
+import math
+import random
+import re
+import time
+from array import array
+from concurrent.futures import ThreadPoolExecutor
+
+FEET = 0.3048
+EARTH_RADIUS = 6371000.
+
+
+def parse_coordinate(s):
+    """Parse an OpenAir coordinate like "35:30:01 S 136:49:20 E"."""
+
+    m = re.match(r'\s*([\d:.]+)\s*([NS])\s*([\d:.]+)\s*([EW])', s, re.I)
+    if m is None:
+        raise ValueError('Malformed coordinate: ' + s)
+
+    def degrees(value, hemisphere):
+        result = 0.
+        for i, part in enumerate(value.split(':')):
+            result += float(part) / 60 ** i
+        return -result if hemisphere.upper() in 'SW' else result
+
+    return degrees(m.group(3), m.group(4)), degrees(m.group(1), m.group(2))
+
+
+def parse_altitude(s):
+    """Returns (altitude, reference) as expected by addPolygon()."""
+
+    s = s.strip().upper()
+    if s.startswith(('SFC', 'GND')):
+        return 0., 'AGL'
+    if s.startswith('UNL'):
+        return 50000., 'MSL'
+
+    m = re.match(r'FL\s*(\d+)', s)
+    if m is not None:
+        return float(m.group(1)), 'FL'
+
+    m = re.match(r'(\d+)\s*(M|FT|F)?\s*(.*)', s)
+    if m is None:
+        return 0., 'MSL'
+
+    value = float(m.group(1))
+    if m.group(2) != 'M':
+        value *= FEET
+
+    return value, 'AGL' if m.group(3).startswith(('AGL', 'SFC', 'GND')) else 'MSL'
+
+
+def destination(center, bearing, distance):
+    lon, lat = center
+    d = distance / EARTH_RADIUS
+    return (lon + math.degrees(d * math.sin(bearing) / math.cos(math.radians(lat))),
+            lat + math.degrees(d * math.cos(bearing)))
+
+
+def bearing_distance(center, point):
+    dx = math.radians(point[0] - center[0]) * math.cos(math.radians(center[1]))
+    dy = math.radians(point[1] - center[1])
+    return math.atan2(dx, dy), math.hypot(dx, dy) * EARTH_RADIUS
+
+
+def arc(center, radius, start, end, clockwise, step=math.radians(5)):
+    """Approximate an arc with points every 5 degrees."""
+
+    if clockwise:
+        while end <= start:
+            end += 2 * math.pi
+    else:
+        while end >= start:
+            end -= 2 * math.pi
+
+    n = max(1, int(abs(end - start) / step))
+    return [destination(center, start + (end - start) * i / n, radius)
+            for i in range(n + 1)]
+
+
+def load_openair(path):
+    """A minimal OpenAir reader; returns a list of
+    (points, name, class, base, base_ref, top, top_ref)."""
+
+    airspaces = []
+    current = None
+    center = None
+    clockwise = True
+
+    def flush():
+        if current is not None and len(current['points']) >= 3:
+            airspaces.append((current['points'], current['name'],
+                              current['class'],
+                              current['base'][0], current['base'][1],
+                              current['top'][0], current['top'][1]))
+
+    with open(path, encoding='latin-1') as f:
+        for line in f:
+            line = line.split('*', 1)[0].strip()
+            if not line:
+                continue
+
+            command, _, value = line.partition(' ')
+            command = command.upper()
+
+            if command == 'AC':
+                flush()
+                current = dict(points=[], name='',
+                               base=(0., 'AGL'), top=(50000., 'MSL'))
+                current['class'] = {
+                    'A': 'CLASSA', 'B': 'CLASSB', 'C': 'CLASSC',
+                    'D': 'CLASSD', 'E': 'CLASSE', 'F': 'CLASSF',
+                    'G': 'CLASSG', 'R': 'RESTRICTED', 'Q': 'DANGER',
+                    'P': 'PROHIBITED', 'CTR': 'CTR', 'W': 'WAVE',
+                    'GP': 'NOGLIDER', 'TMZ': 'TMZ', 'RMZ': 'RMZ',
+                }.get(value.strip().upper(), 'OTHER')
+                clockwise = True
+            elif current is None:
+                continue
+            elif command == 'AN':
+                current['name'] = value.strip()
+            elif command == 'AL':
+                current['base'] = parse_altitude(value)
+            elif command == 'AH':
+                current['top'] = parse_altitude(value)
+            elif command == 'V':
+                key, _, value = value.partition('=')
+                key = key.strip().upper()
+                if key == 'X':
+                    center = parse_coordinate(value)
+                elif key == 'D':
+                    clockwise = value.strip() != '-'
+            elif command == 'DP':
+                current['points'].append(parse_coordinate(value))
+            elif command == 'DC' and center is not None:
+                radius = float(value) * 1852
+                current['points'].extend(arc(center, radius, 0, 2 * math.pi, True)[:-1])
+            elif command == 'DB' and center is not None:
+                start, end = [parse_coordinate(p) for p in value.split(',')]
+                start_bearing, radius = bearing_distance(center, start)
+                end_bearing, _ = bearing_distance(center, end)
+                current['points'].extend(arc(center, radius, start_bearing,
+                                             end_bearing, clockwise))
+            elif command == 'DA' and center is not None:
+                radius, start, end = [float(x) for x in value.split(',')]
+                current['points'].extend(arc(center, radius * 1852,
+                                             math.radians(start),
+                                             math.radians(end), clockwise))
+
+    flush()
+    return airspaces
+
+
+def load_igc(path):
+    """Returns the columns (times, longitudes, latitudes, altitudes)."""
+
+    flight = xcsoar.Flight(path, False)
+    columns = tuple(array('d') for _ in range(4))
+
+    for fix in flight.path():
+        columns[0].append(fix[0].timestamp())
+        columns[1].append(fix[2]['longitude'])
+        columns[2].append(fix[2]['latitude'])
+        columns[3].append(fix[3])
+
+    return columns
+
+
+def random_flight(polygons, n_fixes, rnd):
+    """A random walk at 30 m/s with one fix per second, starting at
+    the boundary of a random airspace."""
+
+    lon, lat = rnd.choice(rnd.choice(polygons)[0])
+    alt = rnd.uniform(500, 3000)
+    bearing = rnd.uniform(0, 2 * math.pi)
+
+    columns = tuple(array('d') for _ in range(4))
+    for i in range(n_fixes):
+        bearing += rnd.gauss(0, 0.05)
+        lon, lat = destination((lon, lat), bearing, 30)
+        alt = min(max(alt + rnd.gauss(0, 2), 0), 6000)
+        columns[0].append(i)
+        columns[1].append(lon)
+        columns[2].append(lat)
+        columns[3].append(alt)
+
+    return columns
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark bulk airspace intrusion checks.')
+    parser.add_argument('airspace_file', type=str, help='OpenAir file')
+    parser.add_argument('igc_files', type=str, nargs='*')
+    parser.add_argument('--flights', type=int, default=200,
+                        help='number of random flights without IGC files')
+    parser.add_argument('--fixes', type=int, default=5 * 3600,
+                        help='number of fixes per random flight')
+    parser.add_argument('--threads', type=int, default=4)
+    args = parser.parse_args()
+
+    t = time.perf_counter()
+    polygons = load_openair(args.airspace_file)
+
+    airspaces = xcsoar.Airspaces()
+    for polygon in polygons:
+        points = [dict(longitude=lon, latitude=lat) for lon, lat in polygon[0]]
+        airspaces.addPolygon(points, *polygon[1:])
+    airspaces.optimise()
+
+    print('Loaded {} airspaces in {:.2f} s'.format(
+        len(polygons), time.perf_counter() - t))
+
+    if args.igc_files:
+        flights = [load_igc(path) for path in args.igc_files]
+    else:
+        rnd = random.Random(42)
+        flights = [random_flight(polygons, args.fixes, rnd)
+                   for _ in range(args.flights)]
+
+    n_fixes = sum(len(flight[0]) for flight in flights)
+
+    t = time.perf_counter()
+    results = [airspaces.findIntrusionsBulk(*flight) for flight in flights]
+    duration = time.perf_counter() - t
+
+    n_intrusions = sum(len(result[0]) for result in results)
+    print('{} flights, {} fixes, {} intrusions in {:.2f} s: {:.0f} fixes/s'.format(
+        len(flights), n_fixes, n_intrusions, duration, n_fixes / duration))
+
+    with ThreadPoolExecutor(args.threads) as executor:
+        t = time.perf_counter()
+        threaded_results = list(executor.map(
+            lambda flight: airspaces.findIntrusionsBulk(*flight), flights))
+        duration = time.perf_counter() - t
+
+    assert threaded_results == results
+    print('{} threads: {:.2f} s, {:.0f} fixes/s'.format(
+        args.threads, duration, n_fixes / duration))
+
+    for path, (indices, entry_times, exit_times) in zip(args.igc_files, results):
+        print(path)
+        for index, entry, exit in zip(indices, entry_times, exit_times):
+            print('  {}: {:.0f} .. {:.0f}'.format(polygons[index][1], entry, exit))
+
+
+if __name__ == '__main__':
+    main()
@@ -19,9 +19,26 @@
 #include "io/ZipLineReader.hpp"
 #include "io/MapFile.hpp"
 #include "Profile/Profile.hpp"
+#include "thread/Parallel.hpp"
 
 #include <string.h>
 
+/**
+ * Only borders with at least this many vertices are compressed;
+ * smaller ones (e.g. circles) are not worth the decoding overhead.
+ */
+static constexpr unsigned COMPRESS_MIN_POINTS = 16;
+
+/**
+ * Parse OpenAir files with multiple threads?  On a single core, this
+ * would only add overhead.
+ */
+static bool
+UseParallelParser() noexcept
+{
+  return GetProcessorCount() > 1;
+}
+
 static bool
 ParseAirspaceFile(Airspaces &airspaces, Path path,
                   OperationEnvironment &operation) noexcept
@@ -31,7 +48,7 @@ try {
   BufferedReader buffered_reader{progress_reader};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, buffered_reader, UseParallelParser());
   } catch (...) {
     // TODO translate this?
     std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
@@ -54,7 +71,7 @@ try {
   BufferedReader buffered_reader{progress_reader};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, buffered_reader, UseParallelParser());
   } catch (...) {
     // TODO translate this?
     std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
@@ -98,6 +115,15 @@ ReadAirspace(Airspaces &airspaces,
 
   if (airspace_ok) {
     airspaces.Optimise();
+
+    /* compressing the borders saves memory, but costs CPU time each
+       time a border is decoded; it is only worth it on devices which
+       would otherwise run out of memory, so the user has to opt in */
+    bool compress = false;
+    Profile::Get(ProfileKeys::AirspaceCompressBorders, compress);
+    if (compress)
+      airspaces.CompressBorders(COMPRESS_MIN_POINTS);
+
     airspaces.SetFlightLevels(press);
   } else
     // there was a problem
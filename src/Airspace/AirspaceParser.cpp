@@ -22,9 +22,16 @@
 #include "util/StaticString.hxx"
 #include "util/StringCompare.hxx"
 #include "util/StringSplit.hxx"
+#include "util/ScopeExit.hxx"
+#include "thread/Parallel.hpp"
 
+#include <algorithm>
+#include <concepts>
+#include <iterator>
 #include <stdexcept>
 
+#include <string.h>
+
 using std::string_view_literals::operator""sv;
 
 enum class AirspaceFileType {
@@ -211,13 +218,27 @@ struct TempAirspace
   }
 
   /**
-   * If there is an airspace, add it to the #Airspaces and return
-   * true.  Returns false if no airspace was being constructed.
-   * Throws if the airspace is bad.
+   * Is this object in the state left by Reset() (ignoring
+   * #first_line_number)?  The #asclass attribute is ignored, too,
+   * because it is overwritten by the "AC" line which begins the next
+   * airspace.
+   */
+  [[gnu::pure]]
+  bool IsClean() const noexcept {
+    return days_of_operation.equals(AirspaceActivity{}) &&
+      name.empty() && !radio_frequency.IsDefined() &&
+      astype == OTHER && !base && !top && points.empty() &&
+      !center.IsValid() && radius == -1 && rotation == 1;
+  }
+
+  /**
+   * If there is an airspace, add it to the list and return true.
+   * Returns false if no airspace was being constructed.  Throws if
+   * the airspace is bad.
    */
-  bool Commit(Airspaces &airspace_database) {
+  bool Commit(std::vector<AirspacePtr> &dest) {
     if (!points.empty()) {
-      AddPolygon(airspace_database);
+      AddPolygon(dest);
       return true;
     } else
       return false;
@@ -233,7 +254,7 @@ struct TempAirspace
   }
 
   void
-  AddPolygon(Airspaces &airspace_database)
+  AddPolygon(std::vector<AirspacePtr> &dest)
   {
     Check();
 
@@ -250,7 +271,7 @@ struct TempAirspace
     as->SetProperties(std::move(name), asclass, astype, *base, *top);
     as->SetRadioFrequency(radio_frequency);
     as->SetDays(days_of_operation);
-    airspace_database.Add(std::move(as));
+    dest.emplace_back(std::move(as));
   }
 
   GeoPoint RequireCenter() {
@@ -266,7 +287,7 @@ struct TempAirspace
   }
 
   void
-  AddCircle(Airspaces &airspace_database)
+  AddCircle(std::vector<AirspacePtr> &dest)
   {
     Check();
 
@@ -284,7 +305,7 @@ struct TempAirspace
     as->SetProperties(std::move(name), asclass, std::move(astype), *base, *top);
     as->SetRadioFrequency(radio_frequency);
     as->SetDays(days_of_operation);
-    airspace_database.Add(std::move(as));
+    dest.emplace_back(std::move(as));
   }
 
   static constexpr int
@@ -468,6 +489,41 @@ ReadAltitude(StringParser<> &input)
   return altitude;
 }
 
+/**
+ * Like StringParser::ReadDouble(), but with a fast path for plain
+ * integers, which are the usual case in OpenAir coordinates.  The
+ * result is the same: everything which strtod() could parse
+ * differently (fractions, exponents, hexadecimal, very long numbers)
+ * goes the slow path.
+ */
+static std::optional<double>
+ReadCoordinateComponent(StringParser<> &input) noexcept
+{
+  const char *p = input.c_str();
+
+  unsigned value = 0, n = 0;
+  for (; n < 9 && IsDigitASCII(p[n]); ++n)
+    value = value * 10 + unsigned(p[n] - '0');
+
+  switch (p[n]) {
+  case '.':
+  case ',':
+  case 'e':
+  case 'E':
+  case 'x':
+  case 'X':
+    break;
+
+  default:
+    if (n > 0 && !IsDigitASCII(p[n])) {
+      input.Skip(n);
+      return value;
+    }
+  }
+
+  return input.ReadDouble();
+}
+
 /**
  * Throws on error.
  */
@@ -476,20 +532,21 @@ ReadNonNegativeAngle(StringParser<> &input, double max_degrees)
 {
   double degrees;
 
-  if (auto x = input.ReadDouble(); x && *x >= 0 && *x <= max_degrees)
+  if (auto x = ReadCoordinateComponent(input);
+      x && *x >= 0 && *x <= max_degrees)
     degrees = *x;
   else
     throw std::runtime_error("Bad angle");
 
   if (input.SkipMatch(':')) {
-    if (auto minutes = input.ReadDouble();
+    if (auto minutes = ReadCoordinateComponent(input);
         minutes && *minutes >= 0 && *minutes <= 60)
       degrees += *minutes / 60;
     else
       throw std::runtime_error("Bad angle");
 
     if (input.SkipMatch(':')) {
-      if (auto seconds = input.ReadDouble();
+      if (auto seconds = ReadCoordinateComponent(input);
           seconds && *seconds >= 0 && *seconds <= 60)
         degrees += *seconds / 3600;
       else
@@ -640,7 +697,7 @@ ReadRadioFrequency(const std::string_view line) noexcept
  * Throws on error.
  */
 static void
-ParseLine(Airspaces &airspace_database, unsigned line_number,
+ParseLine(std::vector<AirspacePtr> &dest, unsigned line_number,
           StringParser<> &&input,
           StringConverter &string_converter,
           TempAirspace &temp_area)
@@ -661,7 +718,7 @@ ParseLine(Airspaces &airspace_database, unsigned line_number,
     case 'C':
     case 'c':
       temp_area.radius = ParseRadiusNM(input);
-      temp_area.AddCircle(airspace_database);
+      temp_area.AddCircle(dest);
       temp_area.Reset(line_number);
       break;
 
@@ -697,7 +754,7 @@ ParseLine(Airspaces &airspace_database, unsigned line_number,
       if (!input.SkipWhitespace())
         break;
 
-      if (temp_area.Commit(airspace_database))
+      if (temp_area.Commit(dest))
         temp_area.Reset(line_number);
 
       temp_area.asclass = ParseClass(input.c_str());
@@ -746,7 +803,7 @@ ParseLine(Airspaces &airspace_database, unsigned line_number,
  * Throws on error.
  */
 static void
-ParseLine(Airspaces &airspace_database, unsigned line_number, char *line,
+ParseLine(std::vector<AirspacePtr> &dest, unsigned line_number, char *line,
           StringConverter &string_converter,
           TempAirspace &temp_area)
 {
@@ -755,7 +812,7 @@ ParseLine(Airspaces &airspace_database, unsigned line_number, char *line,
   if (comment != nullptr)
     *comment = '\0';
 
-  ParseLine(airspace_database, line_number, StringParser<>{line},
+  ParseLine(dest, line_number, StringParser<>{line},
             string_converter,
             temp_area);
 }
@@ -906,7 +963,7 @@ ParseCircleTNP(StringParser<> &input, TempAirspace &temp_area)
  * Throws on error.
  */
 static void
-ParseLineTNP(Airspaces &airspace_database, unsigned line_number,
+ParseLineTNP(std::vector<AirspacePtr> &dest, unsigned line_number,
              StringParser<> &input,
              StringConverter &string_converter,
              TempAirspace &temp_area, bool &ignore)
@@ -931,7 +988,7 @@ ParseLineTNP(Airspaces &airspace_database, unsigned line_number,
   } else if (input.SkipMatchIgnoreCase("CIRCLE "sv)) {
     ParseCircleTNP(input, temp_area);
 
-    temp_area.AddCircle(airspace_database);
+    temp_area.AddCircle(dest);
     temp_area.ResetTNP(line_number);
   } else if (input.SkipMatchIgnoreCase("CLOCKWISE "sv)) {
     temp_area.rotation = 1;
@@ -940,12 +997,12 @@ ParseLineTNP(Airspaces &airspace_database, unsigned line_number,
     temp_area.rotation = -1;
     ParseArcTNP(input, temp_area);
   } else if (input.SkipMatchIgnoreCase("TITLE="sv)) {
-    if (temp_area.Commit(airspace_database))
+    if (temp_area.Commit(dest))
       temp_area.ResetTNP(line_number);
 
     temp_area.name = string_converter.Convert(input.c_str());
   } else if (input.SkipMatchIgnoreCase("TYPE="sv)) {
-    if (temp_area.Commit(airspace_database))
+    if (temp_area.Commit(dest))
       temp_area.ResetTNP(line_number);
 
     temp_area.asclass = ParseTypeTNP(input.c_str());
@@ -982,57 +1039,360 @@ DetectFileType(const char *line) noexcept
   return AirspaceFileType::UNKNOWN;
 }
 
+/**
+ * Invoke the given function which parses one line.  Its exceptions
+ * are rethrown with the line number (or with the first line number of
+ * the airspace which could not be committed).
+ *
+ * Throws on error.
+ */
+static void
+TranslateLineErrors(unsigned line_number, const char *line,
+                    const TempAirspace &temp_area,
+                    std::invocable<> auto f)
+{
+  try {
+    f();
+  } catch (const TempAirspace::CommitError &e) {
+    throw FmtRuntimeError("Error in airspace at line {}: {}",
+                          temp_area.first_line_number, e.msg);
+  } catch (...) {
+    // TODO translate this?
+    std::throw_with_nested(FmtRuntimeError("Error in line {} ('{}')",
+                                           line_number, line));
+  }
+}
+
+/**
+ * Does this OpenAir line begin a new airspace, i.e. is it an "AC"
+ * line which makes ParseLine() commit the previous one?
+ */
+[[gnu::pure]]
+static bool
+IsAirspaceBegin(const char *line) noexcept
+{
+  return (line[0] == 'A' || line[0] == 'a') &&
+    (line[1] == 'C' || line[1] == 'c') &&
+    IsWhitespaceNotNull(line[2]);
+}
+
+/**
+ * A portion of an OpenAir file, split into blocks which begin with an
+ * "AC" line.
+ *
+ * The blocks are parsed concurrently, each one assuming that the
+ * previous airspace has been committed, which is the usual case.
+ * The results are then merged in file order; if that assumption
+ * turns out to be wrong for a block (or if the block has an error),
+ * it is parsed again with the real parser state.  This way, the
+ * result (including error messages) is exactly the same as parsing
+ * line by line.
+ */
+class OpenAirChunk {
+  struct Line {
+    unsigned number;
+
+    /**
+     * The offset of the (null-terminated) line in #text.
+     */
+    std::size_t offset;
+  };
+
+  struct Block {
+    /**
+     * The index of the first line (the "AC" line) and the index
+     * after the last line in #lines.
+     */
+    std::size_t begin, end;
+
+    /**
+     * The airspaces committed while parsing this block.
+     */
+    std::vector<AirspacePtr> airspaces;
+
+    /**
+     * The parser state after the last line of this block.
+     */
+    TempAirspace temp_area;
+
+    /**
+     * The charset of the #StringConverter after the last line of this
+     * block.
+     */
+    Charset charset;
+
+    /**
+     * Has parsing this block failed?
+     */
+    bool failed;
+  };
+
+  const std::size_t chunk_size;
+
+  std::vector<char> text;
+  std::vector<Line> lines;
+  std::vector<Block> blocks;
+
+public:
+  explicit OpenAirChunk(std::size_t _chunk_size) noexcept
+    :chunk_size(_chunk_size) {}
+
+  bool IsFull() const noexcept {
+    return text.size() >= chunk_size;
+  }
+
+  void Append(unsigned line_number, const char *line) noexcept {
+    if (IsAirspaceBegin(line)) {
+      if (!blocks.empty())
+        blocks.back().end = lines.size();
+
+      blocks.emplace_back();
+      blocks.back().begin = lines.size();
+    }
+
+    lines.push_back({line_number, text.size()});
+    text.insert(text.end(), line, line + strlen(line) + 1);
+  }
+
+  /**
+   * Parse all lines of this chunk, append the committed airspaces to
+   * #dest and clear this chunk.
+   *
+   * Throws on error.
+   */
+  void Parse(std::vector<AirspacePtr> &dest,
+             StringConverter &string_converter,
+             TempAirspace &temp_area, unsigned n_threads);
+
+private:
+  char *GetLine(std::size_t i) noexcept {
+    return text.data() + lines[i].offset;
+  }
+
+  /**
+   * Parse the specified lines with the real parser state.
+   *
+   * Throws on error.
+   */
+  void ParseLines(std::size_t begin, std::size_t end,
+                  std::vector<AirspacePtr> &dest,
+                  StringConverter &string_converter,
+                  TempAirspace &temp_area) {
+    for (std::size_t i = begin; i < end; ++i) {
+      char *line = GetLine(i);
+      TranslateLineErrors(lines[i].number, line, temp_area, [&]{
+        ParseLine(dest, lines[i].number, line, string_converter, temp_area);
+      });
+    }
+  }
+
+  void ParseBlock(Block &block, Charset charset) noexcept;
+
+  /**
+   * Throws on error.
+   */
+  void Merge(Block &block, Charset charset,
+             std::vector<AirspacePtr> &dest,
+             StringConverter &string_converter,
+             TempAirspace &temp_area);
+};
+
 void
-ParseAirspaceFile(Airspaces &airspaces,
-                  BufferedReader &reader)
+OpenAirChunk::ParseBlock(Block &block, Charset charset) noexcept
 {
-  StringConverter string_converter;
+  StringConverter string_converter{charset};
+  block.temp_area.Reset(lines[block.begin].number);
+
+  try {
+    for (std::size_t i = block.begin; i < block.end; ++i)
+      ParseLine(block.airspaces, lines[i].number, GetLine(i),
+                string_converter, block.temp_area);
+    block.failed = false;
+  } catch (...) {
+    /* the error will be reported by Merge() */
+    block.failed = true;
+  }
 
-  bool ignore = false;
+  block.charset = string_converter.GetCharset();
+}
 
+inline void
+OpenAirChunk::Merge(Block &block, Charset charset,
+                    std::vector<AirspacePtr> &dest,
+                    StringConverter &string_converter,
+                    TempAirspace &temp_area)
+{
+  /* the "AC" line commits the previous airspace */
+  ParseLines(block.begin, block.begin + 1,
+             dest, string_converter, temp_area);
+
+  if (block.failed || !temp_area.IsClean() ||
+      string_converter.GetCharset() != charset) {
+    /* the block was parsed with the wrong initial state (or it has
+       an error to be reported): parse it again */
+    ParseLines(block.begin + 1, block.end,
+               dest, string_converter, temp_area);
+    return;
+  }
+
+  std::move(block.airspaces.begin(), block.airspaces.end(),
+            std::back_inserter(dest));
+
+  const unsigned first_line_number = temp_area.first_line_number;
+  temp_area = std::move(block.temp_area);
+  if (temp_area.first_line_number == lines[block.begin].number)
+    /* there was no Reset() after the "AC" line, but the real state
+       may have been reset earlier */
+    temp_area.first_line_number = first_line_number;
+
+  string_converter.SetCharset(block.charset);
+}
+
+void
+OpenAirChunk::Parse(std::vector<AirspacePtr> &dest,
+                    StringConverter &string_converter,
+                    TempAirspace &temp_area, unsigned n_threads)
+{
+  /* the lines before the first "AC" line */
+  ParseLines(0, blocks.empty() ? lines.size() : blocks.front().begin,
+             dest, string_converter, temp_area);
+
+  if (!blocks.empty())
+    blocks.back().end = lines.size();
+
+  const Charset charset = string_converter.GetCharset();
+  RunParallel(blocks.size(), n_threads, [this, charset](unsigned i){
+    ParseBlock(blocks[i], charset);
+  });
+
+  for (auto &block : blocks)
+    Merge(block, charset, dest, string_converter, temp_area);
+
+  text.clear();
+  lines.clear();
+  blocks.clear();
+}
+
+/**
+ * Parse an OpenAir file, beginning with the given (non-empty) line,
+ * which has already been read.
+ *
+ * Throws on error.
+ */
+static void
+ParseOpenAirFile(std::vector<AirspacePtr> &dest,
+                 BufferedReader &reader, char *line, bool parallel,
+                 std::size_t chunk_size)
+{
+  StringConverter string_converter;
   TempAirspace temp_area;
-  AirspaceFileType filetype = AirspaceFileType::UNKNOWN;
 
-  char *line;
+  if (parallel) {
+    const unsigned n_threads = GetProcessorCount();
+    OpenAirChunk chunk{chunk_size};
 
-  // Iterate through the lines
-  while ((line = reader.ReadLine()) != nullptr) {
+    do {
+      StripRight(line);
+
+      // Skip empty line
+      if (StringIsEmpty(line))
+        continue;
+
+      if (chunk.IsFull() && IsAirspaceBegin(line))
+        chunk.Parse(dest, string_converter, temp_area, n_threads);
+
+      chunk.Append(reader.GetLineNumber(), line);
+    } while ((line = reader.ReadLine()) != nullptr);
+
+    chunk.Parse(dest, string_converter, temp_area, n_threads);
+  } else {
+    do {
+      StripRight(line);
+
+      // Skip empty line
+      if (StringIsEmpty(line))
+        continue;
+
+      const unsigned line_number = reader.GetLineNumber();
+      TranslateLineErrors(line_number, line, temp_area, [&]{
+        ParseLine(dest, line_number, line, string_converter, temp_area);
+      });
+    } while ((line = reader.ReadLine()) != nullptr);
+  }
+
+  // Process final area (if any)
+  temp_area.Commit(dest);
+}
+
+/**
+ * Parse a TNP file, beginning with the given (non-empty) line, which
+ * has already been read.
+ *
+ * Throws on error.
+ */
+static void
+ParseTNPFile(std::vector<AirspacePtr> &dest,
+             BufferedReader &reader, char *line)
+{
+  StringConverter string_converter;
+  TempAirspace temp_area;
+  bool ignore = false;
+
+  do {
     StripRight(line);
 
     // Skip empty line
     if (StringIsEmpty(line))
       continue;
 
-    if (filetype == AirspaceFileType::UNKNOWN) {
-      filetype = DetectFileType(line);
-      if (filetype == AirspaceFileType::UNKNOWN)
-        continue;
-    }
+    const unsigned line_number = reader.GetLineNumber();
+    TranslateLineErrors(line_number, line, temp_area, [&]{
+      StringParser<> input(line);
+      ParseLineTNP(dest, line_number, input, string_converter,
+                   temp_area, ignore);
+    });
+  } while ((line = reader.ReadLine()) != nullptr);
 
-    // Parse the line
-    try {
-      if (filetype == AirspaceFileType::OPENAIR)
-        ParseLine(airspaces, reader.GetLineNumber(), line,
-                  string_converter, temp_area);
-      if (filetype == AirspaceFileType::TNP) {
-        StringParser<> input(line);
-        ParseLineTNP(airspaces, reader.GetLineNumber(), input, string_converter,
-                     temp_area, ignore);
-      }
-    } catch (const TempAirspace::CommitError &e) {
-      throw FmtRuntimeError("Error in airspace at line {}: {}",
-                            temp_area.first_line_number, e.msg);
-    } catch (...) {
-      // TODO translate this?
-      std::throw_with_nested(FmtRuntimeError("Error in line {} ('{}')",
-                                             reader.GetLineNumber(),
-                                             line));
-    }
+  // Process final area (if any)
+  temp_area.Commit(dest);
+}
+
+void
+ParseAirspaceFile(Airspaces &airspaces,
+                  BufferedReader &reader, bool parallel,
+                  std::size_t chunk_size)
+{
+  AirspaceFileType filetype = AirspaceFileType::UNKNOWN;
+
+  char *line;
+
+  // Skip lines until the file type is known
+  while ((line = reader.ReadLine()) != nullptr) {
+    StripRight(line);
+
+    filetype = DetectFileType(line);
+    if (filetype != AirspaceFileType::UNKNOWN)
+      break;
   }
 
-  if (filetype == AirspaceFileType::UNKNOWN)
+  /* the airspaces which were parsed before an error are added,
+     too */
+  std::vector<AirspacePtr> parsed;
+  AtScopeExit(&airspaces, &parsed) {
+    for (auto &i : parsed)
+      airspaces.Add(std::move(i));
+  };
+
+  switch (filetype) {
+  case AirspaceFileType::UNKNOWN:
     throw std::runtime_error(WideToUTF8Converter(_("Unknown airspace filetype")));
 
-  // Process final area (if any)
-  temp_area.Commit(airspaces);
+  case AirspaceFileType::OPENAIR:
+    ParseOpenAirFile(parsed, reader, line, parallel, chunk_size);
+    break;
+
+  case AirspaceFileType::TNP:
+    ParseTNPFile(parsed, reader, line);
+    break;
+  }
 }
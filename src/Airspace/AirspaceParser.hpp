@@ -3,12 +3,27 @@
 
 #pragma once
 
+#include <cstddef>
+
 class Airspaces;
 class BufferedReader;
 
+/**
+ * The OpenAir parser collects this much text before it parses the
+ * airspaces in it concurrently.
+ */
+static constexpr std::size_t OPENAIR_CHUNK_SIZE = 256 * 1024;
+
 /**
  * Throws on error.
+ *
+ * @param parallel parse OpenAir files with multiple threads; the
+ * result is the same as with the (slower) line-by-line parser, which
+ * is used if this is false
+ * @param chunk_size see #OPENAIR_CHUNK_SIZE; tests pass a small value
+ * to split small files into several chunks
  */
 void
 ParseAirspaceFile(Airspaces &airspaces,
-                  BufferedReader &reader);
+                  BufferedReader &reader, bool parallel=true,
+                  std::size_t chunk_size=OPENAIR_CHUNK_SIZE);
@@ -13,6 +13,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 class Serialiser;
 class Deserialiser;
@@ -63,6 +64,35 @@ struct CloudClient
   std::chrono::steady_clock::time_point wants_thermals =
     std::chrono::steady_clock::time_point::min();
 
+  /**
+   * The #CloudTrafficSnapshot::time of the last traffic response
+   * sent to this client.  Subsequent responses contain only traffic
+   * which has been updated since (or which is new to the client, see
+   * #traffic_sent_keys).
+   */
+  std::chrono::steady_clock::time_point traffic_sent =
+    std::chrono::steady_clock::time_point::min();
+
+  /**
+   * The (sorted) keys of the traffic selected for the last response.
+   * Traffic which is not in this list has not been sent yet, even if
+   * it has not been updated since #traffic_sent, e.g. because the
+   * client has moved towards it.
+   */
+  std::vector<uint64_t> traffic_sent_keys;
+
+  /**
+   * The time of the last complete traffic response.
+   */
+  std::chrono::steady_clock::time_point traffic_keyframe =
+    std::chrono::steady_clock::time_point::min();
+
+  /**
+   * The #CloudGrid tile of the last traffic response.  After the
+   * client moves to another tile, it gets a complete response.
+   */
+  uint64_t traffic_tile = 0;
+
   /**
    * Last known location.  This is always "defined", because clients
    * without a location are not tracked.
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoPoint.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * The geographic grid used by the cloud server to group data by
+ * region.
+ *
+ * The world is divided into rows of constant latitude; the longitude
+ * is scaled with the cosine of the row's latitude, so all tiles have
+ * roughly the same size (about 55 km).
+ */
+namespace CloudGrid {
+
+/**
+ * The height of a tile (and its width at the equator) [degrees].
+ */
+static constexpr double TILE_HEIGHT = 0.5;
+
+[[gnu::const]]
+static constexpr int
+FloorDiv(int a, int b) noexcept
+{
+  return a >= 0 ? a / b : -((-a - 1) / b) - 1;
+}
+
+[[gnu::const]]
+static constexpr uint64_t
+MakeKey(int row, int column) noexcept
+{
+  return (uint64_t(uint32_t(row)) << 32) | uint32_t(column);
+}
+
+[[gnu::const]]
+static constexpr int
+KeyRow(uint64_t key) noexcept
+{
+  return int32_t(uint32_t(key >> 32));
+}
+
+[[gnu::const]]
+static constexpr int
+KeyColumn(uint64_t key) noexcept
+{
+  return int32_t(uint32_t(key));
+}
+
+/**
+ * The width of all tiles in the given row [degrees longitude].
+ */
+[[gnu::const]]
+static inline double
+TileWidth(int row) noexcept
+{
+  const auto latitude = Angle::Degrees((row + 0.5) * TILE_HEIGHT);
+  return TILE_HEIGHT / std::max(latitude.cos(), 0.05);
+}
+
+[[gnu::const]]
+static inline int
+TileRow(Angle latitude) noexcept
+{
+  return (int)std::floor(latitude.Degrees() / TILE_HEIGHT);
+}
+
+[[gnu::const]]
+static inline int
+TileColumn(int row, double longitude) noexcept
+{
+  return (int)std::floor(longitude / TileWidth(row));
+}
+
+[[gnu::const]]
+static inline uint64_t
+TileKey(GeoPoint location) noexcept
+{
+  const int row = TileRow(location.latitude);
+  return MakeKey(row, TileColumn(row, location.longitude.Degrees()));
+}
+
+[[gnu::const]]
+static inline GeoPoint
+TileCenter(uint64_t key) noexcept
+{
+  const int row = KeyRow(key);
+  return {
+    Angle::Degrees((KeyColumn(key) + 0.5) * TileWidth(row)),
+    Angle::Degrees((row + 0.5) * TILE_HEIGHT),
+  };
+}
+
+/**
+ * Invoke a function for all tile keys in the given row which overlap
+ * the given longitude range.
+ */
+template<typename F>
+static inline void
+ForEachTileInRow(int row, double min_longitude, double max_longitude,
+                 F &&f) noexcept
+{
+  const int max_column = TileColumn(row, max_longitude);
+  for (int column = TileColumn(row, min_longitude);
+       column <= max_column; ++column)
+    f(MakeKey(row, column));
+}
+
+/**
+ * Invoke a function for the given tile and all tiles adjacent to it.
+ */
+template<typename F>
+static inline void
+ForEachNeighbour(uint64_t key, F &&f) noexcept
+{
+  const int row = KeyRow(key);
+  const double min_longitude = KeyColumn(key) * TileWidth(row);
+  const double max_longitude = (KeyColumn(key) + 1) * TileWidth(row);
+
+  for (int r = row - 1; r <= row + 1; ++r) {
+    const double width = TileWidth(r);
+    ForEachTileInRow(r, min_longitude - width, max_longitude + width, f);
+  }
+}
+
+/**
+ * Invoke a function for all tiles which have the given tile as a
+ * neighbour (see ForEachNeighbour()).
+ */
+template<typename F>
+static inline void
+ForEachReverseNeighbour(uint64_t key, F &&f) noexcept
+{
+  const int row = KeyRow(key);
+  const double width = TileWidth(row);
+  const double min_longitude = (KeyColumn(key) - 1) * width;
+  const double max_longitude = (KeyColumn(key) + 2) * width;
+
+  for (int r = row - 1; r <= row + 1; ++r)
+    ForEachTileInRow(r, min_longitude, max_longitude, f);
+}
+
+} // namespace CloudGrid
@@ -2,6 +2,8 @@
 // Copyright The XCSoar Project
 
 #include "Data.hpp"
+#include "Grid.hpp"
+#include "TrafficSnapshot.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
 #include "Serialiser.hpp"
@@ -19,6 +21,7 @@
 #include "util/Compiler.h"
 #include "util/ScopeExit.hxx"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <iomanip>
@@ -30,10 +33,18 @@ static constexpr double TRAFFIC_RANGE = 50000;
 static constexpr double THERMAL_RANGE = 50000;
 
 static constexpr std::chrono::steady_clock::duration MAX_TRAFFIC_AGE = std::chrono::minutes(15);
-static constexpr std::chrono::steady_clock::duration MAX_THERMAL_AGE = std::chrono::minutes(30);
 
 static constexpr std::chrono::steady_clock::duration REQUEST_EXPIRY = std::chrono::minutes(5);
 
+/**
+ * Traffic responses contain only changes since the previous
+ * response; this is the interval for sending all traffic, to recover
+ * from lost datagrams.
+ */
+static constexpr std::chrono::steady_clock::duration TRAFFIC_KEYFRAME_INTERVAL = std::chrono::minutes(1);
+
+static constexpr unsigned MAX_TRAFFIC_RESPONSE = 64;
+
 using std::cout;
 using std::cerr;
 using std::endl;
@@ -45,6 +56,8 @@ class CloudServer final
 
   CoarseTimerEvent save_timer, expire_timer;
 
+  CloudTrafficSnapshots traffic_snapshots;
+
 public:
   CloudServer(AllocatedPath &&_db_path, EventLoop &event_loop,
               SocketAddress bind_address)
@@ -79,8 +92,11 @@ private:
   }
 
   void OnExpireTimer() noexcept {
-    clients.Expire(GetEventLoop().SteadyNow() - std::chrono::minutes(10));
-    if (!clients.empty())
+    const auto now = GetEventLoop().SteadyNow();
+    clients.Expire(now - std::chrono::minutes(10));
+    thermals.Expire(now);
+    traffic_snapshots.Expire(now - std::chrono::minutes(1));
+    if (!clients.empty() || !thermals.empty())
       ScheduleExpire();
   }
 
@@ -207,28 +223,51 @@ CloudServer::OnTrafficRequest(const Client &c, bool near)
 
   client->wants_traffic = now + REQUEST_EXPIRY;
 
-  const auto min_stamp = now - MAX_TRAFFIC_AGE;
+  const uint64_t tile = CloudGrid::TileKey(client->location);
+  const auto &snapshot =
+    traffic_snapshots.Get(tile, clients, TRAFFIC_RANGE,
+                          now - MAX_TRAFFIC_AGE, now);
+
+  /* send only what has changed since the previous response, unless
+     it's time for a complete one */
+  auto since = client->traffic_sent;
+  if (tile != client->traffic_tile ||
+      now >= client->traffic_keyframe + TRAFFIC_KEYFRAME_INTERVAL) {
+    since = std::chrono::steady_clock::time_point::min();
+    client->traffic_tile = tile;
+    client->traffic_keyframe = now;
+  }
+
+  client->traffic_sent = snapshot.time;
 
   TrafficResponseSender s(*this, c.address, c.key);
 
-  unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  /* the snapshot is shared by the whole tile; select the traffic
+     near this client */
+  const auto nearest = snapshot.FindNearest(c.key, client->location,
+                                            TRAFFIC_RANGE,
+                                            MAX_TRAFFIC_RESPONSE);
 
-    if (traffic->stamp < min_stamp)
-      /* don't send stale traffic, it's probably not there anymore */
-      continue;
+  std::vector<uint64_t> sent_keys;
+  sent_keys.reserve(nearest.size());
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
+  for (const auto *i : nearest) {
+    sent_keys.push_back(i->client_key);
+
+    if (i->stamp <= since &&
+        std::binary_search(client->traffic_sent_keys.begin(),
+                           client->traffic_sent_keys.end(),
+                           i->client_key))
+      /* the client has received this already */
+      continue;
 
-    if (++n > 64)
-      break;
+    s.Add(i->traffic);
   }
 
   s.Flush();
+
+  std::sort(sent_keys.begin(), sent_keys.end());
+  client->traffic_sent_keys = std::move(sent_keys);
 }
 
 void
@@ -280,14 +319,16 @@ CloudServer::OnThermalSubmit(const Client &c,
        << lift << "m/s"
        << endl;
 
+  const auto now = std::chrono::steady_clock::now();
+
   const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+    thermals.Submit(c.key,
+                    AGeoPoint(bottom_location, bottom_altitude),
+                    AGeoPoint(top_location, top_altitude),
+                    lift, now);
 
-  /* send this new thermal to all interested clients immediately */
-  const auto now = std::chrono::steady_clock::now();
+  /* send the updated hotspot to all interested clients
+     immediately */
   for (const auto &i : clients.QueryWithinRange(bottom_location,
                                                 THERMAL_RANGE)) {
     if (i->key == c.key)
@@ -318,26 +359,15 @@ CloudServer::OnThermalRequest(const Client &c)
 
   client->wants_thermals = now + REQUEST_EXPIRY;
 
-  const auto min_time = now - MAX_THERMAL_AGE;
-
   ThermalResponseSender s(*this, c.address, c.key);
 
-  unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
+  for (const auto &i : thermals.GetResponse(client->location, now)) {
+    if (i.client_key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
       continue;
 
-    if (thermal->time < min_time)
-      /* don't send old thermals, they're useless */
-      continue;
-
-    s.Add(thermal->Pack());
-
-    if (++n > 256)
-      break;
+    s.Add(i.thermal);
   }
 
   s.Flush();
@@ -6,19 +6,26 @@
 #include "Geo/GeoPoint.hpp"
 #include "util/CRC16CCITT.hpp"
 
-void
-TrafficResponseSender::Add(uint32_t pilot_id, uint32_t time,
-                           GeoPoint location, int altitude)
+SkyLinesTracking::TrafficResponsePacket::Traffic
+TrafficResponseSender::MakeTraffic(uint32_t pilot_id, uint32_t time,
+                                   GeoPoint location, int altitude) noexcept
 {
-  assert(n_traffic < MAX_TRAFFIC);
-
-  auto &traffic = data.traffic[n_traffic++];
+  SkyLinesTracking::TrafficResponsePacket::Traffic traffic;
   traffic.pilot_id = ToBE32(pilot_id);
   traffic.time = ToBE32(time);
   traffic.location = SkyLinesTracking::ExportGeoPoint(location);
   traffic.altitude = ToBE16(altitude);
   traffic.reserved = 0;
   traffic.reserved2 = 0;
+  return traffic;
+}
+
+void
+TrafficResponseSender::Add(const SkyLinesTracking::TrafficResponsePacket::Traffic &traffic)
+{
+  assert(n_traffic < MAX_TRAFFIC);
+
+  data.traffic[n_traffic++] = traffic;
 
   if (n_traffic == MAX_TRAFFIC)
     Flush();
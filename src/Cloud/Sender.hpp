@@ -7,11 +7,10 @@
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "util/ByteOrder.hxx"
 #include "net/StaticSocketAddress.hxx"
+#include "Geo/GeoPoint.hpp"
 
 #include <array>
 
-struct GeoPoint;
-
 class TrafficResponseSender {
   SkyLinesTracking::Server &server;
   const SocketAddress address;
@@ -40,8 +39,18 @@ public:
     data.header.reserved3 = 0;
   }
 
+  [[gnu::pure]]
+  static SkyLinesTracking::TrafficResponsePacket::Traffic
+  MakeTraffic(uint32_t pilot_id, uint32_t time,
+              GeoPoint location, int altitude) noexcept;
+
+  void Add(const SkyLinesTracking::TrafficResponsePacket::Traffic &traffic);
+
   void Add(uint32_t pilot_id, uint32_t time,
-           GeoPoint location, int altitude);
+           GeoPoint location, int altitude) {
+    Add(MakeTraffic(pilot_id, time, location, altitude));
+  }
+
   void Flush();
 };
 
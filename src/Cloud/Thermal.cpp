@@ -3,73 +3,208 @@
 
 #include "Thermal.hpp"
 #include "Serialiser.hpp"
-#include "Geo/Boost/RangeBox.hpp"
-#include "Tracking/SkyLines/Protocol.hpp"
+#include "Grid.hpp"
 #include "Tracking/SkyLines/Assemble.hpp"
 #include "Tracking/SkyLines/Import.hpp"
 
-#include <boost/geometry/algorithms/distance.hpp>
-#include <boost/geometry/algorithms/intersection.hpp>
-#include <boost/geometry/strategies/strategies.hpp>
+#include <algorithm>
+#include <cmath>
 
-CloudThermalContainer::CloudThermalContainer()
+using namespace CloudGrid;
+
+/**
+ * The number of buckets per tile in each direction.
+ */
+static constexpr int TILE_SIZE = 50;
+
+[[gnu::const]]
+static uint64_t
+BucketKey(GeoPoint location) noexcept
+{
+  const int row = (int)std::floor(location.latitude.Degrees() * TILE_SIZE /
+                                  TILE_HEIGHT);
+  const double bucket_width =
+    TileWidth(FloorDiv(row, TILE_SIZE)) / TILE_SIZE;
+  const int column =
+    (int)std::floor(location.longitude.Degrees() / bucket_width);
+  return MakeKey(row, column);
+}
+
+[[gnu::const]]
+static uint64_t
+BucketToTile(uint64_t bucket) noexcept
 {
+  return MakeKey(FloorDiv(KeyRow(bucket), TILE_SIZE),
+                 FloorDiv(KeyColumn(bucket), TILE_SIZE));
 }
 
-CloudThermalContainer::~CloudThermalContainer()
+[[gnu::const]]
+static double
+Decay(CloudThermal::clock_type::duration d) noexcept
 {
-  clear();
+  using FloatDuration = std::chrono::duration<double>;
+  return std::exp2(-FloatDuration(d).count() /
+                   FloatDuration(CloudThermal::HALF_LIFE).count());
+}
+
+double
+CloudThermal::GetWeight(clock_type::time_point now) const noexcept
+{
+  return now > time
+    ? weight * Decay(now - time)
+    : weight;
 }
 
 void
-CloudThermalContainer::clear()
+CloudThermal::Merge(uint64_t _client_key, clock_type::time_point now,
+                    double _weight,
+                    const AGeoPoint &_bottom_location,
+                    const AGeoPoint &_top_location,
+                    double _lift) noexcept
+{
+  double old_weight = weight;
+  if (now > time) {
+    old_weight *= Decay(now - time);
+    time = now;
+  } else
+    /* the new submission is older (may happen while loading) */
+    _weight *= Decay(time - now);
+
+  weight = old_weight + _weight;
+
+  /* the portion of the new submission */
+  const double t = _weight / weight;
+
+  bottom_location = AGeoPoint(bottom_location.Interpolate(_bottom_location, t),
+                              bottom_location.altitude +
+                              t * (_bottom_location.altitude - bottom_location.altitude));
+  top_location = AGeoPoint(top_location.Interpolate(_top_location, t),
+                           top_location.altitude +
+                           t * (_top_location.altitude - top_location.altitude));
+  lift += t * (_lift - lift);
+
+  if (_client_key != client_key)
+    client_key = 0;
+}
+
+CloudThermalContainer::CloudThermalContainer() noexcept = default;
+CloudThermalContainer::~CloudThermalContainer() noexcept = default;
+
+std::size_t
+CloudThermalContainer::size() const noexcept
 {
-  while (!list.empty())
-    Remove(list.back());
+  std::size_t n = 0;
+  for (const auto &[key, tile] : tiles)
+    n += tile.thermals.size();
+  return n;
 }
 
 CloudThermal &
-CloudThermalContainer::Make(uint64_t client_key,
-                            const AGeoPoint &bottom_location,
-                            const AGeoPoint &top_location,
-                            double lift)
+CloudThermalContainer::Insert(uint64_t client_key,
+                              const AGeoPoint &bottom_location,
+                              const AGeoPoint &top_location,
+                              double lift, double weight,
+                              clock_type::time_point time)
 {
-  auto thermal = std::make_shared<CloudThermal>(client_key, bottom_location,
-                                                top_location, lift);
-  Insert(*thermal);
-  return *thermal;
+  const uint64_t bucket = BucketKey(top_location);
+  const uint64_t tile_key = BucketToTile(bucket);
+  auto &thermals = tiles[tile_key].thermals;
+
+  Invalidate(tile_key);
+
+  auto i = std::find_if(thermals.begin(), thermals.end(),
+                        [bucket](const CloudThermal &t){
+                          return t.bucket == bucket;
+                        });
+  if (i != thermals.end()) {
+    i->Merge(client_key, time, weight,
+             bottom_location, top_location, lift);
+    return *i;
+  }
+
+  return thermals.emplace_back(bucket, client_key, time, weight,
+                               bottom_location, top_location, lift);
 }
 
-void
-CloudThermalContainer::Insert(CloudThermal &thermal)
+const CloudThermal &
+CloudThermalContainer::Submit(uint64_t client_key,
+                              const AGeoPoint &bottom_location,
+                              const AGeoPoint &top_location,
+                              double lift,
+                              clock_type::time_point now)
 {
-  list.push_front(thermal);
-  rtree.insert(thermal.shared_from_this());
+  return Insert(client_key, bottom_location, top_location, lift, 1, now);
 }
 
 void
-CloudThermalContainer::Remove(CloudThermal &thermal)
+CloudThermalContainer::Invalidate(uint64_t tile_key) noexcept
 {
-  list.erase(list.iterator_to(thermal));
-  rtree.remove(thermal.shared_from_this());
+  ForEachReverseNeighbour(tile_key, [this](uint64_t key){
+    if (auto i = tiles.find(key); i != tiles.end())
+      i->second.response_valid = false;
+  });
 }
 
 void
-CloudThermalContainer::Expire(std::chrono::steady_clock::time_point before)
+CloudThermalContainer::Expire(clock_type::time_point now) noexcept
 {
-  while (!list.empty() && list.back().time < before)
-    Remove(list.back());
+  for (auto i = tiles.begin(); i != tiles.end();) {
+    auto &thermals = i->second.thermals;
+    if (std::erase_if(thermals, [now](const CloudThermal &t){
+      return t.GetWeight(now) < CloudThermal::MIN_WEIGHT;
+    }) > 0)
+      Invalidate(i->first);
+
+    if (thermals.empty())
+      i = tiles.erase(i);
+    else
+      ++i;
+  }
 }
 
-CloudThermalContainer::query_iterator_range
-CloudThermalContainer::QueryWithinRange(GeoPoint location, double range) const
+std::span<const CloudThermalContainer::ResponseItem>
+CloudThermalContainer::GetResponse(GeoPoint location,
+                                   clock_type::time_point now)
 {
-  const auto q = boost::geometry::index::intersects(BoostRangeBox(location, range));
-  return {rtree.qbegin(q), rtree.qend()};
+  const uint64_t tile_key = TileKey(location);
+  auto &tile = tiles[tile_key];
+
+  if (tile.response_valid ||
+      (!tile.response.empty() &&
+       now < tile.response_time + MIN_RESPONSE_AGE))
+    return tile.response;
+
+  /* collect the hotspots in this tile and all neighbours */
+
+  std::vector<std::pair<double, const CloudThermal *>> candidates;
+
+  ForEachNeighbour(tile_key, [&](uint64_t key){
+    if (auto i = tiles.find(key); i != tiles.end())
+      for (const auto &thermal : i->second.thermals)
+        candidates.emplace_back(thermal.GetWeight(now), &thermal);
+  });
+
+  const std::size_t n = std::min(candidates.size(), MAX_RESPONSE);
+  std::partial_sort(candidates.begin(), std::next(candidates.begin(), n),
+                    candidates.end(),
+                    [](const auto &a, const auto &b){
+                      return a.first > b.first;
+                    });
+
+  tile.response.clear();
+  tile.response.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto &thermal = *candidates[i].second;
+    tile.response.push_back({thermal.client_key, thermal.Pack()});
+  }
+
+  tile.response_time = now;
+  tile.response_valid = true;
+  return tile.response;
 }
 
 SkyLinesTracking::Thermal
-CloudThermal::Pack() const
+CloudThermal::Pack() const noexcept
 {
   // TODO: fill "time" properly
   return SkyLinesTracking::MakeThermal(0, bottom_location,
@@ -82,32 +217,34 @@ CloudThermal::Pack() const
 void
 CloudThermal::Save(Serialiser &s) const
 {
-  s.Write8(1);
+  s.Write8(2);
   s.Write64(client_key);
   s << time;
   s.WriteT(Pack());
+  s.WriteDouble(weight);
 }
 
 CloudThermal
 CloudThermal::Load(Deserialiser &s)
 {
-  s.Read8();
-  const unsigned client_key = s.Read64();
+  const unsigned version = s.Read8();
+  const uint64_t client_key = s.Read64();
 
-  std::chrono::steady_clock::time_point time;
+  clock_type::time_point time;
   s >> time;
 
   SkyLinesTracking::Thermal t;
   s.ReadT(t);
 
-  CloudThermal thermal(client_key,
-                       AGeoPoint(SkyLinesTracking::ImportGeoPoint(t.bottom_location),
-                                 FromBE16(t.bottom_altitude)),
-                       AGeoPoint(SkyLinesTracking::ImportGeoPoint(t.top_location),
-                                 FromBE16(t.top_altitude)),
-                       FromBE16(t.lift) / 256.);
-  thermal.time = time;
-  return thermal;
+  /* version 1 did not aggregate submissions */
+  const double weight = version >= 2 ? s.ReadDouble() : 1.;
+
+  return CloudThermal(0, client_key, time, weight,
+                      AGeoPoint(SkyLinesTracking::ImportGeoPoint(t.bottom_location),
+                                FromBE16(t.bottom_altitude)),
+                      AGeoPoint(SkyLinesTracking::ImportGeoPoint(t.top_location),
+                                FromBE16(t.top_altitude)),
+                      FromBE16(t.lift) / 256.);
 }
 
 void
@@ -115,10 +252,10 @@ CloudThermalContainer::Save(Serialiser &s) const
 {
   s.Write8(1);
 
-  for (const auto &thermal : list) {
+  ForEach([&s](const CloudThermal &thermal){
     s.Write8(1);
     thermal.Save(s);
-  }
+  });
 
   s.Write8(0);
   s.Write8(0);
@@ -130,8 +267,9 @@ CloudThermalContainer::Load(Deserialiser &s)
   s.Read8();
 
   while (s.Read8() != 0) {
-    auto thermal = std::make_shared<CloudThermal>(CloudThermal::Load(s));
-    Insert(*thermal);
+    const auto t = CloudThermal::Load(s);
+    Insert(t.client_key, t.bottom_location, t.top_location, t.lift,
+           t.weight, t.time);
   }
 
   s.Read8();
@@ -3,132 +3,220 @@
 
 #pragma once
 
-#include "Geo/Boost/GeoPoint.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
 
-#include <boost/intrusive/list.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/range/iterator_range_core.hpp>
-#include <memory>
 #include <chrono>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 class Serialiser;
 class Deserialiser;
-namespace SkyLinesTracking { struct Thermal; }
 
 /**
- * A client which has submitted data to us recently.
+ * A thermal hotspot: the aggregate of all thermals which were
+ * submitted in one small grid cell recently.  Each submission has a
+ * weight of 1 which decays exponentially over time.
  */
-struct CloudThermal
-  : std::enable_shared_from_this<CloudThermal>,
-    boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
-{
-  const uint64_t client_key;
+struct CloudThermal {
+  using clock_type = std::chrono::steady_clock;
 
   /**
-   * Time when this thermal was measured or received.  (Montonic
-   * server-side clock.)
+   * Each submission's weight halves after this duration.
    */
-  std::chrono::steady_clock::time_point time;
+  static constexpr clock_type::duration HALF_LIFE = std::chrono::minutes(10);
+
+  /**
+   * Hotspots with less weight are deleted.  This is 3 half-lifes,
+   * i.e. a single submission lives for 30 minutes.
+   */
+  static constexpr double MIN_WEIGHT = 0.125;
+
+  /**
+   * The key of the grid cell.
+   */
+  uint64_t bucket;
+
+  /**
+   * The client which has submitted this thermal or 0 if more than one
+   * client has contributed.
+   */
+  uint64_t client_key;
+
+  /**
+   * Time when this thermal was last submitted (or received).
+   * (Montonic server-side clock.)
+   */
+  clock_type::time_point time;
+
+  /**
+   * The (decayed) weight at #time.
+   */
+  double weight;
 
   AGeoPoint bottom_location, top_location;
 
   double lift;
 
-  CloudThermal(uint64_t _client_key,
+  CloudThermal(uint64_t _bucket, uint64_t _client_key,
+               clock_type::time_point _time, double _weight,
                const AGeoPoint &_bottom_location,
                const AGeoPoint &_top_location,
-               double _lift)
-    :client_key(_client_key),
-     time(std::chrono::steady_clock::now()),
+               double _lift) noexcept
+    :bucket(_bucket), client_key(_client_key),
+     time(_time), weight(_weight),
      bottom_location(_bottom_location), top_location(_top_location),
      lift(_lift) {}
 
   [[gnu::pure]]
-  SkyLinesTracking::Thermal Pack() const;
+  double GetWeight(clock_type::time_point now) const noexcept;
+
+  /**
+   * Merge another (set of) submissions into this hotspot.  Locations
+   * and lift are averaged according to the weight.
+   */
+  void Merge(uint64_t _client_key, clock_type::time_point now,
+             double _weight,
+             const AGeoPoint &_bottom_location,
+             const AGeoPoint &_top_location,
+             double _lift) noexcept;
+
+  [[gnu::pure]]
+  SkyLinesTracking::Thermal Pack() const noexcept;
 
   void Save(Serialiser &s) const;
   static CloudThermal Load(Deserialiser &s);
 };
 
-using CloudThermalPtr = std::shared_ptr<CloudThermal>;
-
 /**
- * Helper for boost::geometry::index::rtree.
+ * A geospatial container of #CloudThermal hotspots.
+ *
+ * The world is divided into rows of constant latitude; the longitude
+ * is scaled with the cosine of the row's latitude, so all cells have
+ * roughly the same size.  Submissions are merged into a hotspot per
+ * small cell ("bucket", about 1 km).  Buckets are grouped into tiles
+ * (about 55 km), and each tile caches the response for thermal
+ * requests from within it, which is only rebuilt after a hotspot
+ * nearby has changed.
  */
-struct CloudThermalIndexable {
-  typedef GeoPoint result_type;
-
-  [[gnu::pure]]
-  result_type operator()(const CloudThermalPtr &client) const {
-    return client->top_location;
-  }
-};
-
 class CloudThermalContainer {
-  typedef boost::geometry::index::rtree<CloudThermalPtr, boost::geometry::index::rstar<16>,
-                                        CloudThermalIndexable> Tree;
-
-  typedef boost::intrusive::list<CloudThermal,
-                                 boost::intrusive::constant_time_size<false>> List;
+public:
+  using clock_type = CloudThermal::clock_type;
 
   /**
-   * A geospatial container of all thermals, for fast geographic
-   * lookups.
+   * The maximum number of thermals in one response.
    */
-  Tree rtree;
+  static constexpr std::size_t MAX_RESPONSE = 256;
 
   /**
-   * A linked list of thermals, sorted by time, with newer items at
-   * the front.
+   * A response which has been invalidated is still used for this
+   * duration after it was built.  On a busy day, this avoids
+   * rebuilding it for each request.  New submissions are sent to
+   * interested clients immediately anyway.
    */
-  List list;
+  static constexpr clock_type::duration MIN_RESPONSE_AGE =
+    std::chrono::seconds(15);
+
+  struct ResponseItem {
+    /**
+     * Copy of CloudThermal::client_key, to allow the caller to omit a
+     * client's own submissions.
+     */
+    uint64_t client_key;
+
+    SkyLinesTracking::Thermal thermal;
+  };
+
+private:
+  struct Tile {
+    std::vector<CloudThermal> thermals;
+
+    /**
+     * The hotspots in this tile and its neighbours, ordered by
+     * decreasing weight.  Only valid if #response_valid is set.
+     */
+    std::vector<ResponseItem> response;
+
+    /**
+     * When was #response built?
+     */
+    clock_type::time_point response_time;
+
+    bool response_valid = false;
+  };
+
+  std::unordered_map<uint64_t, Tile> tiles;
 
 public:
-  CloudThermalContainer();
-  ~CloudThermalContainer();
+  CloudThermalContainer() noexcept;
+  ~CloudThermalContainer() noexcept;
 
-  void clear();
+  void clear() noexcept {
+    tiles.clear();
+  }
 
-  bool empty() const {
-    return list.empty();
+  bool empty() const noexcept {
+    return tiles.empty();
   }
 
+  [[gnu::pure]]
+  std::size_t size() const noexcept;
+
   /**
-   * For iteration over the list of all clients in unspecified order.
-   * The iterators get invalidated by all modifying calls.
+   * Invoke the given function for each #CloudThermal, in unspecified
+   * order.
    */
-  List::const_iterator begin() const {
-    return list.begin();
-  }
-
-  List::const_iterator end() const {
-    return list.end();
+  template<typename F>
+  void ForEach(F &&f) const {
+    for (const auto &[key, tile] : tiles)
+      for (const auto &thermal : tile.thermals)
+        f(thermal);
   }
 
   /**
-   * Create a new #CloudThermal, or refresh the existing one.
+   * Add a thermal submission.  It is merged into an existing hotspot
+   * nearby or creates a new one.
+   *
+   * @return the hotspot; the reference is invalidated by all
+   * modifying calls
    */
-  CloudThermal &Make(uint64_t client_key,
-                     const AGeoPoint &bottom_location,
-                     const AGeoPoint &top_location,
-                     double lift);
-
-  void Insert(CloudThermal &client);
+  const CloudThermal &Submit(uint64_t client_key,
+                             const AGeoPoint &bottom_location,
+                             const AGeoPoint &top_location,
+                             double lift,
+                             clock_type::time_point now);
 
   /**
-   * Remove a #CloudThermal and its data.  Be careful - the given reference
-   * is invalidated, unless the caller holds another #CloudThermalPtr.
+   * Delete all hotspots whose weight has decayed below
+   * CloudThermal::MIN_WEIGHT.
    */
-  void Remove(CloudThermal &client);
+  void Expire(clock_type::time_point now) noexcept;
 
-  void Expire(std::chrono::steady_clock::time_point before);
-
-  typedef Tree::const_query_iterator query_iterator;
-  typedef boost::iterator_range<query_iterator> query_iterator_range;
-
-  [[gnu::pure]]
-  query_iterator_range QueryWithinRange(GeoPoint location, double range) const;
+  /**
+   * Return the hotspots around the given location (at least one tile
+   * in each direction), strongest first.  The result is cached, so
+   * this is cheap unless something has changed nearby.
+   *
+   * The returned span is invalidated by all modifying calls.
+   */
+  std::span<const ResponseItem> GetResponse(GeoPoint location,
+                                            clock_type::time_point now);
 
   void Save(Serialiser &s) const;
   void Load(Deserialiser &s);
+
+private:
+  CloudThermal &Insert(uint64_t client_key,
+                       const AGeoPoint &bottom_location,
+                       const AGeoPoint &top_location,
+                       double lift, double weight,
+                       clock_type::time_point time);
+
+  /**
+   * Clear the response cache of all tiles whose response may include
+   * hotspots of the given tile.
+   */
+  void Invalidate(uint64_t tile_key) noexcept;
 };
@@ -101,9 +101,10 @@ ToKML(BufferedOutputStream &os, const CloudThermalContainer &thermals)
 
   const auto min_time = std::chrono::steady_clock::now() - MAX_THERMAL_AGE;
 
-  for (const auto &thermal : thermals)
+  thermals.ForEach([&os, min_time](const CloudThermal &thermal){
     if (thermal.time >= min_time)
       ToKML(os, thermal);
+  });
 
   os.Write("    </Folder>\n");
   os.Write("  </Document>\n"
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TrafficSnapshot.hpp"
+#include "Client.hpp"
+#include "Grid.hpp"
+#include "Sender.hpp"
+
+#include <boost/geometry/index/predicates.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+
+const CloudTrafficSnapshot &
+CloudTrafficSnapshots::Get(uint64_t tile_key,
+                           const CloudClientContainer &clients,
+                           double range,
+                           clock_type::time_point min_stamp,
+                           clock_type::time_point now)
+{
+  auto &snapshot = snapshots[tile_key];
+  if (now < snapshot.time + TICK)
+    return snapshot;
+
+  const GeoPoint center = CloudGrid::TileCenter(tile_key);
+
+  /* the clients may be anywhere in the tile; extend the range by
+     the distance from the center to a corner */
+  const int row = CloudGrid::KeyRow(tile_key);
+  const GeoPoint corner{
+    Angle::Degrees(CloudGrid::KeyColumn(tile_key) * CloudGrid::TileWidth(row)),
+    Angle::Degrees(row * CloudGrid::TILE_HEIGHT),
+  };
+  range += center.DistanceS(corner);
+
+  snapshot.time = now;
+  snapshot.items.clear();
+  for (const auto &client : clients.QueryWithinRange(center, range))
+    if (client->stamp >= min_stamp)
+      snapshot.items.push_back({
+          client->key, client->stamp, client->location,
+          TrafficResponseSender::MakeTraffic(client->id, 0, //TODO: time?
+                                             client->location,
+                                             client->altitude),
+        });
+
+  snapshot.Index(center);
+  return snapshot;
+}
+
+static CloudTrafficSnapshot::FlatPoint
+ToFlatPoint(GeoPoint location, double longitude_scale) noexcept
+{
+  return {
+    location.longitude.Radians() * longitude_scale,
+    location.latitude.Radians(),
+  };
+}
+
+void
+CloudTrafficSnapshot::Index(GeoPoint center) noexcept
+{
+  longitude_scale = center.latitude.cos();
+
+  std::vector<Tree::value_type> values;
+  values.reserve(items.size());
+  for (std::size_t i = 0; i < items.size(); ++i)
+    values.emplace_back(ToFlatPoint(items[i].location, longitude_scale),
+                        i);
+
+  /* the range constructor uses the packing algorithm, which is much
+     faster than inserting one value at a time */
+  tree = Tree(values);
+}
+
+std::vector<const CloudTrafficSnapshot::Item *>
+CloudTrafficSnapshot::FindNearest(uint64_t client_key,
+                                  GeoPoint location, double range,
+                                  std::size_t max_items) const noexcept
+{
+  /* one more, because the client itself is probably among the
+     nearest */
+  const auto q =
+    boost::geometry::index::nearest(ToFlatPoint(location, longitude_scale),
+                                    max_items + 1);
+
+  std::vector<const Item *> result;
+  result.reserve(max_items);
+
+  /* the query iterator returns the values ordered by distance */
+  for (auto i = tree.qbegin(q), end = tree.qend();
+       i != end && result.size() < max_items; ++i) {
+    const Item &item = items[i->second];
+    if (item.client_key != client_key &&
+        location.DistanceS(item.location) <= range)
+      result.push_back(&item);
+  }
+
+  return result;
+}
+
+void
+CloudTrafficSnapshots::Expire(clock_type::time_point before) noexcept
+{
+  std::erase_if(snapshots, [before](const auto &i){
+    return i.second.time < before;
+  });
+}
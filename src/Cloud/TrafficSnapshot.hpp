@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Geo/GeoPoint.hpp"
+
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class CloudClientContainer;
+
+/**
+ * The traffic in one region (a tile of the #CloudGrid and its
+ * neighbours), packed for #TrafficResponsePacket.  It is shared by
+ * all clients in that region and rebuilt at most once per tick.  It
+ * is a superset of what each client may receive; use FindNearest()
+ * to select the traffic for one client.
+ */
+struct CloudTrafficSnapshot {
+  using clock_type = std::chrono::steady_clock;
+
+  /**
+   * A location projected to a plane tangent at the tile center
+   * (radians).  Within the few hundred kilometers a snapshot
+   * covers, distances in this plane order the traffic like real
+   * distances do.
+   */
+  using FlatPoint =
+    boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian>;
+
+  /**
+   * Maps the #FlatPoint of each item to its position in #items.
+   */
+  using Tree = boost::geometry::index::rtree<std::pair<FlatPoint, uint32_t>,
+                                             boost::geometry::index::rstar<16>>;
+
+  struct Item {
+    /**
+     * Copy of CloudClient::key, to allow the caller to omit a
+     * client's own location.
+     */
+    uint64_t client_key;
+
+    /**
+     * Copy of CloudClient::stamp, to allow the caller to omit
+     * traffic which the client has received already.
+     */
+    clock_type::time_point stamp;
+
+    /**
+     * Copy of CloudClient::location, to select the traffic near
+     * one client.
+     */
+    GeoPoint location;
+
+    SkyLinesTracking::TrafficResponsePacket::Traffic traffic;
+  };
+
+  /**
+   * When was this snapshot built?
+   */
+  clock_type::time_point time;
+
+  /**
+   * All traffic within range of any point in the tile, in no
+   * particular order.
+   */
+  std::vector<Item> items;
+
+  /**
+   * A geospatial index of #items; see Index().
+   */
+  Tree tree;
+
+  /**
+   * The cosine of the tile center's latitude, which scales
+   * longitudes in #FlatPoint.
+   */
+  double longitude_scale;
+
+  /**
+   * Build #tree after #items has been filled.
+   *
+   * @param center the center of the region
+   */
+  void Index(GeoPoint center) noexcept;
+
+  /**
+   * Return the items within the given range of the given location
+   * (excluding the client with the given key), ordered by distance,
+   * at most #max_items.  The cost depends on #max_items, not on the
+   * number of items.
+   */
+  std::vector<const Item *> FindNearest(uint64_t client_key,
+                                        GeoPoint location, double range,
+                                        std::size_t max_items) const noexcept;
+};
+
+class CloudTrafficSnapshots {
+public:
+  using clock_type = CloudTrafficSnapshot::clock_type;
+
+  /**
+   * A snapshot is rebuilt if it is older than this.
+   */
+  static constexpr clock_type::duration TICK = std::chrono::seconds(1);
+
+private:
+  std::unordered_map<uint64_t, CloudTrafficSnapshot> snapshots;
+
+public:
+  /**
+   * Return the snapshot for the tile containing the given location,
+   * rebuilding it if it is older than #TICK.
+   *
+   * The returned reference is invalidated by all modifying calls.
+   *
+   * @param range the maximum distance of traffic from a client; the
+   * snapshot contains all traffic within this range of any point in
+   * the tile
+   * @param min_stamp omit traffic older than this
+   */
+  const CloudTrafficSnapshot &Get(uint64_t tile_key,
+                                  const CloudClientContainer &clients,
+                                  double range,
+                                  clock_type::time_point min_stamp,
+                                  clock_type::time_point now);
+
+  /**
+   * Delete all snapshots which have not been rebuilt (i.e. used)
+   * since the given time.
+   */
+  void Expire(clock_type::time_point before) noexcept;
+};
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Accumulates the time the #GlideComputer spends in each of its
+ * sub-computers.  This is meant for benchmarks; by default, the
+ * #GlideComputer has no profile, and the overhead is one pointer
+ * check per section.
+ */
+class ComputerProfile {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  enum class Section : uint8_t {
+    AIR_DATA,
+
+    /**
+     * Trace, task manager and auto task.
+     */
+    TASK,
+
+    /**
+     * Route planner and reach.
+     */
+    ROUTE,
+
+    /**
+     * Contest solvers and the idle update of the task manager.
+     */
+    CONTEST,
+
+    WARNINGS,
+    STATS,
+    CU,
+    CONDITION_MONITORS,
+    LOG,
+
+    /**
+     * Everything else: team code, working band, trace history,
+     * retrospective, ...
+     */
+    MISC,
+
+    COUNT
+  };
+
+  static constexpr std::size_t N_SECTIONS = std::size_t(Section::COUNT);
+
+  struct Counter {
+    clock_type::duration duration{};
+    unsigned n = 0;
+  };
+
+  std::array<Counter, N_SECTIONS> counters;
+
+  static constexpr const char *GetName(Section section) noexcept {
+    switch (section) {
+    case Section::AIR_DATA: return "air data";
+    case Section::TASK: return "task";
+    case Section::ROUTE: return "route";
+    case Section::CONTEST: return "contest";
+    case Section::WARNINGS: return "warnings";
+    case Section::STATS: return "stats";
+    case Section::CU: return "cu";
+    case Section::CONDITION_MONITORS: return "condition monitors";
+    case Section::LOG: return "log";
+    case Section::MISC: return "misc";
+    case Section::COUNT: break;
+    }
+
+    return nullptr;
+  }
+
+  void Add(Section section, clock_type::duration duration) noexcept {
+    auto &c = counters[std::size_t(section)];
+    c.duration += duration;
+    ++c.n;
+  }
+
+  /**
+   * Measures the lifetime of this object and adds it to the given
+   * section.  Does nothing if the #ComputerProfile pointer is
+   * nullptr.
+   */
+  class Scope {
+    ComputerProfile *const profile;
+    const Section section;
+    clock_type::time_point start;
+
+  public:
+    Scope(ComputerProfile *_profile, Section _section) noexcept
+      :profile(_profile), section(_section) {
+      if (profile != nullptr)
+        start = clock_type::now();
+    }
+
+    ~Scope() noexcept {
+      if (profile != nullptr)
+        profile->Add(section, clock_type::now() - start);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+  };
+};
@@ -3,6 +3,7 @@
 
 #include "ContestComputer.hpp"
 #include "Engine/Contest/Settings.hpp"
+#include "thread/Parallel.hpp"
 
 ContestComputer::ContestComputer(const Trace &trace_full,
                                  const Trace &trace_triangle,
@@ -10,6 +11,9 @@ ContestComputer::ContestComputer(const Trace &trace_full,
   :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
 {
   contest_manager.SetIncremental(true);
+
+  /* exhaustive solving may use all processors */
+  contest_manager.SetThreads(GetProcessorCount());
 }
 
 void
@@ -19,6 +19,7 @@ GlideComputer::GlideComputer(const ComputerSettings &_settings,
   :air_data_computer(_way_points),
    warning_computer(_settings.airspace.warnings, _airspace_database),
    task_computer(task, _airspace_database, &warning_computer.GetManager()),
+   reachability_computer(_way_points),
    idle_condition_monitors(warning_computer.GetManager()),
    waypoints(_way_points),
    retrospective(_way_points),
@@ -41,6 +42,7 @@ GlideComputer::ResetFlight(const bool full)
 
   cu_computer.Reset();
   warning_computer.Reset();
+  reachability_computer.Reset();
 
   trace_history_time.Reset();
 }
@@ -77,63 +79,102 @@ GlideComputer::ProcessGPS(bool force)
 
   calculated.Expire(basic.clock);
 
+  using Section = ComputerProfile::Section;
+
   // Process basic information
-  air_data_computer.ProcessBasic(Basic(), SetCalculated(),
-                                 settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::AIR_DATA);
+    air_data_computer.ProcessBasic(Basic(), SetCalculated(),
+                                   settings);
+  }
 
   // Process basic task information
   const bool last_finished = calculated.ordered_task_stats.task_finished;
 
-  task_computer.ProcessBasicTask(basic,
-                                 calculated,
-                                 settings,
-                                 force);
+  {
+    const ComputerProfile::Scope scope(profile, Section::TASK);
+    task_computer.ProcessBasicTask(basic,
+                                   calculated,
+                                   settings,
+                                   force);
+  }
 
-  CalculateWorkingBand();
+  {
+    const ComputerProfile::Scope scope(profile, Section::MISC);
+    CalculateWorkingBand();
+  }
 
-  task_computer.ProcessMoreTask(basic, calculated, settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::ROUTE);
+    task_computer.ProcessMoreTask(basic, calculated, settings);
+    reachability_computer.Compute(basic, calculated, settings.task,
+                                  settings.polar.glide_polar_task,
+                                  GetProtectedRoutePlanner());
+  }
 
   if (!last_finished && calculated.ordered_task_stats.task_finished)
     OnFinishTask();
 
   // Check if everything is okay with the gps time and process it
-  air_data_computer.FlightTimes(Basic(), SetCalculated(),
-                                settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::AIR_DATA);
+    air_data_computer.FlightTimes(Basic(), SetCalculated(),
+                                  settings);
+  }
 
   TakeoffLanding(last_flying);
 
-  task_computer.ProcessAutoTask(basic, calculated);
+  {
+    const ComputerProfile::Scope scope(profile, Section::TASK);
+    task_computer.ProcessAutoTask(basic, calculated);
+  }
 
   // Process extended information
-  air_data_computer.ProcessVertical(Basic(),
-                                    SetCalculated(),
-                                    settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::AIR_DATA);
+    air_data_computer.ProcessVertical(Basic(),
+                                      SetCalculated(),
+                                      settings);
+  }
 
-  stats_computer.ProcessClimbEvents(calculated);
+  {
+    const ComputerProfile::Scope scope(profile, Section::STATS);
+    stats_computer.ProcessClimbEvents(calculated);
+  }
 
-  cu_computer.Compute(basic, calculated, settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::CU);
+    cu_computer.Compute(basic, calculated, settings);
+  }
 
-  // Calculate the team code
-  CalculateOwnTeamCode();
+  {
+    const ComputerProfile::Scope scope(profile, Section::MISC);
 
-  // Calculate the bearing and range of the teammate
-  CalculateTeammateBearingRange();
+    // Calculate the team code
+    CalculateOwnTeamCode();
 
-  // update basic trace history
-  if (basic.time_available) {
-    const auto dt = trace_history_time.Update(basic.time,
-                                              milliseconds{500}, seconds{30});
-    if (dt.count() > 0)
-      calculated.trace_history.append(basic);
-    else if (dt.count() < 0)
-      /* time warp */
-      calculated.trace_history.clear();
-  }
+    // Calculate the bearing and range of the teammate
+    CalculateTeammateBearingRange();
 
-  CalculateVarioScale();
+    // update basic trace history
+    if (basic.time_available) {
+      const auto dt = trace_history_time.Update(basic.time,
+                                                milliseconds{500}, seconds{30});
+      if (dt.count() > 0)
+        calculated.trace_history.append(basic);
+      else if (dt.count() < 0)
+        /* time warp */
+        calculated.trace_history.clear();
+    }
+
+    CalculateVarioScale();
+  }
 
   // Update the ConditionMonitors
-  condition_monitors.Update(Basic(), Calculated(), settings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::CONDITION_MONITORS);
+    condition_monitors.Update(Basic(), Calculated(), settings);
+  }
 
   CalculateFuelBurnTimeRemain(calculated);
 
@@ -159,22 +200,42 @@ GlideComputer::ProcessIdle(bool exhaustive)
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
 
+  using Section = ComputerProfile::Section;
+
   // Log GPS fixes for internal usage
   // (snail trail, stats, contest, ...)
-  stats_computer.DoLogging(basic, calculated);
-  log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  {
+    const ComputerProfile::Scope scope(profile, Section::STATS);
+    stats_computer.DoLogging(basic, calculated);
+  }
 
-  task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
-                            exhaustive);
+  {
+    const ComputerProfile::Scope scope(profile, Section::LOG);
+    log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  }
 
-  warning_computer.Update(GetComputerSettings(), basic,
-                          calculated, calculated.airspace_warnings);
+  {
+    const ComputerProfile::Scope scope(profile, Section::CONTEST);
+    task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
+                              exhaustive);
+  }
 
-  idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
+  {
+    const ComputerProfile::Scope scope(profile, Section::WARNINGS);
+    warning_computer.Update(GetComputerSettings(), basic,
+                            calculated, calculated.airspace_warnings);
+  }
+
+  {
+    const ComputerProfile::Scope scope(profile, Section::CONDITION_MONITORS);
+    idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
+  }
 
   // Calculate summary of flight
-  if (basic.location_available)
+  if (basic.location_available) {
+    const ComputerProfile::Scope scope(profile, Section::MISC);
     retrospective.UpdateSample(basic.location);
+  }
 }
 
 bool
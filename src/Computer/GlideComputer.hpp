@@ -12,9 +12,11 @@
 #include "LogComputer.hpp"
 #include "WarningComputer.hpp"
 #include "CuComputer.hpp"
+#include "ReachabilityComputer.hpp"
 #include "Engine/Contest/Solvers/Retrospective.hpp"
 #include "ConditionMonitor/ConditionMonitors.hpp"
 #include "ConditionMonitor/MoreConditionMonitors.hpp"
+#include "ComputerProfile.hpp"
 
 class Waypoints;
 class ProtectedTaskManager;
@@ -33,6 +35,7 @@ class GlideComputer : public GlideComputerBlackboard
   StatsComputer stats_computer;
   LogComputer log_computer;
   CuComputer cu_computer;
+  ReachabilityComputer reachability_computer;
 
   ConditionMonitors condition_monitors;
   MoreConditionMonitors idle_condition_monitors;
@@ -46,6 +49,11 @@ class GlideComputer : public GlideComputerBlackboard
 
   PeriodClock idle_clock;
 
+  /**
+   * If set, the time spent in each sub-computer is accounted here.
+   */
+  ComputerProfile *profile = nullptr;
+
   /**
    * This object is used to check whether to update
    * DerivedInfo::trace_history.
@@ -65,6 +73,10 @@ public:
     log_computer.SetLogger(logger);
   }
 
+  void SetProfile(ComputerProfile *_profile) noexcept {
+    profile = _profile;
+  }
+
   /**
    * Resets the GlideComputer data
    * @param full Reset all data?
@@ -129,6 +141,10 @@ public:
     return task_computer.GetProtectedRoutePlanner();
   }
 
+  const ProtectedWaypointReachTable &GetWaypointReach() const {
+    return reachability_computer.GetTable();
+  }
+
   void ClearAirspaces() {
     task_computer.ClearAirspaces();
   }
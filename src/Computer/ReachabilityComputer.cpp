@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ReachabilityComputer.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/GlideSolvers/GlideState.hpp"
+#include "Engine/GlideSolvers/GlideResult.hpp"
+#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Task/ProtectedRoutePlanner.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void
+ReachabilityComputer::Reset() noexcept
+{
+  candidates.clear();
+  candidate_center = GeoPoint::Invalid();
+  last_valid = false;
+
+  next.clear();
+  Publish();
+}
+
+void
+ReachabilityComputer::Publish() noexcept
+{
+  ProtectedWaypointReachTable::ExclusiveLease lease(table);
+  WaypointReachTable &t = lease;
+  t.list.swap(next);
+}
+
+static int
+Quantise(double value, double step) noexcept
+{
+  return (int)std::lround(value / step);
+}
+
+/**
+ * Calculate an upper bound for the distance [m] which can be glided
+ * from the given height.
+ */
+[[gnu::pure]]
+static double
+GetMaximumRange(const GlidePolar &glide_polar, double height,
+                const SpeedVector &wind) noexcept
+{
+  if (height <= 0)
+    return 0;
+
+  /* the best glide ratio over ground is achieved somewhere between
+     minimum sink and best L/D speed */
+  return height * (glide_polar.GetVBestLD() + wind.norm)
+    / glide_polar.GetSMin();
+}
+
+void
+ReachabilityComputer::UpdateCandidates(const GeoPoint &location,
+                                       const double range) noexcept
+{
+  if (waypoints_serial != waypoints.GetSerial()) {
+    waypoints_serial = waypoints.GetSerial();
+
+    watched.clear();
+    for (const auto &w : waypoints)
+      if (w->flags.watched)
+        watched.push_back(w);
+  }
+
+  candidates.clear();
+  candidate_center = location;
+  candidate_radius = range + CANDIDATE_MARGIN;
+
+  waypoints.VisitWithinRange(location, candidate_radius,
+                             [this](const WaypointPtr &w){
+                               if (w->IsLandable() && !w->flags.watched)
+                                 candidates.push_back(w);
+                             });
+
+  candidates.insert(candidates.end(), watched.begin(), watched.end());
+}
+
+static WaypointReachability
+CalculateDirect(WaypointReach &r, const Waypoint &waypoint,
+                const MoreData &basic, const SpeedVector &wind,
+                const MacCready &mac_cready, double safety_height) noexcept
+{
+  const auto elevation = waypoint.elevation + safety_height;
+  const GlideState state(GeoVector(basic.location, waypoint.location),
+                         elevation, basic.nav_altitude, wind);
+
+  const GlideResult result = mac_cready.SolveStraight(state);
+  if (!result.IsOk())
+    return WaypointReachability::INVALID;
+
+  r.reach.direct = result.pure_glide_altitude_difference;
+  return result.pure_glide_altitude_difference > 0
+    ? WaypointReachability::TERRAIN
+    : WaypointReachability::UNREACHABLE;
+}
+
+static WaypointReachability
+CalculateRoute(WaypointReach &r, const Waypoint &waypoint,
+               const ProtectedRoutePlanner &route_planner,
+               double safety_height, bool reach_enabled) noexcept
+{
+  const double elevation = waypoint.elevation + safety_height;
+  const AGeoPoint destination(waypoint.location, elevation);
+
+  auto reach = route_planner.FindPositiveArrival(destination);
+  if (!reach)
+    return WaypointReachability::INVALID;
+
+  r.reach = *reach;
+  r.reach.Subtract(elevation);
+
+  if (!r.reach.IsReachableDirect())
+    return WaypointReachability::UNREACHABLE;
+  else if (reach_enabled && !r.reach.IsReachableTerrain())
+    return WaypointReachability::STRAIGHT;
+  else
+    return WaypointReachability::TERRAIN;
+}
+
+void
+ReachabilityComputer::Compute(const MoreData &basic,
+                              const DerivedInfo &calculated,
+                              const TaskBehaviour &task_behaviour,
+                              const GlidePolar &glide_polar_task,
+                              const ProtectedRoutePlanner &route_planner) noexcept
+{
+  const GlidePolar &glide_polar =
+    task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
+    ? glide_polar_task
+    : calculated.glide_polar_safety;
+
+  if (!basic.location_available || !basic.NavAltitudeAvailable() ||
+      !glide_polar.IsValid()) {
+    if (last_valid) {
+      next.clear();
+      Publish();
+      last_valid = false;
+    }
+
+    return;
+  }
+
+  const SpeedVector wind = calculated.GetWindOrZero();
+  const double safety_height = task_behaviour.safety_height_arrival;
+  const bool reach_enabled = task_behaviour.route_planner.IsReachEnabled();
+
+  const Key key{
+    Quantise(basic.location.latitude.Degrees(), LOCATION_STEP),
+    Quantise(basic.location.longitude.Degrees(), LOCATION_STEP),
+    Quantise(basic.nav_altitude, ALTITUDE_STEP),
+    wind.norm, wind.bearing.Native(),
+    glide_polar.GetMC(), glide_polar.GetBugs(), glide_polar.GetBallast(),
+    safety_height,
+    waypoints.GetSerial(), route_planner.GetReachSerial(),
+    !route_planner.IsTerrainReachEmpty(), reach_enabled,
+  };
+
+  if (last_valid && key == last_key)
+    /* nothing has changed */
+    return;
+
+  last_key = key;
+  last_valid = true;
+
+  const GeoPoint &location = basic.location;
+  const double altitude = basic.nav_altitude;
+
+  /* the candidates are collected with the height above sea level,
+     which bounds the range to all waypoints which are not below sea
+     level */
+  const double range = GetMaximumRange(glide_polar, altitude, wind);
+
+  if (!candidate_center.IsValid() ||
+      waypoints_serial != waypoints.GetSerial() ||
+      candidate_center.DistanceS(location) + range > candidate_radius)
+    UpdateCandidates(location, range);
+
+  /* find the candidates within glide range of the height above each
+     one's arrival altitude; if there are too many, keep only the
+     nearest ones */
+
+  in_range.clear();
+  out_of_range.clear();
+  for (unsigned i = 0; i < candidates.size(); ++i) {
+    const Waypoint &waypoint = *candidates[i];
+    if (!waypoint.has_elevation)
+      continue;
+
+    const double height = altitude - (waypoint.elevation + safety_height);
+    const double distance = location.DistanceS(waypoint.location);
+    if (distance <= GetMaximumRange(glide_polar, height, wind))
+      in_range.emplace_back(distance, i);
+    else
+      out_of_range.emplace_back(distance, i);
+  }
+
+  if (in_range.size() > WaypointReachTable::MAX_SIZE) {
+    const auto middle = std::next(in_range.begin(),
+                                  WaypointReachTable::MAX_SIZE);
+    std::nth_element(in_range.begin(), middle, in_range.end());
+    in_range.erase(middle, in_range.end());
+  }
+
+  /* the remaining entries are for the waypoints out of range, watched
+     ones first, then the nearest ones */
+  const std::size_t n_out_of_range =
+    std::min(out_of_range.size(),
+             WaypointReachTable::MAX_SIZE - in_range.size());
+  if (n_out_of_range < out_of_range.size()) {
+    const auto middle = std::next(out_of_range.begin(), n_out_of_range);
+    std::nth_element(out_of_range.begin(), middle, out_of_range.end(),
+                     [this](const auto &a, const auto &b){
+                       const bool a_watched = candidates[a.second]->flags.watched;
+                       const bool b_watched = candidates[b.second]->flags.watched;
+                       return a_watched != b_watched
+                         ? a_watched
+                         : a.first < b.first;
+                     });
+    out_of_range.erase(middle, out_of_range.end());
+  }
+
+  const MacCready mac_cready(task_behaviour.glide, glide_polar);
+
+  next.clear();
+  for (const auto &[distance, i] : in_range) {
+    const Waypoint &waypoint = *candidates[i];
+
+    WaypointReach r;
+    r.id = waypoint.id;
+    r.reach.Clear();
+    r.reachable = key.route
+      ? CalculateRoute(r, waypoint, route_planner,
+                       safety_height, reach_enabled)
+      : CalculateDirect(r, waypoint, basic, wind,
+                        mac_cready, safety_height);
+    if (r.reachable != WaypointReachability::INVALID)
+      next.push_back(r);
+  }
+
+  /* out of glide range, the route planner would not find anything;
+     a straight glide is enough to show how far below the glide path
+     these waypoints are */
+  for (const auto &[distance, i] : out_of_range) {
+    const Waypoint &waypoint = *candidates[i];
+
+    WaypointReach r;
+    r.id = waypoint.id;
+    r.reach.Clear();
+    r.reachable = CalculateDirect(r, waypoint, basic, wind,
+                                  mac_cready, safety_height);
+    if (r.reachable != WaypointReachability::INVALID)
+      next.push_back(r);
+  }
+
+  std::sort(next.begin(), next.end(),
+            [](const WaypointReach &a, const WaypointReach &b){
+              return a.id < b.id;
+            });
+
+  Publish();
+}
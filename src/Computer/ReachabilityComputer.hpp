@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "WaypointReachTable.hpp"
+#include "Engine/Waypoint/Ptr.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "util/Serial.hpp"
+
+#include <utility>
+#include <vector>
+
+struct MoreData;
+struct DerivedInfo;
+struct TaskBehaviour;
+class GlidePolar;
+class Waypoints;
+class ProtectedRoutePlanner;
+
+/**
+ * Calculates the arrival altitudes of all landable (and watched)
+ * waypoints within glide range, see #WaypointReachTable.  Nearby
+ * waypoints out of glide range (and all watched waypoints) get a
+ * cheap straight glide estimate, if there is room in the table.
+ *
+ * The candidate waypoints are collected with some margin, and the
+ * collection is reused until the aircraft leaves it.  The arrival
+ * altitudes are only calculated again after one of the inputs
+ * (quantised position and altitude, polar, wind, reach) has changed.
+ */
+class ReachabilityComputer {
+  /**
+   * The candidates are collected within this radius [m] beyond the
+   * glide range.
+   */
+  static constexpr double CANDIDATE_MARGIN = 10000;
+
+  /**
+   * The step [degrees] to which the location is quantised before it
+   * is compared with the previous one (roughly 150 to 220 m).
+   */
+  static constexpr double LOCATION_STEP = 0.002;
+
+  /**
+   * The step [m] to which the altitude is quantised before it is
+   * compared with the previous one.
+   */
+  static constexpr double ALTITUDE_STEP = 10;
+
+  const Waypoints &waypoints;
+
+  /**
+   * The landable waypoints within #candidate_radius around
+   * #candidate_center, and all watched waypoints.
+   */
+  std::vector<WaypointPtr> candidates;
+
+  /**
+   * All watched waypoints, collected when the waypoint database has
+   * changed.  The map shows their arrival altitude even when they
+   * are far out of range.
+   */
+  std::vector<WaypointPtr> watched;
+
+  GeoPoint candidate_center;
+  double candidate_radius;
+
+  /**
+   * The Waypoints::GetSerial() value when #candidates was collected.
+   */
+  Serial waypoints_serial;
+
+  /**
+   * All inputs of the calculation.  If none has changed, the table is
+   * still up to date.
+   */
+  struct Key {
+    int latitude, longitude, altitude;
+    double wind_norm, wind_bearing;
+    double mc, bugs, ballast;
+    double safety_height;
+    Serial waypoints_serial, reach_serial;
+    bool route, reach_enabled;
+
+    constexpr bool operator==(const Key &) const noexcept = default;
+  };
+
+  Key last_key;
+  bool last_valid;
+
+  /**
+   * Temporary lists of (distance, index into #candidates) pairs.
+   */
+  std::vector<std::pair<double, unsigned>> in_range, out_of_range;
+
+  /**
+   * The new table is built here, and then swapped with the published
+   * one.
+   */
+  std::vector<WaypointReach> next;
+
+  ProtectedWaypointReachTable table;
+
+public:
+  explicit ReachabilityComputer(const Waypoints &_waypoints) noexcept
+    :waypoints(_waypoints) {
+    Reset();
+  }
+
+  const ProtectedWaypointReachTable &GetTable() const noexcept {
+    return table;
+  }
+
+  void Reset() noexcept;
+
+  void Compute(const MoreData &basic, const DerivedInfo &calculated,
+               const TaskBehaviour &task_behaviour,
+               const GlidePolar &glide_polar_task,
+               const ProtectedRoutePlanner &route_planner) noexcept;
+
+private:
+  void UpdateCandidates(const GeoPoint &location, double range) noexcept;
+
+  /**
+   * Replace the published table with #next.
+   */
+  void Publish() noexcept;
+};
@@ -48,6 +48,18 @@ TraceComputer::LockedCopyTo(TracePointVector &v,
   full.GetPoints(v, min_time, location, resolution);
 }
 
+void
+TraceComputer::LockedSyncTo(TracePointVector &v, Serial &modify_serial) const
+{
+  const std::lock_guard lock{mutex};
+
+  if (modify_serial != full.GetModifySerial()) {
+    full.GetPoints(v);
+    modify_serial = full.GetModifySerial();
+  } else
+    full.SyncPoints(v);
+}
+
 void
 TraceComputer::Update(const ComputerSettings &settings_computer,
                       const MoreData &basic, const DerivedInfo &calculated)
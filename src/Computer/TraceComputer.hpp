@@ -70,6 +70,15 @@ public:
                     std::chrono::duration<unsigned> min_time,
                     const GeoPoint &location, double resolution) const;
 
+  /**
+   * Copy only the trace points which were appended since the last
+   * call.  If the trace was modified otherwise (e.g. by thinning,
+   * see Trace::GetModifySerial()), the vector is filled from scratch
+   * and #modify_serial is updated.  The trace is locked, and the
+   * method may be called from any thread.
+   */
+  void LockedSyncTo(TracePointVector &v, Serial &modify_serial) const;
+
   void Update(const ComputerSettings &settings_computer,
               const MoreData &basic, const DerivedInfo &calculated);
 };
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Route/ReachResult.hpp"
+#include "Engine/Route/WaypointReachability.hpp"
+#include "thread/Guard.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * The arrival altitude of one waypoint, see #WaypointReachTable.
+ */
+struct WaypointReach {
+  /**
+   * The Waypoint::id.
+   */
+  unsigned id;
+
+  /**
+   * The arrival altitude above the waypoint elevation plus the
+   * arrival safety height.
+   */
+  ReachResult reach;
+
+  WaypointReachability reachable;
+};
+
+/**
+ * The reachability of landable and watched waypoints near the
+ * aircraft.  This is calculated by #ReachabilityComputer, so readers
+ * (e.g. the map renderer) don't need to invoke the glide solver or
+ * the route planner.
+ *
+ * Waypoints out of glide range are
+ * WaypointReachability::UNREACHABLE, with only #ReachResult::direct
+ * set.  Waypoints which are not in the table are too far away (or
+ * reachability could not be calculated at all).
+ */
+struct WaypointReachTable {
+  /**
+   * If more waypoints are within glide range, only the nearest ones
+   * are calculated.  Waypoints out of glide range fill the remaining
+   * entries, watched ones first.
+   */
+  static constexpr unsigned MAX_SIZE = 256;
+
+  /**
+   * Sorted by #WaypointReach::id.
+   */
+  std::vector<WaypointReach> list;
+
+  void Clear() noexcept {
+    list.clear();
+  }
+
+  [[gnu::pure]]
+  const WaypointReach *Find(unsigned id) const noexcept {
+    auto i = std::lower_bound(list.begin(), list.end(), id,
+                              [](const WaypointReach &r, unsigned _id){
+                                return r.id < _id;
+                              });
+    return i != list.end() && i->id == id
+      ? &*i
+      : nullptr;
+  }
+};
+
+/**
+ * The #WaypointReachTable published by #ReachabilityComputer.  It is
+ * shared with the readers instead of being copied with #DerivedInfo
+ * on every blackboard update.
+ */
+class ProtectedWaypointReachTable : public Guard<WaypointReachTable> {
+  WaypointReachTable table;
+
+public:
+  ProtectedWaypointReachTable() noexcept
+    :Guard<WaypointReachTable>(table) {}
+};
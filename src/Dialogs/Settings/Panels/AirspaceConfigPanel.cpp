@@ -9,6 +9,7 @@
 #include "Widget/RowFormWidget.hpp"
 #include "Dialogs/Airspace/Airspace.hpp"
 #include "Profile/Keys.hpp"
+#include "Profile/Profile.hpp"
 #include "Language/Language.hpp"
 #include "Airspace/AirspaceComputerSettings.hpp"
 #include "Renderer/AirspaceRendererSettings.hpp"
@@ -31,6 +32,7 @@ enum ControlIndex {
   AcknowledgeTime,
   UseBlackOutline,
   AirspaceFillMode,
+  CompressBorders,
   AirspaceTransparency
 };
 
@@ -209,6 +211,13 @@ AirspaceConfigPanel::Prepare(ContainerWindow &parent,
           as_fill_mode_list, (unsigned)renderer.fill_mode);
   SetExpertRow(AirspaceFillMode);
 
+  bool compress_borders = false;
+  Profile::Get(ProfileKeys::AirspaceCompressBorders, compress_borders);
+  AddBoolean(_("Compress borders"),
+             _("Keep the airspace borders in a compact encoding which is decoded when needed.  This saves memory with large airspace files, but costs CPU time."),
+             compress_borders);
+  SetExpertRow(CompressBorders);
+
 #if defined(HAVE_HATCHED_BRUSH) && defined(HAVE_ALPHA_BLEND)
   AddBoolean(_("Airspace transparency"), _("If enabled, then airspaces are filled transparently."),
              renderer.transparency);
@@ -262,6 +271,14 @@ AirspaceConfigPanel::Save(bool &_changed) noexcept
 
   changed |= SaveValueEnum(AirspaceFillMode, ProfileKeys::AirspaceFillMode, renderer.fill_mode);
 
+  bool compress_borders = false;
+  Profile::Get(ProfileKeys::AirspaceCompressBorders, compress_borders);
+  if (SaveValue(CompressBorders, ProfileKeys::AirspaceCompressBorders,
+                compress_borders)) {
+    changed = true;
+    AirspaceFileChanged = true;
+  }
+
 #if defined(HAVE_HATCHED_BRUSH) && defined(HAVE_ALPHA_BLEND)
   changed |= SaveValue(AirspaceTransparency, ProfileKeys::AirspaceTransparency,
                        renderer.transparency);
@@ -34,7 +34,9 @@
 #include "Blackboard/BlackboardListener.hpp"
 #include "Language/Language.hpp"
 #include "Components.hpp"
+#include "BackendComponents.hpp"
 #include "DataComponents.hpp"
+#include "Computer/GlideComputer.hpp"
 
 #include <algorithm>
 #include <list>
@@ -417,6 +419,23 @@ WaypointListWidget::OnModified(DataField &df) noexcept
   UpdateList();
 }
 
+/**
+ * Look up the reachability calculated by #ReachabilityComputer.
+ */
+static WaypointReachability
+GetReachability(const Waypoint &waypoint) noexcept
+{
+  if (backend_components == nullptr || !backend_components->glide_computer)
+    return WaypointReachability::UNREACHABLE;
+
+  const ProtectedWaypointReachTable::Lease
+    table(backend_components->glide_computer->GetWaypointReach());
+  const auto *reach = table->Find(waypoint.id);
+  return reach != nullptr
+    ? reach->reachable
+    : WaypointReachability::UNREACHABLE;
+}
+
 void
 WaypointListWidget::OnPaintItem(Canvas &canvas, const PixelRect rc,
                                 unsigned i) noexcept
@@ -439,7 +458,8 @@ WaypointListWidget::OnPaintItem(Canvas &canvas, const PixelRect rc,
                              info.GetVector(location),
                              row_renderer,
                              UIGlobals::GetMapLook().waypoint,
-                             CommonInterface::GetMapSettings().waypoint);
+                             CommonInterface::GetMapSettings().waypoint,
+                             GetReachability(*info.waypoint));
 }
 
 void
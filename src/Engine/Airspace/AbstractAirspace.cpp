@@ -11,11 +11,157 @@
 #include "Geo/GeoBounds.hpp"
 #include "AirspaceIntersectionVector.hpp"
 #include "Atmosphere/Pressure.hpp"
+#include "Geo/CompressedPolygon.hpp"
+#include "thread/Mutex.hxx"
 #include "util/StringAPI.hxx"
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+struct AbstractAirspace::CompressedBorder {
+  CompressedPolygon polygon;
+
+  /**
+   * The projection for the decoded border.  Protected by the mutex of
+   * the airspace's #BorderCache shard.
+   */
+  FlatProjection projection;
+};
+
+/**
+ * The most recently used decoded borders of airspaces with a
+ * compressed border.
+ *
+ * The cache is split into shards, each with its own lock and an equal
+ * share of the capacity, so the calculation thread and the drawing
+ * thread rarely wait for each other.  Borders are decoded outside of
+ * the lock.
+ */
+class BorderCache {
+  using Key = const AbstractAirspace *;
+  using BorderPtr = AbstractAirspace::BorderPtr;
+
+  static constexpr std::size_t N_SHARDS = 16;
+
+public:
+  /**
+   * The capacity of the cache (all shards) before Reserve() is
+   * called.
+   */
+  static constexpr std::size_t MIN_SIZE = 256;
+
+  class Shard {
+    /**
+     * Most recently used first.
+     */
+    std::list<std::pair<Key, BorderPtr>> list;
+
+    std::unordered_map<Key, decltype(list)::iterator> map;
+
+  public:
+    Mutex mutex;
+
+    /**
+     * Caller must lock #mutex.
+     */
+    const BorderPtr *Get(Key key) noexcept {
+      auto i = map.find(key);
+      if (i == map.end())
+        return nullptr;
+
+      list.splice(list.begin(), list, i->second);
+      return &i->second->second;
+    }
+
+    /**
+     * Add a border, unless another thread has added one in the
+     * meantime.  Caller must lock #mutex.
+     *
+     * @return the cached border
+     */
+    const BorderPtr &Put(Key key, BorderPtr &&border,
+                         std::size_t capacity) noexcept {
+      if (const auto *existing = Get(key))
+        return *existing;
+
+      while (list.size() >= capacity && !list.empty()) {
+        map.erase(list.back().first);
+        list.pop_back();
+      }
+
+      list.emplace_front(key, std::move(border));
+      map.emplace(key, list.begin());
+      return list.front().second;
+    }
+
+    /**
+     * Caller must lock #mutex.
+     */
+    void Remove(Key key) noexcept {
+      auto i = map.find(key);
+      if (i == map.end())
+        return;
+
+      list.erase(i->second);
+      map.erase(i);
+    }
+  };
+
+private:
+  std::array<Shard, N_SHARDS> shards;
 
-AbstractAirspace::~AbstractAirspace() noexcept = default;
+  std::atomic<std::size_t> shard_capacity{MIN_SIZE / N_SHARDS};
+
+public:
+  Shard &GetShard(Key key) noexcept {
+    /* drop the bits which are always zero due to the allocator's
+       alignment */
+    return shards[(reinterpret_cast<std::uintptr_t>(key) >> 4) % N_SHARDS];
+  }
+
+  std::size_t GetShardCapacity() const noexcept {
+    return shard_capacity.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Grow the cache to hold at least the specified number of borders.
+   * It never shrinks, because there may be several databases.
+   */
+  void Reserve(std::size_t size) noexcept {
+    const std::size_t capacity = (size + N_SHARDS - 1) / N_SHARDS;
+    std::size_t old = shard_capacity.load(std::memory_order_relaxed);
+    while (old < capacity &&
+           !shard_capacity.compare_exchange_weak(old, capacity,
+                                                 std::memory_order_relaxed)) {}
+  }
+};
+
+static BorderCache border_cache;
+
+/**
+ * The decoded border cache holds (at least) one out of this many
+ * compressed borders, see AbstractAirspace::ReserveBorderCache().
+ */
+static constexpr std::size_t BORDER_CACHE_FRACTION = 4;
+
+AbstractAirspace::AbstractAirspace(Shape _shape) noexcept
+  :shape(_shape), active(true)
+{
+}
+
+AbstractAirspace::~AbstractAirspace() noexcept
+{
+  if (compressed_border) {
+    /* another airspace may be allocated at the same address later */
+    auto &shard = border_cache.GetShard(this);
+    const std::lock_guard lock{shard.mutex};
+    shard.Remove(this);
+  }
+}
 
 bool
 AbstractAirspace::Inside(const AltitudeState &state) const noexcept
@@ -176,9 +322,79 @@ AbstractAirspace::MatchNamePrefix(const TCHAR *prefix) const noexcept
   return StringIsEqualIgnoreCase(name.c_str(), prefix, prefix_length);
 }
 
+void
+AbstractAirspace::CompressBorder(const FlatProjection &projection) noexcept
+{
+  if (compressed_border)
+    return;
+
+  compressed_border = std::make_unique<CompressedBorder>(CompressedBorder{
+      CompressedPolygon{m_border},
+      projection,
+    });
+
+  m_border.clear();
+  m_border.shrink_to_fit();
+}
+
+AbstractAirspace::BorderPtr
+AbstractAirspace::DecodeBorder() const noexcept
+{
+  assert(compressed_border);
+
+  auto &shard = border_cache.GetShard(this);
+  FlatProjection projection;
+
+  {
+    const std::lock_guard lock{shard.mutex};
+    if (const auto *border = shard.Get(this))
+      return *border;
+
+    projection = compressed_border->projection;
+  }
+
+  auto border = std::make_shared<SearchPointVector>();
+  compressed_border->polygon.Decode(*border);
+  if (projection.IsValid())
+    border->Project(projection);
+
+  const std::lock_guard lock{shard.mutex};
+  return shard.Put(this, std::move(border), border_cache.GetShardCapacity());
+}
+
+void
+AbstractAirspace::ReserveBorderCache(std::size_t n_compressed) noexcept
+{
+  border_cache.Reserve(n_compressed / BORDER_CACHE_FRACTION);
+}
+
+std::size_t
+AbstractAirspace::GetMemoryUsage() const noexcept
+{
+  std::size_t size = (m_border.capacity() + m_clearance.capacity())
+    * sizeof(SearchPoint);
+
+  if (name.capacity() > tstring{}.capacity())
+    size += (name.capacity() + 1) * sizeof(TCHAR);
+
+  if (compressed_border)
+    size += sizeof(*compressed_border) +
+      compressed_border->polygon.GetMemorySize();
+
+  return size;
+}
+
 void
 AbstractAirspace::Project(const FlatProjection &projection) noexcept
 {
+  if (compressed_border) {
+    auto &shard = border_cache.GetShard(this);
+    const std::lock_guard lock{shard.mutex};
+    compressed_border->projection = projection;
+    shard.Remove(this);
+    return;
+  }
+
   m_border.Project(projection);
 }
 
@@ -186,13 +402,13 @@ const FlatBoundingBox
 AbstractAirspace::GetBoundingBox(const FlatProjection &projection) noexcept
 {
   Project(projection);
-  return m_border.CalculateBoundingbox();
+  return GetPoints()->CalculateBoundingbox();
 }
 
 GeoBounds
 AbstractAirspace::GetGeoBounds() const noexcept
 {
-  return m_border.CalculateGeoBounds();
+  return GetPoints()->CalculateGeoBounds();
 }
 
 const SearchPointVector&
@@ -203,7 +419,7 @@ AbstractAirspace::GetClearance(const FlatProjection &projection) const noexcept
   if (!m_clearance.empty())
     return m_clearance;
 
-  m_clearance = m_border;
+  m_clearance = *GetPoints();
   if (is_convex != TriState::FALSE)
     is_convex = m_clearance.PruneInterior() ? TriState::FALSE : TriState::TRUE;
 
@@ -16,6 +16,8 @@
 #include <iosfwd>
 #endif
 
+#include <memory>
+
 #include <tchar.h>
 
 struct AircraftState;
@@ -60,16 +62,31 @@ protected:
   /** Radio frequency (optional) */
   RadioFrequency radio_frequency = RadioFrequency::Null();
 
-  /** Actual border */
+  /** Actual border; empty if it has been compressed */
   SearchPointVector m_border;
 
+  struct CompressedBorder;
+
+  /**
+   * The compressed border, see CompressBorder().  If this is set,
+   * #m_border is empty.
+   */
+  std::unique_ptr<CompressedBorder> compressed_border;
+
   /** Convex clearance border */
   mutable SearchPointVector m_clearance;
 
   AirspaceActivity days_of_operation;
 
 public:
-  AbstractAirspace(Shape _shape) noexcept:shape(_shape), active(true) {}
+  /**
+   * A shared pointer to the border returned by GetPoints().  For
+   * compressed borders, it keeps the decoded border alive after it
+   * has been evicted from the cache.
+   */
+  using BorderPtr = std::shared_ptr<const SearchPointVector>;
+
+  AbstractAirspace(Shape _shape) noexcept;
   virtual ~AbstractAirspace() noexcept;
 
   Shape GetShape() const noexcept {
@@ -360,12 +377,49 @@ public:
    * For polygon airspaces, this is the actual boundary,
    * for circle airspaces, this is a simplified shape
    *
+   * If the border has been compressed, it is decoded on demand and
+   * kept in an LRU cache shared by all airspaces (see
+   * ReserveBorderCache()).
+   *
    * @return border of airspace
    */
-  const SearchPointVector &GetPoints() const noexcept {
-    return m_border;
+  BorderPtr GetPoints() const noexcept {
+    if (!compressed_border) [[likely]]
+      /* no control block, no reference counting */
+      return BorderPtr{BorderPtr{}, &m_border};
+
+    return DecodeBorder();
+  }
+
+  /**
+   * Replace the border with a compact encoding (see
+   * #CompressedPolygon) to save memory in large databases.  After
+   * this, GetPoints() decodes it on demand.
+   *
+   * @param projection the projection for the decoded border; it is
+   * replaced by the next Project() call
+   */
+  void CompressBorder(const FlatProjection &projection) noexcept;
+
+  bool IsBorderCompressed() const noexcept {
+    return compressed_border != nullptr;
   }
 
+  /**
+   * Grow the cache of decoded borders according to the number of
+   * compressed borders in a database, so the airspaces used by the
+   * calculation and the drawing thread fit in it.  The cache never
+   * shrinks.
+   */
+  static void ReserveBorderCache(std::size_t n_compressed) noexcept;
+
+  /**
+   * Returns an estimate of the heap memory used by this object
+   * (excluding the object itself).
+   */
+  [[gnu::pure]]
+  std::size_t GetMemoryUsage() const noexcept;
+
   /**
    * On-demand access of clearance border.  Generated on call,
    * to deallocate, call clear_clearance().  Uses mutable object
@@ -386,6 +440,8 @@ protected:
   void Project(const FlatProjection &tp) noexcept;
 
 private:
+  BorderPtr DecodeBorder() const noexcept;
+
   /**
    * Find time/distance to specified point on the boundary from an observer
    * given a simplified performance model.  If inside the airspace, this will
@@ -29,25 +29,27 @@ AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts) noexcept
 const GeoPoint
 AirspacePolygon::GetReferenceLocation() const noexcept
 {
-  assert(m_border.size() >= 3);
+  const auto border = GetPoints();
+  assert(border->size() >= 3);
 
-  return m_border[0].GetLocation();
+  return border->front().GetLocation();
 }
 
 const GeoPoint
 AirspacePolygon::GetCenter() const noexcept
 {
-  assert(m_border.size() >= 3);
+  const auto border = GetPoints();
+  assert(border->size() >= 3);
 
   double lat(0), lon(0);
 
-  for (const auto &pt : m_border) {
+  for (const auto &pt : *border) {
     lat += pt.GetLocation().latitude.Native();
     lon += pt.GetLocation().longitude.Native();
   }
 
-  lon = lon / m_border.size();
-  lat = lat / m_border.size();
+  lon = lon / border->size();
+  lat = lat / border->size();
 
   return GeoPoint(Angle::Native(lon), Angle::Native(lat));
 }
@@ -55,7 +57,7 @@ AirspacePolygon::GetCenter() const noexcept
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const noexcept
 {
-  return m_border.IsInside(loc);
+  return GetPoints()->IsInside(loc);
 }
 
 AirspaceIntersectionVector
@@ -67,7 +69,8 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
 
   AirspaceIntersectSort sorter(start, *this);
 
-  for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
+  const auto border = GetPoints();
+  for (auto it = border->begin(); it + 1 != border->end(); ++it) {
 
     const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
     auto t = ray.DistinctIntersection(r_seg);
@@ -83,6 +86,6 @@ AirspacePolygon::ClosestPoint(const GeoPoint &loc,
                               const FlatProjection &projection) const noexcept
 {
   const auto p = projection.ProjectInteger(loc);
-  const auto pb = m_border.NearestPoint(p);
+  const auto pb = GetPoints()->NearestPoint(p);
   return projection.Unproject(pb);
 }
@@ -27,6 +27,7 @@ public:
    * Converts border to convex hull of points (for testing only).
    */
   void MakeConvex() noexcept {
+    assert(!IsBorderCompressed());
     m_border.PruneInterior();
     is_convex = TriState::TRUE;
   }
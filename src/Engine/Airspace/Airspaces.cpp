@@ -83,9 +83,21 @@ Airspaces::Optimise() noexcept
     airspace_tree.clear();
   }
 
-  for (auto &i : tmp_as) {
-    Airspace as(std::move(i), task_projection);
-    airspace_tree.insert(as);
+  if (airspace_tree.empty()) {
+    /* bulk-load the whole tree with the packing algorithm, which is
+       much faster than inserting one at a time and results in a
+       better tree */
+    std::vector<Airspace> v;
+    v.reserve(tmp_as.size());
+    for (auto &i : tmp_as)
+      v.emplace_back(std::move(i), task_projection);
+
+    airspace_tree = AirspaceTree{v};
+  } else {
+    for (auto &i : tmp_as) {
+      Airspace as(std::move(i), task_projection);
+      airspace_tree.insert(as);
+    }
   }
 
   tmp_as.clear();
@@ -146,6 +158,8 @@ Airspaces::SetFlightLevels(const AtmosphericPressure press) noexcept
 
     for (auto &v : QueryAll())
       v.SetFlightLevel(press);
+
+    ++serial;
   }
 }
 
@@ -157,6 +171,8 @@ Airspaces::SetActivity(const AirspaceActivity mask) noexcept
 
     for (auto &v : QueryAll())
       v.SetActivity(mask);
+
+    ++serial;
   }
 }
 
@@ -167,6 +183,23 @@ Airspaces::ClearClearances() noexcept
     v.ClearClearance();
 }
 
+void
+Airspaces::CompressBorders(unsigned min_points) noexcept
+{
+  assert(tmp_as.empty());
+
+  std::size_t n_compressed = 0;
+  for (const auto &i : QueryAll()) {
+    auto &airspace = i.GetAirspace();
+    if (airspace.GetPoints()->size() >= min_points) {
+      airspace.CompressBorder(task_projection);
+      ++n_compressed;
+    }
+  }
+
+  AbstractAirspace::ReserveBorderCache(n_compressed);
+}
+
 [[gnu::pure]]
 static bool
 AirspacePointersEquals(const Airspace &a, const Airspace &b) noexcept
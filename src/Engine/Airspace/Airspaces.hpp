@@ -30,8 +30,9 @@ class Airspaces : public AirspacesInterface {
   std::deque<AirspacePtr> tmp_as;
 
   /**
-   * This attribute keeps track of changes to this project.  It is
-   * used by the renderer cache.
+   * This attribute keeps track of changes to this project,
+   * including changes to the altitudes (flight levels, ground
+   * levels) and the activity.  It is used by the renderer cache.
    */
   Serial serial;
 
@@ -184,6 +185,14 @@ public:
    */
   void ClearClearances() noexcept;
 
+  /**
+   * Compress the borders of all airspaces in this database which
+   * have at least the specified number of vertices, to save memory
+   * in large databases (see AbstractAirspace::CompressBorder()).
+   * Must be called after Optimise().
+   */
+  void CompressBorders(unsigned min_points) noexcept;
+
   /**
    * Copy/delete objects in this database based on query of master
    *
@@ -2,6 +2,10 @@
 // Copyright The XCSoar Project
 
 #include "ContestManager.hpp"
+#include "thread/Parallel.hpp"
+
+#include <atomic>
+#include <initializer_list>
 
 ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_full,
@@ -117,6 +121,17 @@ ContestManager::SetHandicap(unsigned handicap) noexcept
   charron_large.SetHandicap(handicap);
 }
 
+void
+ContestManager::SetThreads(unsigned _n_threads) noexcept
+{
+  n_threads = _n_threads;
+
+  olc_fai.SetThreads(n_threads);
+  xcontest_triangle.SetThreads(n_threads);
+  dhv_xc_triangle.SetThreads(n_threads);
+  weglide_fai.SetThreads(n_threads);
+}
+
 static bool
 RunContest(AbstractContest &_contest,
            ContestResult &result, ContestTraceVector &solution,
@@ -140,6 +155,45 @@ RunContest(AbstractContest &_contest,
   return true;
 }
 
+namespace {
+
+struct ContestJob {
+  AbstractContest &contest;
+  ContestResult &result;
+  ContestTraceVector &solution;
+};
+
+}
+
+/**
+ * Run several solvers which do not depend on each other.  During
+ * exhaustive solving with more than one thread, they are run
+ * concurrently.
+ *
+ * @return true if at least one of them has found a solution
+ */
+static bool
+RunContests(std::initializer_list<ContestJob> jobs,
+            bool exhaustive, unsigned n_threads) noexcept
+{
+  if (!exhaustive || n_threads <= 1) {
+    bool retval = false;
+    for (const auto &job : jobs)
+      retval |= RunContest(job.contest, job.result, job.solution,
+                           exhaustive);
+    return retval;
+  }
+
+  std::atomic_bool retval{false};
+  RunParallel(jobs.size(), n_threads, [&jobs, &retval](unsigned i){
+    const auto &job = jobs.begin()[i];
+    if (RunContest(job.contest, job.result, job.solution, true))
+      retval.store(true, std::memory_order_relaxed);
+  });
+
+  return retval.load(std::memory_order_relaxed);
+}
+
 bool
 ContestManager::UpdateIdle(bool exhaustive) noexcept
 {
@@ -175,11 +229,10 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests({
+        {olc_classic, stats.result[0], stats.solution[0]},
+        {olc_fai, stats.result[1], stats.solution[1]},
+      }, exhaustive, n_threads);
 
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
@@ -197,17 +250,17 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests({
+        {xcontest_free, stats.result[0], stats.solution[0]},
+        {xcontest_triangle, stats.result[1], stats.solution[1]},
+      }, exhaustive, n_threads);
     break;
 
   case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests({
+        {dhv_xc_free, stats.result[0], stats.solution[0]},
+        {dhv_xc_triangle, stats.result[1], stats.solution[1]},
+      }, exhaustive, n_threads);
     break;
 
   case Contest::SIS_AT:
@@ -221,14 +274,11 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::WEGLIDE_FREE:
-    retval = RunContest(weglide_distance, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(weglide_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
-
-    retval |= RunContest(weglide_or, stats.result[2],
-                         stats.solution[2], exhaustive);
+    retval = RunContests({
+        {weglide_distance, stats.result[0], stats.solution[0]},
+        {weglide_fai, stats.result[1], stats.solution[1]},
+        {weglide_or, stats.result[2], stats.solution[2]},
+      }, exhaustive, n_threads);
 
     if (retval) {
       weglide_free.Feed(stats.result[0], stats.solution[0],
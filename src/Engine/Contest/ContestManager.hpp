@@ -53,6 +53,11 @@ class ContestManager
   Charron charron_small;
   Charron charron_large;
 
+  /**
+   * The number of threads used by exhaustive solving.
+   */
+  unsigned n_threads = 1;
+
 public:
   /**
    * Base constructor.
@@ -87,6 +92,13 @@ public:
 
   void SetHandicap(unsigned handicap) noexcept;
 
+  /**
+   * Set the number of threads used by exhaustive solving.
+   * Independent solvers (e.g. the two parts of OLC_PLUS) are run
+   * concurrently, and the triangle solvers split their search.
+   */
+  void SetThreads(unsigned _n_threads) noexcept;
+
   /**
    * Update internal states (non-essential) for housework,
    * or where functions are slow and would cause loss to real-time performance.
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 // set size of reserved queue elements (may differ from Dijkstra default)
 static constexpr unsigned CONTEST_QUEUE_SIZE = 5000;
@@ -277,15 +278,12 @@ ContestDijkstra::AddIncrementalEdges(unsigned first_point) noexcept
   finished = false;
   first_finish_candidate = first_point;
 
-  /* we need a copy of the current edge map, because the following
-     loop will modify it, invalidating the iterator */
-#if GCC_VERSION < 40800 || GCC_VERSION > 40802
-  const Dijkstra::EdgeMap edges = dijkstra.GetEdgeMap();
-#else
-  // workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=59548
-  Dijkstra::EdgeMap edges;
-  edges = dijkstra.GetEdgeMap();
-#endif
+  /* we need a copy of the current edges, because the following
+     loop will modify them; copying only the entries (and not the
+     hash table) is enough for iterating */
+  const auto &edge_map = dijkstra.GetEdgeMap();
+  const std::vector<Dijkstra::EdgeMap::value_type> edges(edge_map.begin(),
+                                                        edge_map.end());
 
   /* establish links between each old node and each new node, to
      initiate the follow-up search, hoping a better solution will be
@@ -5,9 +5,10 @@
 
 #include "util/Serial.hpp"
 #include "Trace/Trace.hpp"
-#include "Trace/Vector.hpp"
 #include "Trace/Point.hpp"
 
+#include <span>
+
 class TraceManager {
 protected:
   const Trace &trace_master;
@@ -29,11 +30,11 @@ private:
 
 protected:
   /**
-   * Working trace for solver.  This contains pointers to trace_master
-   * records, which get Invalidated when the trace gets thinned.  Be
-   * careful!
+   * Working trace for solver.  This refers directly to the points of
+   * trace_master; appending to the master does not affect it, but
+   * thinning modifies the points it refers to.  Be careful!
    */
-  TracePointerVector trace;
+  std::span<const TracePoint> trace;
 
   /** Number of points in current trace set */
   unsigned n_points;
@@ -66,12 +67,12 @@ protected:
   void ClearTrace() noexcept;
 
   /**
-   * Obtain a new #Trace copy.
+   * Obtain a new view of the master #Trace.
    */
   void UpdateTraceFull() noexcept;
 
   /**
-   * Copy points that were added to the end of the master Trace.
+   * Include points that were added to the end of the master Trace.
    *
    * @return true if new points were added
    */
@@ -81,7 +82,7 @@ protected:
   const TracePoint &GetPoint(unsigned i) const noexcept {
     assert(i < n_points);
 
-    return *trace[i];
+    return trace[i];
   }
 
   [[gnu::pure]]
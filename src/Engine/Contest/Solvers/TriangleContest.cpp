@@ -3,8 +3,10 @@
 
 #include "TriangleContest.hpp"
 #include "Cast.hpp"
+#include "util/Compiler.h"
 #include "Trace/Trace.hpp"
 #include "util/QuadTree.hxx"
+#include "thread/Parallel.hpp"
 
 /*
  @todo potential to use 3d convex hull to speed search
@@ -127,6 +129,11 @@ TriangleContest::Solve(bool exhaustive) noexcept
     return SolverResult::FAILED;
   }
 
+  if (exhaustive && running)
+    /* an exhaustive search starts from scratch; discard the
+       unfinished incremental one */
+    ResetBranchAndBound();
+
   if (!running) {
     // branch and bound is currently in finished state, update trace
     UpdateTrace(exhaustive);
@@ -138,8 +145,12 @@ TriangleContest::Solve(bool exhaustive) noexcept
       return SolverResult::FAILED;
     }
 
-    if (is_closed)
-      SolveTriangle(exhaustive);
+    if (is_closed) {
+      if (exhaustive)
+        SolveTriangleExhaustive();
+      else
+        SolveTriangle();
+    }
 
     if (!SaveSolution())
       return SolverResult::FAILED;
@@ -150,43 +161,51 @@ TriangleContest::Solve(bool exhaustive) noexcept
   }
 }
 
-inline void
-TriangleContest::SolveTriangle(bool exhaustive) noexcept
+TriangleContest::ClosingPairs
+TriangleContest::RelaxClosingPairs() const noexcept
 {
-  Candidate best_triangle{.distance = best_d};
-  ClosingPair best_closing_pair;
+  ClosingPairs relaxed_pairs;
 
-  if (exhaustive || !predict) {
-    ClosingPairs relaxed_pairs;
+  unsigned relax = n_points * 0.03;
 
-    unsigned relax = n_points * 0.03;
+  // for all closed trace loops
+  for (auto closing_pair = closing_pairs.closing_pairs.begin();
+       closing_pair != closing_pairs.closing_pairs.end();
+       ++closing_pair) {
 
-    // for all closed trace loops
-    for (auto closing_pair = closing_pairs.closing_pairs.begin();
-         closing_pair != closing_pairs.closing_pairs.end();
-         ++closing_pair) {
+    auto already_relaxed = relaxed_pairs.FindRange(*closing_pair);
+    if (already_relaxed.first != 0 || already_relaxed.second != 0)
+      // this pair is already relaxed... continue with next
+      continue;
 
-      auto already_relaxed = relaxed_pairs.FindRange(*closing_pair);
-      if (already_relaxed.first != 0 || already_relaxed.second != 0)
-        // this pair is already relaxed... continue with next
-        continue;
+    unsigned relax_first = closing_pair->first;
+    unsigned relax_last = closing_pair->second;
 
-      unsigned relax_first = closing_pair->first;
-      unsigned relax_last = closing_pair->second;
+    const unsigned max_first = closing_pair->first + relax;
+    const unsigned max_last = closing_pair->second + relax;
 
-      const unsigned max_first = closing_pair->first + relax;
-      const unsigned max_last = closing_pair->second + relax;
+    for (auto relaxed = std::next(closing_pair);
+         relaxed != closing_pairs.closing_pairs.end() &&
+         relaxed->first <= max_first && relaxed->second <= max_last;
+         ++relaxed)
+      relax_last = std::max(relax_last, relaxed->second);
 
-      for (auto relaxed = std::next(closing_pair);
-           relaxed != closing_pairs.closing_pairs.end() &&
-           relaxed->first <= max_first && relaxed->second <= max_last;
-           ++relaxed)
-        relax_last = std::max(relax_last, relaxed->second);
+    relaxed_pairs.Insert({relax_first, relax_last});
+  }
 
-      relaxed_pairs.Insert({relax_first, relax_last});
-    }
+  // TODO: reverse sort relaxed pairs according to number of contained points
+
+  return relaxed_pairs;
+}
+
+inline void
+TriangleContest::SolveTriangle() noexcept
+{
+  Candidate best_triangle{.distance = best_d};
+  ClosingPair best_closing_pair;
 
-    // TODO: reverse sort relaxed pairs according to number of contained points
+  if (!predict) {
+    const ClosingPairs relaxed_pairs = RelaxClosingPairs();
 
     ClosingPairs close_look;
 
@@ -199,7 +218,7 @@ TriangleContest::SolveTriangle(bool exhaustive) noexcept
 
       const auto triangle = RunBranchAndBound(relaxed_pair.first,
                                               relaxed_pair.second,
-                                              best_triangle.distance, exhaustive);
+                                              best_triangle.distance, false);
 
       if (triangle.distance > best_triangle.distance) {
         // solution is better than best_triangle
@@ -225,7 +244,7 @@ TriangleContest::SolveTriangle(bool exhaustive) noexcept
     for (const auto &close_look_pair : close_look.closing_pairs) {
       const auto triangle = RunBranchAndBound(close_look_pair.first,
                                               close_look_pair.second,
-                                              best_triangle.distance, exhaustive);
+                                              best_triangle.distance, false);
 
       if (triangle.distance > best_triangle.distance) {
         // solution is better than best_triangle
@@ -252,24 +271,180 @@ TriangleContest::SolveTriangle(bool exhaustive) noexcept
     }
   }
 
-  if (best_triangle.distance > 0) {
-    solution.resize(5);
+  SaveTriangle(best_triangle, best_closing_pair);
+}
+
+inline void
+TriangleContest::SolveTriangleExhaustive() noexcept
+{
+  Candidate best_triangle{.distance = best_d};
+  ClosingPair best_closing_pair;
+
+  std::atomic_uint bound{best_d};
+
+  /* same as SolveTriangle(), but all relaxed pairs are solved at
+     once, and then all close look pairs */
+
+  auto subproblems = MakeSubproblems(RelaxClosingPairs());
+  SolveSubproblems(subproblems, bound, true);
+
+  ClosingPairs close_look;
+
+  for (const auto &subproblem : subproblems) {
+    if (subproblem.result.distance <= best_triangle.distance)
+      continue;
+
+    if (subproblem.unrelaxed.first != 0 || subproblem.unrelaxed.second != 0) {
+      best_closing_pair = subproblem.unrelaxed;
+      best_triangle = subproblem.result;
+    } else {
+      for (const auto &closing_pair : closing_pairs.closing_pairs)
+        if (closing_pair.first >= subproblem.pair.first &&
+            closing_pair.second <= subproblem.pair.second)
+          close_look.Insert(closing_pair);
+    }
+  }
+
+  subproblems = MakeSubproblems(close_look);
+  SolveSubproblems(subproblems, bound, false);
+
+  for (const auto &subproblem : subproblems) {
+    if (subproblem.result.distance > best_triangle.distance) {
+      best_closing_pair = subproblem.pair;
+      best_triangle = subproblem.result;
+    }
+  }
+
+  SaveTriangle(best_triangle, best_closing_pair);
+}
 
-    solution[0] = TraceManager::GetPoint(best_closing_pair.first);
-    solution[1] = TraceManager::GetPoint(best_triangle.tp1);
-    solution[2] = TraceManager::GetPoint(best_triangle.tp2);
-    solution[3] = TraceManager::GetPoint(best_triangle.tp3);
-    solution[4] = TraceManager::GetPoint(best_closing_pair.second);
-    best_d = best_triangle.distance;
+std::vector<TriangleContest::Subproblem>
+TriangleContest::MakeSubproblems(const ClosingPairs &pairs) const noexcept
+{
+  std::vector<Subproblem> subproblems;
 
-    is_complete = true;
+  if (n_threads <= 1 || pairs.closing_pairs.empty()) {
+    for (const auto &pair : pairs.closing_pairs)
+      subproblems.emplace_back(pair);
+    return subproblems;
   }
+
+  /* if there are too few closing pairs to keep all threads busy,
+     split their trees: expand the top nodes breadth-first and give
+     each resulting node to a separate subproblem */
+  const std::size_t n_pairs = pairs.closing_pairs.size();
+  const std::size_t min_subproblems = 4 * n_threads;
+  const std::size_t split = (min_subproblems + n_pairs - 1) / n_pairs;
+
+  for (const auto &pair : pairs.closing_pairs) {
+    if (split <= 1) {
+      subproblems.emplace_back(pair);
+      continue;
+    }
+
+    const auto validator =
+      OLCTriangleRules::MakeValidator(trace_master.GetProjection(),
+                                      GetPoint(pair.first).GetLocation());
+
+    BranchAndBoundTree tree;
+    CheckAddCandidate(tree, 0, validator,
+                      CandidateSet(*this, pair.first, pair.second + 1));
+
+    while (!tree.empty() && tree.size() < split) {
+      const auto node = std::prev(tree.end());
+      if (node->second.tp1.GetSize() == 1 &&
+          node->second.tp2.GetSize() == 1 &&
+          node->second.tp3.GetSize() == 1)
+        /* can't split this one */
+        break;
+
+      const CandidateSet candidate_set = node->second;
+      tree.erase(node);
+      Branch(tree, candidate_set, 0, validator);
+    }
+
+    for (const auto &node : tree)
+      subproblems.emplace_back(pair).tree.insert(node);
+  }
+
+  return subproblems;
+}
+
+void
+TriangleContest::SolveSubproblems(std::vector<Subproblem> &subproblems,
+                                  std::atomic_uint &bound,
+                                  bool check_unrelaxed) const noexcept
+{
+  RunParallel(subproblems.size(), n_threads, [&](unsigned i){
+    auto &subproblem = subproblems[i];
+
+    subproblem.result = BranchAndBound(subproblem.tree,
+                                       subproblem.pair.first,
+                                       subproblem.pair.second,
+                                       bound.load(std::memory_order_relaxed),
+                                       max_iterations, &bound);
+    subproblem.tree.clear();
+
+    if (subproblem.result.distance == 0)
+      return;
+
+    if (check_unrelaxed) {
+      subproblem.unrelaxed =
+        closing_pairs.FindRange({subproblem.result.tp1,
+                                 subproblem.result.tp2});
+      if (subproblem.unrelaxed.first == 0 &&
+          subproblem.unrelaxed.second == 0)
+        /* not a valid solution, don't use it for pruning */
+        return;
+    }
+
+    /* raise the shared bound */
+    unsigned d = bound.load(std::memory_order_relaxed);
+    while (subproblem.result.distance > d &&
+           !bound.compare_exchange_weak(d, subproblem.result.distance,
+                                        std::memory_order_relaxed)) {}
+  });
 }
 
+void
+TriangleContest::SaveTriangle(const Candidate &triangle,
+                              ClosingPair closing_pair) noexcept
+{
+  if (triangle.distance == 0)
+    return;
+
+  solution.resize(5);
+
+  solution[0] = TraceManager::GetPoint(closing_pair.first);
+  solution[1] = TraceManager::GetPoint(triangle.tp1);
+  solution[2] = TraceManager::GetPoint(triangle.tp2);
+  solution[3] = TraceManager::GetPoint(triangle.tp3);
+  solution[4] = TraceManager::GetPoint(closing_pair.second);
+  best_d = triangle.distance;
+
+  is_complete = true;
+}
 
 TriangleContest::Candidate
 TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
                                    bool exhaustive) noexcept
+{
+  // set max_iterations only if non-exhaustive and predictive solving is enabled.
+  // otherwise use predefined value.
+  if (!exhaustive && predict)
+    max_iterations = tick_iterations;
+
+  const auto result = BranchAndBound(branch_and_bound, from, to, worst_d,
+                                     max_iterations, nullptr);
+  running = !branch_and_bound.empty();
+  return result;
+}
+
+TriangleContest::Candidate
+TriangleContest::BranchAndBound(BranchAndBoundTree &tree,
+                                unsigned from, unsigned to, unsigned worst_d,
+                                const unsigned _max_iterations,
+                                const std::atomic_uint *bound) const noexcept
 {
   /* Some general information about the branch and bound method can be found here:
    * http://eaton.math.rpi.edu/faculty/Mitchell/papers/leeejem.html
@@ -297,21 +472,15 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
     OLCTriangleRules::MakeValidator(trace_master.GetProjection(),
                                     GetPoint(from).GetLocation());
 
-  if (!running) {
+  if (tree.empty()) {
     // initiate algorithm. otherwise continue unfinished run
-    running = true;
 
     // initialize bound-and-branch tree with root node (note: Candidate set interval is [min, max))
     CandidateSet root_candidates(*this, from, to + 1);
-    CheckAddCandidate(worst_d, validator, root_candidates);
+    CheckAddCandidate(tree, worst_d, validator, root_candidates);
   }
 
-  // set max_iterations only if non-exhaustive and predictive solving is enabled.
-  // otherwise use predefined value.
-  if (!exhaustive && predict)
-    max_iterations = tick_iterations;
-
-  while (!branch_and_bound.empty()) {
+  while (!tree.empty()) {
     /* now loop over the tree, branching each found candidate set, adding the branch if it's feasible.
      * remove all candidate sets with d_max smaller than d_min of the largest integral candidate set
      * always work on the node with largest d_min
@@ -320,14 +489,18 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
     iterations++;
 
     // break loop if max_iterations or max_tree_size exceeded
-    if (iterations > max_iterations || branch_and_bound.size() > max_tree_size)
+    if (iterations > _max_iterations || tree.size() > max_tree_size)
       break;
 
+    // other threads may have found a better triangle
+    if (bound != nullptr)
+      worst_d = std::max(worst_d, bound->load(std::memory_order_relaxed));
+
     // first clean up tree, removeing all nodes with d_max < worst_d
-    branch_and_bound.erase(branch_and_bound.begin(), branch_and_bound.lower_bound(worst_d));
+    tree.erase(tree.begin(), tree.lower_bound(worst_d));
 
     // we might have cleaned up the whole tree. nothing to do then...
-    if (branch_and_bound.empty())
+    if (tree.empty())
       break;
 
     /* get node to work on.
@@ -335,13 +508,13 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
      * this is a mixed depht-first/breadth-first approach, the latter
      * beeing faster, but the first a lot more memory efficient.
      */
-    std::multimap<unsigned, CandidateSet>::iterator node;
+    BranchAndBoundTree::iterator node;
 
-    if (branch_and_bound.size() > n_points * 4 && iterations % 16 != 0) {
-      node = branch_and_bound.upper_bound(branch_and_bound.rbegin()->first / 2);
-      if (node == branch_and_bound.end()) --node;
+    if (tree.size() > n_points * 4 && iterations % 16 != 0) {
+      node = tree.upper_bound(tree.rbegin()->first / 2);
+      if (node == tree.end()) --node;
     } else {
-      node = --branch_and_bound.end();
+      node = --tree.end();
     }
 
     if (node->second.df_min >= worst_d &&
@@ -358,66 +531,13 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
       integral_feasible = true;
 
     } else {
-      // split largest bounding box of node and create child nodes
-
-      const unsigned tp1_diag = node->second.tp1.GetDiagnoal();
-      const unsigned tp2_diag = node->second.tp2.GetDiagnoal();
-      const unsigned tp3_diag = node->second.tp3.GetDiagnoal();
-
-      const unsigned max_diag = std::max({tp1_diag, tp2_diag, tp3_diag});
-
-      if (tp1_diag == max_diag && node->second.tp1.GetSize() != 1) {
-        // split tp1 range
-        const unsigned split = (node->second.tp1.index_min + node->second.tp1.index_max) / 2;
-
-        if (split <= node->second.tp2.index_max) {
-          CheckAddCandidate(worst_d, validator,
-                            {{*this, node->second.tp1.index_min, split},
-                             node->second.tp2, node->second.tp3});
-
-          CheckAddCandidate(worst_d, validator,
-                            {{*this, split, node->second.tp1.index_max},
-                             node->second.tp2, node->second.tp3});
-        }
-      } else if (tp2_diag == max_diag && node->second.tp2.GetSize() != 1) {
-        // split tp2 range
-        const unsigned split = (node->second.tp2.index_min + node->second.tp2.index_max) / 2;
-
-        if (split <= node->second.tp3.index_max && split >= node->second.tp1.index_min) {
-          CheckAddCandidate(worst_d, validator,
-                            {node->second.tp1,
-                             {*this, node->second.tp2.index_min, split},
-                             node->second.tp3});
-
-          CheckAddCandidate(worst_d, validator,
-                            {node->second.tp1,
-                             {*this, split, node->second.tp2.index_max},
-                             node->second.tp3});
-        }
-      } else if (node->second.tp3.GetSize() != 1) {
-        // split tp3 range
-        const unsigned split = (node->second.tp3.index_min + node->second.tp3.index_max) / 2;
-
-        if (split >= node->second.tp2.index_min) {
-          CheckAddCandidate(worst_d, validator,
-                            {node->second.tp1, node->second.tp2,
-                             {*this, node->second.tp3.index_min, split}});
-
-          CheckAddCandidate(worst_d, validator,
-                            {node->second.tp1, node->second.tp2,
-                             {*this, split, node->second.tp3.index_max}});
-        }
-      }
+      Branch(tree, node->second, worst_d, validator);
     }
 
     // remove current node
-    branch_and_bound.erase(node);
+    tree.erase(node);
   }
 
-
-  if (branch_and_bound.empty())
-    running = false;
-
   if (!integral_feasible)
     return {};
 
@@ -425,6 +545,63 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
   return result;
 }
 
+void
+TriangleContest::Branch(BranchAndBoundTree &tree, const CandidateSet &node,
+                        unsigned worst_d,
+                        const OLCTriangleValidator &validator) const noexcept
+{
+  // split largest bounding box of node and create child nodes
+
+  const unsigned tp1_diag = node.tp1.GetDiagnoal();
+  const unsigned tp2_diag = node.tp2.GetDiagnoal();
+  const unsigned tp3_diag = node.tp3.GetDiagnoal();
+
+  const unsigned max_diag = std::max({tp1_diag, tp2_diag, tp3_diag});
+
+  if (tp1_diag == max_diag && node.tp1.GetSize() != 1) {
+    // split tp1 range
+    const unsigned split = (node.tp1.index_min + node.tp1.index_max) / 2;
+
+    if (split <= node.tp2.index_max) {
+      CheckAddCandidate(tree, worst_d, validator,
+                        {{*this, node.tp1.index_min, split},
+                         node.tp2, node.tp3});
+
+      CheckAddCandidate(tree, worst_d, validator,
+                        {{*this, split, node.tp1.index_max},
+                         node.tp2, node.tp3});
+    }
+  } else if (tp2_diag == max_diag && node.tp2.GetSize() != 1) {
+    // split tp2 range
+    const unsigned split = (node.tp2.index_min + node.tp2.index_max) / 2;
+
+    if (split <= node.tp3.index_max && split >= node.tp1.index_min) {
+      CheckAddCandidate(tree, worst_d, validator,
+                        {node.tp1,
+                         {*this, node.tp2.index_min, split},
+                         node.tp3});
+
+      CheckAddCandidate(tree, worst_d, validator,
+                        {node.tp1,
+                         {*this, split, node.tp2.index_max},
+                         node.tp3});
+    }
+  } else if (node.tp3.GetSize() != 1) {
+    // split tp3 range
+    const unsigned split = (node.tp3.index_min + node.tp3.index_max) / 2;
+
+    if (split >= node.tp2.index_min) {
+      CheckAddCandidate(tree, worst_d, validator,
+                        {node.tp1, node.tp2,
+                         {*this, node.tp3.index_min, split}});
+
+      CheckAddCandidate(tree, worst_d, validator,
+                        {node.tp1, node.tp2,
+                         {*this, split, node.tp3.index_max}});
+    }
+  }
+}
+
 ContestResult
 TriangleContest::CalculateResult() const noexcept
 {
@@ -9,8 +9,10 @@
 #include "Trace/Point.hpp"
 #include "Geo/Flat/FlatBoundingBox.hpp"
 
+#include <atomic>
 #include <map>
 #include <utility> // for std::swap()
+#include <vector>
 
 /**
  * Specialisation of AbstractContest for OLC Triangle (triangle) rules
@@ -71,6 +73,11 @@ private:
   unsigned max_iterations = 1e6,
            max_tree_size = 5e5;
 
+  /**
+   * The number of threads used for exhaustive solving.
+   */
+  unsigned n_threads = 1;
+
   typedef std::pair<unsigned, unsigned> ClosingPair;
 
   struct ClosingPairs {
@@ -239,7 +246,7 @@ private:
      * distances for certain checks, otherwise real distances for marginal fai triangles.
      */
     [[gnu::pure]]
-    bool IsIntegral(TriangleContest &parent,
+    bool IsIntegral(const TriangleContest &parent,
                     const OLCTriangleValidator &validator) const noexcept {
       if (!(tp1.GetSize() == 1 && tp2.GetSize() == 1 && tp3.GetSize() == 1))
         return false;
@@ -255,7 +262,33 @@ private:
     }
   };
 
-  std::multimap<unsigned, CandidateSet> branch_and_bound;
+  /**
+   * The branch and bound tree: candidate sets ordered by their
+   * maximum distance.
+   */
+  using BranchAndBoundTree = std::multimap<unsigned, CandidateSet>;
+
+  BranchAndBoundTree branch_and_bound;
+
+  /**
+   * One independent part of an exhaustive search, which may run on
+   * any thread: a closing pair and (optionally) a subset of its
+   * branch and bound tree.
+   */
+  struct Subproblem {
+    ClosingPair pair;
+    BranchAndBoundTree tree;
+
+    Candidate result{};
+
+    /**
+     * The unrelaxed closing pair containing #result, or (0,0).
+     */
+    ClosingPair unrelaxed{};
+
+    explicit Subproblem(ClosingPair _pair) noexcept
+      :pair(_pair) {}
+  };
 
 public:
   TriangleContest(const Trace &_trace,
@@ -268,20 +301,60 @@ public:
 
 private:
   bool FindClosingPairs(unsigned old_size) noexcept;
-  void SolveTriangle(bool exhaustive) noexcept;
+
+  [[gnu::pure]]
+  ClosingPairs RelaxClosingPairs() const noexcept;
+
+  void SolveTriangle() noexcept;
+
+  /**
+   * Find the best triangle, splitting the search into subproblems
+   * which are solved on up to #n_threads threads.  They share a
+   * global lower bound for pruning.
+   */
+  void SolveTriangleExhaustive() noexcept;
+
+  std::vector<Subproblem> MakeSubproblems(const ClosingPairs &pairs) const noexcept;
+  void SolveSubproblems(std::vector<Subproblem> &subproblems,
+                        std::atomic_uint &bound,
+                        bool check_unrelaxed) const noexcept;
+
+  void SaveTriangle(const Candidate &triangle,
+                    ClosingPair closing_pair) noexcept;
 
   Candidate RunBranchAndBound(unsigned from, unsigned to, unsigned best_d,
                               bool exhaustive) noexcept;
 
+  /**
+   * Run the branch and bound algorithm on the given tree.  An empty
+   * tree is initialised with the whole closing pair; otherwise, an
+   * unfinished run is continued.
+   *
+   * @param bound an optional lower bound shared with other threads
+   * which is used for pruning
+   */
+  Candidate BranchAndBound(BranchAndBoundTree &tree,
+                           unsigned from, unsigned to, unsigned worst_d,
+                           unsigned _max_iterations,
+                           const std::atomic_uint *bound) const noexcept;
+
+  /**
+   * Split the largest bounding box of the node and add the feasible
+   * children to the tree.
+   */
+  void Branch(BranchAndBoundTree &tree, const CandidateSet &node,
+              unsigned worst_d,
+              const OLCTriangleValidator &validator) const noexcept;
+
   void UpdateTrace(bool force) noexcept override;
   void ResetBranchAndBound() noexcept;
 
-  void CheckAddCandidate(unsigned worst_d,
-                         const OLCTriangleValidator &validator,
-                         CandidateSet candidate_set) noexcept {
+  static void CheckAddCandidate(BranchAndBoundTree &tree, unsigned worst_d,
+                                const OLCTriangleValidator &validator,
+                                CandidateSet candidate_set) noexcept {
     if (candidate_set.df_max >= worst_d &&
         candidate_set.IsFeasible(validator))
-      branch_and_bound.emplace(candidate_set.df_max, candidate_set);
+      tree.emplace(candidate_set.df_max, candidate_set);
   }
 
 public:
@@ -293,6 +366,13 @@ public:
     max_tree_size = _max_tree_size;
   };
 
+  /**
+   * Set the number of threads used for exhaustive solving.
+   */
+  void SetThreads(unsigned _n_threads) noexcept {
+    n_threads = _n_threads;
+  }
+
   /* virtual methods from AbstractContest */
   void Reset() noexcept override;
   SolverResult Solve(bool exhaustive) noexcept override;
@@ -28,19 +28,27 @@ public:
       :parent(_parent), value(_value) {}
   };
 
+  /**
+   * A #FlatHashMap specialisation, which refers to its entries by
+   * index.
+   */
   using EdgeMap = typename MapTemplate::template Bind<Edge>;
-  using edge_iterator = typename EdgeMap::iterator;
   using edge_const_iterator = typename EdgeMap::const_iterator;
+  using edge_index = typename EdgeMap::size_type;
 
 private:
   struct Value
   {
     value_type edge_value;
 
-    edge_iterator iterator;
+    /**
+     * Index of the node in #edges.  Unlike an iterator, this remains
+     * valid while the map grows.
+     */
+    edge_index index;
 
-    constexpr Value(value_type _edge_value, edge_iterator _iterator) noexcept
-      :edge_value(_edge_value), iterator(_iterator) {}
+    constexpr Value(value_type _edge_value, edge_index _index) noexcept
+      :edge_value(_edge_value), index(_index) {}
   };
 
   struct Rank {
@@ -72,13 +80,7 @@ public:
    * Default constructor
    */
   Dijkstra() noexcept {
-    /* this is a kludge to prevent rehashing, because rehashing would
-       invalidate all iterators stored inside the priority queue
-       "q", and would thus lead to use-after-free crashes */
-    // TODO this hard-codes the use of std::unordered_map
-    // TODO come up with a better solution
-    edges.reserve(4093);
-    edges.max_load_factor(1e10);
+    edges.reserve(4096);
   }
 
   Dijkstra(const Dijkstra &) = delete;
@@ -140,14 +142,15 @@ public:
    * @return Node for processing
    */
   Node Pop() noexcept {
-    edge_const_iterator cur(q.top().iterator);
-    current_value = cur->second.value;
+    const auto &cur = edges.GetEntry(q.top().index);
+    current_value = cur.second.value;
 
     do {
       q.pop();
-    } while (!q.empty() && q.top().iterator->second.value < q.top().edge_value);
+    } while (!q.empty() &&
+             edges.GetEntry(q.top().index).second.value < q.top().edge_value);
 
-    return cur->first;
+    return cur.first;
   }
 
   /**
@@ -198,8 +201,8 @@ public:
     // Clear the search queue
     q.clear();
 
-    for (const auto &i : edges)
-      q.emplace(i.second.value, i);
+    for (edge_index i = 0; i < edges.size(); ++i)
+      q.emplace(edges.GetEntry(i).second.value, i);
   }
 
 private:
@@ -226,7 +229,7 @@ private:
       // -> Don't use this new leg
       return false;
 
-    q.emplace(edge_value, it);
+    q.emplace(edge_value, edges.GetIndex(it));
     return true;
   }
 };
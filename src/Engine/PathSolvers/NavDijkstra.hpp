@@ -6,8 +6,8 @@
 #include "Dijkstra.hpp"
 #include "ScanTaskPoint.hpp"
 #include "SolverResult.hpp"
+#include "util/FlatHashMap.hpp"
 
-#include <unordered_map>
 #include <cassert>
 
 /**
@@ -38,8 +38,7 @@ protected:
     };
 
     template<typename Value>
-    struct Bind : public std::unordered_map<ScanTaskPoint, Value,
-                                            Hash, Equal> {
+    struct Bind : public FlatHashMap<ScanTaskPoint, Value, Hash, Equal> {
     };
   };
 
@@ -3,9 +3,8 @@
 
 #pragma once
 
-#include "util/ReservablePriorityQueue.hpp"
-
-#include <unordered_map>
+#include "util/FlatHashMap.hpp"
+#include "util/DaryHeap.hpp"
 
 struct AStarPriorityValue
 {
@@ -48,6 +47,9 @@ struct AStarPriorityValue
  * Modifications by John Wharington to track optimal solution
  * @see http://en.giswiki.net/wiki/Dijkstra%27s_algorithm
  *
+ * The node map and the queue keep their memory across searches, and
+ * Clear() is cheap; reuse one instance for many searches.
+ *
  * @param m_min Whether this algorithm will search for min or max distance
  */
 template <class Node, class Hash=std::hash<Node>,
@@ -55,21 +57,37 @@ template <class Node, class Hash=std::hash<Node>,
           bool m_min=true>
 class AStar
 {
-  typedef std::unordered_map<Node, AStarPriorityValue, Hash, KeyEqual> node_value_map;
-
-  typedef typename node_value_map::iterator node_value_iterator;
+  struct NodeInfo {
+    /**
+     * The best value found so far.
+     */
+    AStarPriorityValue value;
+
+    /**
+     * The predecessor on the path with the best value.
+     */
+    Node parent;
+
+    constexpr NodeInfo(const AStarPriorityValue &_value,
+                       const Node &_parent) noexcept
+      :value(_value), parent(_parent) {}
+  };
 
-  typedef std::unordered_map<Node, Node, Hash, KeyEqual> node_parent_map;
+  using NodeMap = FlatHashMap<Node, NodeInfo, Hash, KeyEqual>;
+  using size_type = typename NodeMap::size_type;
 
   struct NodeValue {
     AStarPriorityValue priority;
 
-    node_value_iterator iterator;
+    /**
+     * Index of the node in #nodes.
+     */
+    size_type index;
 
     constexpr
     NodeValue(const AStarPriorityValue &_priority,
-              node_value_iterator _iterator) noexcept
-      :priority(_priority), iterator(_iterator) {}
+              size_type _index) noexcept
+      :priority(_priority), index(_index) {}
   };
 
   struct Rank {
@@ -80,23 +98,20 @@ class AStar
   };
 
   /**
-   * Stores the value of each node.  It is updated by push(), if a
-   * value lower than the current one is found.
+   * Stores the value and the predecessor of each node.  It is updated
+   * by Push(), if a value lower than the current one is found.
    */
-  node_value_map node_values;
+  NodeMap nodes;
 
   /**
-   * Stores the predecessor of each node.  It is maintained by
-   * set_predecessor().
+   * A sorted list of all possible node paths, lowest distance first.
    */
-  node_parent_map node_parents;
+  DaryHeap<NodeValue, Rank> q;
 
   /**
-   * A sorted list of all possible node paths, lowest distance first.
+   * Index of the node which was returned by Pop().
    */
-  reservable_priority_queue<NodeValue, std::vector<NodeValue>, Rank> q;
-
-  node_value_iterator cur;
+  size_type cur = 0;
 
 public:
   static constexpr unsigned DEFAULT_QUEUE_SIZE = 1024;
@@ -128,13 +143,9 @@ public:
 
   /** Clears the queues */
   void Clear() noexcept {
-    // Clear the search queue
     q.clear();
-
-    // Clear the node_parent_map
-    node_parents.clear();
-    // Clear the node_value_map
-    node_values.clear();
+    nodes.clear();
+    cur = 0;
   }
 
   /**
@@ -152,15 +163,16 @@ public:
    *
    * @return Node for processing
    */
-  const Node &Pop() noexcept {
-    cur = q.top().iterator;
+  Node Pop() noexcept {
+    cur = q.top().index;
 
     do { // remove this item
       q.pop();
-    } while (!q.empty() && (q.top().priority > q.top().iterator->second));
+    } while (!q.empty() &&
+             q.top().priority > nodes.GetEntry(q.top().index).second.value);
     // and all lower rank than this
 
-    return cur->first;
+    return nodes.GetEntry(cur).first;
   }
 
   /**
@@ -185,9 +197,8 @@ public:
    */
   [[gnu::pure]]
   Node GetPredecessor(const Node &node) const noexcept {
-    // Try to find the given node in the node_parent_map
-    const auto it = node_parents.find(node);
-    if (it == node_parents.end())
+    const auto it = nodes.find(node);
+    if (it == nodes.end())
       // first entry
       // If the node wasn't found
       // -> Return the given node itself
@@ -195,12 +206,13 @@ public:
 
     // If the node was found
     // -> Return the parent node
-    return it->second;
+    return it->second.parent;
   }
 
   /** Reserve queue size (if available) */
   void Reserve(unsigned size) noexcept {
     q.reserve(size);
+    nodes.reserve(size);
   }
 
   /**
@@ -209,14 +221,17 @@ public:
    */
   [[gnu::pure]]
   AStarPriorityValue GetNodeValue(const Node &node) const noexcept {
-    if (cur->first == node)
-      return cur->second;
+    if (cur < nodes.size()) {
+      const auto &current = nodes.GetEntry(cur);
+      if (current.first == node)
+        return current.second.value;
+    }
 
-    const auto it = node_values.find(node);
-    if (it == node_values.end())
+    const auto it = nodes.find(node);
+    if (it == nodes.end())
       return AStarPriorityValue(0);
 
-    return it->second;
+    return it->second.value;
   }
 
 private:
@@ -229,37 +244,21 @@ private:
    */
   void Push(const Node &node, const Node &parent,
             const AStarPriorityValue &edge_value) noexcept {
-    // Try to find the given node n in the node_value_map
-    const auto [it, inserted] = node_values.try_emplace(node, edge_value);
+    // Try to find the given node n in the node map
+    const auto [it, inserted] = nodes.try_emplace(node, edge_value, parent);
     if (inserted) {
       // first entry
       // If the node wasn't found
-      // -> Insert a new node into the node_value_map
-
-      // Remember the parent node
-      SetPredecessor(node, parent);
-    } else if (it->second > edge_value) {
+      // -> It has been inserted together with its parent
+    } else if (it->second.value > edge_value) {
       // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = edge_value;
-      // replace, it's bigger
-
-      // Remember the new parent node
-      SetPredecessor(node, parent);
+      // -> Replace the value and the parent with the new ones
+      it->second = NodeInfo(edge_value, parent);
     } else
       // If the node was found but the value is higher or equal
       // -> Don't use this new leg
       return;
 
-    q.push(NodeValue(edge_value, it));
-  }
-
-  void SetPredecessor(const Node &node, const Node &parent) noexcept {
-    // Try to find the given node in the node_parent_map
-    auto result = node_parents.try_emplace(node, parent);
-    if (!result.second)
-      // If the node was found
-      // -> Replace the according parent node with the new one
-      result.first->second = parent;
+    q.emplace(edge_value, nodes.GetIndex(it));
   }
 };
@@ -229,7 +229,7 @@ RoutePlanner::LinkCleared(const RouteLink &e) noexcept
 bool
 RoutePlanner::IsSetUnique(const RouteLinkBase &e) noexcept
 {
-  return unique_links.insert(e).second;
+  return unique_links.insert(e);
 }
 
 void
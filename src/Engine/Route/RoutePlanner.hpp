@@ -9,9 +9,10 @@
 #include "AStar.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/SearchPointVector.hpp"
+#include "util/FlatHashMap.hpp"
 
+#include <queue>
 #include <utility>
-#include <unordered_set>
 
 #include <limits.h>
 
@@ -101,11 +102,11 @@ private:
    */
   SearchPointVector search_hull;
 
-  typedef std::unordered_set<RouteLinkBase, RouteLinkBaseHasher,
-                             RouteLinkBaseEqual> RouteLinkSet;
+  typedef FlatHashSet<RouteLinkBase, RouteLinkBaseHasher,
+                      RouteLinkBaseEqual> RouteLinkSet;
 
   /** Links that have been visited during solution */
-  RouteLinkSet unique_links{50000};
+  RouteLinkSet unique_links{4096};
   typedef std::queue< RouteLink> RouteLinkQueue;
   /** Link candidates to be processed for intersection tests */
   RouteLinkQueue links;
@@ -210,8 +210,9 @@ OrderedTask::RunDijsktraMin(const GeoPoint &location) noexcept
   const unsigned active_index = GetActiveIndex();
   dijkstra.SetTaskSize(task_size - active_index);
   for (unsigned i = active_index; i != task_size; ++i) {
-    const SearchPointVector &boundary = task_points[i]->GetSearchPoints();
-    dijkstra.SetBoundary(i - active_index, boundary);
+    const auto &tp = *task_points[i];
+    dijkstra.SetBoundary(i - active_index, tp.GetSearchPoints(),
+                         tp.GetSearchPointsSerial());
   }
 
   SearchPoint ac(location, task_projection);
@@ -266,35 +267,35 @@ OrderedTask::RunDijsktraMax() noexcept
     dijkstra_max = std::make_unique<TaskDijkstraMax>();
   TaskDijkstraMax &dijkstra = *dijkstra_max;
 
-  const unsigned active_index = GetActiveIndex();
-  dijkstra.SetTaskSize(task_size);
-  for (unsigned i = 0; i != task_size; ++i) {
-    const SearchPointVector &boundary = i == active_index
-      /* since one can still travel further in the current sector, use
-         the full boundary here */
-      ? task_points[i]->GetBoundaryPoints()
-      : task_points[i]->GetSearchPoints();
-    dijkstra_max->SetBoundary(i, boundary);
-  }
-
   double start_radius(-1), finish_radius(-1);
   if (subtract_start_finish_cylinder_radius) {
     /* to subtract the start/finish cylinder radius, we use only the
        nominal points (i.e. the cylinder's center), and later replace
        it with a point on the cylinder boundary */
 
-    const auto &start = *task_points.front();
-    start_radius = GetCylinderRadiusOrMinusOne(start);
-    if (start_radius > 0)
-      dijkstra.SetBoundary(0, start.GetNominalPoints());
+    start_radius = GetCylinderRadiusOrMinusOne(*task_points.front());
+    finish_radius = GetCylinderRadiusOrMinusOne(*task_points.back());
+  }
+
+  const unsigned active_index = GetActiveIndex();
+  dijkstra.SetTaskSize(task_size);
+  for (unsigned i = 0; i != task_size; ++i) {
+    const auto &tp = *task_points[i];
+    const SearchPointVector &boundary =
+      (i == 0 && start_radius > 0) ||
+      (i == task_size - 1 && finish_radius > 0)
+      ? tp.GetNominalPoints()
+      : i == active_index
+      /* since one can still travel further in the current sector, use
+         the full boundary here */
+      ? tp.GetBoundaryPoints()
+      : tp.GetSearchPoints();
 
-    const auto &finish = *task_points.back();
-    finish_radius = GetCylinderRadiusOrMinusOne(finish);
-    if (finish_radius > 0)
-      dijkstra.SetBoundary(task_size - 1, finish.GetNominalPoints());
+    /* only the modified task points need to be scanned again */
+    dijkstra.SetBoundary(i, boundary, tp.GetSearchPointsSerial());
   }
 
-  if (!dijkstra_max->DistanceMax())
+  if (!dijkstra.DistanceMax())
     return false;
 
   for (unsigned i = 0; i != task_size; ++i) {
@@ -4,43 +4,92 @@
 #include "TaskDijkstra.hpp"
 #include "Geo/SearchPointVector.hpp"
 
+#include <limits>
+
 TaskDijkstra::TaskDijkstra(bool _is_min) noexcept
-  :NavDijkstra(0),
-   is_min(_is_min)
+  :is_min(_is_min)
 {
 }
 
-inline unsigned
-TaskDijkstra::GetStageSize(const unsigned stage) const noexcept
+const SearchPoint &
+TaskDijkstra::GetPoint(unsigned stage, unsigned index) const noexcept
 {
-  assert(stage < num_stages);
-
-  return boundaries[stage]->size();
+  return (*GetLayer(stage).boundary)[index];
 }
 
-const SearchPoint &
-TaskDijkstra::GetPoint(const ScanTaskPoint sp) const noexcept
+bool
+TaskDijkstra::UpdateLayer(const unsigned layer_index) noexcept
 {
-  return (*boundaries[sp.GetStageNumber()])[sp.GetPointIndex()];
+  Layer &layer = layers[layer_index];
+  const SearchPointVector &boundary = *layer.boundary;
+  if (boundary.empty())
+    return false;
+
+  layer.values.resize(boundary.size());
+  layer.next.resize(boundary.size());
+
+  if (layer_index == 0) {
+    /* this is the finish */
+    std::fill(layer.values.begin(), layer.values.end(), value_type{});
+  } else {
+    const Layer &following = layers[layer_index - 1];
+    const SearchPointVector &destinations = *following.boundary;
+
+    for (std::size_t i = 0; i < boundary.size(); ++i) {
+      value_type best_value = std::numeric_limits<value_type>::max();
+      unsigned best_index = 0;
+
+      for (std::size_t j = 0; j < destinations.size(); ++j) {
+        const value_type value = CalcEdgeValue(boundary[i], destinations[j])
+          + following.values[j];
+        if (value < best_value) {
+          best_value = value;
+          best_index = j;
+        }
+      }
+
+      layer.values[i] = best_value;
+      layer.next[i] = best_index;
+    }
+  }
+
+  layer.valid = true;
+  return true;
 }
 
-void
-TaskDijkstra::AddEdges(const ScanTaskPoint curNode) noexcept
+bool
+TaskDijkstra::UpdateLayers() noexcept
 {
-  ScanTaskPoint destination(curNode.GetStageNumber() + 1, 0);
-  const unsigned dsize = GetStageSize(destination.GetStageNumber());
+  bool modified = false;
+
+  for (unsigned i = 0; i < num_stages; ++i) {
+    if (!modified && layers[i].valid)
+      continue;
+
+    modified = true;
+    if (!UpdateLayer(i)) {
+      layers[i].valid = false;
+      return false;
+    }
+  }
 
-  for (const ScanTaskPoint end(destination.GetStageNumber(), dsize);
-       destination != end; destination.IncrementPointIndex())
-    Link(destination, curNode, CalcDistance(curNode, destination));
+  if (modified)
+    /* the layers beyond the current task size were calculated from
+       old values; they may become relevant again if the task size
+       grows */
+    for (unsigned i = num_stages; i < MAX_STAGES; ++i)
+      layers[i].valid = false;
+
+  return true;
 }
 
-void
-TaskDijkstra::AddZeroStartEdges() noexcept
+inline TaskDijkstra::value_type
+TaskDijkstra::CalcStartValue(unsigned index,
+                             const SearchPoint &location) const noexcept
 {
-  const unsigned stage = 0;
-  ScanTaskPoint destination(stage, 0);
-  const unsigned dsize = GetStageSize(stage);
+  if (location.IsValid())
+    return static_cast<value_type>(GetPoint(0, index).GetLocation()
+                                   .Distance(location.GetLocation()));
 
   /* only the first start edge is really going to be zero; all
      following edges will be incremented, to add some bias preferring
@@ -48,31 +97,30 @@ TaskDijkstra::AddZeroStartEdges() noexcept
      observation zone; this prevents very rare miscalculations, which
      should never occur in real flights, but can fail our unit tests
      with synthetic input values */
-  value_type value = 0;
-
-  for (const ScanTaskPoint end(stage, dsize);
-       destination != end; destination.IncrementPointIndex())
-    LinkStart(destination, value++);
+  return index;
 }
 
-void
-TaskDijkstra::AddStartEdges(unsigned stage,
-                            const SearchPoint &currentLocation) noexcept
+bool
+TaskDijkstra::Run(const SearchPoint &location) noexcept
 {
-  assert(currentLocation.IsValid());
+  if (num_stages == 0 || !UpdateLayers())
+    return false;
 
-  ScanTaskPoint destination(stage, 0);
-  const unsigned dsize = GetStageSize(stage);
+  const Layer &first = GetLayer(0);
 
-  for (const ScanTaskPoint end(stage, dsize);
-       destination != end; destination.IncrementPointIndex())
-    LinkStart(destination, CalcDistance(destination, currentLocation));
-}
+  value_type best_value = std::numeric_limits<value_type>::max();
+  unsigned best_index = 0;
+  for (std::size_t i = 0; i < first.values.size(); ++i) {
+    const value_type value = CalcStartValue(i, location) + first.values[i];
+    if (value < best_value) {
+      best_value = value;
+      best_index = i;
+    }
+  }
 
-bool
-TaskDijkstra::Run() noexcept
-{
-  const bool retval = DistanceGeneral() == SolverResult::VALID;
-  dijkstra.Clear();
-  return retval;
+  solution[0] = best_index;
+  for (unsigned stage = 1; stage < num_stages; ++stage)
+    solution[stage] = GetLayer(stage - 1).next[solution[stage - 1]];
+
+  return true;
 }
@@ -3,9 +3,11 @@
 
 #pragma once
 
-#include "PathSolvers/NavDijkstra.hpp"
+#include "PathSolvers/Dijkstra.hpp" // for DIJKSTRA_MINMAX_OFFSET
 #include "Geo/SearchPoint.hpp"
 
+#include <array>
+#include <vector>
 #include <cassert>
 
 class OrderedTask;
@@ -15,25 +17,75 @@ class SearchPointVector;
  * Class used to scan an OrderedTask for maximum/minimum distance
  * points.
  *
- * Uses flat-projected integer representation of search points for
- * speed, but this also makes the system approximate.
- *
  * Search points are located on OZ boundaries and each form a convex
  * hull, as this produces the minimum search vector size without loss
  * of accuracy.
  *
  * Searches are sensitive to active task point, in that task points
  * before the active task point need only be searched for maximum achieved
- * distance rather than border search points. 
+ * distance rather than border search points.
  *
  * Before each calculation, set up this object with SetTaskSize() and
  * call SetBoundary() for each task point.
  *
- * This uses a Dijkstra search and so is O(N log(N)).
+ * The task is a layered graph without cycles, therefore this class
+ * does not need a priority queue; instead, it calculates the best
+ * path from each search point to the finish, one stage ("layer") at
+ * a time, beginning at the finish.  These layers are retained
+ * between calculations, and only the layers of modified stages
+ * (and the ones preceding them) are recalculated.  The layers are
+ * indexed from the finish, which means that advancing the active
+ * task point does not invalidate them.
  */
-class TaskDijkstra : protected NavDijkstra<>
+class TaskDijkstra
 {
-  const SearchPointVector *boundaries[MAX_STAGES];
+protected:
+  using value_type = unsigned;
+
+  static constexpr unsigned MAX_STAGES = 32;
+
+private:
+  struct Layer {
+    /**
+     * The search points of this stage.  This pointer and #serial
+     * are compared in SetBoundary() to detect modifications.
+     */
+    const SearchPointVector *boundary = nullptr;
+
+    unsigned serial = 0;
+
+    /**
+     * Are #values and #next up to date with #boundary and with the
+     * layer of the following stage?
+     */
+    bool valid = false;
+
+    /**
+     * The value of the best path from each search point to the
+     * finish.
+     */
+    std::vector<value_type> values;
+
+    /**
+     * The index of the search point in the following stage which is
+     * on the best path.
+     */
+    std::vector<unsigned> next;
+  };
+
+  /**
+   * The layers, indexed by the number of stages to the finish
+   * (i.e. the finish is always at index 0).
+   */
+  std::array<Layer, MAX_STAGES> layers;
+
+  /** Number of stages in search */
+  unsigned num_stages = 0;
+
+  /**
+   * An array containing the point index for each of the solution's stages.
+   */
+  unsigned solution[MAX_STAGES];
 
   const bool is_min;
 
@@ -45,14 +97,30 @@ public:
    */
   explicit TaskDijkstra(const bool is_min) noexcept;
 
+  TaskDijkstra(const TaskDijkstra &) = delete;
+  TaskDijkstra &operator=(const TaskDijkstra &) = delete;
+
   void SetTaskSize(unsigned size) noexcept {
-    SetStageCount(size);
+    assert(size <= MAX_STAGES);
+
+    num_stages = size;
   }
 
-  void SetBoundary(unsigned idx, const SearchPointVector &boundary) noexcept {
+  /**
+   * @param serial a number which changes whenever the contents of
+   * the #SearchPointVector change, see
+   * SampledTaskPoint::GetSearchPointsSerial()
+   */
+  void SetBoundary(unsigned idx, const SearchPointVector &boundary,
+                   unsigned serial) noexcept {
     assert(idx < num_stages);
 
-    boundaries[idx] = &boundary;
+    Layer &layer = GetLayer(idx);
+    if (layer.boundary != &boundary || layer.serial != serial) {
+      layer.boundary = &boundary;
+      layer.serial = serial;
+      layer.valid = false;
+    }
   }
 
   /**
@@ -62,73 +130,74 @@ public:
   const SearchPoint &GetSolution(unsigned stage) const noexcept {
     assert(stage < num_stages);
 
-    return GetPoint(ScanTaskPoint(stage, solution[stage]));
+    return GetPoint(stage, solution[stage]);
   }
 
 protected:
+  /**
+   * Update all invalid layers and find the best path.
+   *
+   * @param location the aircraft location; if it is invalid, a
+   * zero-length start edge is added to each point in the first stage
+   * @return false if there is no solution
+   */
+  bool Run(const SearchPoint &location) noexcept;
+
+private:
   [[gnu::pure]]
-  const SearchPoint &GetPoint(ScanTaskPoint sp) const noexcept;
+  Layer &GetLayer(unsigned stage) noexcept {
+    assert(stage < num_stages);
 
-  bool Run() noexcept;
+    return layers[num_stages - 1 - stage];
+  }
 
-  bool Link(const ScanTaskPoint node, const ScanTaskPoint parent,
-            value_type value) noexcept {
-    if (!is_min)
-      value = DIJKSTRA_MINMAX_OFFSET - value;
+  [[gnu::pure]]
+  const Layer &GetLayer(unsigned stage) const noexcept {
+    assert(stage < num_stages);
 
-    return NavDijkstra::Link(node, parent, value);
+    return layers[num_stages - 1 - stage];
   }
 
-  /**
-   * Add a zero-length start edge to each point in the first stage.
-   */
-  void AddZeroStartEdges() noexcept;
+  [[gnu::pure]]
+  const SearchPoint &GetPoint(unsigned stage,
+                              unsigned index) const noexcept;
 
   /**
-   * Add a start edge from the given location to each point in the
-   * given stage.
-   */
-  void AddStartEdges(unsigned stage, const SearchPoint &loc) noexcept;
-
-  /** 
-   * Distance function for free point
-   * 
-   * @param curNode Destination node
-   * @param currentLocation Origin location
-   * 
-   * @return Distance (flat) from origin to destination
+   * Distance function for edges
+   *
+   * @return Distance from origin to destination, converted to the
+   * value of the edge
    */
   [[gnu::pure]]
-  value_type CalcDistance(const ScanTaskPoint curNode,
-                          const SearchPoint &currentLocation) const noexcept {
+  value_type CalcEdgeValue(const SearchPoint &origin,
+                           const SearchPoint &destination) const noexcept {
     /* using expensive floating point formulas here to avoid integer
        rounding errors */
-
-    const GeoPoint &a = GetPoint(curNode).GetLocation();
-    const GeoPoint &b = currentLocation.GetLocation();
-
-    return static_cast<value_type>(a.Distance(b));
+    const auto distance = static_cast<value_type>(origin.GetLocation()
+                                                  .Distance(destination.GetLocation()));
+    return is_min ? distance : DIJKSTRA_MINMAX_OFFSET - distance;
   }
 
-  /** 
-   * Distance function for edges
-   * 
-   * @param s1 Origin node
-   * @param s2 Destination node
-   * 
-   * @return Distance (flat) from origin to destination
+  /**
+   * Recalculate the specified layer from the one following it.
+   *
+   * @return false if the stage has no search points
    */
-  [[gnu::pure]]
-  value_type CalcDistance(const ScanTaskPoint s1,
-                          const ScanTaskPoint s2) const noexcept {
-    return CalcDistance(s1, GetPoint(s2));
-  }
+  bool UpdateLayer(unsigned layer_index) noexcept;
 
-private:
-  [[gnu::pure]]
-  unsigned GetStageSize(const unsigned stage) const noexcept;
+  /**
+   * Recalculate all layers which are invalid, and all layers
+   * preceding them.
+   *
+   * @return false if a stage has no search points
+   */
+  bool UpdateLayers() noexcept;
 
-protected:
-  /* methods from NavDijkstra */
-  virtual void AddEdges(ScanTaskPoint curNode) noexcept final;
+  /**
+   * Calculate the value of the start edge leading to the given
+   * point in the first stage.
+   */
+  [[gnu::pure]]
+  value_type CalcStartValue(unsigned index,
+                            const SearchPoint &location) const noexcept;
 };
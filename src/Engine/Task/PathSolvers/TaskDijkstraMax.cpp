@@ -6,8 +6,5 @@
 bool
 TaskDijkstraMax::DistanceMax() noexcept
 {
-  dijkstra.Clear();
-  dijkstra.Reserve(256);
-  AddZeroStartEdges();
-  return Run();
+  return Run(SearchPoint::Invalid());
 }
@@ -6,15 +6,5 @@
 bool
 TaskDijkstraMin::DistanceMin(const SearchPoint &currentLocation) noexcept
 {
-  dijkstra.Clear();
-  dijkstra.Reserve(256);
-
-  if (currentLocation.IsValid()) {
-    AddStartEdges(0, currentLocation);
-  } else {
-    AddZeroStartEdges();
-  }
-
-  return Run();
+  return Run(currentLocation);
 }
-
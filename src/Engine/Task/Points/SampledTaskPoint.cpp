@@ -5,10 +5,15 @@
 #include "Task/ObservationZones/Boundary.hpp"
 #include "Navigation/Aircraft.hpp"
 
+#include <atomic>
+
+static std::atomic_uint next_serial;
+
 SampledTaskPoint::SampledTaskPoint(const GeoPoint &location,
                                    const bool b_scored) noexcept
   :boundary_scored(b_scored), past(false),
-   nominal_points(1, location)
+   nominal_points(1, location),
+   serial(++next_serial)
 {
 #ifndef NDEBUG
   search_max.SetInvalid();
@@ -16,6 +21,12 @@ SampledTaskPoint::SampledTaskPoint(const GeoPoint &location,
 #endif
 }
 
+void
+SampledTaskPoint::Modified() noexcept
+{
+  serial = ++next_serial;
+}
+
 // SAMPLES
 
 bool
@@ -32,6 +43,7 @@ SampledTaskPoint::AddInsideSample(const AircraftState& state,
   // add sample to polygon
   SearchPoint sp(state.location, projection);
   sampled_points.push_back(sp);
+  Modified();
 
   // re-compute convex hull
   bool retval = sampled_points.PruneInterior();
@@ -52,6 +64,7 @@ SampledTaskPoint::ClearSampleAllButLast(const AircraftState& ref_last,
     sampled_points.clear();
     SearchPoint sp(ref_last.location, projection);
     sampled_points.push_back(sp);
+    Modified();
   }
 }
 
@@ -68,6 +81,7 @@ SampledTaskPoint::UpdateOZ(const FlatProjection &projection,
     boundary_points.push_back(sp);
 
   UpdateProjection(projection);
+  Modified();
 }
 
 // SAMPLES + BOUNDARY
@@ -86,6 +100,7 @@ void
 SampledTaskPoint::Reset() noexcept
 {
   sampled_points.clear();
+  Modified();
 }
 
 const SearchPointVector &
@@ -40,6 +40,13 @@ class SampledTaskPoint {
   SearchPoint search_max;
   SearchPoint search_min;
 
+  /**
+   * A process-wide unique number which changes whenever one of the
+   * #SearchPointVector attributes is modified.  This allows
+   * #TaskDijkstra to keep results for unmodified task points.
+   */
+  unsigned serial;
+
 public:
   /**
    * Constructor.  Clears boundary and interior samples on
@@ -149,9 +156,21 @@ public:
     return boundary_scored;
   }
 
+  /**
+   * Returns a number which identifies the current contents of all
+   * #SearchPointVector attributes.  It changes each time one of
+   * them is modified.
+   */
+  unsigned GetSearchPointsSerial() const noexcept {
+    return serial;
+  }
+
 protected:
   void SetPast(bool _past) noexcept {
-    past = _past;
+    if (_past != past) {
+      past = _past;
+      Modified();
+    }
   }
 
   /**
@@ -163,6 +182,8 @@ protected:
                              const FlatProjection &projection) noexcept;
 
 private:
+  void Modified() noexcept;
+
   /**
    * Re-project boundary and interior sample polygons.
    * Must be called if task_projection changes.
@@ -6,10 +6,14 @@
 #include "AlternateList.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
-#include "Task/Solvers/TaskSolution.hpp"
+#include "Task/TaskBehaviour.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "GlideSolvers/GlideState.hpp"
+#include "GlideSolvers/MacCready.hpp"
 #include "Waypoint/Waypoints.hpp"
 
+#include <algorithm>
+
 /** min search range in m */
 static constexpr double min_search_range = 50000;
 
@@ -98,61 +102,57 @@ IsReachable(const GlideResult &result, bool final_glide) noexcept
 }
 
 bool
-AbortTask::FillReachable(const AircraftState &state,
-                         AlternateList &approx_waypoints,
-                         const GlidePolar &polar, bool only_airfield,
-                         bool final_glide, [[maybe_unused]] bool safety) noexcept
+AbortTask::FillReachable(AlternateList &approx_waypoints,
+                         bool only_airfield, bool final_glide) noexcept
 {
   if (IsTaskFull() || approx_waypoints.empty())
     return false;
 
-  const AGeoPoint p_start(state.location, state.altitude);
-
   bool found_final_glide = false;
   AlternateList q;
   q.reserve(32);
 
-  for (auto v = approx_waypoints.begin(); v != approx_waypoints.end();) {
-    if (only_airfield && !v->waypoint->IsAirport()) {
-      ++v;
-      continue;
-    }
-
-    UnorderedTaskPoint t(v->waypoint, task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
+  /* move the reachable candidates to "q", and compact the remaining
+     ones (preserving their order) */
+  auto dest = approx_waypoints.begin();
+  for (auto &v : approx_waypoints) {
+    const GlideResult &result = v.solution;
 
-    if (IsReachable(result, final_glide)) {
+    if ((!only_airfield || v.waypoint->IsAirport()) &&
+        IsReachable(result, final_glide)) {
       bool intersects = false;
       const bool is_reachable_final = IsReachable(result, true);
 
       if (intersection_test && final_glide && is_reachable_final)
         intersects = intersection_test->Intersects(
-            AGeoPoint(v->waypoint->location, result.min_arrival_altitude));
+            AGeoPoint(v.waypoint->location, result.min_arrival_altitude));
 
       if (!intersects) {
-        q.emplace_back(v->waypoint, result);
-        // remove it since it's already in the list now      
-        v = approx_waypoints.erase(v);
+        q.emplace_back(std::move(v));
 
         if (is_reachable_final)
           found_final_glide = true;
 
-        continue; // skip incrementing v since we just erased it
+        continue;
       }
-    } 
+    }
 
-    ++v;
+    if (&*dest != &v)
+      *dest = std::move(v);
+    ++dest;
   }
 
-  /* sort by arrival time */
-  std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
+  approx_waypoints.erase(dest, approx_waypoints.end());
+
+  /* sort by arrival time; only the ones which fit into the task are
+     needed */
+  const auto n = std::min(q.size(), max_abort - task_points.size());
+  std::partial_sort(q.begin(), std::next(q.begin(), n), q.end(),
+                    [](const auto &x, const auto &y){
     return x.solution.time_elapsed + x.solution.time_virtual <
       y.solution.time_elapsed + y.solution.time_virtual;
   });
 
-  const auto n = std::min(q.size(), max_abort - task_points.size());
   for (std::size_t j = 0; j < n; ++j) {
     auto &top = q[j];
     task_points.emplace_back(std::move(top.waypoint), task_behaviour,
@@ -166,6 +166,59 @@ AbortTask::FillReachable(const AircraftState &state,
   return found_final_glide;
 }
 
+void
+AbortTask::UpdateCandidates(const GeoPoint &location,
+                            const double range) noexcept
+{
+  if (candidate_center.IsValid() &&
+      waypoints_serial == waypoints.GetSerial() &&
+      candidate_center.DistanceS(location) + range <= candidate_radius)
+    /* still up to date */
+    return;
+
+  candidates.clear();
+  candidate_center = location;
+  candidate_radius = range + candidate_margin;
+  waypoints_serial = waypoints.GetSerial();
+
+  waypoints.VisitWithinRange(location, candidate_radius,
+                             [this](const WaypointPtr &wp){
+                               if (wp->IsLandable())
+                                 candidates.push_back(wp);
+                             });
+}
+
+void
+AbortTask::SolveCandidates(const AircraftState &state,
+                           const GlidePolar &glide_polar, double range,
+                           AlternateList &approx_waypoints) const noexcept
+{
+  if (candidates.empty())
+    return;
+
+  const auto in_range = waypoints.GetRangeFilter(state.location, range);
+
+  /* all solutions share the same settings and polar, so one solver
+     instance is used for all of them, and each candidate is solved
+     only once per update (not once per FillReachable() pass) */
+  const MacCready mac_cready(task_behaviour.glide, glide_polar);
+
+  for (const auto &wp : candidates) {
+    if (!in_range(*wp))
+      continue;
+
+    /* this is what GlideState::Remaining() calculates for an
+       UnorderedTaskPoint */
+    const GlideState gs(GeoVector(state.location, wp->location),
+                        std::max(0.,
+                                 wp->GetElevationOrZero() +
+                                 task_behaviour.safety_height_arrival),
+                        state.altitude, state.wind);
+
+    approx_waypoints.emplace_back(wp, mac_cready.Solve(gs));
+  }
+}
+
 void
 AbortTask::ClientUpdate([[maybe_unused]] const AircraftState &state_now,
                         [[maybe_unused]] bool reachable) noexcept
@@ -196,14 +249,13 @@ AbortTask::UpdateSample(const AircraftState &state,
     /* can't work without a polar */
     return false;
 
+  const double range = GetAbortRange(state, glide_polar);
+  UpdateCandidates(state.location, range);
+
   AlternateList approx_waypoints;
-  approx_waypoints.reserve(128);
+  approx_waypoints.reserve(candidates.size());
+  SolveCandidates(state, glide_polar, range, approx_waypoints);
 
-  waypoints.VisitWithinRange(state.location,
-                             GetAbortRange(state, glide_polar), [&approx_waypoints](const auto &wp){
-                               if (wp->IsLandable())
-                                 approx_waypoints.emplace_back(wp);
-                             });
   if (approx_waypoints.empty()) {
     /** @todo increase range */
     return false;
@@ -212,16 +264,14 @@ AbortTask::UpdateSample(const AircraftState &state,
   // sort by arrival time
 
   // first try with final glide only
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       true, true, true);
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       false, true, true);
+  reachable_landable |= FillReachable(approx_waypoints, true, true);
+  reachable_landable |= FillReachable(approx_waypoints, false, true);
 
   // inform clients that the landable reachable scan has been performed 
   ClientUpdate(state, true);
 
   // now try without final glide constraint and not preferring airports
-  FillReachable(state, approx_waypoints, glide_polar, false, false, false);
+  FillReachable(approx_waypoints, false, false);
 
   // inform clients that the landable unreachable scan has been performed 
   ClientUpdate(state, false);
@@ -250,6 +300,8 @@ void
 AbortTask::Reset() noexcept
 {
   Clear();
+  candidates.clear();
+  candidate_center = GeoPoint::Invalid();
   UnorderedTask::Reset();
 }
 
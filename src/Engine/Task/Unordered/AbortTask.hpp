@@ -5,6 +5,8 @@
 
 #include "UnorderedTask.hpp"
 #include "UnorderedTaskPoint.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "util/Serial.hpp"
 
 #include <vector>
 #include <cassert>
@@ -48,6 +50,12 @@ private:
   /** max number of items in list */
   static constexpr AlternateTaskVector::size_type max_abort = 10;
 
+  /**
+   * The landable candidates are collected within this radius [m]
+   * beyond the abort range.
+   */
+  static constexpr double candidate_margin = 10000;
+
   /** whether the AbortTask is the master or running in background */
   bool is_active;
 
@@ -59,6 +67,23 @@ private:
   unsigned active_waypoint;
   bool reachable_landable;
 
+  /**
+   * The landable waypoints within #candidate_radius around
+   * #candidate_center, in the order returned by
+   * Waypoints::VisitWithinRange().  This is reused by each update
+   * until the aircraft leaves the area (or the abort range grows),
+   * instead of querying the waypoint tree each time.
+   */
+  std::vector<WaypointPtr> candidates;
+
+  GeoPoint candidate_center = GeoPoint::Invalid();
+  double candidate_radius;
+
+  /**
+   * The Waypoints::GetSerial() value when #candidates was collected.
+   */
+  Serial waypoints_serial;
+
 public:
   /** 
    * Base constructor.
@@ -140,19 +165,30 @@ protected:
    * waypoints satisfying approximate range queries.  Can be used
    * to add airfields only, or landpoints.
    *
-   * @param state Aircraft state
-   * @param approx_waypoints List of candidate waypoints
-   * @param polar Polar used for tests
+   * @param approx_waypoints List of candidate waypoints with their
+   * glide solutions; the ones which were found reachable are removed
    * @param only_airfield If true, only add waypoints that are airfields.
    * @param final_glide Whether solution must be glide only or climb allowed
-   * @param safety Whether solution uses safety polar
    *
    * @return True if a landpoint within final glide was found
    */
-  bool FillReachable(const AircraftState &state,
-                     AlternateList &approx_waypoints,
-                     const GlidePolar &polar, bool only_airfield,
-                     bool final_glide, bool safety) noexcept;
+  bool FillReachable(AlternateList &approx_waypoints,
+                     bool only_airfield, bool final_glide) noexcept;
+
+private:
+  /**
+   * Ensure that #candidates covers the given range around the
+   * location, and query the waypoint tree again if it does not.
+   */
+  void UpdateCandidates(const GeoPoint &location, double range) noexcept;
+
+  /**
+   * Copy all #candidates within range to the list, and calculate a
+   * glide solution for each of them.
+   */
+  void SolveCandidates(const AircraftState &state,
+                       const GlidePolar &glide_polar, double range,
+                       AlternateList &approx_waypoints) const noexcept;
 
 protected:
   /**
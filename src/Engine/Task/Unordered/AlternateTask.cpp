@@ -6,6 +6,8 @@
 #include "Geo/Math.hpp"
 #include "Navigation/Aircraft.hpp"
 
+#include <algorithm>
+
 AlternateTask::AlternateTask(const TaskBehaviour &tb,
                              const Waypoints &wps) noexcept
   :AbortTask(tb, wps)
@@ -55,13 +57,14 @@ AlternateTask::ClientUpdate(const AircraftState &state_now,
     q.emplace_back(std::move(wp), i.solution, delta);
   }
 
-  /* sort by distance diversion */
-  std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
+  /* sort by distance diversion; only the best ones are needed */
+  const auto n = std::min(q.size(), max_alternates);
+  std::partial_sort(q.begin(), std::next(q.begin(), n), q.end(),
+                    [](const auto &x, const auto &y){
     return x.delta > y.delta;
   });
 
   // now push results onto the list, best first.
-  const auto n = std::min(q.size(), max_alternates);
   for (std::size_t i = 0; i < n; ++i) {
     AlternatePoint &top = q[i];
 
@@ -3,37 +3,36 @@
 
 #include "Trace.hpp"
 #include "Vector.hpp"
-#include "util/GlobalSliceAllocator.hxx"
 
 #include <algorithm>
 #include <iterator>
+#include <numeric>
 
 Trace::Trace(const Time _no_thin_time, const Time max_time,
              const unsigned max_size) noexcept
-  :cached_size(0),
-   max_time(max_time),
+  :max_time(max_time),
    no_thin_time(_no_thin_time),
    max_size(max_size),
    opt_size((3 * max_size) / 4)
 {
   assert(max_size >= 4);
+
+  /* reserve all memory now; this guarantees that push_back() never
+     moves existing points */
+  points.reserve(max_size);
+  deltas.reserve(max_size);
+  heap.reserve(max_size);
 }
 
 void
 Trace::clear() noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   average_delta_distance = 0;
   average_delta_time = {};
 
-  delta_list.clear();
-  chronological_list.clear_and_dispose(MakeDisposer());
-  cached_size = 0;
-
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
+  points.clear();
+  deltas.clear();
+  heap.clear();
 
   ++modify_serial;
   ++append_serial;
@@ -53,101 +52,207 @@ Trace::GetRecentTime(const Time t) const noexcept
 }
 
 void
-Trace::UpdateDelta(TraceDelta &td) noexcept
+Trace::HeapSiftUp(unsigned position) noexcept
+{
+  const unsigned i = heap[position];
+
+  while (position > 0) {
+    const unsigned parent = (position - 1) / 2;
+    if (!DeltaRank(i, heap[parent]))
+      break;
+
+    HeapSet(position, heap[parent]);
+    position = parent;
+  }
+
+  HeapSet(position, i);
+}
+
+void
+Trace::HeapSiftDown(unsigned position) noexcept
+{
+  const unsigned i = heap[position];
+  const unsigned n = heap.size();
+
+  while (true) {
+    unsigned child = 2 * position + 1;
+    if (child >= n)
+      break;
+
+    if (child + 1 < n && DeltaRank(heap[child + 1], heap[child]))
+      ++child;
+
+    if (!DeltaRank(heap[child], i))
+      break;
+
+    HeapSet(position, heap[child]);
+    position = child;
+  }
+
+  HeapSet(position, i);
+}
+
+void
+Trace::HeapPush(unsigned i) noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
+  assert(deltas[i].heap_index == NOT_QUEUED);
 
-  if (&td == &chronological_list.front() ||
-      &td == &chronological_list.back())
+  heap.push_back(i);
+  HeapSiftUp(heap.size() - 1);
+}
+
+void
+Trace::HeapRemove(unsigned i) noexcept
+{
+  const unsigned position = deltas[i].heap_index;
+  if (position == NOT_QUEUED)
     return;
 
-  const auto ci = chronological_list.iterator_to(td);
-  const TraceDelta &previous = *std::prev(ci);
-  const TraceDelta &next = *std::next(ci);
+  assert(position < heap.size());
+  assert(heap[position] == i);
 
-  delta_list.erase(delta_list.iterator_to(td));
-  td.Update(previous.point, next.point);
-  delta_list.insert(td);
+  deltas[i].heap_index = NOT_QUEUED;
+
+  const unsigned last = heap.back();
+  heap.pop_back();
+
+  if (last == i)
+    return;
+
+  /* move the last item into the gap, and restore the heap order */
+  HeapSet(position, last);
+  if (position > 0 && DeltaRank(last, heap[(position - 1) / 2]))
+    HeapSiftUp(position);
+  else
+    HeapSiftDown(position);
 }
 
 void
-Trace::EraseInside(DeltaList::iterator it) noexcept
+Trace::UpdateDelta(unsigned i, unsigned previous, unsigned next) noexcept
 {
-  assert(cached_size > 0);
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-  assert(it != delta_list.end());
-
-  const TraceDelta &td = *it;
-  assert(!td.IsEdge());
-
-  const auto ci = chronological_list.iterator_to(td);
-  TraceDelta &previous = const_cast<TraceDelta &>(*std::prev(ci));
-  TraceDelta &next = const_cast<TraceDelta &>(*std::next(ci));
-
-  // now delete the item
-  chronological_list.erase(chronological_list.iterator_to(td));
-  delta_list.erase_and_dispose(it, MakeDisposer());
-  --cached_size;
-
-  // and update the deltas
-  UpdateDelta(previous);
-  UpdateDelta(next);
+  Delta &delta = deltas[i];
+  delta.Update(points[previous], points[i], points[next]);
+
+  if (delta.heap_index == NOT_QUEUED)
+    return;
+
+  const unsigned position = delta.heap_index;
+  if (position > 0 && DeltaRank(i, heap[(position - 1) / 2]))
+    HeapSiftUp(position);
+  else
+    HeapSiftDown(position);
 }
 
 bool
 Trace::EraseDelta(const unsigned target_size, const Time recent) noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   if (size() <= 2)
     return false;
 
-  bool modified = false;
-
   const Time recent_time = GetRecentTime(recent);
 
-  auto candidate = delta_list.begin();
-  while (size() > target_size) {
-    const TraceDelta &td = *candidate;
-    if (!td.IsEdge() && td.point.GetTime() < recent_time) {
-      EraseInside(candidate);
-      candidate = delta_list.begin(); // find new top
-      modified = true;
-    } else {
-      ++candidate;
+  /* the chronological neighbours of each point; erased points are
+     only marked until Compact() is called */
+  const unsigned n = size();
+  std::vector<unsigned> previous(n), next(n);
+  std::iota(previous.begin(), previous.end(), 0u - 1);
+  std::iota(next.begin(), next.end(), 1u);
+
+  /* points which may not be removed; they are taken out of the heap
+     temporarily */
+  std::vector<unsigned> suppressed;
+
+  unsigned remaining = n;
+  while (remaining > target_size && !heap.empty()) {
+    const unsigned i = heap.front();
+    HeapRemove(i);
+
+    if (points[i].GetTime() >= recent_time) {
       // suppressed removal, skip it.
+      suppressed.push_back(i);
+      continue;
     }
+
+    deltas[i].heap_index = REMOVED;
+    --remaining;
+
+    const unsigned p = previous[i], nx = next[i];
+    next[p] = nx;
+    previous[nx] = p;
+
+    // and update the deltas
+    if (p > 0)
+      UpdateDelta(p, previous[p], nx);
+    if (nx < n - 1)
+      UpdateDelta(nx, p, next[nx]);
   }
 
-  return modified;
+  for (const unsigned i : suppressed)
+    HeapPush(i);
+
+  if (remaining == n)
+    return false;
+
+  Compact();
+  return true;
+}
+
+void
+Trace::Compact() noexcept
+{
+  const unsigned n = size();
+
+  /* maps old indices to new ones */
+  std::vector<unsigned> new_index(n);
+
+  unsigned dest = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    if (deltas[i].heap_index == REMOVED)
+      continue;
+
+    new_index[i] = dest;
+    if (dest != i) {
+      points[dest] = points[i];
+      deltas[dest] = deltas[i];
+    }
+
+    ++dest;
+  }
+
+  points.resize(dest);
+  deltas.resize(dest);
+
+  /* the order of the heap is not affected */
+  for (auto &i : heap)
+    i = new_index[i];
 }
 
 bool
 Trace::EraseEarlierThan(const Time p_time) noexcept
 {
-  if (p_time == Time{} || empty() || GetFront().point.GetTime() >= p_time)
+  if (p_time == Time{} || empty() || front().GetTime() >= p_time)
     // there will be nothing to remove
     return false;
 
-  do {
-    auto ci = chronological_list.begin();
-    TraceDelta &td = *ci;
-    chronological_list.erase(ci);
+  const unsigned n_erase =
+    std::distance(points.begin(),
+                  std::partition_point(points.begin(), points.end(),
+                                       [p_time](const TracePoint &i){
+                                         return i.GetTime() < p_time;
+                                       }));
+
+  for (unsigned i = 0; i < n_erase; ++i)
+    HeapRemove(i);
 
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
+  points.erase(points.begin(), std::next(points.begin(), n_erase));
+  deltas.erase(deltas.begin(), std::next(deltas.begin(), n_erase));
 
-    --cached_size;
-  } while (!empty() && GetFront().point.GetTime() < p_time);
+  for (auto &i : heap)
+    i -= n_erase;
 
-  // need to set deltas for first point, only one of these
-  // will occur (have to search for this point)
+  // need to set deltas for first point
   if (!empty())
-    EraseStart(GetFront());
+    EraseStart(0);
 
   ++modify_serial;
   ++append_serial;
@@ -160,44 +265,30 @@ Trace::EraseLaterThan(const Time min_time) noexcept
   assert(min_time.count() > 0);
   assert(!empty());
 
-  while (!empty() && GetBack().point.GetTime() > min_time) {
-    TraceDelta &td = GetBack();
-
-    chronological_list.erase(chronological_list.iterator_to(td));
-
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
-
-    --cached_size;
+  while (!empty() && back().GetTime() > min_time) {
+    HeapRemove(size() - 1);
+    points.pop_back();
+    deltas.pop_back();
   }
 
-  /* need to set deltas for first point, only one of these will occur
-     (have to search for this point) */
+  /* need to set deltas for the last point */
   if (!empty())
-    EraseStart(GetBack());
+    EraseStart(size() - 1);
 }
 
-/**
- * Update start node (and neighbour) after min time pruning
- */
 void
-Trace::EraseStart(TraceDelta &td) noexcept
+Trace::EraseStart(unsigned i) noexcept
 {
-  delta_list.erase(delta_list.iterator_to(td));
-
-  td.elim_distance = null_delta;
-  td.elim_time = null_time;
+  HeapRemove(i);
 
-  delta_list.insert(td);
+  Delta &delta = deltas[i];
+  delta.elim_distance = null_delta;
+  delta.elim_time = null_time;
 }
 
 void
 Trace::push_back(const TracePoint &point) noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   const Time min_delta = std::chrono::seconds{2};
 
   if (empty()) {
@@ -230,17 +321,17 @@ Trace::push_back(const TracePoint &point) noexcept
 
   assert(size() < max_size);
 
-  TraceDelta *td = allocator.allocate(1);
-  std::allocator_traits<Allocator>::construct(allocator, td, point);
-  td->point.Project(task_projection);
-
-  delta_list.insert(*td);
-  chronological_list.push_back(*td);
-
-  ++cached_size;
+  points.push_back(point);
+  points.back().Project(task_projection);
+  deltas.push_back(Delta::Edge());
 
-  if (td != &chronological_list.front())
-    UpdateDelta(*std::prev(chronological_list.iterator_to(*td)));
+  /* the previous last point is not an edge anymore */
+  const unsigned n = size();
+  if (n >= 3) {
+    const unsigned i = n - 2;
+    deltas[i].Update(points[i - 1], points[i], points[i + 1]);
+    HeapPush(i);
+  }
 
   ++append_serial;
 }
@@ -252,10 +343,9 @@ Trace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
   unsigned acc = 0;
   unsigned counter = 0;
 
-  const auto end = chronological_list.end();
-  for (auto it = chronological_list.begin();
-       it != end && it->point.GetTime() < r; ++it, ++counter)
-    acc += it->delta_distance;
+  for (unsigned n = size(); counter < n && points[counter].GetTime() < r;
+       ++counter)
+    acc += deltas[counter].delta_distance;
 
   if (counter)
     return acc / counter;
@@ -267,22 +357,21 @@ Trace::Time
 Trace::CalcAverageDeltaTime(const Time no_thin) const noexcept
 {
   const Time r = GetRecentTime(no_thin);
-  unsigned counter = 0;
 
   /* find the last item before the "r" timestamp */
-  const auto end = chronological_list.end();
-  ChronologicalList::const_iterator it;
-  for (it = chronological_list.begin(); it != end && it->point.GetTime() < r; ++it)
-    ++counter;
+  const auto it = std::find_if(points.begin(), points.end(),
+                               [r](const TracePoint &i){
+                                 return i.GetTime() >= r;
+                               });
+  unsigned counter = std::distance(points.begin(), it);
 
   if (counter < 2)
     return {};
 
-  --it;
   --counter;
 
   Time start_time = front().GetTime();
-  Time end_time = it->point.GetTime();
+  Time end_time = std::prev(it)->GetTime();
   return (end_time - start_time) / counter;
 }
 
@@ -323,8 +412,6 @@ Trace::Thin2() noexcept
 void
 Trace::Thin() noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
   assert(size() == max_size);
 
   Thin2();
@@ -341,60 +428,11 @@ Trace::Thin() noexcept
 void
 Trace::GetPoints(TracePointVector& iov) const noexcept
 {
-  iov.clear();
-  iov.reserve(size());
-  std::copy(begin(), end(), std::back_inserter(iov));
-}
-
-template<typename I>
-class PointerIterator {
-  I i;
-
-public:
-  typedef typename I::iterator_category iterator_category;
-  typedef typename I::pointer value_type;
-  typedef typename I::pointer *pointer;
-  typedef value_type &reference;
-  typedef typename I::difference_type difference_type;
-
-  PointerIterator() = default;
-  explicit PointerIterator(I _i) noexcept:i(_i) {}
-
-  PointerIterator<I> &operator--() noexcept {
-    --i;
-    return *this;
-  }
-
-  PointerIterator<I> &operator++() noexcept {
-    ++i;
-    return *this;
-  }
-
-  typename I::pointer operator*() noexcept {
-    return &*i;
-  }
-
-  bool operator==(const PointerIterator<I> &other) const noexcept {
-    return i == other.i;
-  }
-
-  bool operator!=(const PointerIterator<I> &other) const noexcept {
-    return i != other.i;
-  }
-};
-
-void
-Trace::GetPoints(TracePointerVector &v) const noexcept
-{
-  v.clear();
-  v.reserve(size());
-  std::copy(PointerIterator<decltype(begin())>(begin()),
-            PointerIterator<decltype(end())>(end()),
-            std::back_inserter(v));
+  iov.assign(points.begin(), points.end());
 }
 
 bool
-Trace::SyncPoints(TracePointerVector &v) const noexcept
+Trace::SyncPoints(TracePointVector &v) const noexcept
 {
   assert(v.size() <= size());
 
@@ -402,11 +440,7 @@ Trace::SyncPoints(TracePointerVector &v) const noexcept
     /* no news */
     return false;
 
-  v.reserve(size());
-
-  PointerIterator<decltype(end())> e(end());
-  std::copy(std::prev(e, size() - v.size()), e,
-            std::back_inserter(v));
+  v.insert(v.end(), std::next(points.begin(), v.size()), points.end());
   assert(v.size() == size());
   return true;
 }
@@ -417,28 +451,26 @@ Trace::GetPoints(TracePointVector &v, const Time min_time,
                  double min_distance) const noexcept
 {
   /* skip the trace points that are before min_time */
-  Trace::const_iterator i = begin(), end = this->end();
-  unsigned skipped = 0;
-  while (true) {
-    if (i == end)
-      /* nothing left */
-      return;
-
-    if (i->GetTime() >= min_time)
-      /* found the first point that is within range */
-      break;
-
-    ++i;
-    ++skipped;
-  }
-
-  assert(skipped < size());
+  auto i = std::partition_point(points.begin(), points.end(),
+                                [min_time](const TracePoint &p){
+                                  return p.GetTime() < min_time;
+                                });
+  if (i == points.end())
+    /* nothing left */
+    return;
 
-  v.reserve(size() - skipped);
+  v.reserve(std::distance(i, points.end()));
   const unsigned range = ProjectRange(location, min_distance);
   const unsigned sq_range = range * range;
+
+  const auto end = points.end();
   do {
-    v.push_back(*i);
-    i.NextSquareRange(sq_range, end);
+    const TracePoint &previous = *i;
+    v.push_back(previous);
+
+    /* skip points closer than the resolution */
+    do {
+      ++i;
+    } while (i != end && i->FlatSquareDistanceTo(previous) < sq_range);
   } while (i != end);
 }
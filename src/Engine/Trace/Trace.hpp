@@ -5,21 +5,17 @@
 
 #include "Point.hpp"
 #include "util/NonCopyable.hpp"
-#include "util/Sanitizer.hxx"
-#include "util/SliceAllocator.hxx"
 #include "util/Serial.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 #include "time/Stamp.hpp"
 
-#include <boost/intrusive/list.hpp>
-#include <boost/intrusive/set.hpp>
 #include <algorithm>
 #include <cassert>
-#include <type_traits>
+#include <span>
+#include <vector>
 #include <stdlib.h>
 
 class TracePointVector;
-class TracePointerVector;
 
 /**
  * This class uses a smart thinning algorithm to limit the number of items
@@ -30,74 +26,32 @@ class TracePointerVector;
  * the candidate point removed.  In this version, time differences is also a
  * secondary factor, such that thinning attempts to remove points such that,
  * for equal distance ranking, smaller time step details are removed first.
+ *
+ * The points are stored in a contiguous array (which solvers can
+ * access without copying, see GetPoints()), and the thinning
+ * candidates are managed in an index-based binary heap.
  */
 class Trace : private NonCopyable
 {
   using Time = TracePoint::Time;
 
-  struct TraceDelta
-    : boost::intrusive::set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
-      boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>> {
-
-    /**
-     * Function used to points for sorting by deltas.
-     * Ranking is primarily by distance delta; for equal distances, rank by
-     * time delta.
-     * This is like a modified Douglas-Peuker algorithm
-     */
-    [[gnu::pure]]
-    static constexpr bool DeltaRank(const TraceDelta &x,
-                                    const TraceDelta &y) noexcept {
-      // distance is king
-      if (x.elim_distance < y.elim_distance)
-        return true;
-
-      if (x.elim_distance > y.elim_distance)
-        return false;
-
-      // distance is equal, so go by time error
-      if (x.elim_time < y.elim_time)
-        return true;
-
-      if (x.elim_time > y.elim_time)
-        return false;
-
-      // all else fails, go by age
-      if (x.point.IsOlderThan(y.point))
-        return true;
-
-      if (x.point.IsNewerThan(y.point))
-        return false;
-
-      return false;
-    }
-
-    struct DeltaRankOp {
-      constexpr bool operator()(const TraceDelta &s1,
-                                const TraceDelta &s2) const noexcept {
-        return DeltaRank(s1, s2);
-      }
-    };
-
-    TracePoint point;
-
+  /**
+   * Thinning information about a point.  It is stored in #deltas at
+   * the same index as the point in #points.
+   */
+  struct Delta {
     Time elim_time;
     unsigned elim_distance;
     unsigned delta_distance;
 
-    explicit TraceDelta(const TracePoint &p) noexcept
-      :point(p),
-       elim_time(null_time), elim_distance(null_delta),
-       delta_distance(0) {}
-
-    TraceDelta(const TracePoint &p_last, const TracePoint &p,
-               const TracePoint &p_next) noexcept
-      :point(p),
-       elim_time(TimeMetric(p_last, p, p_next)),
-       elim_distance(DistanceMetric(p_last, p, p_next)),
-       delta_distance(p.FlatDistanceTo(p_last))
-    {
-      assert(elim_distance != null_delta);
+    /**
+     * The position of this point in #heap, or one of the special
+     * values #NOT_QUEUED and #REMOVED.
+     */
+    unsigned heap_index;
+
+    static constexpr Delta Edge(unsigned delta_distance=0) noexcept {
+      return {null_time, null_delta, delta_distance, NOT_QUEUED};
     }
 
     /**
@@ -107,76 +61,70 @@ class Trace : private NonCopyable
       return elim_time == null_time;
     }
 
-    void Update(const TracePoint &p_last, const TracePoint &p_next) noexcept {
+    void Update(const TracePoint &p_last, const TracePoint &point,
+                const TracePoint &p_next) noexcept {
       elim_time = TimeMetric(p_last, point, p_next);
       elim_distance = DistanceMetric(p_last, point, p_next);
       delta_distance = point.FlatDistanceTo(p_last);
-    }
-
-    /**
-     * Calculate error distance, between last through this to next,
-     * if this node is removed.  This metric provides for Douglas-Peuker
-     * thinning.
-     *
-     * @param last Point previous in time to this node
-     * @param node This node
-     * @param next Point succeeding this node
-     *
-     * @return Distance error if this node is thinned
-     */
-    [[gnu::pure]]
-    static unsigned DistanceMetric(const TracePoint &last,
-                                   const TracePoint &node,
-                                   const TracePoint &next) noexcept {
-      const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
-      const int d_rem = last.FlatDistanceTo(next);
-      return abs(d_this - d_rem);
-    }
-
-    /**
-     * Calculate error time, between last through this to next,
-     * if this node is removed.  This metric provides for fair thinning
-     * (tendency to to result in equal time steps)
-     *
-     * @param last Point previous in time to this node
-     * @param node This node
-     * @param next Point succeeding this node
-     *
-     * @return Time delta if this node is thinned
-     */
-    static constexpr Time TimeMetric(const TracePoint &last,
-                                     const TracePoint &node,
-                                     const TracePoint &next) noexcept {
-      return next.DeltaTime(last)
-        - std::min(next.DeltaTime(node), node.DeltaTime(last));
+      assert(elim_distance != null_delta);
     }
   };
 
-  /* using multiset, not because we need multiple values (we don't),
-     but to avoid set's overhead for duplicate elimination */
-  typedef boost::intrusive::multiset<TraceDelta,
-                                     boost::intrusive::compare<TraceDelta::DeltaRankOp>,
-                                     boost::intrusive::constant_time_size<false>> DeltaList;
+  /**
+   * Calculate error distance, between last through this to next,
+   * if this node is removed.  This metric provides for Douglas-Peuker
+   * thinning.
+   *
+   * @param last Point previous in time to this node
+   * @param node This node
+   * @param next Point succeeding this node
+   *
+   * @return Distance error if this node is thinned
+   */
+  [[gnu::pure]]
+  static unsigned DistanceMetric(const TracePoint &last,
+                                 const TracePoint &node,
+                                 const TracePoint &next) noexcept {
+    const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
+    const int d_rem = last.FlatDistanceTo(next);
+    return abs(d_this - d_rem);
+  }
 
-  typedef boost::intrusive::list<TraceDelta,
-                                 boost::intrusive::constant_time_size<false>> ChronologicalList;
+  /**
+   * Calculate error time, between last through this to next,
+   * if this node is removed.  This metric provides for fair thinning
+   * (tendency to to result in equal time steps)
+   *
+   * @param last Point previous in time to this node
+   * @param node This node
+   * @param next Point succeeding this node
+   *
+   * @return Time delta if this node is thinned
+   */
+  static constexpr Time TimeMetric(const TracePoint &last,
+                                   const TracePoint &node,
+                                   const TracePoint &next) noexcept {
+    return next.DeltaTime(last)
+      - std::min(next.DeltaTime(node), node.DeltaTime(last));
+  }
 
   /**
-   * Use a SliceAllocator for allocating TraceDelta instances.  This
-   * reduces a lot of allocation overhead (both CPU and memory),
-   * because there will be lots of these objects.  Fall back to
-   * std::allocator when compiled with AddressSanitizer, because that
-   * avoids hiding memory errors.
+   * All points, sorted by time.  The capacity is reserved in the
+   * constructor, therefore appending never moves existing points.
    */
-  using Allocator = std::conditional_t<HaveAddressSanitizer(),
-                                       std::allocator<TraceDelta>,
-                                       SliceAllocator<TraceDelta, 128u>>;
+  std::vector<TracePoint> points;
 
-  Allocator allocator;
+  /**
+   * Thinning information, parallel to #points.
+   */
+  std::vector<Delta> deltas;
 
-  DeltaList delta_list;
-  ChronologicalList chronological_list;
-  unsigned cached_size;
+  /**
+   * A binary min-heap of indices into #points, ordered by
+   * DeltaRank().  It contains all points except for the first and
+   * the last one; those can't be thinned.
+   */
+  std::vector<unsigned> heap;
 
   TaskProjection task_projection;
 
@@ -190,25 +138,6 @@ class Trace : private NonCopyable
 
   Serial append_serial, modify_serial;
 
-  template<typename Alloc>
-  struct Disposer {
-    Alloc &alloc;
-
-    void operator()(typename std::allocator_traits<Alloc>::pointer td) {
-      std::allocator_traits<Alloc>::destroy(alloc, td);
-      alloc.deallocate(td, 1);
-    }
-  };
-
-  template<typename Alloc>
-  static Disposer<Alloc> MakeDisposer(Alloc &alloc) {
-    return {alloc};
-  }
-
-  Disposer<decltype(allocator)> MakeDisposer() {
-    return MakeDisposer(allocator);
-  }
-
 public:
   /**
    * Constructor.  Task projection is updated after first call to append().
@@ -222,10 +151,6 @@ public:
                  const Time max_time = null_time,
                  const unsigned max_size = 1000) noexcept;
 
-  ~Trace() noexcept {
-    clear();
-  }
-
 protected:
   /**
    * Find recent time after which points should not be culled
@@ -239,25 +164,14 @@ protected:
   Time GetRecentTime(Time t) const noexcept;
 
   /**
-   * Update delta values for specified item in the delta list and the
-   * tree.  This repositions the item after into its sorted position.
-   *
-   * @param it Item to update
-   * @param tree Tree containing leaf
-   *
-   * @return Iterator to updated item
-   */
-  void UpdateDelta(TraceDelta &td) noexcept;
-
-  /**
-   * Erase a non-edge item from delta list and tree, updating
-   * deltas in the process.  This Invalidates the calling iterator.
-   *
-   * @param it Item to erase
-   * @param tree Tree to remove from
+   * Update the delta values of the specified point and reposition it
+   * in the heap (unless it is not queued).
    *
+   * @param i the index of the point to be updated
+   * @param previous the index of the preceding (not removed) point
+   * @param next the index of the succeeding (not removed) point
    */
-  void EraseInside(DeltaList::iterator it) noexcept;
+  void UpdateDelta(unsigned i, unsigned previous, unsigned next) noexcept;
 
   /**
    * Erase elements based on delta metric until the size is
@@ -268,7 +182,6 @@ protected:
    * fail to set the target size.
    *
    * @param target_size Size of desired list.
-   * @param tree Tree to remove from
    * @param recent Time window for which to not remove points
    *
    * @return True if items were erased
@@ -281,7 +194,6 @@ protected:
    * and update earliest item to become the new start
    *
    * @param p_time Time to remove
-   * @param tree Tree to remove from
    *
    * @return True if items were erased
    */
@@ -294,9 +206,10 @@ protected:
   void EraseLaterThan(Time min_time) noexcept;
 
   /**
-   * Update start node (and neighbour) after min time pruning
+   * Turn the specified point into an edge (first or last point)
+   * after the points before or after it have been erased.
    */
-  void EraseStart(TraceDelta &td_start) noexcept;
+  void EraseStart(unsigned i) noexcept;
 
 public:
   /**
@@ -331,7 +244,7 @@ public:
    * @return Number of traces in tree
    */
   unsigned size() const noexcept {
-    return cached_size;
+    return points.size();
   }
 
   /**
@@ -340,7 +253,7 @@ public:
    * @return True if no traces stored
    */
   bool empty() const noexcept {
-    return cached_size == 0;
+    return points.empty();
   }
 
   /**
@@ -363,6 +276,18 @@ public:
     return modify_serial;
   }
 
+  /**
+   * Returns all trace points sorted by time, without copying them.
+   *
+   * Appending points does not move the existing ones, so the span
+   * (and pointers to its elements) remains valid until
+   * GetModifySerial() changes; after that, it refers to different
+   * points.
+   */
+  std::span<const TracePoint> GetPoints() const noexcept {
+    return points;
+  }
+
   /** 
    * Retrieve a vector of trace points sorted by time
    * 
@@ -371,11 +296,6 @@ public:
    */
   void GetPoints(TracePointVector& iov) const noexcept;
 
-  /**
-   * Retrieve a vector of trace points sorted by time
-   */
-  void GetPoints(TracePointerVector &v) const noexcept;
-
   /**
    * Update the given #TracePointVector after points were appended to
    * this object.  This must not be called after thinning has
@@ -383,7 +303,7 @@ public:
    *
    * @return true if new points were added
    */
-  bool SyncPoints(TracePointerVector &v) const noexcept;
+  bool SyncPoints(TracePointVector &v) const noexcept;
 
   /**
    * Fill the vector with trace points, not before #min_time, minimum
@@ -395,13 +315,13 @@ public:
   const TracePoint &front() const noexcept {
     assert(!empty());
 
-    return chronological_list.front().point;
+    return points.front();
   }
 
   const TracePoint &back() const noexcept {
     assert(!empty());
 
-    return chronological_list.back().point;
+    return points.back();
   }
 
 private:
@@ -428,17 +348,11 @@ private:
    */
   void Thin() noexcept;
 
-  TraceDelta &GetFront() noexcept {
-    assert(!empty());
-
-    return chronological_list.front();
-  }
-
-  TraceDelta &GetBack() noexcept {
-    assert(!empty());
-
-    return chronological_list.back();
-  }
+  /**
+   * Remove the points which were marked by EraseDelta(), closing the
+   * gaps.
+   */
+  void Compact() noexcept;
 
   [[gnu::pure]]
   unsigned CalcAverageDeltaDistance(Time no_thin) const noexcept;
@@ -446,67 +360,76 @@ private:
   [[gnu::pure]]
   Time CalcAverageDeltaTime(Time no_thin) const noexcept;
 
-  static constexpr unsigned null_delta = 0 - 1;
+  /**
+   * Function used to points for sorting by deltas.
+   * Ranking is primarily by distance delta; for equal distances, rank by
+   * time delta.
+   * This is like a modified Douglas-Peuker algorithm
+   */
+  [[gnu::pure]]
+  bool DeltaRank(unsigned x, unsigned y) const noexcept {
+    const Delta &dx = deltas[x], &dy = deltas[y];
 
-public:
-  static constexpr auto null_time = TracePoint::INVALID_TIME;
+    // distance is king
+    if (dx.elim_distance != dy.elim_distance)
+      return dx.elim_distance < dy.elim_distance;
 
-  unsigned GetAverageDeltaDistance() const noexcept {
-    return average_delta_distance;
+    // distance is equal, so go by time error
+    if (dx.elim_time != dy.elim_time)
+      return dx.elim_time < dy.elim_time;
+
+    // all else fails, go by age
+    return points[x].IsOlderThan(points[y]);
   }
 
-  Time GetAverageDeltaTime() const noexcept {
-    return average_delta_time;
+  void HeapSet(unsigned position, unsigned i) noexcept {
+    heap[position] = i;
+    deltas[i].heap_index = position;
   }
 
-public:
-  class const_iterator : public ChronologicalList::const_iterator {
-    friend class Trace;
+  void HeapSiftUp(unsigned position) noexcept;
+  void HeapSiftDown(unsigned position) noexcept;
 
-    const_iterator(ChronologicalList::const_iterator &&_iterator) noexcept
-      :ChronologicalList::const_iterator(std::move(_iterator)) {}
+  void HeapPush(unsigned i) noexcept;
 
-  public:
-    using ChronologicalList::const_iterator::iterator_category;
-    using ChronologicalList::const_iterator::difference_type;
-    typedef const TracePoint value_type;
-    typedef const TracePoint *pointer;
-    typedef const TracePoint &reference;
+  /**
+   * Remove the specified point from the heap (if it is queued).
+   */
+  void HeapRemove(unsigned i) noexcept;
 
-    const_iterator() = default;
+  static constexpr unsigned null_delta = 0 - 1;
 
-    const TracePoint &operator*() const noexcept {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return td.point;
-    }
+  /**
+   * A #Delta::heap_index value for points which are not in the heap.
+   */
+  static constexpr unsigned NOT_QUEUED = 0 - 1;
 
-    const TracePoint *operator->() const noexcept {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return &td.point;
-    }
+  /**
+   * A #Delta::heap_index value for points which were erased by
+   * EraseDelta(), but not yet by Compact().
+   */
+  static constexpr unsigned REMOVED = 0 - 2;
 
-    const_iterator &NextSquareRange(unsigned sq_resolution,
-                                    const const_iterator &end) noexcept {
-      const TracePoint &previous = **this;
-      while (true) {
-        ++*this;
+public:
+  static constexpr auto null_time = TracePoint::INVALID_TIME;
+
+  unsigned GetAverageDeltaDistance() const noexcept {
+    return average_delta_distance;
+  }
 
-        if (*this == end)
-          return *this;
+  Time GetAverageDeltaTime() const noexcept {
+    return average_delta_time;
+  }
 
-        const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-        if (td.point.FlatSquareDistanceTo(previous) >= sq_resolution)
-          return *this;
-      }
-    }
-  };
+public:
+  using const_iterator = std::vector<TracePoint>::const_iterator;
 
   const_iterator begin() const noexcept {
-    return chronological_list.begin();
+    return points.begin();
   }
 
   const_iterator end() const noexcept {
-    return chronological_list.end();
+    return points.end();
   }
 
   const TaskProjection &GetProjection() const noexcept {
@@ -13,12 +13,3 @@ class TracePointVector : public std::vector<TracePoint> {
 public:
   void ScanBounds(GeoBounds &bounds) const noexcept;
 };
-
-/**
- * A direct-access storage for TracePoint pointers that refer to
- * elements of a Trace.  Be careful: all pointers get Invalidated when
- * the Trace gets thinned.  Be sure to check Trace::GetModifySerial()
- * for updates.
- */
-class TracePointerVector : public std::vector<const TracePoint *> {
-};
@@ -7,22 +7,24 @@
 #include "Waypoint.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 #include "util/RadixTree.hpp"
-#include "util/QuadTree.hxx"
+#include "util/PackedRTree.hpp"
 #include "util/Serial.hpp"
 #include "util/tstring_view.hxx"
 
+#include <cassert>
+#include <cstdlib>
 #include <functional>
 
 using WaypointVisitor = std::function<void(const WaypointPtr &)>;
 
 /**
- * Container for waypoints using kd-tree representation internally for
- * fast geospatial lookups.
+ * Container for waypoints using a packed R-tree internally for fast
+ * geospatial lookups.
  */
 class Waypoints {
   /**
    * Function object used to provide access to coordinate values by
-   * QuadTree.
+   * PackedRTree.
    */
   struct WaypointAccessor {
     [[gnu::pure]]
@@ -37,9 +39,11 @@ class Waypoints {
   };
 
   /**
-   * Type of KD-tree data structure for waypoint container
+   * Type of spatial index for waypoint container.  The waypoints
+   * loaded from files are bulk-loaded into a static tree by
+   * Optimise(); waypoints added later are kept in a small overlay.
    */
-  using WaypointTree = QuadTree<WaypointPtr, WaypointAccessor>;
+  using WaypointTree = PackedRTree<WaypointPtr, WaypointAccessor>;
 
   class WaypointNameTree : public RadixTree<WaypointPtr> {
   public:
@@ -155,7 +159,6 @@ public:
    * Prepare and enable the next Optimise() call.
    */
   void ScheduleOptimise() noexcept {
-    waypoint_tree.Flatten();
     waypoint_tree.ClearBounds();
   }
 
@@ -278,6 +281,42 @@ public:
   void VisitWithinRange(const GeoPoint &loc, double range,
                         WaypointVisitor visitor) const;
 
+  /**
+   * Checks whether a waypoint is within range of a location, using
+   * the same (approximate, flat) metric as VisitWithinRange().  This
+   * allows callers to cache the result of a wider query and narrow it
+   * down later, without walking the tree again.
+   */
+  class RangeFilter {
+    FlatGeoPoint flat_location;
+    unsigned square_range;
+
+  public:
+    RangeFilter(const FlatGeoPoint &_flat_location,
+                unsigned range) noexcept
+      :flat_location(_flat_location), square_range(range * range) {}
+
+    [[gnu::pure]]
+    bool operator()(const Waypoint &wp) const noexcept {
+      const unsigned dx = std::abs(wp.flat_location.x - flat_location.x);
+      const unsigned dy = std::abs(wp.flat_location.y - flat_location.y);
+      return dx * dx + dy * dy <= square_range;
+    }
+  };
+
+  /**
+   * Create a #RangeFilter.  Must not be called while the container is
+   * empty.
+   */
+  [[gnu::pure]]
+  RangeFilter GetRangeFilter(const GeoPoint &loc,
+                             double range) const noexcept {
+    assert(!IsEmpty());
+
+    return RangeFilter(task_projection.ProjectInteger(loc),
+                       task_projection.ProjectRangeInteger(loc, range));
+  }
+
   /**
    * Call visitor function on waypoints with the specified name
    * prefix.
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FlarmNetBinary.hpp"
+#include "FlarmNetDatabase.hpp"
+#include "FlarmNetRecord.hpp"
+#include "Id.hpp"
+#include "io/OutputStream.hxx"
+#include "util/SpanCast.hxx"
+#include "util/UTF8.hpp"
+
+#ifdef _UNICODE
+#include "util/ConvertString.hpp"
+#endif
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <string.h>
+
+namespace FlarmNetBinary {
+
+template<std::size_t size>
+[[gnu::pure]]
+static std::string_view
+ToStringView(const char (&src)[size]) noexcept
+{
+  return {src, strnlen(src, size)};
+}
+
+View::View(std::span<const std::byte> src)
+{
+  if (!IsBinary(src))
+    throw std::runtime_error("Not a binary FlarmNet database");
+
+  const auto &header = *reinterpret_cast<const Header *>(src.data());
+  if (header.version != VERSION)
+    throw std::runtime_error("Unsupported FlarmNet database version");
+
+  /* divide instead of multiplying n, which could overflow on 32 bit
+     targets */
+  constexpr std::size_t record_size = sizeof(Record) + sizeof(PackedLE32);
+  const std::size_t n = header.n_records;
+  src = src.subspan(sizeof(header));
+  if (n > src.size() / record_size || src.size() != n * record_size)
+    throw std::runtime_error("Malformed FlarmNet database");
+
+  records = FromBytesStrict<const Record>(src.first(n * sizeof(Record)));
+  callsign_index = FromBytesStrict<const PackedLE32>(src.subspan(n * sizeof(Record)));
+}
+
+const Record *
+View::FindById(uint32_t id) const noexcept
+{
+  const auto i = std::lower_bound(records.begin(), records.end(), id,
+                                  [](const Record &r, uint32_t value){
+                                    return r.id < value;
+                                  });
+  return i != records.end() && i->id == id
+    ? &*i
+    : nullptr;
+}
+
+std::span<const PackedLE32>
+View::FindByCallSign(const char *_prefix, bool exact) const noexcept
+{
+  const std::string_view prefix{_prefix};
+
+  const auto GetCallSign = [this](uint32_t i) noexcept {
+    /* tolerate corrupt indexes */
+    return i < records.size()
+      ? ToStringView(records[i].callsign)
+      : std::string_view{};
+  };
+
+  const auto begin =
+    std::partition_point(callsign_index.begin(), callsign_index.end(),
+                         [&](uint32_t i){
+                           return GetCallSign(i) < prefix;
+                         });
+
+  const auto end =
+    std::partition_point(begin, callsign_index.end(),
+                         [&](uint32_t i){
+                           const auto callsign = GetCallSign(i);
+                           return exact
+                             ? callsign == prefix
+                             : callsign.starts_with(prefix);
+                         });
+
+  return {begin, end};
+}
+
+bool
+IsBinary(std::span<const std::byte> src) noexcept
+{
+  return src.size() >= sizeof(Header) &&
+    reinterpret_cast<const Header *>(src.data())->magic == MAGIC;
+}
+
+template<std::size_t size, std::size_t dest_size>
+static void
+DecodeString(StaticString<dest_size> &dest, const char (&src)[size]) noexcept
+{
+  char buffer[size + 1];
+  *std::copy_n(src, strnlen(src, size), buffer) = '\0';
+
+  if (!dest.SetUTF8(buffer))
+    dest.clear();
+}
+
+void
+Decode(FlarmNetRecord &dest, const Record &src) noexcept
+{
+  FlarmId::FromValue(src.id).Format(dest.id.buffer());
+  DecodeString(dest.pilot, src.pilot);
+  DecodeString(dest.airfield, src.airfield);
+  DecodeString(dest.plane_type, src.plane_type);
+  DecodeString(dest.registration, src.registration);
+  DecodeString(dest.callsign, src.callsign);
+  DecodeString(dest.frequency, src.frequency);
+}
+
+template<std::size_t size>
+static void
+EncodeString(char (&dest)[size], const TCHAR *src) noexcept
+{
+  std::fill_n(dest, size, '\0');
+
+#ifdef _UNICODE
+  const WideToUTF8Converter utf8(src);
+  if (!utf8.IsValid())
+    return;
+
+  CopyTruncateStringUTF8(dest, utf8.c_str(), size - 1);
+#else
+  CopyTruncateStringUTF8(dest, src, size - 1);
+#endif
+}
+
+static void
+Encode(Record &dest, FlarmId id, const FlarmNetRecord &src) noexcept
+{
+  dest.id = id.GetValue();
+  EncodeString(dest.pilot, src.pilot);
+  EncodeString(dest.airfield, src.airfield);
+  EncodeString(dest.plane_type, src.plane_type);
+  EncodeString(dest.registration, src.registration);
+  EncodeString(dest.callsign, src.callsign);
+  EncodeString(dest.frequency, src.frequency);
+}
+
+void
+Write(OutputStream &os, const FlarmNetDatabase &database)
+{
+  /* the database is sorted by id already */
+  std::vector<Record> records;
+  for (const auto &[id, record] : database)
+    Encode(records.emplace_back(), id, record);
+
+  std::vector<uint32_t> index(records.size());
+  std::iota(index.begin(), index.end(), 0);
+  std::stable_sort(index.begin(), index.end(),
+                   [&records](uint32_t a, uint32_t b){
+                     return ToStringView(records[a].callsign) <
+                       ToStringView(records[b].callsign);
+                   });
+
+  const std::vector<PackedLE32> packed_index(index.begin(), index.end());
+
+  Header header;
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.n_records = records.size();
+
+  os.Write(ReferenceAsBytes(header));
+  os.Write(std::as_bytes(std::span{records}));
+  os.Write(std::as_bytes(std::span{packed_index}));
+}
+
+} // namespace FlarmNetBinary
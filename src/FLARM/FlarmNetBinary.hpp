@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "util/PackedLittleEndian.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+struct FlarmNetRecord;
+class FlarmNetDatabase;
+class OutputStream;
+
+/**
+ * A compact binary representation of the FlarmNet.org / OGN device
+ * database which is designed to be mapped into memory and used
+ * without parsing.
+ *
+ * The file begins with a #Header, followed by all #Record objects
+ * sorted by FLARM id, followed by an array of record numbers sorted
+ * by callsign (and FLARM id).  All strings are UTF-8 and padded with
+ * null bytes.
+ */
+namespace FlarmNetBinary {
+
+static constexpr uint32_t MAGIC = 0x4e464358; // "XCFN"
+static constexpr uint32_t VERSION = 1;
+
+struct Header {
+  PackedLE32 magic, version;
+
+  PackedLE32 n_records;
+};
+
+struct Record {
+  PackedLE32 id;
+
+  char pilot[34];
+  char airfield[34];
+  char plane_type[34];
+  char registration[13];
+  char callsign[7];
+  char frequency[13];
+};
+
+static_assert(alignof(Record) == 1);
+
+/**
+ * A view on a (mapped) binary database.
+ */
+struct View {
+  std::span<const Record> records;
+
+  /**
+   * Indexes into #records, sorted by callsign.
+   */
+  std::span<const PackedLE32> callsign_index;
+
+  /**
+   * Parse and verify the header.
+   *
+   * Throws on error.
+   */
+  explicit View(std::span<const std::byte> src);
+
+  [[gnu::pure]]
+  const Record *FindById(uint32_t id) const noexcept;
+
+  /**
+   * Find all records whose callsign begins with the given (UTF-8)
+   * prefix.  An exact match is also a prefix match; pass
+   * exact=true to reject longer callsigns.
+   *
+   * @return a range of #callsign_index
+   */
+  [[gnu::pure]]
+  std::span<const PackedLE32> FindByCallSign(const char *prefix,
+                                             bool exact) const noexcept;
+};
+
+/**
+ * Does the given buffer begin with the magic number of this format?
+ */
+[[gnu::pure]]
+bool
+IsBinary(std::span<const std::byte> src) noexcept;
+
+void
+Decode(FlarmNetRecord &dest, const Record &src) noexcept;
+
+/**
+ * Write the given database in the binary format.
+ *
+ * Throws on I/O error.
+ */
+void
+Write(OutputStream &os, const FlarmNetDatabase &database);
+
+} // namespace FlarmNetBinary
@@ -2,10 +2,38 @@
 // Copyright The XCSoar Project
 
 #include "FlarmNetDatabase.hpp"
+#include "io/FileMapping.hpp"
+#include "system/Path.hpp"
 #include "util/StringAPI.hxx"
 
+#ifdef _UNICODE
+#include "util/ConvertString.hpp"
+#endif
+
 #include <cassert>
 
+FlarmNetDatabase::FlarmNetDatabase() noexcept = default;
+FlarmNetDatabase::~FlarmNetDatabase() noexcept = default;
+
+std::size_t
+FlarmNetDatabase::size() const noexcept
+{
+  if (view)
+    return view->records.size();
+
+  const std::lock_guard lock{mutex};
+  return map.size();
+}
+
+void
+FlarmNetDatabase::Clear() noexcept
+{
+  const std::lock_guard lock{mutex};
+  map.clear();
+  view.reset();
+  mapping.reset();
+}
+
 void
 FlarmNetDatabase::Insert(const FlarmNetRecord &record) noexcept
 {
@@ -14,12 +42,91 @@ FlarmNetDatabase::Insert(const FlarmNetRecord &record) noexcept
     /* ignore malformed records */
     return;
 
+  const std::lock_guard lock{mutex};
   map.insert(std::make_pair(id, record));
 }
 
+bool
+FlarmNetDatabase::Map(Path path)
+{
+  auto new_mapping = std::make_unique<FileMapping>(path);
+  if (!Load(*new_mapping))
+    return false;
+
+  mapping = std::move(new_mapping);
+  return true;
+}
+
+bool
+FlarmNetDatabase::Load(std::span<const std::byte> src)
+{
+  if (!FlarmNetBinary::IsBinary(src))
+    return false;
+
+  FlarmNetBinary::View new_view{src};
+
+  const std::lock_guard lock{mutex};
+  map.clear();
+  view = new_view;
+  mapping.reset();
+  return true;
+}
+
+inline const FlarmNetRecord &
+FlarmNetDatabase::Decode(const FlarmNetBinary::Record &src) const noexcept
+{
+  auto [i, inserted] = map.try_emplace(FlarmId::FromValue(src.id));
+  if (inserted)
+    FlarmNetBinary::Decode(i->second, src);
+  return i->second;
+}
+
+const FlarmNetRecord *
+FlarmNetDatabase::FindRecordById(FlarmId id) const noexcept
+{
+  const std::lock_guard lock{mutex};
+
+  if (auto i = map.find(id); i != map.end())
+    return &i->second;
+
+  if (view)
+    if (const auto *record = view->FindById(id.GetValue()))
+      return &Decode(*record);
+
+  return nullptr;
+}
+
+/**
+ * Look up a callsign in the binary database's callsign index.
+ */
+[[gnu::pure]]
+static std::span<const PackedLE32>
+FindByCallSign(const FlarmNetBinary::View &view, const TCHAR *cn) noexcept
+{
+#ifdef _UNICODE
+  const WideToUTF8Converter utf8(cn);
+  if (!utf8.IsValid())
+    return {};
+
+  return view.FindByCallSign(utf8.c_str(), true);
+#else
+  return view.FindByCallSign(cn, true);
+#endif
+}
+
 const FlarmNetRecord *
 FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const noexcept
 {
+  const std::lock_guard lock{mutex};
+
+  if (view) {
+    for (const uint32_t i : FindByCallSign(*view, cn))
+      if (i < view->records.size())
+        return &Decode(view->records[i]);
+
+    return nullptr;
+  }
+
   for (const auto &[id, record] : map) {
     assert(id.IsDefined());
 
@@ -33,13 +140,30 @@ FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const noexcept
 unsigned
 FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
                                         const FlarmNetRecord *array[],
-                                        [[maybe_unused]] unsigned size) const noexcept
+                                        unsigned size) const noexcept
 {
+  const std::lock_guard lock{mutex};
+
   unsigned count = 0;
 
+  if (view) {
+    for (const uint32_t i : FindByCallSign(*view, cn)) {
+      if (count >= size)
+        break;
+
+      if (i < view->records.size())
+        array[count++] = &Decode(view->records[i]);
+    }
+
+    return count;
+  }
+
   for (const auto &[id, record] : map) {
     assert(id.IsDefined());
 
+    if (count >= size)
+      break;
+
     if (StringIsEqual(record.callsign, cn))
       array[count++] = &record;
   }
@@ -49,13 +173,31 @@ FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
 
 unsigned
 FlarmNetDatabase::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
-                                    [[maybe_unused]] unsigned size) const noexcept
+                                    unsigned size) const noexcept
 {
+  const std::lock_guard lock{mutex};
+
   unsigned count = 0;
 
+  if (view) {
+    /* no need to decode the records */
+    for (const uint32_t i : FindByCallSign(*view, cn)) {
+      if (count >= size)
+        break;
+
+      if (i < view->records.size())
+        array[count++] = FlarmId::FromValue(view->records[i].id);
+    }
+
+    return count;
+  }
+
   for (const auto &[id, record] : map) {
     assert(id.IsDefined());
 
+    if (count >= size)
+      break;
+
     if (StringIsEqual(record.callsign, cn))
       array[count++] = id;
   }
@@ -5,47 +5,95 @@
 
 #include "Id.hpp"
 #include "FlarmNetRecord.hpp"
+#include "FlarmNetBinary.hpp"
+#include "thread/Mutex.hxx"
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <tchar.h>
 
+class Path;
+class FileMapping;
+
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * The records are either inserted one by one (from the FlarmNet.org
+ * text file) or looked up in a binary database (see #FlarmNetBinary)
+ * which is mapped into memory.  In the latter case, records are
+ * decoded on demand, and #map caches them, because callers expect
+ * the returned pointers to remain valid.
  */
 class FlarmNetDatabase {
   typedef std::map<FlarmId, FlarmNetRecord> RecordMap;
-  RecordMap map;
+
+  /**
+   * Protects #map, which may be modified by lookups if a binary
+   * database is mapped.
+   */
+  mutable Mutex mutex;
+
+  mutable RecordMap map;
+
+  std::unique_ptr<FileMapping> mapping;
+
+  std::optional<FlarmNetBinary::View> view;
 
 public:
+  FlarmNetDatabase() noexcept;
+  ~FlarmNetDatabase() noexcept;
+
+  FlarmNetDatabase(const FlarmNetDatabase &) = delete;
+  FlarmNetDatabase &operator=(const FlarmNetDatabase &) = delete;
+
+  [[gnu::pure]]
   bool IsEmpty() const noexcept {
-    return map.empty();
+    return size() == 0;
   }
 
-  void Clear() noexcept {
-    map.clear();
-  }
+  /**
+   * Returns the number of records.
+   */
+  [[gnu::pure]]
+  std::size_t size() const noexcept;
+
+  void Clear() noexcept;
 
   void Insert(const FlarmNetRecord &record) noexcept;
 
+  /**
+   * Map a binary database file (see #FlarmNetBinary) into memory.
+   *
+   * Throws on error.
+   *
+   * @return false if the file is not in the binary format
+   */
+  bool Map(Path path);
+
+  /**
+   * Use the given binary database (see #FlarmNetBinary).  The
+   * caller is responsible for keeping the buffer valid as long as
+   * this object is used.
+   *
+   * Throws if the database is malformed.
+   *
+   * @return false if the buffer is not in the binary format
+   */
+  bool Load(std::span<const std::byte> src);
+
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
    * @param id FLARM id
    * @return FLARMNetRecord object
    */
-  [[gnu::pure]]
-  const FlarmNetRecord *FindRecordById(FlarmId id) const noexcept {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmNetRecord *FindRecordById(FlarmId id) const noexcept;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
    * @param cn Callsign
    * @return FLARMNetRecord object
    */
-  [[gnu::pure]]
   const FlarmNetRecord *FindFirstRecordByCallSign(const TCHAR *cn) const noexcept;
 
   unsigned FindRecordsByCallSign(const TCHAR *cn,
@@ -54,6 +102,10 @@ public:
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                              unsigned size) const noexcept;
 
+  /**
+   * Iterate over all records which were inserted with Insert().
+   * Records in a mapped binary database are not visited.
+   */
   [[gnu::pure]]
   auto begin() const noexcept {
     return map.begin();
@@ -63,4 +115,11 @@ public:
   auto end() const noexcept {
     return map.end();
   }
+
+private:
+  /**
+   * Obtain a #FlarmNetRecord for the given binary record, decoding
+   * it if it is not yet in the cache.  Caller must lock #mutex.
+   */
+  const FlarmNetRecord &Decode(const FlarmNetBinary::Record &src) const noexcept;
 };
@@ -23,7 +23,8 @@
 #include "Profile/Keys.hpp"
 
 /**
- * Loads the FLARMnet file
+ * Loads the FLARMnet file.  A binary database (see #FlarmNetBinary)
+ * is mapped into memory; a FlarmNet.org text file is parsed.
  */
 static void
 LoadFLARMnet(FlarmNetDatabase &db) noexcept
@@ -33,6 +34,11 @@ try {
     return;
   }
 
+  if (db.Map(path)) {
+    LogFormat("%zu FLARMnet ids mapped", db.size());
+    return;
+  }
+
   unsigned num_records = FlarmNetReader::LoadFile(path, db);
   if (num_records > 0)
     LogFormat("%u FLARMnet ids found", num_records);
@@ -28,6 +28,18 @@ public:
     return FlarmId(UNDEFINED_VALUE);
   }
 
+  /**
+   * Construct an instance from a value previously obtained with
+   * GetValue().
+   */
+  static constexpr FlarmId FromValue(uint32_t value) noexcept {
+    return FlarmId(value);
+  }
+
+  constexpr uint32_t GetValue() const noexcept {
+    return value;
+  }
+
   constexpr bool IsDefined() const noexcept {
     return value != UNDEFINED_VALUE;
   }
@@ -36,6 +48,13 @@ public:
     value = UNDEFINED_VALUE;
   }
 
+  /**
+   * Returns the raw value, to be used as a hash code.
+   */
+  constexpr uint32_t Hash() const noexcept {
+    return value;
+  }
+
   friend constexpr auto operator<=>(const FlarmId &,
                                     const FlarmId &) noexcept = default;
 
@@ -3,6 +3,8 @@
 
 #include "List.hpp"
 
+#include <array>
+
 const FlarmTraffic *
 TrafficList::FindMaximumAlert() const noexcept
 {
@@ -27,3 +29,31 @@ TrafficList::InCloseRange() const noexcept
   return std::any_of(list.begin(), list.end(), [](const auto &traffic)
     { return traffic.distance < (RoughDistance)4000; });
 }
+
+std::size_t
+TrafficList::FindNearest(std::span<uint16_t> dest,
+                         RoughDistance max_distance) const noexcept
+{
+  std::array<uint16_t, MAX_COUNT> positions;
+  std::size_t n = 0;
+  for (unsigned i = 0; i < list.size(); ++i)
+    if (list[i].distance <= max_distance)
+      positions[n++] = i;
+
+  const auto begin = positions.begin(), end = std::next(begin, n);
+  const auto compare = [this](uint16_t a, uint16_t b){
+    return list[a].distance < list[b].distance;
+  };
+
+  if (n > dest.size()) {
+    /* only the nearest ones fit; move them to the front before
+       sorting */
+    n = dest.size();
+    std::nth_element(begin, std::next(begin, n), end, compare);
+  }
+
+  const auto last = std::next(begin, n);
+  std::sort(begin, last, compare);
+  std::copy(begin, last, dest.begin());
+  return n;
+}
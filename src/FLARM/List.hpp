@@ -7,6 +7,10 @@
 #include "NMEA/Validity.hpp"
 #include "util/TrivialArray.hxx"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
 #include <type_traits>
 
 /**
@@ -14,7 +18,22 @@
  * FLARM.
  */
 struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+  /**
+   * The maximum number of targets.  This is large enough for dense
+   * OGN/ADS-B feeds at competition sites.  Since this object is part
+   * of #NMEAInfo (which is copied for each device and on every
+   * blackboard merge), it must remain trivially copyable.
+   */
+  static constexpr size_t MAX_COUNT = 512;
+
+  /**
+   * The number of slots in #index.  This is a power of two and at
+   * least twice #MAX_COUNT, which keeps the probe sequences short.
+   */
+  static constexpr unsigned INDEX_BITS = 10;
+  static constexpr size_t INDEX_SIZE = size_t(1) << INDEX_BITS;
+  static_assert(INDEX_SIZE >= 2 * MAX_COUNT);
+  static_assert(MAX_COUNT < 0x10000);
 
   /**
    * Time stamp of the latest modification to this object.
@@ -29,10 +48,19 @@ struct TrafficList {
   /** Flarm traffic information */
   TrivialArray<FlarmTraffic, MAX_COUNT> list;
 
+  /**
+   * A hash table (open addressing with linear probing) which maps
+   * FlarmId to the position in #list plus one; 0 is an empty slot.
+   * Only AllocateTraffic() and Expire() modify #list, and they keep
+   * this table up to date.
+   */
+  uint16_t index[INDEX_SIZE];
+
   constexpr void Clear() noexcept {
     modified.Clear();
     new_traffic.Clear();
     list.clear();
+    std::fill_n(index, INDEX_SIZE, 0);
   }
 
   constexpr bool IsEmpty() const noexcept {
@@ -54,13 +82,14 @@ struct TrafficList {
       /* don't bother merging the two lists, we can simply memcpy()
          it */
       list = add.list;
+      std::copy_n(add.index, INDEX_SIZE, index);
       return;
     }
 
     // Add unique traffic from 'add' list
     for (auto &traffic : add.list) {
       if (FindTraffic(traffic.id) == nullptr) {
-        FlarmTraffic * new_traffic = AllocateTraffic();
+        FlarmTraffic * new_traffic = AllocateTraffic(traffic.id);
         if (new_traffic == nullptr)
           return;
         *new_traffic = traffic;
@@ -72,9 +101,16 @@ struct TrafficList {
     modified.Expire(clock, std::chrono::minutes(5));
     new_traffic.Expire(clock, std::chrono::minutes(1));
 
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
-        list.quick_remove(i);
+    /* compact the list in one pass, preserving the order */
+    auto dest = list.begin();
+    for (auto &traffic : list)
+      if (traffic.Refresh(clock))
+        *dest++ = traffic;
+
+    if (dest != list.end()) {
+      list.shrink(std::distance(list.begin(), dest));
+      RebuildIndex();
+    }
   }
 
   constexpr unsigned GetActiveTrafficCount() const noexcept {
@@ -88,11 +124,8 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   constexpr FlarmTraffic *FindTraffic(FlarmId id) noexcept {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const unsigned position = index[FindIndexSlot(id)];
+    return position > 0 ? &list[position - 1] : NULL;
   }
 
   /**
@@ -102,11 +135,8 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   constexpr const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
-    for (const auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const unsigned position = index[FindIndexSlot(id)];
+    return position > 0 ? &list[position - 1] : NULL;
   }
 
   /**
@@ -138,14 +168,24 @@ struct TrafficList {
   }
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object from the array and assigns
+   * the given id to it.  The id must not be in the list already (see
+   * FindTraffic()).
    *
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  constexpr FlarmTraffic *AllocateTraffic() noexcept {
-    return list.full()
-      ? NULL
-      : &list.append();
+  constexpr FlarmTraffic *AllocateTraffic(FlarmId id) noexcept {
+    if (list.full())
+      return NULL;
+
+    const std::size_t slot = FindIndexSlot(id);
+    assert(index[slot] == 0);
+
+    FlarmTraffic &traffic = list.append();
+    traffic.Clear();
+    traffic.id = id;
+    index[slot] = list.size();
+    return &traffic;
   }
 
   /**
@@ -195,6 +235,48 @@ struct TrafficList {
    * Is set if traffic is present and closer than 4Km.
    */
   bool InCloseRange() const noexcept;
+
+  /**
+   * Find the targets which are not farther than the given distance
+   * from the own aircraft, nearest first.  If there are more than
+   * fit into #dest, only the nearest ones are returned.
+   *
+   * @param dest a buffer for the positions in #list
+   * @return the number of positions written to #dest
+   */
+  std::size_t FindNearest(std::span<uint16_t> dest,
+                          RoughDistance max_distance) const noexcept;
+
+  /**
+   * Returns the #index slot where the lookup for the given id
+   * begins.
+   */
+  static constexpr std::size_t GetIndexHash(FlarmId id) noexcept {
+    /* Fibonacci hashing spreads the (often sequential) ids */
+    return uint32_t(id.Hash() * 0x9e3779b1U) >> (32 - INDEX_BITS);
+  }
+
+private:
+
+  /**
+   * Returns the #index slot which refers to the given id, or the
+   * empty slot where it would be inserted.  This always terminates
+   * because #index is never full.
+   */
+  constexpr std::size_t FindIndexSlot(FlarmId id) const noexcept {
+    for (std::size_t i = GetIndexHash(id);; i = (i + 1) % INDEX_SIZE) {
+      const unsigned position = index[i];
+      if (position == 0 || list[position - 1].id == id)
+        return i;
+    }
+  }
+
+  constexpr void RebuildIndex() noexcept {
+    std::fill_n(index, INDEX_SIZE, 0);
+
+    for (unsigned i = 0; i < list.size(); ++i)
+      index[FindIndexSlot(list[i].id)] = i + 1;
+  }
 };
 
 static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "OgnDdbReader.hpp"
+#include "FlarmNetRecord.hpp"
+#include "FlarmNetDatabase.hpp"
+#include "io/CSVLine.hpp"
+#include "io/LineReader.hpp"
+#include "io/FileLineReader.hpp"
+#include "util/StringStrip.hxx"
+
+#include <string>
+
+/**
+ * Read the next column and remove the single quotes around it.
+ */
+static std::string_view
+ReadQuoted(CSVLine &line) noexcept
+{
+  std::string_view value = line.ReadView();
+  if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'')
+    value = value.substr(1, value.size() - 2);
+  return Strip(value);
+}
+
+template<std::size_t size>
+static void
+LoadString(StaticString<size> &dest, std::string_view src) noexcept
+{
+  if (!dest.SetUTF8(std::string{src}.c_str()))
+    dest.clear();
+}
+
+/**
+ * Parse one line of the form:
+ *
+ * 'F','DDA85C','Hornet','D-4449','TH','Y','Y'
+ */
+static bool
+LoadRecord(FlarmNetRecord &record, const char *_line) noexcept
+{
+  if (*_line == '#')
+    /* the header line */
+    return false;
+
+  CSVLine line(_line);
+  line.Skip(); // DEVICE_TYPE
+
+  const auto id = ReadQuoted(line);
+  const auto model = ReadQuoted(line);
+  const auto registration = ReadQuoted(line);
+  const auto callsign = ReadQuoted(line);
+  line.Skip(); // TRACKED
+  const auto identified = ReadQuoted(line);
+
+  if (id.size() != 6 || identified != "Y")
+    return false;
+
+  record.id.SetASCII(id);
+  LoadString(record.plane_type, model);
+  LoadString(record.registration, registration);
+  LoadString(record.callsign, callsign);
+  return true;
+}
+
+unsigned
+OgnDdbReader::LoadFile(NLineReader &reader, FlarmNetDatabase &database)
+{
+  unsigned count = 0;
+
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    FlarmNetRecord record{};
+    if (LoadRecord(record, line)) {
+      database.Insert(record);
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+unsigned
+OgnDdbReader::LoadFile(Path path, FlarmNetDatabase &database)
+{
+  FileLineReaderA file(path);
+  return LoadFile(file, database);
+}
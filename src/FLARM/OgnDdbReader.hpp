@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+class Path;
+class FlarmNetDatabase;
+class NLineReader;
+
+/**
+ * Parser for the CSV export of the OGN device database
+ * (https://ddb.glidernet.org/download/).
+ */
+namespace OgnDdbReader
+{
+  /**
+   * Reads all records from the OGN device database.  Devices whose
+   * owners have opted out of identification are skipped.
+   *
+   * @return the number of records read from the file
+   */
+  unsigned LoadFile(NLineReader &reader, FlarmNetDatabase &database);
+
+  /**
+   * Throws on I/O error.
+   *
+   * @return the number of records read from the file
+   */
+  unsigned LoadFile(Path path, FlarmNetDatabase &database);
+};
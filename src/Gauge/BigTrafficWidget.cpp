@@ -25,6 +25,8 @@
 #include "Interface.hpp"
 #include "Asset.hpp"
 
+#include <span>
+
 /**
  * A Window which renders FLARM traffic, with user interaction.
  */
@@ -179,12 +181,14 @@ FlarmTrafficControl::CalcAutoZoom()
   bool warning_mode = WarningMode();
   RoughDistance zoom_dist = 0;
 
-  for (auto it = data.list.begin(), end = data.list.end();
-      it != end; ++it) {
-    if (warning_mode && !it->HasAlarm())
-      continue;
-
-    zoom_dist = std::max(it->distance, zoom_dist);
+  if (warning_mode) {
+    for (const auto &traffic : data.list)
+      if (traffic.HasAlarm())
+        zoom_dist = std::max(traffic.distance, zoom_dist);
+  } else {
+    /* only the nearest targets are painted */
+    for (unsigned i : std::span{nearest}.first(n_nearest))
+      zoom_dist = std::max(data.list[i].distance, zoom_dist);
   }
 
   double zoom_dist2 = zoom_dist;
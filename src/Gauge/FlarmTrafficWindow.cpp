@@ -149,6 +149,19 @@ FlarmTrafficWindow::UpdateWarnings() noexcept
     : - 1;
 }
 
+/**
+ * Finds the targets which will be painted on the radar and saves
+ * them to "nearest".
+ */
+void
+FlarmTrafficWindow::UpdateNearest() noexcept
+{
+  /* far targets are painted at the edge of the radar, so there is no
+     distance limit */
+  n_nearest = data.FindNearest(nearest,
+                               std::numeric_limits<uint32_t>::max());
+}
+
 /**
  * This should be called when the radar needs to be repainted
  */
@@ -180,6 +193,7 @@ FlarmTrafficWindow::Update(Angle new_direction, const TrafficList &new_data,
   settings = new_settings;
 
   UpdateWarnings();
+  UpdateNearest();
   UpdateSelector(selection_id, pt);
 
   Invalidate();
@@ -515,8 +529,8 @@ FlarmTrafficWindow::PaintRadarTraffic(Canvas &canvas) noexcept
     return;
   }
 
-  // Iterate through the traffic (normal traffic)
-  for (unsigned i = 0; i < data.list.size(); ++i) {
+  // Iterate through the nearest traffic (normal traffic)
+  for (unsigned i : std::span{nearest}.first(n_nearest)) {
     const FlarmTraffic &traffic = data.list[i];
 
     if (!traffic.HasAlarm() &&
@@ -715,7 +729,7 @@ FlarmTrafficWindow::SelectNearTarget(PixelPoint p, int max_distance) noexcept
   int min_distance = 99999;
   int min_id = -1;
 
-  for (unsigned i = 0; i < data.list.size(); ++i) {
+  for (unsigned i : std::span{nearest}.first(n_nearest)) {
     // If FLARM target does not exist -> next one
     if (!data.list[i].IsDefined())
       continue;
@@ -9,6 +9,7 @@
 #include "TeamCode/Settings.hpp"
 #include "Math/FastRotation.hpp"
 
+#include <array>
 #include <cstdint>
 
 class Color;
@@ -36,6 +37,21 @@ protected:
 
   PixelPoint sc[TrafficList::MAX_COUNT];
 
+  /**
+   * The maximum number of targets on the radar, not counting the
+   * selected one and the ones with an alarm.  Dense OGN/ADS-B feeds
+   * would clutter the radar otherwise.
+   */
+  static constexpr std::size_t MAX_RADAR_TARGETS = 32;
+
+  /**
+   * The positions (in #data) of the nearest targets, nearest first.
+   * Only these (plus the selection and alarms) are painted, and only
+   * their #sc entries are valid.
+   */
+  std::array<uint16_t, MAX_RADAR_TARGETS> nearest;
+  std::size_t n_nearest = 0;
+
   bool enable_north_up = false;
   Angle heading = Angle::Zero();
   FastRotation fr;
@@ -91,6 +107,7 @@ protected:
 
   void UpdateSelector(FlarmId id, PixelPoint pt) noexcept;
   void UpdateWarnings() noexcept;
+  void UpdateNearest() noexcept;
   void Update(Angle new_direction, const TrafficList &new_data,
               const TeamCodeSettings &new_settings) noexcept;
   void PaintRadarNoTraffic(Canvas &canvas) const noexcept;
@@ -103,16 +103,7 @@ PaintTask(Canvas &canvas, const WindowProjection &projection,
     AirspaceRenderer airspace_renderer(airspace_look);
     airspace_renderer.SetAirspaces(airspaces);
 
-#ifndef ENABLE_OPENGL
-    BufferCanvas stencil_canvas;
-    stencil_canvas.Create(canvas);
-#endif
-
-    airspace_renderer.Draw(canvas,
-#ifndef ENABLE_OPENGL
-                           stencil_canvas,
-#endif
-                           projection, settings_map.airspace);
+    airspace_renderer.Draw(canvas, projection, settings_map.airspace);
   }
 
 #ifdef ENABLE_OPENGL
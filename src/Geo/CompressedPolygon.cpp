@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "CompressedPolygon.hpp"
+#include "SearchPointVector.hpp"
+#include "GeoPoint.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+static int32_t
+Quantise(Angle a) noexcept
+{
+  return (int32_t)std::lround(a.Native() * CompressedPolygon::SCALE);
+}
+
+static Angle
+Dequantise(int32_t value) noexcept
+{
+  return Angle::Native(value / CompressedPolygon::SCALE);
+}
+
+static constexpr uint32_t
+ZigZagEncode(int32_t value) noexcept
+{
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static constexpr int32_t
+ZigZagDecode(uint32_t value) noexcept
+{
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static void
+WriteVarint(std::vector<std::byte> &dest, uint32_t value) noexcept
+{
+  while (value >= 0x80) {
+    dest.push_back(std::byte(value | 0x80));
+    value >>= 7;
+  }
+
+  dest.push_back(std::byte(value));
+}
+
+static uint32_t
+ReadVarint(const std::byte *&src) noexcept
+{
+  uint32_t value = 0;
+  unsigned shift = 0;
+
+  std::byte b;
+  do {
+    b = *src++;
+    value |= uint32_t(b & std::byte{0x7f}) << shift;
+    shift += 7;
+  } while ((b & std::byte{0x80}) != std::byte{});
+
+  return value;
+}
+
+static constexpr const GeoPoint &
+GetLocation(const GeoPoint &p) noexcept
+{
+  return p;
+}
+
+static constexpr const GeoPoint &
+GetLocation(const SearchPoint &p) noexcept
+{
+  return p.GetLocation();
+}
+
+/**
+ * Encode the coordinate differences between consecutive points.  The
+ * quantised values fit in 31 bits, so the differences are computed
+ * with wrap-around in 32 bit; decoding wraps back the same way.
+ */
+template<typename R>
+static AllocatedArray<std::byte>
+Encode(const R &points) noexcept
+{
+  std::vector<std::byte> buffer;
+  buffer.reserve(std::size(points) * 4);
+
+  uint32_t last_longitude = 0, last_latitude = 0;
+  for (const auto &i : points) {
+    const GeoPoint &p = GetLocation(i);
+    const uint32_t longitude = Quantise(p.longitude);
+    const uint32_t latitude = Quantise(p.latitude);
+
+    WriteVarint(buffer, ZigZagEncode(int32_t(longitude - last_longitude)));
+    WriteVarint(buffer, ZigZagEncode(int32_t(latitude - last_latitude)));
+
+    last_longitude = longitude;
+    last_latitude = latitude;
+  }
+
+  return AllocatedArray<std::byte>{std::span<const std::byte>{buffer}};
+}
+
+CompressedPolygon::CompressedPolygon(std::span<const GeoPoint> points) noexcept
+  :data(Encode(points)), n_points(points.size())
+{
+}
+
+CompressedPolygon::CompressedPolygon(const SearchPointVector &points) noexcept
+  :data(Encode(points)), n_points(points.size())
+{
+}
+
+void
+CompressedPolygon::Decode(SearchPointVector &dest) const noexcept
+{
+  dest.clear();
+  dest.reserve(n_points);
+
+  const std::byte *src = data.data();
+
+  uint32_t longitude = 0, latitude = 0;
+  for (unsigned i = 0; i < n_points; ++i) {
+    longitude += uint32_t(ZigZagDecode(ReadVarint(src)));
+    latitude += uint32_t(ZigZagDecode(ReadVarint(src)));
+
+    dest.emplace_back(GeoPoint{Dequantise(int32_t(longitude)),
+                               Dequantise(int32_t(latitude))});
+  }
+
+  assert(src == data.data() + data.size());
+}
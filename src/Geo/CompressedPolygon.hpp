@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "util/AllocatedArray.hxx"
+
+#include <cstddef>
+#include <span>
+
+struct GeoPoint;
+class SearchPointVector;
+
+/**
+ * A compact read-only copy of a list of #GeoPoint objects, e.g. an
+ * airspace border.  The coordinates are quantised to about 5 cm,
+ * delta-encoded and stored as zigzag/LEB128 variable-length
+ * integers, which takes 3-6 bytes per vertex for typical polygons
+ * instead of 24 bytes per #SearchPoint.
+ */
+class CompressedPolygon {
+  AllocatedArray<std::byte> data;
+
+  unsigned n_points = 0;
+
+public:
+  /**
+   * The number of quantisation steps per radian.
+   */
+  static constexpr double SCALE = 1 << 27;
+
+  CompressedPolygon() noexcept = default;
+
+  explicit CompressedPolygon(std::span<const GeoPoint> points) noexcept;
+  explicit CompressedPolygon(const SearchPointVector &points) noexcept;
+
+  bool empty() const noexcept {
+    return n_points == 0;
+  }
+
+  unsigned size() const noexcept {
+    return n_points;
+  }
+
+  /**
+   * Returns the number of bytes allocated for the encoded points.
+   */
+  std::size_t GetMemorySize() const noexcept {
+    return data.size();
+  }
+
+  /**
+   * Replace the contents of the given vector with the decoded
+   * points.  The points are not projected.
+   */
+  void Decode(SearchPointVector &dest) const noexcept;
+};
@@ -39,6 +39,15 @@ public:
     buffered.Flush();
   }
 
+  /**
+   * Flush the buffer and synchronise the file to the storage
+   * device.
+   */
+  void Sync() {
+    buffered.Flush();
+    file.Sync();
+  }
+
   void Sign();
 
 private:
@@ -52,11 +61,12 @@ private:
 
   static const char *GetHFFXARecord();
   static const char *GetIRecord();
+
+public:
   static double GetEPE(const GPSState &gps);
   /** Satellites in use if logger fix quality is a valid gps */
   static int GetSIU(const GPSState &gps);
 
-public:
   /**
    * @param logger_id the ID of the logger, consisting of exactly 3
    * alphanumeric characters (plain ASCII)
@@ -85,6 +95,5 @@ public:
   void LogEmptyFRecord(const BrokenTime &time);
   void LogFRecord(const BrokenTime &time, const int *satellite_ids);
 
-protected:
   void LogEvent(const BrokenTime &time, const char *event = "");
 };
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "Logger/LoggerImpl.hpp"
+#include "Logger/LoggerThread.hpp"
 #include "Logger/Settings.hpp"
 #include "LogFile.hpp"
 #include "LocalPath.hpp"
@@ -65,12 +66,17 @@ LoggerImpl::StopLogger([[maybe_unused]] const NMEAInfo &gps_info)
   if (writer == nullptr)
     return;
 
-  writer->Flush();
-
-  if (!simulator)
-    writer->Sign();
-
-  writer->Flush();
+  try {
+    if (writer->Finish(!simulator)) {
+      const auto statistics = writer->GetStatistics();
+      const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(statistics.max_write_duration);
+      LogFormat("Logger: %u records, max queue depth %zu, max write latency %u ms",
+                statistics.n_records, statistics.max_queue_depth,
+                (unsigned)latency.count());
+    }
+  } catch (...) {
+    LogError(std::current_exception());
+  }
 
   LogFormat(_T("Logger stopped: %s"), filename.c_str());
 
@@ -189,7 +195,7 @@ LoggerImpl::WritePoint(const NMEAInfo &gps_info)
   writer->LogPoint(gps_info);
 }
 
-bool
+std::unique_ptr<IGCWriter>
 LoggerImpl::StartLogger(const NMEAInfo &gps_info,
                         [[maybe_unused]] const LoggerSettings &settings,
                         const char *logger_id)
@@ -219,15 +225,17 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
 
   frecord.Reset();
 
+  std::unique_ptr<IGCWriter> igc;
+
   try {
-    writer = std::make_unique<IGCWriter>(filename);
+    igc = std::make_unique<IGCWriter>(filename);
   } catch (...) {
     LogError(std::current_exception());
-    return false;
+    return nullptr;
   }
 
   LogFormat(_T("Logger Started: %s"), filename.c_str());
-  return true;
+  return igc;
 }
 
 void
@@ -271,11 +279,12 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
                    asset_number[i] : _T('A');
   logger_id[3] = _T('\0');
 
-  if (!StartLogger(gps_info, settings, logger_id))
+  auto igc = StartLogger(gps_info, settings, logger_id);
+  if (igc == nullptr)
     return;
 
   simulator = gps_info.location_available && !gps_info.gps.real;
-  writer->WriteHeader(gps_info.date_time_utc, decl.pilot_name, decl.copilot_name,
+  igc->WriteHeader(gps_info.date_time_utc, decl.pilot_name, decl.copilot_name,
                       decl.aircraft_type, decl.aircraft_registration,
                       decl.competition_id,
                       logger_id, GetGPSDeviceName(), simulator);
@@ -284,13 +293,16 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
     BrokenDateTime FirstDateTime = !pre_takeoff_buffer.empty()
       ? pre_takeoff_buffer.peek().date_time_utc
       : gps_info.date_time_utc;
-    writer->StartDeclaration(FirstDateTime, decl.Size());
+    igc->StartDeclaration(FirstDateTime, decl.Size());
 
     for (unsigned i = 0; i< decl.Size(); ++i)
-      writer->AddDeclaration(decl.GetLocation(i), decl.GetName(i));
+      igc->AddDeclaration(decl.GetLocation(i), decl.GetName(i));
 
-    writer->EndDeclaration();
+    igc->EndDeclaration();
   }
+
+  /* from here on, the file is written by the LoggerThread */
+  writer = std::make_unique<LoggerThread>(std::move(igc));
 }
 
 void
@@ -18,6 +18,7 @@ struct NMEAInfo;
 struct LoggerSettings;
 struct Declaration;
 class IGCWriter;
+class LoggerThread;
 
 /**
  * Implementation of logger
@@ -74,7 +75,12 @@ public:
 
 private:
   AllocatedPath filename;
-  std::unique_ptr<IGCWriter> writer;
+
+  /**
+   * Writes the IGC file in a separate thread, to keep file I/O
+   * away from the #CalculationThread.
+   */
+  std::unique_ptr<LoggerThread> writer;
 
   OverwritingRingBuffer<PreTakeoffBuffer, PRETAKEOFF_BUFFER_MAX> pre_takeoff_buffer;
 
@@ -112,11 +118,15 @@ public:
 
 private:
   /**
+   * Create a new IGC file.
+   *
    * @param logger_id the ID of the logger, consisting of exactly 3
    * alphanumeric characters (plain ASCII)
+   * @return the new #IGCWriter or nullptr on error
    */
-  bool StartLogger(const NMEAInfo &gps_info, const LoggerSettings &settings,
-                   const char *logger_id);
+  std::unique_ptr<IGCWriter> StartLogger(const NMEAInfo &gps_info,
+                                         const LoggerSettings &settings,
+                                         const char *logger_id);
 
 private:
   void LogPointToBuffer(const NMEAInfo &gps_info) noexcept;
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "LoggerThread.hpp"
+#include "IGC/IGCWriter.hpp"
+#include "NMEA/Info.hpp"
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+LoggerThread::LoggerThread(std::unique_ptr<IGCWriter> &&_writer) noexcept
+  :StandbyThread("Logger"), writer(std::move(_writer)),
+   last_sync(std::chrono::steady_clock::now())
+{
+  assert(writer != nullptr);
+
+  fix.Clear();
+
+  queue.reserve(MAX_QUEUE);
+  batch.reserve(MAX_QUEUE);
+}
+
+LoggerThread::~LoggerThread() noexcept
+{
+  LockStop();
+}
+
+void
+LoggerThread::Push(Record &&record)
+{
+  std::unique_lock lock{mutex};
+
+  if (queue.size() >= MAX_QUEUE)
+    /* the thread is too slow; wait for it to catch up instead of
+       dropping records */
+    WaitDone(lock);
+
+  queue.push_back(std::move(record));
+  statistics.max_queue_depth = std::max(statistics.max_queue_depth,
+                                        queue.size());
+
+  Trigger();
+}
+
+void
+LoggerThread::LogPoint(const NMEAInfo &gps_info)
+{
+  if (!fix.Apply(gps_info))
+    return;
+
+  Record record(Record::Type::FIX);
+  record.fix = fix;
+  record.epe = gps_info.location_available
+    ? (int)IGCWriter::GetEPE(gps_info.gps)
+    : 0;
+  record.satellites = IGCWriter::GetSIU(gps_info.gps);
+  Push(std::move(record));
+}
+
+void
+LoggerThread::LogEvent(const NMEAInfo &gps_info, const char *event)
+{
+  Record record(Record::Type::EVENT);
+  record.time = gps_info.date_time_utc;
+  record.event = event;
+  Push(std::move(record));
+
+  // tech_spec_gnss.pdf says we need a B record immediately after an E record
+  LogPoint(gps_info);
+}
+
+void
+LoggerThread::LogEmptyFRecord(const BrokenTime &time)
+{
+  Record record(Record::Type::F_RECORD);
+  record.time = time;
+  record.satellite_ids_available = false;
+  Push(std::move(record));
+}
+
+void
+LoggerThread::LogFRecord(const BrokenTime &time, const int *satellite_ids)
+{
+  Record record(Record::Type::F_RECORD);
+  record.time = time;
+  record.satellite_ids_available = true;
+  std::copy_n(satellite_ids, record.satellite_ids.size(),
+              record.satellite_ids.begin());
+  Push(std::move(record));
+}
+
+void
+LoggerThread::LoggerNote(const TCHAR *text)
+{
+  Record record(Record::Type::NOTE);
+  record.note = text;
+  Push(std::move(record));
+}
+
+inline void
+LoggerThread::WriteBatch()
+{
+  for (const auto &record : batch) {
+    switch (record.type) {
+    case Record::Type::FIX:
+      writer->LogPoint(record.fix, record.epe, record.satellites);
+      break;
+
+    case Record::Type::EVENT:
+      writer->LogEvent(record.time, record.event.c_str());
+      break;
+
+    case Record::Type::F_RECORD:
+      if (record.satellite_ids_available)
+        writer->LogFRecord(record.time, record.satellite_ids.data());
+      else
+        writer->LogEmptyFRecord(record.time);
+      break;
+
+    case Record::Type::NOTE:
+      writer->LoggerNote(record.note.c_str());
+      break;
+    }
+  }
+
+  writer->Flush();
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now >= last_sync + SYNC_INTERVAL) {
+    writer->Sync();
+    last_sync = now;
+  }
+}
+
+void
+LoggerThread::Tick() noexcept
+{
+  assert(batch.empty());
+
+  batch.swap(queue);
+
+  if (!failed) {
+    bool success;
+    std::chrono::steady_clock::duration duration;
+
+    {
+      const ScopeUnlock unlock(mutex);
+
+      const auto start = std::chrono::steady_clock::now();
+
+      try {
+        WriteBatch();
+        success = true;
+      } catch (...) {
+        LogError(std::current_exception(), "Failed to write IGC file");
+        success = false;
+      }
+
+      duration = std::chrono::steady_clock::now() - start;
+    }
+
+    statistics.max_write_duration = std::max(statistics.max_write_duration,
+                                             duration);
+    if (success)
+      statistics.n_records += batch.size();
+    else
+      failed = true;
+  }
+
+  batch.clear();
+}
+
+bool
+LoggerThread::Finish(bool sign)
+{
+  {
+    std::unique_lock lock{mutex};
+    WaitDone(lock);
+    Stop();
+
+    if (failed)
+      return false;
+  }
+
+  /* the thread has exited; now we can access the writer directly */
+
+  writer->Flush();
+
+  if (sign)
+    writer->Sign();
+
+  writer->Flush();
+  writer->Sync();
+  return true;
+}
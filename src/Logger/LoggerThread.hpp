@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "thread/StandbyThread.hpp"
+#include "IGC/IGCFix.hpp"
+#include "NMEA/GPSState.hpp"
+#include "time/BrokenTime.hpp"
+#include "util/tstring.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <tchar.h>
+
+struct NMEAInfo;
+class IGCWriter;
+
+/**
+ * Writes the records of an IGC file in a separate thread.  The
+ * caller (usually the #CalculationThread) only converts each fix to a
+ * compact binary record and appends it to a queue.  The thread does
+ * the formatting, the G record digest and the file I/O.  This way, a
+ * stalling storage device (e.g. a slow SD card) does not delay the
+ * caller.
+ *
+ * Durability policy: after each batch of records, the data is passed
+ * to the kernel (just like #IGCWriter does after each B record), and
+ * every #SYNC_INTERVAL, it is synchronised to the storage device.
+ *
+ * All public methods must be called from the same thread (or with a
+ * mutex which serialises them, see #Logger).
+ */
+class LoggerThread final : private StandbyThread {
+public:
+  /**
+   * The maximum number of records in the queue.  If the thread
+   * falls behind this far (several minutes at one fix per second),
+   * the caller blocks until the queue has been written, because
+   * dropping fixes would corrupt the flight log.
+   */
+  static constexpr std::size_t MAX_QUEUE = 256;
+
+  static constexpr std::chrono::steady_clock::duration SYNC_INTERVAL =
+    std::chrono::minutes(1);
+
+  struct Statistics {
+    /**
+     * The number of records which were written.
+     */
+    unsigned n_records = 0;
+
+    /**
+     * The largest number of records which were waiting in the
+     * queue.
+     */
+    std::size_t max_queue_depth = 0;
+
+    /**
+     * The longest time it took to write one batch of records.
+     */
+    std::chrono::steady_clock::duration max_write_duration{};
+  };
+
+private:
+  struct Record {
+    enum class Type : uint8_t {
+      /**
+       * A B record with #fix, #epe and #satellites.
+       */
+      FIX,
+
+      /**
+       * An E record with #time and #event.
+       */
+      EVENT,
+
+      /**
+       * An F record with #time and (if #satellite_ids_available)
+       * #satellite_ids.
+       */
+      F_RECORD,
+
+      /**
+       * An L record with #note.
+       */
+      NOTE,
+    } type;
+
+    bool satellite_ids_available;
+
+    int epe, satellites;
+
+    IGCFix fix;
+
+    BrokenTime time;
+
+    std::array<int, GPSState::MAXSATELLITES> satellite_ids;
+
+    std::string event;
+
+    tstring note;
+
+    explicit Record(Type _type) noexcept:type(_type) {}
+  };
+
+  /**
+   * Only accessed by the thread (and after the thread was stopped).
+   */
+  const std::unique_ptr<IGCWriter> writer;
+
+  /**
+   * The last fix, used by the caller to build B records.
+   */
+  IGCFix fix;
+
+  /**
+   * New records which have not yet been picked up by the thread.
+   * Protected by the mutex.
+   */
+  std::vector<Record> queue;
+
+  /**
+   * The records which are being written by the thread.
+   */
+  std::vector<Record> batch;
+
+  std::chrono::steady_clock::time_point last_sync;
+
+  /**
+   * Protected by the mutex.
+   */
+  Statistics statistics;
+
+  /**
+   * Set by the thread after a write error; all further records are
+   * discarded.  Protected by the mutex.
+   */
+  bool failed = false;
+
+public:
+  /**
+   * @param writer an #IGCWriter which has already written the
+   * header
+   */
+  explicit LoggerThread(std::unique_ptr<IGCWriter> &&writer) noexcept;
+  ~LoggerThread() noexcept;
+
+  void LogPoint(const NMEAInfo &gps_info);
+  void LogEvent(const NMEAInfo &gps_info, const char *event);
+  void LogEmptyFRecord(const BrokenTime &time);
+  void LogFRecord(const BrokenTime &time, const int *satellite_ids);
+  void LoggerNote(const TCHAR *text);
+
+  /**
+   * Write all pending records, stop the thread, optionally append
+   * the G record and synchronise the file.
+   *
+   * Throws on I/O error.
+   *
+   * @return false if a write error occurred in the thread (which
+   * has already been logged)
+   */
+  bool Finish(bool sign);
+
+  Statistics GetStatistics() noexcept {
+    const std::lock_guard lock{mutex};
+    return statistics;
+  }
+
+private:
+  void Push(Record &&record);
+
+  /**
+   * Write all records in #batch.  Called by the thread without the
+   * mutex.
+   *
+   * Throws on I/O error.
+   */
+  void WriteBatch();
+
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override;
+};
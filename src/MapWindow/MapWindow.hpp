@@ -35,6 +35,7 @@ class MapOverlay;
 class Waypoints;
 class Airspaces;
 class ProtectedTaskManager;
+class ProtectedRoutePlanner;
 class GlideComputer;
 class ContainerWindow;
 class NOAAStore;
@@ -115,9 +115,6 @@ MapWindow::RenderAirspace(Canvas &canvas) noexcept
 {
   if (GetMapSettings().airspace.enable) {
     airspace_renderer.Draw(canvas,
-#ifndef ENABLE_OPENGL
-                           buffer_canvas,
-#endif
                            render_projection,
                            Basic(), Calculated(),
                            GetComputerSettings().airspace,
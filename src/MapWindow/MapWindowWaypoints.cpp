@@ -2,14 +2,16 @@
 // Copyright The XCSoar Project
 
 #include "MapWindow.hpp"
+#include "Computer/GlideComputer.hpp"
 
 void
 MapWindow::DrawWaypoints(Canvas &canvas) noexcept
 {
   waypoint_renderer.Render(canvas, label_block,
                            render_projection, GetMapSettings().waypoint,
-                           GetComputerSettings().polar,
                            GetComputerSettings().task,
-                           Basic(), Calculated(),
-                           task, route_planner);
+                           Basic(), task,
+                           glide_computer != nullptr
+                           ? &glide_computer->GetWaypointReach()
+                           : nullptr);
 }
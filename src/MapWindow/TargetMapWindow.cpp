@@ -20,7 +20,6 @@
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/Scissor.hpp"
 #else
-#include "ui/canvas/WindowCanvas.hpp"
 #endif
 
 static const ComputerSettings &
@@ -110,9 +109,6 @@ TargetMapWindow::RenderAirspace(Canvas &canvas) noexcept
 {
   if (GetMapSettings().airspace.enable)
     airspace_renderer.Draw(canvas,
-#ifndef ENABLE_OPENGL
-                           buffer_canvas,
-#endif
                            projection,
                            Basic(), Calculated(),
                            GetComputerSettings().airspace,
@@ -153,10 +149,11 @@ TargetMapWindow::DrawWaypoints(Canvas &canvas) noexcept
 
   way_point_renderer.Render(canvas, label_block,
                             projection, settings,
-                            GetComputerSettings().polar,
                             GetComputerSettings().task,
-                            Basic(), Calculated(),
-                            task, nullptr);
+                            Basic(), task,
+                            glide_computer != nullptr
+                            ? &glide_computer->GetWaypointReach()
+                            : nullptr);
 }
 
 inline void
@@ -311,10 +308,6 @@ TargetMapWindow::OnResize(PixelSize new_size) noexcept
 {
   BufferWindow::OnResize(new_size);
 
-#ifndef ENABLE_OPENGL
-  buffer_canvas.Grow(new_size);
-#endif
-
   projection.SetScreenSize(new_size);
   projection.SetScreenOrigin(PixelRect{new_size}.GetCenter());
   projection.UpdateScreenBounds();
@@ -326,11 +319,6 @@ TargetMapWindow::OnCreate()
   BufferWindow::OnCreate();
 
   drag_mode = DRAG_NONE;
-
-#ifndef ENABLE_OPENGL
-  WindowCanvas canvas(*this);
-  buffer_canvas.Create(canvas);
-#endif
 }
 
 void
@@ -341,9 +329,5 @@ TargetMapWindow::OnDestroy() noexcept
   SetAirspaces(nullptr);
   SetWaypoints(nullptr);
 
-#ifndef ENABLE_OPENGL
-  buffer_canvas.Destroy();
-#endif
-
   BufferWindow::OnDestroy();
 }
@@ -11,10 +11,6 @@
 #include "Renderer/WaypointRenderer.hpp"
 #include "Renderer/TrailRenderer.hpp"
 
-#ifndef ENABLE_OPENGL
-#include "ui/canvas/BufferCanvas.hpp"
-#endif
-
 struct WaypointLook;
 struct TaskLook;
 struct AircraftLook;
@@ -34,12 +30,6 @@ class TargetMapWindow : public BufferWindow {
   const TopographyLook &topography_look;
   const OverlayLook &overlay_look;
 
-#ifndef ENABLE_OPENGL
-  // graphics vars
-
-  BufferCanvas buffer_canvas;
-#endif
-
   MapWindowProjection projection;
 
   LabelBlock label_block;
@@ -70,6 +70,14 @@ public:
     return last.count();
   }
 
+  /**
+   * Returns the time stamp of the last update.  Only meaningful if
+   * IsValid() is true.
+   */
+  constexpr TimeStamp ToTimeStamp() const noexcept {
+    return Export(last);
+  }
+
   /**
    * Checks if the time stamp has expired, and calls clear() if so.
    *
@@ -4,9 +4,16 @@
 #include "Projection.hpp"
 #include "Geo/FAISphere.hpp"
 #include "Math/Angle.hpp"
+#include "Math/FastTrig.hpp"
 
 #include <algorithm>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 Projection::Projection() noexcept
 {
   SetScale(1);
@@ -53,6 +60,140 @@ Projection::GeoToScreen(const GeoPoint &g) const noexcept
   return sc;
 }
 
+#if defined(__SSE2__) || defined(__aarch64__)
+
+/**
+ * Look up the fastcosine() of two latitudes which have already been
+ * converted with UnsafeRadiansToIntAngle().
+ */
+static inline std::pair<double, double>
+FastCosinePair(unsigned a, unsigned b) noexcept
+{
+  return {SINETABLE[IntAngleForCos(a)], SINETABLE[IntAngleForCos(b)]};
+}
+
+#endif
+
+void
+Projection::GeoToScreen(std::span<const GeoPoint> src,
+                        std::span<PixelPoint> dest) const noexcept
+{
+  assert(IsValid());
+  assert(dest.size() >= src.size());
+
+  static_assert(sizeof(GeoPoint) == 2 * sizeof(double));
+
+  std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(__aarch64__)
+  /* this mirrors GeoPoint::operator-(), Angle::AsDelta(),
+     Angle::fastcosine() and AngleToPixels() for two points at a time;
+     AsDelta()'s special case for denormals can be omitted, because
+     they become zero pixels anyway */
+
+  std::array<int, 4> raw;
+
+  for (const std::size_t n = src.size() & ~std::size_t(1); i < n; i += 2) {
+    const double *p = reinterpret_cast<const double *>(&src[i]);
+
+#ifdef __SSE2__
+    const __m128d p0 = _mm_loadu_pd(p), p1 = _mm_loadu_pd(p + 2);
+    const __m128d longitude = _mm_unpacklo_pd(p0, p1);
+    const __m128d latitude = _mm_unpackhi_pd(p0, p1);
+
+    const __m128d pi = _mm_set1_pd(M_PI), minus_pi = _mm_set1_pd(-M_PI);
+    const __m128d two_pi = _mm_set1_pd(M_2PI);
+
+    __m128d dlon = _mm_sub_pd(_mm_set1_pd(geo_location.longitude.Native()),
+                              longitude);
+    dlon = _mm_add_pd(dlon, _mm_and_pd(_mm_cmple_pd(dlon, minus_pi), two_pi));
+    dlon = _mm_sub_pd(dlon, _mm_and_pd(_mm_cmpgt_pd(dlon, pi), two_pi));
+
+    if (_mm_movemask_pd(_mm_or_pd(_mm_cmple_pd(dlon, minus_pi),
+                                  _mm_cmpgt_pd(dlon, pi))) != 0) {
+      /* more than one full circle away; let the scalar code handle
+         this */
+      dest[i] = GeoToScreen(src[i]);
+      dest[i + 1] = GeoToScreen(src[i + 1]);
+      continue;
+    }
+
+    const __m128d dlat =
+      _mm_max_pd(_mm_set1_pd(-M_PI_2),
+                 _mm_min_pd(_mm_set1_pd(M_PI_2),
+                            _mm_sub_pd(_mm_set1_pd(geo_location.latitude.Native()),
+                                       latitude)));
+
+    const __m128i int_angle =
+      _mm_cvttpd_epi32(_mm_add_pd(_mm_mul_pd(latitude,
+                                             _mm_set1_pd(INT_ANGLE_MULT)),
+                                  _mm_set1_pd(10 * INT_ANGLE_RANGE + 0.5)));
+    const auto [cos0, cos1] =
+      FastCosinePair(_mm_cvtsi128_si32(int_angle),
+                     _mm_cvtsi128_si32(_mm_srli_si128(int_angle, 4)));
+
+    const __m128d scale = _mm_set1_pd(draw_scale);
+    const __m128i x = _mm_cvttpd_epi32(_mm_mul_pd(_mm_set_pd(cos1, cos0),
+                                                  _mm_mul_pd(dlon, scale)));
+    const __m128i y = _mm_cvttpd_epi32(_mm_mul_pd(dlat, scale));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(raw.data()),
+                     _mm_unpacklo_epi64(x, y));
+#else
+    const float64x2x2_t p01 = vld2q_f64(p);
+    const float64x2_t longitude = p01.val[0], latitude = p01.val[1];
+
+    const float64x2_t pi = vdupq_n_f64(M_PI), minus_pi = vdupq_n_f64(-M_PI);
+    const float64x2_t zero = vdupq_n_f64(0), two_pi = vdupq_n_f64(M_2PI);
+
+    float64x2_t dlon = vsubq_f64(vdupq_n_f64(geo_location.longitude.Native()),
+                                 longitude);
+    dlon = vaddq_f64(dlon, vbslq_f64(vcleq_f64(dlon, minus_pi), two_pi, zero));
+    dlon = vsubq_f64(dlon, vbslq_f64(vcgtq_f64(dlon, pi), two_pi, zero));
+
+    if (vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(vcleq_f64(dlon, minus_pi),
+                                                   vcgtq_f64(dlon, pi)))) != 0) {
+      /* more than one full circle away; let the scalar code handle
+         this */
+      dest[i] = GeoToScreen(src[i]);
+      dest[i + 1] = GeoToScreen(src[i + 1]);
+      continue;
+    }
+
+    const float64x2_t dlat =
+      vmaxq_f64(vdupq_n_f64(-M_PI_2),
+                vminq_f64(vdupq_n_f64(M_PI_2),
+                          vsubq_f64(vdupq_n_f64(geo_location.latitude.Native()),
+                                    latitude)));
+
+    const uint64x2_t int_angle =
+      vcvtq_u64_f64(vaddq_f64(vmulq_f64(latitude,
+                                        vdupq_n_f64(INT_ANGLE_MULT)),
+                              vdupq_n_f64(10 * INT_ANGLE_RANGE + 0.5)));
+    const auto [cos0, cos1] =
+      FastCosinePair(vgetq_lane_u64(int_angle, 0),
+                     vgetq_lane_u64(int_angle, 1));
+    const float64x2_t cos = vsetq_lane_f64(cos1, vdupq_n_f64(cos0), 1);
+
+    const float64x2_t scale = vdupq_n_f64(draw_scale);
+    const int32x2_t x = vmovn_s64(vcvtq_s64_f64(vmulq_f64(cos,
+                                                          vmulq_f64(dlon, scale))));
+    const int32x2_t y = vmovn_s64(vcvtq_s64_f64(vmulq_f64(dlat, scale)));
+
+    vst1q_s32(raw.data(), vcombine_s32(x, y));
+#endif
+
+    for (unsigned j = 0; j < 2; ++j) {
+      const auto r = screen_rotation.Rotate(PixelPoint(raw[j], raw[2 + j]));
+      dest[i + j] = {screen_origin.x - r.x, screen_origin.y + r.y};
+    }
+  }
+#endif
+
+  for (; i < src.size(); ++i)
+    dest[i] = GeoToScreen(src[i]);
+}
+
 void
 Projection::SetScale(const double _scale) noexcept
 {
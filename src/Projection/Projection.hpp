@@ -8,7 +8,10 @@
 #include "Math/Util.hpp"
 #include "ui/dim/Point.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <span>
 
 /**
  * This is a class that can be used for converting geographical into screen
@@ -119,6 +122,34 @@ public:
   [[gnu::pure]]
   PixelPoint GeoToScreen(const GeoPoint &g) const noexcept;
 
+  /**
+   * Converts many GeoPoints to screen coordinates.  The results are
+   * the same as calling GeoToScreen() for each point, but this
+   * method converts several points at a time (with SSE2 or NEON
+   * where available).
+   *
+   * @param dest the destination buffer, must be as large as #src
+   */
+  void GeoToScreen(std::span<const GeoPoint> src,
+                   std::span<PixelPoint> dest) const noexcept;
+
+  /**
+   * Converts many GeoPoints to screen coordinates of another point
+   * type (e.g. #BulkPixelPoint).
+   */
+  template<typename P>
+  void GeoToScreen(std::span<const GeoPoint> src, P *dest) const noexcept {
+    std::array<PixelPoint, 64> buffer;
+
+    while (!src.empty()) {
+      const std::size_t n = std::min(src.size(), buffer.size());
+      const std::span<PixelPoint> chunk{buffer.data(), n};
+      GeoToScreen(src.first(n), chunk);
+      dest = std::copy(chunk.begin(), chunk.end(), dest);
+      src = src.subspan(n);
+    }
+  }
+
   /**
    * Returns the origin/rotation center in screen coordinates
    * @return The origin/rotation center in screen coordinates
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#ifdef ENABLE_OPENGL
+
+#include "AirspacePolygonCache.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "ui/canvas/Pen.hpp"
+#include "ui/canvas/opengl/Buffer.hpp"
+#include "ui/canvas/opengl/Geo.hpp"
+#include "ui/canvas/opengl/Globals.hpp"
+#include "ui/canvas/opengl/Shaders.hpp"
+#include "ui/canvas/opengl/Program.hpp"
+#include "ui/canvas/opengl/Triangulate.hpp"
+#include "ui/canvas/opengl/VertexPointer.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <limits>
+
+AirspacePolygonCache::AirspacePolygonCache() noexcept = default;
+AirspacePolygonCache::~AirspacePolygonCache() noexcept = default;
+
+void
+AirspacePolygonCache::Clear() noexcept
+{
+  polygons.clear();
+  vertices.clear();
+  n_uploaded = 0;
+}
+
+void
+AirspacePolygonCache::Update(const Airspaces &_airspaces) noexcept
+{
+  if (&_airspaces == airspaces && _airspaces.GetSerial() == serial)
+    return;
+
+  /* the AbstractAirspace pointers may be stale */
+  Clear();
+
+  airspaces = &_airspaces;
+  serial = _airspaces.GetSerial();
+}
+
+void
+AirspacePolygonCache::Add(const AirspacePolygon &airspace) noexcept
+{
+  const auto border = airspace.GetPoints();
+  const SearchPointVector &points = *border;
+  const std::size_t n = points.size();
+  if (n < 3 || n > std::numeric_limits<GLushort>::max())
+    return;
+
+  auto [i, inserted] = polygons.try_emplace(&airspace);
+  if (!inserted)
+    return;
+
+  Polygon &polygon = i->second;
+  polygon.reference = airspace.GetReferenceLocation();
+  polygon.offset = vertices.size();
+  polygon.n_vertices = n;
+
+  for (const auto &p : points) {
+    const GeoPoint delta = p.GetLocation() - polygon.reference;
+    vertices.emplace_back(float(delta.longitude.Native()),
+                          float(delta.latitude.Native()));
+  }
+
+  /* the triangulation is done in geographic coordinates; it does not
+     change with the projection, because projecting is an affine
+     transformation (at least as far as the shader is concerned) */
+  polygon.triangles.resize(3 * (n - 2));
+  const unsigned n_indices =
+    PolygonToTriangles(vertices.data() + polygon.offset, n,
+                       polygon.triangles.data(), 0);
+  polygon.triangles.resize(n_indices);
+}
+
+void
+AirspacePolygonCache::Commit() noexcept
+{
+  if (n_uploaded == vertices.size())
+    return;
+
+  if (buffer == nullptr)
+    buffer = std::make_unique<GLArrayBuffer>();
+
+  buffer->Load(GLsizeiptr(vertices.size() * sizeof(vertices.front())),
+               vertices.data());
+  n_uploaded = vertices.size();
+}
+
+inline void
+AirspacePolygonCache::Begin(const WindowProjection &projection,
+                            const GeoPoint &reference) const noexcept
+{
+  assert(buffer != nullptr);
+  assert(n_uploaded == vertices.size());
+
+  OpenGL::solid_shader->Use();
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(ToGLM(projection, reference)));
+
+  buffer->Bind();
+}
+
+inline void
+AirspacePolygonCache::End() noexcept
+{
+  GLArrayBuffer::Unbind();
+
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(glm::mat4(1)));
+}
+
+bool
+AirspacePolygonCache::DrawInterior(const Polygon &polygon,
+                                   const WindowProjection &projection,
+                                   Color color) const noexcept
+{
+  if (polygon.triangles.empty())
+    return false;
+
+  Begin(projection, polygon.reference);
+
+  const FloatPoint2D *const base = nullptr;
+  const ScopeVertexPointer vp(GL_FLOAT, base + polygon.offset);
+
+  color.Bind();
+  glDrawElements(GL_TRIANGLES, polygon.triangles.size(), GL_UNSIGNED_SHORT,
+                 polygon.triangles.data());
+
+  End();
+  return true;
+}
+
+bool
+AirspacePolygonCache::IsOutlineSupported(const Pen &pen) noexcept
+{
+  /* wider lines need to be converted to triangles in screen
+     coordinates, and dashed lines need a different shader, see
+     Canvas::DrawPolygon() */
+  return pen.GetWidth() <= 2 && pen.GetStyle() == Pen::SOLID;
+}
+
+void
+AirspacePolygonCache::DrawOutline(const Polygon &polygon,
+                                  const WindowProjection &projection,
+                                  const Pen &pen) const noexcept
+{
+  assert(IsOutlineSupported(pen));
+
+  Begin(projection, polygon.reference);
+
+  const FloatPoint2D *const base = nullptr;
+  const ScopeVertexPointer vp(GL_FLOAT, base);
+
+  pen.Bind();
+  glDrawArrays(GL_LINE_LOOP, polygon.offset, polygon.n_vertices);
+  pen.Unbind();
+
+  End();
+}
+
+#endif /* ENABLE_OPENGL */
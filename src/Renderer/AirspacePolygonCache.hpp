@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoPoint.hpp"
+#include "Math/Point2D.hpp"
+#include "util/Serial.hpp"
+#include "ui/opengl/System.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class AbstractAirspace;
+class AirspacePolygon;
+class Airspaces;
+class WindowProjection;
+class GLArrayBuffer;
+class Color;
+class Pen;
+
+/**
+ * Caches the vertices and the triangulation of airspace polygons for
+ * the OpenGL renderer.  The vertices of all polygons are stored in
+ * one vertex buffer object, relative to each airspace's reference
+ * location; the projection to the screen is done by the shader.
+ * This way, drawing an airspace costs only a few OpenGL calls, and
+ * nothing needs to be projected, triangulated or uploaded again
+ * when the map moves.
+ */
+class AirspacePolygonCache {
+public:
+  struct Polygon {
+    GeoPoint reference;
+
+    /**
+     * The index of the first vertex in the vertex buffer.
+     */
+    unsigned offset;
+
+    unsigned n_vertices;
+
+    /**
+     * Triangle indices relative to #offset.  Empty if the polygon
+     * could not be triangulated.
+     */
+    std::vector<GLushort> triangles;
+  };
+
+private:
+  const Airspaces *airspaces = nullptr;
+  Serial serial;
+
+  std::unordered_map<const AbstractAirspace *, Polygon> polygons;
+
+  std::vector<FloatPoint2D> vertices;
+
+  std::unique_ptr<GLArrayBuffer> buffer;
+
+  /**
+   * The number of #vertices which have been uploaded to #buffer.
+   */
+  std::size_t n_uploaded = 0;
+
+public:
+  AirspacePolygonCache() noexcept;
+  ~AirspacePolygonCache() noexcept;
+
+  AirspacePolygonCache(const AirspacePolygonCache &) = delete;
+  AirspacePolygonCache &operator=(const AirspacePolygonCache &) = delete;
+
+  /**
+   * Discard the cache if the given airspace database is a different
+   * one or has been modified.
+   */
+  void Update(const Airspaces &airspaces) noexcept;
+
+  /**
+   * Add the polygon to the cache (if it is not already).  Call
+   * Commit() before drawing.
+   */
+  void Add(const AirspacePolygon &airspace) noexcept;
+
+  /**
+   * Upload new vertices to the vertex buffer object.
+   */
+  void Commit() noexcept;
+
+  /**
+   * Look up a polygon previously passed to Add().
+   *
+   * @return nullptr if the polygon is not in the cache
+   */
+  [[gnu::pure]]
+  const Polygon *Get(const AbstractAirspace &airspace) const noexcept {
+    auto i = polygons.find(&airspace);
+    return i != polygons.end() ? &i->second : nullptr;
+  }
+
+  /**
+   * Fill the polygon with the solid shader, using the given color.
+   *
+   * @return false if the polygon has no triangulation
+   */
+  bool DrawInterior(const Polygon &polygon,
+                    const WindowProjection &projection,
+                    Color color) const noexcept;
+
+  /**
+   * Draw the polygon's outline with the solid shader.  Only solid
+   * pens which are not wider than 2 pixels are supported.
+   */
+  void DrawOutline(const Polygon &polygon,
+                   const WindowProjection &projection,
+                   const Pen &pen) const noexcept;
+
+  /**
+   * Can the given #Pen be used with DrawOutline()?
+   */
+  [[gnu::pure]]
+  static bool IsOutlineSupported(const Pen &pen) noexcept;
+
+private:
+  void Clear() noexcept;
+
+  /**
+   * Bind the vertex buffer and set up the shader to project
+   * vertices relative to the given reference location.
+   */
+  void Begin(const WindowProjection &projection,
+             const GeoPoint &reference) const noexcept;
+  static void End() noexcept;
+};
@@ -33,7 +33,8 @@ GetPolygonPoints(std::vector<BulkPixelPoint> &pts,
   projection.SetScreenAngle(Angle::Zero());
   projection.UpdateScreenBounds();
 
-  const SearchPointVector &border = airspace.GetPoints();
+  const auto border_ptr = airspace.GetPoints();
+  const SearchPointVector &border = *border_ptr;
 
   pts.reserve(border.size());
   for (auto it = border.begin(), it_end = border.end(); it != it_end; ++it)
@@ -7,12 +7,15 @@
 #include "Look/AirspaceLook.hpp"
 #include "Airspace/Airspaces.hpp"
 #include "Airspace/AirspaceVisibility.hpp"
+#include "Airspace/AirspaceComputerSettings.hpp"
 #include "Airspace/AirspaceWarning.hpp"
 #include "Airspace/ProtectedAirspaceWarningManager.hpp"
 #include "Airspace/AirspaceWarningCopy.hpp"
 #include "Engine/Airspace/AirspaceWarningManager.hpp"
 #include "NMEA/Aircraft.hpp"
 
+#include <algorithm>
+
 class AirspaceMapVisible
 {
   const AirspaceVisibility visible_predicate;
@@ -33,6 +36,129 @@ public:
   }
 };
 
+#ifndef ENABLE_OPENGL
+
+static void
+AddThresholds(std::vector<double> &base, std::vector<double> &top,
+              std::vector<double> &agl_base, std::vector<double> &agl_top,
+              const AbstractAirspace &airspace, double margin) noexcept
+{
+  /* see AirspaceAltitude::IsBelow() and AirspaceAltitude::IsAbove();
+     for AGL altitudes, only the aircraft's height above terrain
+     matters */
+  const AirspaceAltitude &b = airspace.GetBase();
+  if (b.reference == AltitudeReference::AGL) {
+    if (!b.IsTerrain())
+      agl_base.push_back(b.altitude_above_terrain - margin);
+  } else
+    base.push_back(b.altitude - margin);
+
+  const AirspaceAltitude &t = airspace.GetTop();
+  if (t.reference == AltitudeReference::AGL)
+    agl_top.push_back(t.altitude_above_terrain + margin);
+  else
+    top.push_back(t.altitude + margin);
+}
+
+void
+AirspaceRenderer::AltitudeBands::Update(const Airspaces &_airspaces,
+                                        double _margin) noexcept
+{
+  if (&_airspaces == airspaces && _airspaces.GetSerial() == serial &&
+      _margin == margin)
+    return;
+
+  airspaces = &_airspaces;
+  serial = _airspaces.GetSerial();
+  margin = _margin;
+
+  base.clear();
+  top.clear();
+  agl_base.clear();
+  agl_top.clear();
+
+  for (const auto &i : _airspaces.QueryAll())
+    AddThresholds(base, top, agl_base, agl_top, i.GetAirspace(), margin);
+
+  for (auto *v : {&base, &top, &agl_base, &agl_top}) {
+    std::sort(v->begin(), v->end());
+    v->erase(std::unique(v->begin(), v->end()), v->end());
+  }
+}
+
+std::size_t
+AirspaceRenderer::AltitudeBands::GetKey(const AltitudeState &state,
+                                        bool with_top) const noexcept
+{
+  /* the number of thresholds at or below the altitude ("base") and
+     the number of thresholds below it ("top") */
+  const auto at_or_below = [](const std::vector<double> &v, double value){
+    return std::size_t(std::upper_bound(v.begin(), v.end(), value) -
+                       v.begin());
+  };
+
+  const auto below = [](const std::vector<double> &v, double value){
+    return std::size_t(std::lower_bound(v.begin(), v.end(), value) -
+                       v.begin());
+  };
+
+  std::size_t key = at_or_below(base, state.altitude);
+  key = key * 31 + at_or_below(agl_base, state.altitude_agl);
+
+  if (with_top) {
+    key = key * 31 + below(top, state.altitude);
+    key = key * 31 + below(agl_top, state.altitude_agl);
+  }
+
+  return key;
+}
+
+/**
+ * Calculate a hash of the inputs of #AirspaceMapVisible (except for
+ * the warnings, which have their own serial).  Aircraft altitudes
+ * are only included if the display mode depends on them, and only
+ * as the altitude band, so the hash changes only if an airspace
+ * changes its visibility.
+ */
+std::size_t
+AirspaceRenderer::GetVisibleKey(const AirspaceComputerSettings &computer_settings,
+                                const AirspaceRendererSettings &renderer_settings,
+                                const AltitudeState &state) noexcept
+{
+  std::size_t key = std::size_t(renderer_settings.altitude_mode) + 1;
+  const auto add = [&key](std::size_t value){
+    key = key * 31 + value;
+  };
+
+  switch (renderer_settings.altitude_mode) {
+  case AirspaceDisplayMode::ALLON:
+  case AirspaceDisplayMode::ALLOFF:
+    break;
+
+  case AirspaceDisplayMode::CLIP:
+    add(renderer_settings.clip_altitude);
+    break;
+
+  case AirspaceDisplayMode::AUTO:
+  case AirspaceDisplayMode::ALLBELOW:
+    add(computer_settings.warnings.altitude_warning_margin);
+    altitude_bands.Update(*airspaces,
+                          computer_settings.warnings.altitude_warning_margin);
+    add(altitude_bands.GetKey(state, renderer_settings.altitude_mode ==
+                              AirspaceDisplayMode::AUTO));
+    break;
+
+  case AirspaceDisplayMode::INSIDE:
+    altitude_bands.Update(*airspaces, 0);
+    add(altitude_bands.GetKey(state, true));
+    break;
+  }
+
+  return key;
+}
+
+#endif /* !ENABLE_OPENGL */
+
 void
 AirspaceRenderer::DrawIntersections(Canvas &canvas,
                                     const WindowProjection &projection) const
@@ -45,31 +171,23 @@ AirspaceRenderer::DrawIntersections(Canvas &canvas,
 
 void
 AirspaceRenderer::Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-                       Canvas &stencil_canvas,
-#endif
                        const WindowProjection &projection,
                        const AirspaceRendererSettings &settings,
                        const AirspaceWarningCopy &awc,
-                       const AirspacePredicate &visible)
+                       const AirspacePredicate &visible,
+                       std::size_t visible_key)
 {
   if (airspaces == nullptr || airspaces->IsEmpty())
     return;
 
   DrawInternal(canvas,
-#ifndef ENABLE_OPENGL
-               stencil_canvas,
-#endif
-               projection, settings, awc, visible);
+               projection, settings, awc, visible, visible_key);
 
   intersections = awc.GetLocations();
 }
 
 void
 AirspaceRenderer::Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-                       Canvas &stencil_canvas,
-#endif
                        const WindowProjection &projection,
                        const AirspaceRendererSettings &settings)
 {
@@ -81,17 +199,11 @@ AirspaceRenderer::Draw(Canvas &canvas,
     awc.Visit(*warning_manager);
 
   Draw(canvas,
-#ifndef ENABLE_OPENGL
-       stencil_canvas,
-#endif
-       projection, settings, awc, [](const auto &){ return true; });
+       projection, settings, awc, [](const auto &){ return true; }, 0);
 }
 
 void
 AirspaceRenderer::Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-                       Canvas &stencil_canvas,
-#endif
                        const WindowProjection &projection,
                        const MoreData &basic,
                        const DerivedInfo &calculated,
@@ -108,9 +220,14 @@ AirspaceRenderer::Draw(Canvas &canvas,
   const AircraftState aircraft = ToAircraftState(basic, calculated);
   const AirspaceMapVisible visible(computer_settings, settings,
                                    aircraft, awc);
-  Draw(canvas,
 #ifndef ENABLE_OPENGL
-       stencil_canvas,
+  const std::size_t visible_key =
+    GetVisibleKey(computer_settings, settings, aircraft);
+#else
+  /* the OpenGL renderer has no cached fill */
+  const std::size_t visible_key = 0;
 #endif
-       projection, settings, awc, visible);
+
+  Draw(canvas,
+       projection, settings, awc, visible, visible_key);
 }
@@ -7,17 +7,26 @@
 #include "util/StaticArray.hxx"
 #include "Geo/GeoPoint.hpp"
 
+#include <cstddef>
+
 #ifndef ENABLE_OPENGL
-#include "TransparentRendererCache.hpp"
+#include "MapLayerCache.hpp"
+#include "ui/canvas/BufferCanvas.hpp"
 #include "util/Serial.hpp"
+#else
+#include "AirspacePolygonCache.hpp"
 #endif
 
+#include <vector>
+
 struct AirspaceLook;
 struct MoreData;
 struct DerivedInfo;
 struct AirspaceComputerSettings;
 struct AirspaceRendererSettings;
+struct AltitudeState;
 class Airspaces;
+class AbstractAirspace;
 class ProtectedAirspaceWarningManager;
 class AirspaceWarningCopy;
 class Canvas;
@@ -37,9 +46,80 @@ class AirspaceRenderer
    * This object caches the airspace fill.  This avoids drawing it
    * again and again each frame when nothing has changed.
    */
-  TransparentRendererCache fill_cache;
+  MapLayerCache fill_cache;
+
+  /**
+   * The stencil used for drawing the fill into #fill_cache; it is
+   * grown to the size of the layer buffer.
+   */
+  BufferCanvas stencil_canvas;
+
+  Serial last_warning_serial, last_airspaces_serial;
+
+  /**
+   * A hash of everything else the fill depends on: the #Airspaces
+   * pointer, the renderer settings and the inputs of the visibility
+   * predicate.
+   */
+  std::size_t last_fill_key = 0;
+
+  /**
+   * Incremented each time the fill needs to be drawn again (for
+   * example because one of the serials or #last_fill_key has
+   * changed); this is the serial passed to #fill_cache.
+   */
+  unsigned fill_serial = 0;
+
+  /**
+   * The aircraft altitudes at which the visibility of an airspace
+   * changes.  Between two of them, the altitude-dependent display
+   * modes show the same airspaces, so the cached fill can be reused
+   * while the aircraft climbs or descends.
+   */
+  struct AltitudeBands {
+    const Airspaces *airspaces = nullptr;
+    Serial serial;
+    double margin;
+
+    /**
+     * Sorted thresholds for MSL (and flight level) altitudes: an
+     * airspace base is below the aircraft if the altitude is at or
+     * above the #base threshold, its top is above the aircraft if
+     * the altitude is at or below the #top threshold.
+     */
+    std::vector<double> base, top;
+
+    /**
+     * The same for AGL altitudes, compared with the aircraft's
+     * height above terrain.
+     */
+    std::vector<double> agl_base, agl_top;
+
+    void Update(const Airspaces &airspaces, double margin) noexcept;
+
+    /**
+     * Calculate a number which identifies the band the aircraft is
+     * in.
+     *
+     * @param with_top include the airspace tops (not needed for
+     * AirspaceDisplayMode::ALLBELOW)
+     */
+    [[gnu::pure]]
+    std::size_t GetKey(const AltitudeState &state,
+                       bool with_top) const noexcept;
+  } altitude_bands;
+#else
+  /**
+   * The triangulated airspace polygons, stored in a vertex buffer
+   * object.
+   */
+  AirspacePolygonCache polygon_cache;
 
-  Serial last_warning_serial;
+  /**
+   * The visible airspaces; kept here to avoid reallocating it each
+   * frame.
+   */
+  std::vector<const AbstractAirspace *> visible_airspaces;
 #endif
 
 public:
@@ -79,54 +159,54 @@ public:
 
 private:
 #ifndef ENABLE_OPENGL
-  bool DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
+  bool DrawFill(Canvas &buffer_canvas,
                 const WindowProjection &projection,
                 const AirspaceRendererSettings &settings,
                 const AirspaceWarningCopy &awc,
                 const AirspacePredicate &visible);
 
   void DrawFillCached(Canvas &canvas,
-                      Canvas &stencil_canvas,
                       const WindowProjection &projection,
                       const AirspaceRendererSettings &settings,
                       const AirspaceWarningCopy &awc,
-                      const AirspacePredicate &visible);
+                      const AirspacePredicate &visible,
+                      std::size_t visible_key);
 
   void DrawOutline(Canvas &canvas,
                    const WindowProjection &projection,
                    const AirspaceRendererSettings &settings,
                    const AirspacePredicate &visible) const;
+
+  std::size_t GetVisibleKey(const AirspaceComputerSettings &computer_settings,
+                            const AirspaceRendererSettings &renderer_settings,
+                            const AltitudeState &state) noexcept;
 #endif
 
   void DrawInternal(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-                    Canvas &stencil_canvas,
-#endif
                     const WindowProjection &projection,
                     const AirspaceRendererSettings &settings,
                     const AirspaceWarningCopy &awc,
-                    const AirspacePredicate &visible);
+                    const AirspacePredicate &visible,
+                    std::size_t visible_key);
 
 public:
   /**
    * Draw airspaces selected by the given #AirspacePredicate.
+   *
+   * @param visible_key a hash of the inputs of the predicate; the
+   * cached fill is drawn again when it changes
    */
   void Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-            Canvas &stencil_canvas,
-#endif
             const WindowProjection &projection,
             const AirspaceRendererSettings &settings,
             const AirspaceWarningCopy &awc,
-            const AirspacePredicate &visible);
+            const AirspacePredicate &visible,
+            std::size_t visible_key);
 
   /**
    * Draw all airspaces.
    */
   void Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-            Canvas &stencil_canvas,
-#endif
             const WindowProjection &projection,
             const AirspaceRendererSettings &settings);
 
@@ -134,9 +214,6 @@ public:
    * Draw airspaces that are visible according to standard rules.
    */
   void Draw(Canvas &canvas,
-#ifndef ENABLE_OPENGL
-            Canvas &stencil_canvas,
-#endif
             const WindowProjection &projection,
             const MoreData &basic, const DerivedInfo &calculated,
             const AirspaceComputerSettings &computer_settings,
@@ -22,15 +22,21 @@ class AirspaceVisitorRenderer final
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
+  const WindowProjection &window_projection;
+  const AirspacePolygonCache &polygon_cache;
+
+  const Pen black_pen{1, COLOR_BLACK};
 
 public:
   AirspaceVisitorRenderer(Canvas &_canvas, const WindowProjection &_projection,
                           const AirspaceLook &_look,
                           const AirspaceWarningCopy &_warnings,
-                          const AirspaceRendererSettings &_settings)
+                          const AirspaceRendererSettings &_settings,
+                          const AirspacePolygonCache &_polygon_cache)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
-     look(_look), warning_manager(_warnings), settings(_settings)
+     look(_look), warning_manager(_warnings), settings(_settings),
+     window_projection(_projection), polygon_cache(_polygon_cache)
   {
     glStencilMask(0xff);
     glClear(GL_STENCIL_BUFFER_BIT);
@@ -82,8 +88,16 @@ private:
 
   void VisitPolygon(const AirspacePolygon &airspace) {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
-    if (!PreparePolygon(airspace.GetPoints()))
-      return;
+    const auto *cached = polygon_cache.Get(airspace);
+
+    /* the polygon is projected to the screen only for the passes
+       which cannot be done with the #polygon_cache */
+    bool prepared = false;
+    if (cached == nullptr) {
+      if (!PreparePolygon(*airspace.GetPoints()))
+        return;
+      prepared = true;
+    }
 
     const AirspaceClassRendererSettings &class_settings =
       settings.classes[as_type_or_class];
@@ -99,6 +113,14 @@ private:
       const GLEnable<GL_STENCIL_TEST> stencil;
 
       if (!fill_airspace) {
+        /* the thick pen needs to be triangulated in screen
+           coordinates */
+        if (!prepared) {
+          if (!PreparePolygon(*airspace.GetPoints()))
+            return;
+          prepared = true;
+        }
+
         // set stencil for filling (bit 0)
         SetFillStencil();
         DrawPrepared();
@@ -107,9 +129,15 @@ private:
 
       // fill interior without overpainting any previous outlines
       {
-        SetupInterior(airspace, !fill_airspace);
+        const Color color = SetupInterior(airspace, !fill_airspace);
         const GLEnable<GL_BLEND> blend;
-        DrawPrepared();
+        if (prepared ||
+            !polygon_cache.DrawInterior(*cached, window_projection, color)) {
+          if (!prepared && !PreparePolygon(*airspace.GetPoints()))
+            return;
+          prepared = true;
+          DrawPrepared();
+        }
       }
 
       if (!fill_airspace) {
@@ -121,8 +149,12 @@ private:
     }
 
     // draw outline
-    if (SetupOutline(airspace))
-      DrawPrepared();
+    if (const Pen *pen = SetupOutline(airspace)) {
+      if (!prepared && AirspacePolygonCache::IsOutlineSupported(*pen))
+        polygon_cache.DrawOutline(*cached, window_projection, *pen);
+      else if (prepared || PreparePolygon(*airspace.GetPoints()))
+        DrawPrepared();
+    }
   }
 
 public:
@@ -139,17 +171,22 @@ public:
   }
 
 private:
-  bool SetupOutline(const AbstractAirspace &airspace) {
+  /**
+   * @return the selected pen or nullptr if no outline shall be drawn
+   */
+  const Pen *SetupOutline(const AbstractAirspace &airspace) {
     AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
 
+    const Pen *pen;
     if (settings.black_outline)
-      canvas.SelectBlackPen();
+      pen = &black_pen;
     else if (settings.classes[as_type_or_class].border_width == 0)
       // Don't draw outlines if border_width == 0
-      return false;
+      return nullptr;
     else
-      canvas.Select(look.classes[as_type_or_class].border_pen);
+      pen = &look.classes[as_type_or_class].border_pen;
 
+    canvas.Select(*pen);
     canvas.SelectHollowBrush();
 
     // set bit 1 in stencil buffer, where an outline is drawn
@@ -157,11 +194,14 @@ private:
     glStencilMask(2);
     glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 
-    return true;
+    return pen;
   }
 
-  void SetupInterior(const AbstractAirspace &airspace,
-                     bool check_fillstencil = false) {
+  /**
+   * @return the fill color
+   */
+  Color SetupInterior(const AbstractAirspace &airspace,
+                      bool check_fillstencil = false) {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
     const AirspaceClassLook &class_look = look.classes[as_type_or_class];
 
@@ -172,8 +212,10 @@ private:
       glStencilFunc(GL_EQUAL, 0, 2);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(90)));
+    const Color color = class_look.fill_color.WithAlpha(90);
+    canvas.Select(Brush(color));
     canvas.SelectNullPen();
+    return color;
   }
 
   void SetFillStencil() {
@@ -203,15 +245,21 @@ class AirspaceFillRenderer final
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
+  const WindowProjection &window_projection;
+  const AirspacePolygonCache &polygon_cache;
+
+  const Pen black_pen{1, COLOR_BLACK};
 
 public:
   AirspaceFillRenderer(Canvas &_canvas, const WindowProjection &_projection,
                        const AirspaceLook &_look,
                        const AirspaceWarningCopy &_warnings,
-                       const AirspaceRendererSettings &_settings)
+                       const AirspaceRendererSettings &_settings,
+                       const AirspacePolygonCache &_polygon_cache)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
-     look(_look), warning_manager(_warnings), settings(_settings)
+     look(_look), warning_manager(_warnings), settings(_settings),
+     window_projection(_projection), polygon_cache(_polygon_cache)
   {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
@@ -232,18 +280,38 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
+    const auto *cached = polygon_cache.Get(airspace);
+    if (cached == nullptr) {
+      if (!PreparePolygon(*airspace.GetPoints()))
+        return;
+
+      if (!warning_manager.IsAcked(airspace) && SetupInterior(airspace)) {
+        // fill interior without overpainting any previous outlines
+        GLEnable<GL_BLEND> blend;
+        DrawPrepared();
+      }
+
+      // draw outline
+      if (SetupOutline(airspace))
+        DrawPrepared();
       return;
+    }
 
     if (!warning_manager.IsAcked(airspace) && SetupInterior(airspace)) {
-      // fill interior without overpainting any previous outlines
       GLEnable<GL_BLEND> blend;
-      DrawPrepared();
+      if (!polygon_cache.DrawInterior(*cached, window_projection,
+                                      GetFillColor(airspace)) &&
+          PreparePolygon(*airspace.GetPoints()))
+        DrawPrepared();
     }
 
     // draw outline
-    if (SetupOutline(airspace))
-      DrawPrepared();
+    if (const Pen *pen = SetupOutline(airspace)) {
+      if (AirspacePolygonCache::IsOutlineSupported(*pen))
+        polygon_cache.DrawOutline(*cached, window_projection, *pen);
+      else if (PreparePolygon(*airspace.GetPoints()))
+        DrawPrepared();
+    }
   }
 
 public:
@@ -260,30 +328,38 @@ public:
   }
 
 private:
-  bool SetupOutline(const AbstractAirspace &airspace) {
+  /**
+   * @return the selected pen or nullptr if no outline shall be drawn
+   */
+  const Pen *SetupOutline(const AbstractAirspace &airspace) {
     AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
 
+    const Pen *pen;
     if (settings.black_outline)
-      canvas.SelectBlackPen();
+      pen = &black_pen;
     else if (settings.classes[as_type_or_class].border_width == 0)
       // Don't draw outlines if border_width == 0
-      return false;
+      return nullptr;
     else
-      canvas.Select(look.classes[as_type_or_class].border_pen);
+      pen = &look.classes[as_type_or_class].border_pen;
 
+    canvas.Select(*pen);
     canvas.SelectHollowBrush();
 
-    return true;
+    return pen;
   }
 
-  bool SetupInterior(const AbstractAirspace &airspace) {
+  [[gnu::pure]]
+  Color GetFillColor(const AbstractAirspace &airspace) const {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
+    return look.classes[as_type_or_class].fill_color.WithAlpha(48);
+  }
+
+  bool SetupInterior(const AbstractAirspace &airspace) {
     if (settings.fill_mode == AirspaceRendererSettings::FillMode::NONE)
       return false;
 
-    const AirspaceClassLook &class_look = look.classes[as_type_or_class];
-
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(48)));
+    canvas.Select(Brush(GetFillColor(airspace)));
     canvas.SelectNullPen();
 
     return true;
@@ -295,27 +371,42 @@ AirspaceRenderer::DrawInternal(Canvas &canvas,
                                const WindowProjection &projection,
                                const AirspaceRendererSettings &settings,
                                const AirspaceWarningCopy &awc,
-                               const AirspacePredicate &visible)
+                               const AirspacePredicate &visible,
+                               [[maybe_unused]] std::size_t visible_key)
 {
   const auto range =
     airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
                                 projection.GetScreenDistanceMeters());
 
+  /* collect the visible airspaces and make sure all of their
+     polygons are in the vertex buffer before drawing the first
+     one */
+  polygon_cache.Update(*airspaces);
+  visible_airspaces.clear();
+  for (const auto &i : range) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    if (!visible(airspace))
+      continue;
+
+    if (airspace.GetShape() == AbstractAirspace::Shape::POLYGON)
+      polygon_cache.Add((const AirspacePolygon &)airspace);
+
+    visible_airspaces.push_back(&airspace);
+  }
+
+  polygon_cache.Commit();
+
   if (settings.fill_mode == AirspaceRendererSettings::FillMode::ALL ||
       settings.fill_mode == AirspaceRendererSettings::FillMode::NONE) {
-    AirspaceFillRenderer renderer(canvas, projection, look, awc, settings);
-    for (const auto &i : range) {
-      const AbstractAirspace &airspace = i.GetAirspace();
-      if (visible(airspace))
-        renderer.Visit(airspace);
-    }
+    AirspaceFillRenderer renderer(canvas, projection, look, awc, settings,
+                                  polygon_cache);
+    for (const auto *airspace : visible_airspaces)
+      renderer.Visit(*airspace);
   } else {
-    AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings);
-    for (const auto &i : range) {
-      const AbstractAirspace &airspace = i.GetAirspace();
-      if (visible(airspace))
-        renderer.Visit(airspace);
-    }
+    AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings,
+                                     polygon_cache);
+    for (const auto *airspace : visible_airspaces)
+      renderer.Visit(*airspace);
   }
 }
 
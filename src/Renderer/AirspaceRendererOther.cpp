@@ -17,6 +17,8 @@
 #include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
 #include "MapWindow/StencilMapCanvas.hpp"
 
+#include <functional>
+
 /**
  * Class to render airspaces onto map in two passes,
  * one for border, one for area.
@@ -59,7 +61,7 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawSearchPointVector(airspace.GetPoints());
+    DrawSearchPointVector(*airspace.GetPoints());
   }
 
 public:
@@ -169,7 +171,7 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    DrawPolygon(airspace.GetPoints());
+    DrawPolygon(*airspace.GetPoints());
   }
 
 public:
@@ -190,7 +192,7 @@ public:
 };
 
 inline bool
-AirspaceRenderer::DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
+AirspaceRenderer::DrawFill(Canvas &buffer_canvas,
                            const WindowProjection &projection,
                            const AirspaceRendererSettings &settings,
                            const AirspaceWarningCopy &awc,
@@ -216,23 +218,79 @@ AirspaceRenderer::DrawFill(Canvas &buffer_canvas, Canvas &stencil_canvas,
   return v.Commit();
 }
 
+/**
+ * Calculate a hash of the #AirspaceRendererSettings attributes which
+ * affect the airspace fill.
+ */
+[[gnu::pure]]
+static std::size_t
+GetFillSettingsKey(const AirspaceRendererSettings &settings) noexcept
+{
+  std::size_t key = std::size_t(settings.fill_mode);
+  const auto add = [&key](std::size_t value){
+    key = key * 31 + value;
+  };
+
+#if defined(HAVE_HATCHED_BRUSH) && defined(HAVE_ALPHA_BLEND)
+  add(settings.transparency);
+#endif
+
+  for (const auto &i : settings.classes) {
+    add(i.display);
+#ifdef HAVE_HATCHED_BRUSH
+    add(i.brush);
+#endif
+    add((i.fill_color.Red() << 16) | (i.fill_color.Green() << 8) |
+        i.fill_color.Blue());
+    add(i.border_width);
+    add(std::size_t(i.fill_mode));
+  }
+
+  return key;
+}
+
 inline void
-AirspaceRenderer::DrawFillCached(Canvas &canvas, Canvas &stencil_canvas,
+AirspaceRenderer::DrawFillCached(Canvas &canvas,
                                  const WindowProjection &projection,
                                  const AirspaceRendererSettings &settings,
                                  const AirspaceWarningCopy &awc,
-                                 const AirspacePredicate &visible)
+                                 const AirspacePredicate &visible,
+                                 std::size_t visible_key)
 {
-  if (awc.GetSerial() != last_warning_serial ||
-      !fill_cache.Check(projection)) {
+  if (awc.GetSerial() != last_warning_serial) {
     last_warning_serial = awc.GetSerial();
+    ++fill_serial;
+  }
+
+  if (airspaces->GetSerial() != last_airspaces_serial) {
+    last_airspaces_serial = airspaces->GetSerial();
+    ++fill_serial;
+  }
+
+  /* the outlines are drawn each frame; the cached fill must follow
+     every change which affects them, too */
+  std::size_t fill_key = std::hash<const Airspaces *>{}(airspaces);
+  fill_key = fill_key * 31 + GetFillSettingsKey(settings);
+  fill_key = fill_key * 31 + visible_key;
+  if (fill_key != last_fill_key) {
+    last_fill_key = fill_key;
+    ++fill_serial;
+  }
+
+  if (!fill_cache.Check(projection, fill_serial)) {
+    Canvas &buffer_canvas = fill_cache.Begin(canvas, projection, fill_serial);
+    const WindowProjection &buffer_projection =
+      fill_cache.GetBufferProjection();
+
+    if (stencil_canvas.IsDefined())
+      stencil_canvas.Grow(buffer_projection.GetScreenSize());
+    else
+      stencil_canvas.Create(canvas, buffer_projection.GetScreenSize());
 
-    Canvas &buffer_canvas = fill_cache.Begin(canvas, projection);
-    if (DrawFill(buffer_canvas, stencil_canvas,
-                                projection, settings, awc, visible))
-      fill_cache.Commit(canvas, projection);
+    if (DrawFill(buffer_canvas, buffer_projection, settings, awc, visible))
+      fill_cache.Commit(canvas);
     else
-      fill_cache.CommitEmpty();
+      fill_cache.CommitEmpty(canvas);
   }
 
 #ifdef HAVE_ALPHA_BLEND
@@ -245,7 +303,7 @@ AirspaceRenderer::DrawFillCached(Canvas &canvas, Canvas &stencil_canvas,
 #endif
 #endif
 #ifdef HAVE_HATCHED_BRUSH
-    fill_cache.CopyAndTo(canvas, projection);
+    fill_cache.DrawAnd(canvas, projection);
 #endif
 }
 
@@ -268,14 +326,15 @@ AirspaceRenderer::DrawOutline(Canvas &canvas,
 }
 
 void
-AirspaceRenderer::DrawInternal(Canvas &canvas, Canvas &stencil_canvas,
+AirspaceRenderer::DrawInternal(Canvas &canvas,
                                const WindowProjection &projection,
                                const AirspaceRendererSettings &settings,
                                const AirspaceWarningCopy &awc,
-                               const AirspacePredicate &visible)
+                               const AirspacePredicate &visible,
+                               std::size_t visible_key)
 {
   if (settings.fill_mode != AirspaceRendererSettings::FillMode::NONE)
-    DrawFillCached(canvas, stencil_canvas, projection, settings, awc, visible);
+    DrawFillCached(canvas, projection, settings, awc, visible, visible_key);
 
   DrawOutline(canvas, projection, settings, visible);
 }
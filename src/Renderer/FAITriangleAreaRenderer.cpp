@@ -8,6 +8,8 @@
 #include "Projection/WindowProjection.hpp"
 #include "ui/canvas/Canvas.hpp"
 
+#include <span>
+
 void
 RenderFAISector(Canvas &canvas, const WindowProjection &projection,
                 const GeoPoint &pt1, const GeoPoint &pt2,
@@ -22,9 +24,9 @@ RenderFAISector(Canvas &canvas, const WindowProjection &projection,
     GeoClip(projection.GetScreenBounds().Scale(1.1))
     .ClipPolygon(clipped, geo_points, geo_end - geo_points);
 
-  BulkPixelPoint points[FAI_TRIANGLE_SECTOR_MAX], *p = points;
-  for (GeoPoint *geo_i = clipped; geo_i != clipped_end;)
-    *p++ = projection.GeoToScreen(*geo_i++);
+  BulkPixelPoint points[FAI_TRIANGLE_SECTOR_MAX];
+  const std::span<const GeoPoint> src{clipped, clipped_end};
+  projection.GeoToScreen(src, points);
 
-  canvas.DrawPolygon(points, p - points);
+  canvas.DrawPolygon(points, src.size());
 }
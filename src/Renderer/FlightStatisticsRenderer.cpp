@@ -99,18 +99,7 @@ FlightStatisticsRenderer::RenderContest(Canvas &canvas, const PixelRect rc,
 
   background_renderer.Draw(canvas, proj, settings_map.terrain);
 
-  {
-#ifndef ENABLE_OPENGL
-    BufferCanvas stencil_canvas;
-    stencil_canvas.Create(canvas);
-#endif
-
-    airspace_renderer.Draw(canvas,
-#ifndef ENABLE_OPENGL
-                           stencil_canvas,
-#endif
-                           proj, settings_map.airspace);
-  }
+  airspace_renderer.Draw(canvas, proj, settings_map.airspace);
 
 #ifdef ENABLE_OPENGL
   /* desaturate the map background, to focus on the contest */
@@ -284,18 +273,7 @@ FlightStatisticsRenderer::RenderTask(Canvas &canvas, const PixelRect rc,
 
   background_renderer.Draw(canvas, proj, settings_map.terrain);
 
-  {
-#ifndef ENABLE_OPENGL
-    BufferCanvas stencil_canvas;
-    stencil_canvas.Create(canvas);
-#endif
-
-    airspace_renderer.Draw(canvas,
-#ifndef ENABLE_OPENGL
-                           stencil_canvas,
-#endif
-                           proj, settings_map.airspace);
-  }
+  airspace_renderer.Draw(canvas, proj, settings_map.airspace);
 
 #ifdef ENABLE_OPENGL
   /* desaturate the map background, to focus on the task */
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "MapLayerCache.hpp"
+#include "Geo/Quadrilateral.hpp"
+#include "ui/canvas/Features.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "ui/canvas/Color.hpp"
+#endif
+
+/**
+ * Is the given point (relative to the buffer) within the buffer?
+ * Unlike PixelRect::Contains(), this includes the right and bottom
+ * edges, because the screen corners are mapped to them.
+ */
+[[gnu::const]]
+static bool
+IsInside(PixelPoint p, PixelSize size) noexcept
+{
+  return p.x >= 0 && p.y >= 0 &&
+    unsigned(p.x) <= size.width && unsigned(p.y) <= size.height;
+}
+
+inline bool
+MapLayerCache::IsSupported() noexcept
+{
+#ifdef ENABLE_OPENGL
+  return BufferCanvas::IsOffscreenSupported();
+#else
+  return true;
+#endif
+}
+
+bool
+MapLayerCache::Check(const WindowProjection &projection,
+                     unsigned _serial) const noexcept
+{
+  assert(projection.IsValid());
+
+  if (!valid || _serial != serial ||
+      projection.GetScreenSize() != screen_size ||
+      projection.GetScale() != buffer_projection.GetScale())
+    return false;
+
+#ifdef ENABLE_OPENGL
+  /* small rotations are applied while compositing; larger ones would
+     rotate symbols and text too much */
+  if (!projection.GetScreenAngle().CompareRoughly(buffer_projection.GetScreenAngle()))
+    return false;
+#else
+  /* rotating is not implemented, only shifting */
+  if (projection.GetScreenAngle() != buffer_projection.GetScreenAngle())
+    return false;
+#endif
+
+  /* are all screen corners covered by the buffer? */
+  const auto q = projection.GetGeoQuadrilateral();
+  const auto buffer_size = buffer_projection.GetScreenSize();
+  return IsInside(buffer_projection.GeoToScreen(q.top_left), buffer_size) &&
+    IsInside(buffer_projection.GeoToScreen(q.top_right), buffer_size) &&
+    IsInside(buffer_projection.GeoToScreen(q.bottom_left), buffer_size) &&
+    IsInside(buffer_projection.GeoToScreen(q.bottom_right), buffer_size);
+}
+
+Canvas &
+MapLayerCache::Begin(Canvas &canvas, const WindowProjection &projection,
+                     unsigned _serial) noexcept
+{
+  assert(canvas.IsDefined());
+  assert(projection.IsValid());
+  assert(!drawing);
+
+  valid = false;
+  serial = _serial;
+  screen_size = projection.GetScreenSize();
+
+  buffer_projection = projection;
+
+  if (!IsSupported())
+    return canvas;
+
+  /* add a margin of a quarter of the screen size on each side, to
+     allow shifting the layer without drawing it again */
+  const PixelPoint margin(screen_size.width / 4, screen_size.height / 4);
+  const PixelSize buffer_size(screen_size.width + 2 * margin.x,
+                              screen_size.height + 2 * margin.y);
+
+  buffer_projection.SetScreenSize(buffer_size);
+  buffer_projection.SetScreenOrigin(projection.GetScreenOrigin() + margin);
+  buffer_projection.UpdateScreenBounds();
+
+#ifndef NDEBUG
+  drawing = true;
+#endif
+
+#ifdef ENABLE_OPENGL
+  if (buffer.IsDefined())
+    buffer.Resize(buffer_size);
+  else
+    buffer.CreateTransparent(buffer_size);
+
+  buffer.BeginOffscreen();
+  buffer.Clear(Color(0, 0, 0, 0));
+#else
+  if (buffer.IsDefined())
+    buffer.Resize(buffer_size);
+  else
+    buffer.Create(canvas, buffer_size);
+
+  buffer.ClearWhite();
+#endif
+
+  return buffer;
+}
+
+void
+MapLayerCache::Commit([[maybe_unused]] Canvas &canvas) noexcept
+{
+  assert(canvas.IsDefined());
+
+  if (!IsSupported())
+    return;
+
+  assert(drawing);
+
+#ifdef ENABLE_OPENGL
+  buffer.CommitOffscreen();
+#endif
+
+#ifndef NDEBUG
+  drawing = false;
+#endif
+
+  valid = true;
+  empty = false;
+}
+
+#ifdef ENABLE_OPENGL
+
+inline void
+MapLayerCache::GetCorners(const WindowProjection &projection,
+                          PixelPoint (&corners)[4]) const noexcept
+{
+  const auto r = buffer_projection.GetScreenRect();
+  corners[0] = projection.GeoToScreen(buffer_projection.ScreenToGeo(r.GetTopLeft()));
+  corners[1] = projection.GeoToScreen(buffer_projection.ScreenToGeo(r.GetTopRight()));
+  corners[2] = projection.GeoToScreen(buffer_projection.ScreenToGeo(r.GetBottomLeft()));
+  corners[3] = projection.GeoToScreen(buffer_projection.ScreenToGeo(r.GetBottomRight()));
+}
+
+void
+MapLayerCache::Draw(Canvas &canvas,
+                    const WindowProjection &projection) const noexcept
+{
+  assert(!drawing);
+
+  if (!valid || empty)
+    return;
+
+  PixelPoint corners[4];
+  GetCorners(projection, corners);
+  buffer.DrawTransparentTo(canvas, corners);
+}
+
+#else
+
+inline PixelPoint
+MapLayerCache::GetSourceOffset(const WindowProjection &projection) const noexcept
+{
+  return buffer_projection.GeoToScreen(projection.GetGeoLocation())
+    - projection.GetScreenOrigin();
+}
+
+void
+MapLayerCache::Draw(Canvas &canvas,
+                    const WindowProjection &projection) const noexcept
+{
+  assert(!drawing);
+
+  if (!valid || empty)
+    return;
+
+  canvas.CopyTransparentWhite({0, 0}, screen_size,
+                              buffer, GetSourceOffset(projection));
+}
+
+void
+MapLayerCache::DrawAnd(Canvas &canvas,
+                       const WindowProjection &projection) const noexcept
+{
+  assert(!drawing);
+
+  if (!valid || empty)
+    return;
+
+  canvas.CopyAnd({0, 0}, screen_size, buffer, GetSourceOffset(projection));
+}
+
+#ifdef HAVE_ALPHA_BLEND
+
+void
+MapLayerCache::AlphaBlendTo(Canvas &canvas,
+                            const WindowProjection &projection,
+                            uint8_t alpha) const noexcept
+{
+  assert(!drawing);
+
+  if (!valid || empty)
+    return;
+
+  const PixelPoint offset = GetSourceOffset(projection);
+
+#ifdef USE_MEMORY_CANVAS
+  canvas.AlphaBlendNotWhite({0, 0}, screen_size,
+                            buffer, offset, screen_size,
+                            alpha);
+#else
+  canvas.AlphaBlend({0, 0}, screen_size,
+                    buffer, offset, screen_size,
+                    alpha);
+#endif
+}
+
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Projection/WindowProjection.hpp"
+#include "ui/canvas/BufferCanvas.hpp"
+#include "ui/canvas/Features.hpp" // for HAVE_ALPHA_BLEND
+
+#include <cstdint>
+
+class Canvas;
+
+/**
+ * Helper class for implementing renderers that retain their output
+ * in an off-screen buffer.  The buffer is bigger than the screen and
+ * is tagged with the projection it was drawn with and with a data
+ * serial supplied by the caller.  As long as both are unchanged, the
+ * layer is only composited again, shifted (and on OpenGL also
+ * rotated) to match the current projection.
+ *
+ * The buffer is transparent: on OpenGL, it has an alpha channel;
+ * elsewhere, white pixels are treated as transparent.
+ *
+ * Usage:
+ *
+ *   if (!cache.Check(projection, serial)) {
+ *     Canvas &buffer = cache.Begin(canvas, projection, serial);
+ *     renderer.Draw(buffer, cache.GetBufferProjection());
+ *     cache.Commit(canvas);
+ *   }
+ *
+ *   cache.Draw(canvas, projection);
+ */
+class MapLayerCache {
+  /**
+   * The projection used for drawing into the buffer; it is the
+   * screen projection enlarged by a margin on all sides.
+   */
+  WindowProjection buffer_projection;
+
+  BufferCanvas buffer;
+
+  /**
+   * The size of the screen the buffer was drawn for.
+   */
+  PixelSize screen_size;
+
+  unsigned serial;
+
+  /**
+   * Does the buffer contain a layer which matches #buffer_projection
+   * and #serial?
+   */
+  bool valid = false;
+
+  /**
+   * Was nothing drawn into the buffer?  Compositing can be skipped
+   * then.
+   */
+  bool empty;
+
+#ifndef NDEBUG
+  bool drawing = false;
+#endif
+
+public:
+  /**
+   * Discard the buffer contents, forcing the caller to draw again.
+   */
+  void Invalidate() noexcept {
+    valid = false;
+  }
+
+  /**
+   * Check if the buffer can be used for the given projection.
+   *
+   * @param serial a number which changes each time the data shown
+   * by this layer (or its settings) is modified
+   * @return true if the buffer is valid for the given projection;
+   * the caller may skip to Draw()
+   */
+  [[gnu::pure]]
+  bool Check(const WindowProjection &projection,
+             unsigned serial) const noexcept;
+
+  /**
+   * Begin drawing to the buffer.  Render to the returned Canvas
+   * using GetBufferProjection().  Call Commit() or CommitEmpty() when
+   * you're done.
+   *
+   * On OpenGL without frame buffer object support, the layer cannot
+   * be retained; this returns the given #Canvas and the screen
+   * projection, and Draw() will be a no-op.
+   */
+  Canvas &Begin(Canvas &canvas, const WindowProjection &projection,
+                unsigned serial) noexcept;
+
+  /**
+   * Returns the projection to be used for drawing between Begin()
+   * and Commit().
+   */
+  const WindowProjection &GetBufferProjection() const noexcept {
+    return buffer_projection;
+  }
+
+  /**
+   * Finish drawing to the buffer.
+   */
+  void Commit(Canvas &canvas) noexcept;
+
+  /**
+   * Finish drawing to the buffer.  Indicate that nothing relevant
+   * was drawn, so compositing can be skipped.
+   */
+  void CommitEmpty(Canvas &canvas) noexcept {
+    Commit(canvas);
+    empty = true;
+  }
+
+  /**
+   * Composite the buffer onto the given #Canvas.  Call Check() or
+   * Commit() before this.
+   */
+  void Draw(Canvas &canvas, const WindowProjection &projection) const noexcept;
+
+#ifndef ENABLE_OPENGL
+  /**
+   * Composite the buffer onto the given #Canvas with a bitwise "and"
+   * operation.
+   */
+  void DrawAnd(Canvas &canvas,
+               const WindowProjection &projection) const noexcept;
+
+#ifdef HAVE_ALPHA_BLEND
+  /**
+   * Composite the buffer onto the given #Canvas with the given
+   * opacity, skipping white pixels.
+   */
+  void AlphaBlendTo(Canvas &canvas, const WindowProjection &projection,
+                    uint8_t alpha) const noexcept;
+#endif
+#endif
+
+private:
+  /**
+   * Is the buffer usable on this platform?  On OpenGL, this requires
+   * frame buffer objects.
+   */
+  [[gnu::pure]]
+  static bool IsSupported() noexcept;
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Calculate the screen positions of the buffer's corners.
+   */
+  void GetCorners(const WindowProjection &projection,
+                  PixelPoint (&corners)[4]) const noexcept;
+#else
+  /**
+   * Calculate the position within the buffer which corresponds to
+   * the screen's top left corner.
+   */
+  [[gnu::pure]]
+  PixelPoint GetSourceOffset(const WindowProjection &projection) const noexcept;
+#endif
+};
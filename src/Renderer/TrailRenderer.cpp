@@ -13,6 +13,7 @@
 #include "Engine/Contest/ContestTrace.hpp"
 
 #include <algorithm>
+#include <span>
 
 bool
 TrailRenderer::LoadTrace(const TraceComputer &trace_computer) noexcept
@@ -60,7 +61,7 @@ GetAltitudeColorIndex(double alt, double min_alt, double max_alt) noexcept
 
 [[gnu::pure]]
 static std::pair<double, double>
-GetMinMax(TrailSettings::Type type, const TracePointVector &trace) noexcept
+GetMinMax(TrailSettings::Type type, std::span<const TracePoint> trace) noexcept
 {
   double value_min, value_max;
 
@@ -99,12 +100,22 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
   if (settings.length == TrailSettings::Length::OFF)
     return;
 
-  if (!LoadTrace(trace_computer, min_time, projection))
-    return;
-
   if (!basic.location_available || !calculated.wind_available)
     enable_traildrift = false;
 
+  bool scaled_trail = settings.scaling_enabled &&
+                      projection.GetMapScale() <= 6000;
+
+#ifdef ENABLE_OPENGL
+  if (!enable_traildrift &&
+      DrawBuffered(canvas, trace_computer, projection, min_time, pos,
+                   settings, scaled_trail))
+    return;
+#endif
+
+  if (!LoadTrace(trace_computer, min_time, projection))
+    return;
+
   GeoPoint traildrift;
   if (enable_traildrift) {
     GeoPoint tp1 = FindLatitudeLongitude(basic.location,
@@ -117,9 +128,6 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
   auto value_min = minmax.first;
   auto value_max = minmax.second;
 
-  bool scaled_trail = settings.scaling_enabled &&
-                      projection.GetMapScale() <= 6000;
-
   const GeoBounds bounds = projection.GetScreenBounds().Scale(4);
 
   PixelPoint last_point(0, 0);
@@ -180,6 +188,80 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
     canvas.DrawLine(last_point, pos);
 }
 
+#ifdef ENABLE_OPENGL
+
+bool
+TrailRenderer::DrawBuffered(Canvas &canvas,
+                            const TraceComputer &trace_computer,
+                            const WindowProjection &projection,
+                            TimeStamp min_time, const PixelPoint pos,
+                            const TrailSettings &settings,
+                            bool scaled_trail) noexcept
+{
+  switch (settings.type) {
+  case TrailSettings::Type::VARIO_1:
+  case TrailSettings::Type::VARIO_2:
+    if (scaled_trail)
+      /* each segment may have a different width */
+      return false;
+    break;
+
+  case TrailSettings::Type::ALTITUDE:
+    break;
+
+  case TrailSettings::Type::VARIO_1_DOTS:
+  case TrailSettings::Type::VARIO_2_DOTS:
+  case TrailSettings::Type::VARIO_DOTS_AND_LINES:
+  case TrailSettings::Type::VARIO_EINK:
+    return false;
+  }
+
+  /* all of these have the same width */
+  const Pen &pen = look.trail_pens[0];
+  if (!TrailVertexBuffer::IsSupported(pen))
+    return false;
+
+  buffer.Update(trace_computer);
+
+  const TracePointVector &trace = buffer.GetTrace();
+  const auto first =
+    std::partition_point(trace.begin(), trace.end(),
+                         [t = min_time.Cast<TracePoint::Time>()](const auto &i){
+                           return i.GetTime() < t;
+                         });
+  if (first == trace.end())
+    return true;
+
+  const auto [value_min, value_max] =
+    GetMinMax(settings.type, std::span{first, trace.end()});
+  if (settings.type != buffer_type ||
+      value_min != buffer_value_min || value_max != buffer_value_max) {
+    buffer.InvalidateColors();
+    buffer_type = settings.type;
+    buffer_value_min = value_min;
+    buffer_value_max = value_max;
+  }
+
+  const auto GetPen = [&](const TracePoint &i) -> const Pen & {
+    const unsigned index = settings.type == TrailSettings::Type::ALTITUDE
+      ? GetAltitudeColorIndex(i.GetAltitude(), value_min, value_max)
+      : GetSnailColorIndex(i.GetVario(), value_min, value_max);
+    return look.trail_pens[index];
+  };
+
+  buffer.UpdateColors([&](const TracePoint &i){
+    return GetPen(i).GetColor();
+  });
+
+  buffer.Draw(projection, std::distance(trace.begin(), first), pen);
+
+  canvas.Select(GetPen(trace.back()));
+  canvas.DrawLine(projection.GeoToScreen(trace.back().GetLocation()), pos);
+  return true;
+}
+
+#endif
+
 void
 TrailRenderer::Draw(Canvas &canvas, const WindowProjection &projection) noexcept
 {
@@ -8,6 +8,11 @@
 #include "Engine/Trace/Vector.hpp"
 #include "time/Stamp.hpp"
 
+#ifdef ENABLE_OPENGL
+#include "TrailVertexBuffer.hpp"
+#include "MapSettings.hpp"
+#endif
+
 struct PixelPoint;
 struct BulkPixelPoint;
 class Canvas;
@@ -32,6 +37,19 @@ class TrailRenderer {
   TracePointVector trace;
   AllocatedArray<BulkPixelPoint> points;
 
+#ifdef ENABLE_OPENGL
+  /**
+   * The snail trail in vertex buffer objects, see DrawBuffered().
+   */
+  TrailVertexBuffer buffer;
+
+  /**
+   * The parameters the colors in #buffer were calculated with.
+   */
+  TrailSettings::Type buffer_type = TrailSettings::Type::VARIO_1;
+  double buffer_value_min = 0, buffer_value_max = 0;
+#endif
+
 public:
   TrailRenderer(const TrailLook &_look) noexcept:look(_look) {}
 
@@ -89,4 +107,19 @@ public:
 private:
   void DrawTraceVector(Canvas &canvas, const Projection &projection,
                        const TracePointVector &trace) noexcept;
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Draw the snail trail from #buffer.  This supports only the trail
+   * types which consist of lines of the same width, and no trail
+   * drift.
+   *
+   * @return false if the settings are not supported
+   */
+  bool DrawBuffered(Canvas &canvas, const TraceComputer &trace_computer,
+                    const WindowProjection &projection,
+                    TimeStamp min_time, PixelPoint pos,
+                    const TrailSettings &settings,
+                    bool scaled_trail) noexcept;
+#endif
 };
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#ifdef ENABLE_OPENGL
+
+#include "TrailVertexBuffer.hpp"
+#include "Computer/TraceComputer.hpp"
+#include "ui/canvas/Pen.hpp"
+#include "ui/canvas/opengl/Buffer.hpp"
+#include "ui/canvas/opengl/Geo.hpp"
+#include "ui/canvas/opengl/Globals.hpp"
+#include "ui/canvas/opengl/Shaders.hpp"
+#include "ui/canvas/opengl/Program.hpp"
+#include "ui/canvas/opengl/VertexPointer.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+TrailVertexBuffer::TrailVertexBuffer() noexcept = default;
+TrailVertexBuffer::~TrailVertexBuffer() noexcept = default;
+
+void
+TrailVertexBuffer::Clear() noexcept
+{
+  vertices.clear();
+  n_uploaded_vertices = 0;
+  InvalidateColors();
+}
+
+inline void
+TrailVertexBuffer::AppendVertices(std::size_t start) noexcept
+{
+  const auto ToVertex = [this](const TracePoint &point){
+    const GeoPoint delta = point.GetLocation() - reference;
+    return FloatPoint2D(float(delta.longitude.Native()),
+                        float(delta.latitude.Native()));
+  };
+
+  if (trace.size() < 2)
+    return;
+
+  /* grow geometrically; reserving the exact size would reallocate
+     on every append */
+  if (const std::size_t n = (trace.size() - 1) * 2; n > vertices.capacity())
+    vertices.reserve(std::max(n, 2 * vertices.capacity()));
+
+  for (std::size_t i = std::max(start, std::size_t(1));
+       i < trace.size(); ++i) {
+    vertices.push_back(ToVertex(trace[i - 1]));
+    vertices.push_back(ToVertex(trace[i]));
+  }
+}
+
+void
+TrailVertexBuffer::Update(const TraceComputer &trace_computer) noexcept
+{
+  const Serial old_modify_serial = modify_serial;
+  const std::size_t old_size = trace.size();
+
+  trace_computer.LockedSyncTo(trace, modify_serial);
+
+  if (modify_serial != old_modify_serial) {
+    /* points were removed or the trace was cleared: start over */
+    Clear();
+
+    if (!trace.empty())
+      reference = trace.front().GetLocation();
+
+    AppendVertices(0);
+  } else if (trace.size() > old_size)
+    AppendVertices(old_size);
+}
+
+bool
+TrailVertexBuffer::IsSupported(const Pen &pen) noexcept
+{
+  /* Canvas::DrawLinePiece() draws pens up to 2 pixels wide with
+     GL_LINES, too */
+  return pen.GetStyle() == Pen::SOLID &&
+    (pen.GetWidth() <= 2 || pen.GetWidth() <= OpenGL::max_line_width);
+}
+
+/**
+ * Upload the elements of the given vector after #n_uploaded to the
+ * buffer object, reallocating it if it is too small.
+ */
+template<typename T>
+static void
+Upload(std::unique_ptr<GLArrayBuffer> &buffer, std::size_t &capacity,
+       std::size_t &n_uploaded, const std::vector<T> &v) noexcept
+{
+  if (n_uploaded == v.size())
+    return;
+
+  if (buffer == nullptr)
+    buffer = std::make_unique<GLArrayBuffer>();
+
+  buffer->Bind();
+
+  if (v.size() > capacity) {
+    /* grow exponentially to keep the number of reallocations low
+       while the trace grows */
+    capacity = std::bit_ceil(std::max(v.size(), std::size_t(256)));
+    GLArrayBuffer::Data(GLsizeiptr(capacity * sizeof(T)), nullptr);
+    n_uploaded = 0;
+  }
+
+  GLArrayBuffer::SubData(GLintptr(n_uploaded * sizeof(T)),
+                         GLsizeiptr((v.size() - n_uploaded) * sizeof(T)),
+                         v.data() + n_uploaded);
+  n_uploaded = v.size();
+
+  GLArrayBuffer::Unbind();
+}
+
+inline void
+TrailVertexBuffer::Commit() noexcept
+{
+  Upload(vertex_buffer, vertex_capacity, n_uploaded_vertices, vertices);
+  Upload(color_buffer, color_capacity, n_uploaded_colors, colors);
+}
+
+void
+TrailVertexBuffer::Draw(const WindowProjection &projection,
+                        std::size_t first, const Pen &pen) noexcept
+{
+  assert(IsSupported(pen));
+  assert(colors.size() == vertices.size());
+
+  if (first + 1 >= trace.size())
+    return;
+
+  Commit();
+
+  OpenGL::solid_shader->Use();
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(ToGLM(projection, reference)));
+
+  pen.Bind();
+
+  const FloatPoint2D *const vertex_base = nullptr;
+  vertex_buffer->Bind();
+  const ScopeVertexPointer vp(GL_FLOAT, vertex_base);
+
+  const Color *const color_base = nullptr;
+  color_buffer->Bind();
+  const ScopeColorPointer cp(color_base);
+
+  GLArrayBuffer::Unbind();
+
+  /* the segment ending at trace point #i is stored at vertex
+     (i - 1) * 2 */
+  glDrawArrays(GL_LINES, first * 2, (trace.size() - 1 - first) * 2);
+
+  pen.Unbind();
+
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(glm::mat4(1)));
+}
+
+#endif /* ENABLE_OPENGL */
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Trace/Vector.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Math/Point2D.hpp"
+#include "util/Serial.hpp"
+#include "ui/canvas/Color.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class TraceComputer;
+class WindowProjection;
+class GLArrayBuffer;
+class Pen;
+
+/**
+ * A copy of the full trace in vertex buffer objects, for drawing the
+ * snail trail with OpenGL.  New trace points are appended to the
+ * existing buffers; only if the trace was thinned, everything is
+ * rebuilt.  Each trail segment is stored as a pair of vertices
+ * (relative to a reference location) with its own color, and the
+ * projection to the screen is done by the shader, therefore moving
+ * the map does not need any per-point work.
+ */
+class TrailVertexBuffer {
+  TracePointVector trace;
+
+  /**
+   * The Trace::GetModifySerial() value #trace was obtained with.
+   */
+  Serial modify_serial;
+
+  /**
+   * All #vertices are relative to this location.
+   */
+  GeoPoint reference;
+
+  /**
+   * Two vertices for each segment, i.e. (#trace.size() - 1) * 2.
+   */
+  std::vector<FloatPoint2D> vertices;
+
+  /**
+   * The color of each vertex.  This may be shorter than #vertices
+   * if UpdateColors() has not been called yet.
+   */
+  std::vector<Color> colors;
+
+  std::unique_ptr<GLArrayBuffer> vertex_buffer, color_buffer;
+
+  /**
+   * The number of elements (not bytes) which have been allocated in
+   * #vertex_buffer and #color_buffer.
+   */
+  std::size_t vertex_capacity = 0, color_capacity = 0;
+
+  /**
+   * The number of elements which have been uploaded to
+   * #vertex_buffer and #color_buffer.
+   */
+  std::size_t n_uploaded_vertices = 0, n_uploaded_colors = 0;
+
+public:
+  TrailVertexBuffer() noexcept;
+  ~TrailVertexBuffer() noexcept;
+
+  TrailVertexBuffer(const TrailVertexBuffer &) = delete;
+  TrailVertexBuffer &operator=(const TrailVertexBuffer &) = delete;
+
+  /**
+   * Copy new points from the #TraceComputer.
+   */
+  void Update(const TraceComputer &trace_computer) noexcept;
+
+  const TracePointVector &GetTrace() const noexcept {
+    return trace;
+  }
+
+  /**
+   * Discard all colors; they will be recalculated by the next
+   * UpdateColors() call.
+   */
+  void InvalidateColors() noexcept {
+    colors.clear();
+    n_uploaded_colors = 0;
+  }
+
+  /**
+   * Calculate the colors of all segments which do not have one yet.
+   *
+   * @param f a function which returns the color for the segment
+   * ending at the given #TracePoint
+   */
+  template<typename F>
+  void UpdateColors(F &&f) {
+    for (std::size_t i = colors.size() / 2 + 1; i < trace.size(); ++i) {
+      const Color color = f(trace[i]);
+      colors.push_back(color);
+      colors.push_back(color);
+    }
+  }
+
+  /**
+   * Can the given #Pen be used with Draw()?
+   */
+  [[gnu::pure]]
+  static bool IsSupported(const Pen &pen) noexcept;
+
+  /**
+   * Draw the trail beginning at the given trace index.  The caller
+   * must have called UpdateColors() before.
+   *
+   * @param pen the pen whose width and style is used
+   */
+  void Draw(const WindowProjection &projection, std::size_t first,
+            const Pen &pen) noexcept;
+
+private:
+  void Clear() noexcept;
+
+  /**
+   * Append vertices for the segments ending at trace index #start
+   * and later.
+   */
+  void AppendVertices(std::size_t start) noexcept;
+
+  /**
+   * Upload new #vertices and #colors.
+   */
+  void Commit() noexcept;
+};
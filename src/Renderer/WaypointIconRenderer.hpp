@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include "WaypointReachability.hpp"
+#include "Engine/Route/WaypointReachability.hpp"
 #include "Math/Angle.hpp"
 
 struct PixelPoint;
@@ -11,22 +11,18 @@
 #include "Engine/Util/Gradient.hpp"
 #include "Engine/Waypoint/Waypoint.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
-#include "Engine/GlideSolvers/GlideState.hpp"
-#include "Engine/GlideSolvers/GlideResult.hpp"
-#include "Engine/GlideSolvers/MacCready.hpp"
 #include "Engine/Task/TaskManager.hpp"
 #include "Engine/Task/AbstractTask.hpp"
 #include "Engine/Task/Unordered/UnorderedTaskPoint.hpp"
 #include "Engine/Task/Ordered/Points/OrderedTaskPoint.hpp"
 #include "Task/ProtectedTaskManager.hpp"
-#include "Task/ProtectedRoutePlanner.hpp"
 #include "ui/canvas/Canvas.hpp"
 #include "Units/Units.hpp"
 #include "util/TruncateString.hpp"
 #include "util/StaticArray.hxx"
 #include "util/Macros.hpp"
 #include "NMEA/MoreData.hpp"
-#include "NMEA/Derived.hpp"
+#include "Computer/WaypointReachTable.hpp"
 #include "Engine/Route/ReachResult.hpp"
 #include "Look/WaypointLook.hpp"
 
@@ -60,63 +56,11 @@ struct VisibleWaypoint {
     return ::IsReachable(reachable);
   }
 
-  void CalculateReachabilityDirect(const MoreData &basic,
-                                   const SpeedVector &wind,
-                                   const MacCready &mac_cready,
-                                   const TaskBehaviour &task_behaviour) noexcept {
-    assert(basic.location_available);
-    assert(basic.NavAltitudeAvailable());
-
-    if (!waypoint->has_elevation)
-      return;
-
-    const auto elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const GlideState state(GeoVector(basic.location, waypoint->location),
-                           elevation, basic.nav_altitude, wind);
-
-    const GlideResult result = mac_cready.SolveStraight(state);
-    if (!result.IsOk())
-      return;
-
-    reach.direct = result.pure_glide_altitude_difference;
-    if (result.pure_glide_altitude_difference > 0)
-      reachable = WaypointReachability::TERRAIN;
-    else
-      reachable = WaypointReachability::UNREACHABLE;
-  }
-
-  bool CalculateRouteArrival(const ProtectedRoutePlanner &route_planner,
-                             const TaskBehaviour &task_behaviour) noexcept {
-    if (!waypoint->has_elevation)
-      return false;
-
-    const double elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const AGeoPoint p_dest (waypoint->location, elevation);
-
-    auto _reach = route_planner.FindPositiveArrival(p_dest);
-    if (!_reach)
-      return false;
-
-    reach = *_reach;
-    reach.Subtract(elevation);
-    return true;
-  }
-
-  void CalculateReachability(const ProtectedRoutePlanner &route_planner,
-                             const TaskBehaviour &task_behaviour) noexcept
-  {
-    if (!CalculateRouteArrival(route_planner, task_behaviour))
-      return;
-
-    if (!reach.IsReachableDirect())
-      reachable = WaypointReachability::UNREACHABLE;
-    else if (task_behaviour.route_planner.IsReachEnabled() &&
-             !reach.IsReachableTerrain())
-      reachable = WaypointReachability::STRAIGHT;
-    else
-      reachable = WaypointReachability::TERRAIN;
+  void LookupReachability(const WaypointReachTable &table) noexcept {
+    if (const auto *r = table.Find(waypoint->id)) {
+      reach = r->reach;
+      reachable = r->reachable;
+    }
   }
 
   void DrawSymbol(WaypointIconRenderer &wir) const noexcept {
@@ -140,9 +84,9 @@ class WaypointVisitorMap final
   /**
    * A list of waypoints that are going to be drawn.  This list is
    * filled in the Visitor methods.  In the second stage, their
-   * reachability is calculated, and the third stage draws them.  This
-   * should ensure that the drawing methods don't need to hold a
-   * mutex.
+   * reachability is looked up in the #WaypointReachTable, and the
+   * third stage draws them.  This should ensure that the drawing
+   * methods don't need to hold a mutex.
    */
   StaticArray<VisibleWaypoint, 256> waypoints;
 
@@ -398,46 +342,19 @@ public:
     task_valid = true;
   }
 
-  void CalculateRoute(const ProtectedRoutePlanner &route_planner) noexcept {
-    for (VisibleWaypoint &vwp : waypoints) {
-      const Waypoint &way_point = *vwp.waypoint;
-
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachability(route_planner, task_behaviour);
-    }
-  }
-
-  void CalculateDirect(const PolarSettings &polar_settings,
-                       const TaskBehaviour &task_behaviour,
-                       const DerivedInfo &calculated) noexcept {
-    if (!basic.location_available || !basic.NavAltitudeAvailable())
-      return;
-
-    const GlidePolar &glide_polar =
-      task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
-      ? polar_settings.glide_polar_task
-      : calculated.glide_polar_safety;
-    const MacCready mac_cready(task_behaviour.glide, glide_polar);
-
+  /**
+   * Obtain the reachability of all landable and watched waypoints
+   * from the table calculated by #ReachabilityComputer.
+   */
+  void Calculate(const WaypointReachTable &table) noexcept {
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
 
       if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachabilityDirect(basic, calculated.GetWindOrZero(),
-                                        mac_cready, task_behaviour);
+        vwp.LookupReachability(table);
     }
   }
 
-  void Calculate(const ProtectedRoutePlanner *route_planner,
-                 const PolarSettings &polar_settings,
-                 const TaskBehaviour &task_behaviour,
-                 const DerivedInfo &calculated) noexcept {
-    if (route_planner != nullptr && !route_planner->IsTerrainReachEmpty())
-      CalculateRoute(*route_planner);
-    else
-      CalculateDirect(polar_settings, task_behaviour, calculated);
-  }
-
   void Draw() noexcept {
     for (const VisibleWaypoint &vwp : waypoints)
       DrawWaypoint(vwp);
@@ -463,11 +380,10 @@ void
 WaypointRenderer::Render(Canvas &canvas, LabelBlock &label_block,
                          const MapWindowProjection &projection,
                          const struct WaypointRendererSettings &settings,
-                         const PolarSettings &polar_settings,
                          const TaskBehaviour &task_behaviour,
-                         const MoreData &basic, const DerivedInfo &calculated,
+                         const MoreData &basic,
                          const ProtectedTaskManager *task,
-                         const ProtectedRoutePlanner *route_planner) noexcept
+                         const ProtectedWaypointReachTable *reach) noexcept
 {
   if (way_points == nullptr || way_points->IsEmpty())
     return;
@@ -493,7 +409,10 @@ WaypointRenderer::Render(Canvas &canvas, LabelBlock &label_block,
                                projection.GetScreenDistanceMeters(),
                                [&v](const auto &w){ v.Add(w); });
 
-  v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
+  if (reach != nullptr) {
+    const ProtectedWaypointReachTable::Lease table(*reach);
+    v.Calculate(table);
+  }
 
   v.Draw();
 
@@ -11,12 +11,10 @@ class Canvas;
 class LabelBlock;
 class MapWindowProjection;
 class Waypoints;
-struct PolarSettings;
 struct TaskBehaviour;
 struct MoreData;
-struct DerivedInfo;
 class ProtectedTaskManager;
-class ProtectedRoutePlanner;
+class ProtectedWaypointReachTable;
 
 /**
  * Renders way point icons and labels into a #Canvas.
@@ -42,9 +40,8 @@ public:
   void Render(Canvas &canvas, LabelBlock &label_block,
               const MapWindowProjection &projection,
               const WaypointRendererSettings &settings,
-              const PolarSettings &polar_settings,
               const TaskBehaviour &task_behaviour,
-              const MoreData &basic, const DerivedInfo &calculated,
+              const MoreData &basic,
               const ProtectedTaskManager *task,
-              const ProtectedRoutePlanner *route_planner) noexcept;
+              const ProtectedWaypointReachTable *reach) noexcept;
 };
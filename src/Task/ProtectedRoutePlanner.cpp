@@ -57,6 +57,7 @@ ProtectedRoutePlanner::SolveReach(const AGeoPoint &origin,
   const std::scoped_lock lock{reach_mutex};
   reach_terrain = std::move(rt);
   reach_working = std::move(rw);
+  ++reach_serial;
 }
 
 const FlatProjection
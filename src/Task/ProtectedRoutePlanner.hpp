@@ -7,6 +7,7 @@
 #include "Engine/Route/ReachFan.hpp"
 #include "Engine/Route/RoutePolars.hpp"
 #include "thread/Mutex.hxx"
+#include "util/Serial.hpp"
 
 struct GlideSettings;
 struct RoutePlannerConfig;
@@ -37,6 +38,11 @@ class ProtectedRoutePlanner
   ReachFan reach_terrain;
   ReachFan reach_working;
 
+  /**
+   * Incremented each time the "reach" fields are modified.
+   */
+  Serial reach_serial;
+
 public:
   ProtectedRoutePlanner(RoutePlannerGlue &route, const Airspaces &_airspaces,
                         const ProtectedAirspaceWarningManager *_warnings) noexcept
@@ -54,6 +60,18 @@ public:
     const std::scoped_lock lock{reach_mutex};
     reach_terrain.Reset();
     reach_working.Reset();
+    ++reach_serial;
+  }
+
+  /**
+   * Returns a #Serial which gets incremented when the reach fans
+   * change, e.g. to check whether FindPositiveArrival() results need
+   * to be calculated again.
+   */
+  [[gnu::pure]]
+  Serial GetReachSerial() const noexcept {
+    const std::scoped_lock lock{reach_mutex};
+    return reach_serial;
   }
 
   [[gnu::pure]]
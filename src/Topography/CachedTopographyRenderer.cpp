@@ -4,23 +4,16 @@
 #include "CachedTopographyRenderer.hpp"
 #include "TopographyStore.hpp"
 
-#ifndef ENABLE_OPENGL
-
 void
 CachedTopographyRenderer::Draw(Canvas &canvas,
                                const WindowProjection &projection) noexcept
 {
-  if (renderer.GetStore().GetSerial() != last_serial ||
-      !cache.Check(projection)) {
-    last_serial = renderer.GetStore().GetSerial();
-
-    Canvas &buffer_canvas = cache.Begin(canvas, projection);
-    buffer_canvas.ClearWhite();
-    renderer.Draw(buffer_canvas, projection);
-    cache.Commit(canvas, projection);
+  const unsigned serial = renderer.GetStore().GetSerial();
+  if (!cache.Check(projection, serial)) {
+    Canvas &buffer_canvas = cache.Begin(canvas, projection, serial);
+    renderer.Draw(buffer_canvas, cache.GetBufferProjection());
+    cache.Commit(canvas);
   }
 
-  cache.CopyTransparentWhiteTo(canvas, projection);
+  cache.Draw(canvas, projection);
 }
-
-#endif
@@ -4,7 +4,7 @@
 #pragma once
 
 #include "TopographyRenderer.hpp"
-#include "Renderer/TransparentRendererCache.hpp"
+#include "Renderer/MapLayerCache.hpp"
 
 /**
  * Class used to manage and render vector topography layers
@@ -12,11 +12,7 @@
 class CachedTopographyRenderer {
   TopographyRenderer renderer;
 
-#ifndef ENABLE_OPENGL
-  TransparentRendererCache cache;
-
-  unsigned last_serial = 0;
-#endif
+  MapLayerCache cache;
 
 public:
   CachedTopographyRenderer(const TopographyStore &store,
@@ -25,18 +21,10 @@ public:
   {}
 
   void Flush() noexcept {
-#ifndef ENABLE_OPENGL
     cache.Invalidate();
-#endif
   }
 
-#ifdef ENABLE_OPENGL
-  void Draw(Canvas &canvas, const WindowProjection &projection) noexcept {
-    renderer.Draw(canvas, projection);
-  }
-#else
   void Draw(Canvas &canvas, const WindowProjection &projection) noexcept;
-#endif
 
   void DrawLabels(Canvas &canvas, const WindowProjection &projection,
                   LabelBlock &label_block) noexcept {
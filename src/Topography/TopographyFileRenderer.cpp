@@ -184,6 +184,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #else // !ENABLE_OPENGL
   const GeoClip clip(projection.GetScreenBounds().Scale(1.1));
   AllocatedArray<GeoPoint> geo_points;
+  AllocatedArray<PixelPoint> screen_points;
 
   const unsigned iskip = file.GetSkipSteps(map_scale);
 #endif
@@ -236,12 +237,16 @@ TopographyFileRenderer::Paint(Canvas &canvas,
         for (unsigned msize : lines) {
         shape_renderer.Begin(msize);
 
-        const GeoPoint *end = points + msize - 1;
-        for (; points < end; ++points)
-          shape_renderer.AddPointIfDistant(projection.GeoToScreen(*points));
+        screen_points.GrowDiscard(msize);
+        projection.GeoToScreen({points, msize}, screen_points.data());
+        points += msize - 1;
+
+        const PixelPoint *p = screen_points.data(), *end = p + msize - 1;
+        for (; p < end; ++p)
+          shape_renderer.AddPointIfDistant(*p);
 
         // make sure we always draw the last point
-        shape_renderer.AddPoint(projection.GeoToScreen(*points));
+        shape_renderer.AddPoint(*p);
 
         shape_renderer.FinishPolyline(canvas);
       }
@@ -294,10 +299,11 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
           shape_renderer.Begin(msize);
 
-          for (unsigned i = 0; i < msize; ++i) {
-            GeoPoint g = geo_points[i];
-            shape_renderer.AddPointIfDistant(projection.GeoToScreen(g));
-          }
+          screen_points.GrowDiscard(msize);
+          projection.GeoToScreen({geo_points.data(), msize},
+                                 screen_points.data());
+          for (unsigned i = 0; i < msize; ++i)
+            shape_renderer.AddPointIfDistant(screen_points[i]);
 
           shape_renderer.FinishPolygon(canvas);
 
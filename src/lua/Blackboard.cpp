@@ -6,9 +6,27 @@
 #include "Geo.hpp"
 #include "MetaTable.hxx"
 #include "Util.hxx"
+#include "Value.hxx"
+#include "Error.hxx"
+#include "Catch.hpp"
+#include "Class.hxx"
+#include "Persistent.hpp"
+#include "Blackboard/BlackboardListener.hpp"
+#include "Blackboard/LiveBlackboard.hpp"
+#include "util/IntrusiveList.hxx"
 #include "util/StringAPI.hxx"
 #include "Interface.hpp"
 
+extern "C" {
+#include <lauxlib.h>
+}
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
 namespace Lua {
 
 static void
@@ -31,80 +49,489 @@ Push(lua_State *L, const BrokenDateTime &dt)
   SetField(L, RelativeStackIndex{-1}, "sec", (lua_Integer)dt.second);
 }
 
+}
+
+/**
+ * The attributes of the "xcsoar.blackboard" table.
+ */
+enum class BlackboardField : uint8_t {
+  CLOCK,
+  TIME,
+  DATE_TIME_UTC,
+  LOCATION,
+  ALTITUDE,
+  ALTITUDE_AGL,
+  TRACK,
+  GROUND_SPEED,
+  AIR_SPEED,
+  BANK_ANGLE,
+  PITCH_ANGLE,
+  HEADING,
+  G_LOAD,
+  STATIC_PRESSURE,
+  PITOT_PRESSURE,
+  DYNAMIC_PRESSURE,
+  TEMPERATURE,
+  HUMIDITY,
+  VOLTAGE,
+  BATTERY_LEVEL,
+  NONCOMP_VARIO,
+  TOTAL_ENERGY_VARIO,
+  NETTO_VARIO,
+  CIRCLING,
+  ACTIVE_TASK_POINT,
+  AIRSPACE_WARNING,
+  COUNT
+};
+
+static constexpr std::array<const char *,
+                            std::size_t(BlackboardField::COUNT)> blackboard_field_names{
+  "clock",
+  "time",
+  "date_time_utc",
+  "location",
+  "altitude",
+  "altitude_agl",
+  "track",
+  "ground_speed",
+  "air_speed",
+  "bank_angle",
+  "pitch_angle",
+  "heading",
+  "g_load",
+  "static_pressure",
+  "pitot_pressure",
+  "dynamic_pressure",
+  "temperature",
+  "humidity",
+  "voltage",
+  "battery_level",
+  "noncomp_vario",
+  "total_energy_vario",
+  "netto_vario",
+  "circling",
+  "active_task_point",
+  "airspace_warning",
+};
+
+[[gnu::pure]]
+static std::optional<BlackboardField>
+FindBlackboardField(const char *name) noexcept
+{
+  for (std::size_t i = 0; i < blackboard_field_names.size(); ++i)
+    if (StringIsEqual(name, blackboard_field_names[i]))
+      return BlackboardField(i);
+
+  return std::nullopt;
+}
+
+/**
+ * A snapshot of one blackboard attribute.  std::monostate means the
+ * value is not available.
+ */
+using BlackboardValue = std::variant<std::monostate, bool, lua_Integer,
+                                     double, Angle, TimeStamp,
+                                     GeoPoint, BrokenDateTime>;
+
 template<typename V>
-static void PushOptional(lua_State *L, bool available, V &&value) {
+static BlackboardValue
+Optional(bool available, V &&value) noexcept
+{
   if (available)
-    Push(L, value);
+    return value;
   else
-    lua_pushnil(L);
+    return std::monostate{};
+}
+
+[[gnu::pure]]
+static BlackboardValue
+GetBlackboardValue(BlackboardField field, const MoreData &basic,
+                   const DerivedInfo &calculated) noexcept
+{
+  switch (field) {
+  case BlackboardField::CLOCK:
+    return basic.clock;
+  case BlackboardField::TIME:
+    return Optional(basic.time_available, basic.time);
+  case BlackboardField::DATE_TIME_UTC:
+    return Optional(basic.time_available, basic.date_time_utc);
+  case BlackboardField::LOCATION:
+    return Optional(basic.location_available, basic.location);
+  case BlackboardField::ALTITUDE:
+    return Optional(basic.NavAltitudeAvailable(), basic.nav_altitude);
+  case BlackboardField::ALTITUDE_AGL:
+    return Optional(calculated.altitude_agl_valid, calculated.altitude_agl);
+  case BlackboardField::TRACK:
+    return Optional(basic.track_available, basic.track);
+  case BlackboardField::GROUND_SPEED:
+    return Optional(basic.ground_speed_available, basic.ground_speed);
+  case BlackboardField::AIR_SPEED:
+    return Optional(basic.airspeed_available, basic.true_airspeed);
+  case BlackboardField::BANK_ANGLE:
+    return Optional(basic.attitude.bank_angle_available,
+                    basic.attitude.bank_angle);
+  case BlackboardField::PITCH_ANGLE:
+    return Optional(basic.attitude.pitch_angle_available,
+                    basic.attitude.pitch_angle);
+  case BlackboardField::HEADING:
+    return Optional(basic.attitude.heading_available, basic.attitude.heading);
+  case BlackboardField::G_LOAD:
+    return Optional(basic.acceleration.available, basic.acceleration.g_load);
+  case BlackboardField::STATIC_PRESSURE:
+    return Optional(basic.static_pressure_available,
+                    basic.static_pressure.GetPascal());
+  case BlackboardField::PITOT_PRESSURE:
+    return Optional(basic.pitot_pressure_available,
+                    basic.pitot_pressure.GetPascal());
+  case BlackboardField::DYNAMIC_PRESSURE:
+    return Optional(basic.dyn_pressure_available,
+                    basic.dyn_pressure.GetPascal());
+  case BlackboardField::TEMPERATURE:
+    return Optional(basic.temperature_available,
+                    basic.temperature.ToKelvin());
+  case BlackboardField::HUMIDITY:
+    return Optional(basic.humidity_available, basic.humidity);
+  case BlackboardField::VOLTAGE:
+    return Optional(basic.voltage_available, basic.voltage);
+  case BlackboardField::BATTERY_LEVEL:
+    return Optional(basic.battery_level_available, basic.battery_level);
+  case BlackboardField::NONCOMP_VARIO:
+    return Optional(basic.noncomp_vario_available, basic.noncomp_vario);
+  case BlackboardField::TOTAL_ENERGY_VARIO:
+    return Optional(basic.total_energy_vario_available,
+                    basic.total_energy_vario);
+  case BlackboardField::NETTO_VARIO:
+    return Optional(basic.netto_vario_available, basic.netto_vario);
+  case BlackboardField::CIRCLING:
+    return calculated.circling;
+  case BlackboardField::ACTIVE_TASK_POINT:
+    return Optional(calculated.ordered_task_stats.task_valid,
+                    (lua_Integer)calculated.ordered_task_stats.active_index);
+  case BlackboardField::AIRSPACE_WARNING:
+    return Optional(calculated.airspace_warnings.latest.IsValid(),
+                    calculated.airspace_warnings.latest.ToTimeStamp());
+  case BlackboardField::COUNT:
+    break;
+  }
+
+  return std::monostate{};
 }
 
+/**
+ * Push the value on the Lua stack; nil if it is not available.
+ */
+static void
+PushBlackboardValue(lua_State *L, const BlackboardValue &value)
+{
+  std::visit([L](const auto &v){
+    if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+      lua_pushnil(L);
+    else
+      Lua::Push(L, v);
+  }, value);
 }
 
 static int
 l_blackboard_index(lua_State *L)
 {
-  const auto &basic = CommonInterface::Basic();
-  const auto &calculated = CommonInterface::Calculated();
-
   const char *name = lua_tostring(L, 2);
   if (name == nullptr)
     return 0;
-  else if (StringIsEqual(name, "clock"))
-    Lua::Push(L, basic.clock);
-  else if (StringIsEqual(name, "time"))
-    Lua::PushOptional(L, basic.time_available, basic.time);
-  else if (StringIsEqual(name, "date_time_utc"))
-    Lua::PushOptional(L, basic.time_available, basic.date_time_utc);
-  else if (StringIsEqual(name, "location"))
-    Lua::PushOptional(L, basic.location_available, basic.location);
-  else if (StringIsEqual(name, "altitude"))
-    Lua::PushOptional(L, basic.NavAltitudeAvailable(), basic.nav_altitude);
-  else if (StringIsEqual(name, "altitude_agl"))
-    Lua::PushOptional(L, calculated.altitude_agl_valid, calculated.altitude_agl);
-  else if (StringIsEqual(name, "track"))
-    Lua::PushOptional(L, basic.track_available, basic.track);
-  else if (StringIsEqual(name, "ground_speed"))
-    Lua::PushOptional(L, basic.ground_speed_available, basic.ground_speed);
-  else if (StringIsEqual(name, "air_speed"))
-    Lua::PushOptional(L, basic.airspeed_available, basic.true_airspeed);
-  else if (StringIsEqual(name, "bank_angle"))
-    Lua::PushOptional(L, basic.attitude.bank_angle_available,
-                      basic.attitude.bank_angle);
-  else if (StringIsEqual(name, "pitch_angle"))
-    Lua::PushOptional(L, basic.attitude.pitch_angle_available,
-                      basic.attitude.pitch_angle);
-  else if (StringIsEqual(name, "heading"))
-    Lua::PushOptional(L, basic.attitude.heading_available, basic.attitude.heading);
-  else if (StringIsEqual(name, "g_load"))
-    Lua::PushOptional(L, basic.acceleration.available, basic.acceleration.g_load);
-  else if (StringIsEqual(name, "static_pressure"))
-    Lua::PushOptional(L, basic.static_pressure_available, basic.static_pressure.GetPascal());
-  else if (StringIsEqual(name, "pitot_pressure"))
-    Lua::PushOptional(L, basic.pitot_pressure_available, basic.pitot_pressure.GetPascal());
-  else if (StringIsEqual(name, "dynamic_pressure"))
-    Lua::PushOptional(L, basic.dyn_pressure_available, basic.dyn_pressure.GetPascal());
-  else if (StringIsEqual(name, "temperature"))
-    Lua::PushOptional(L, basic.temperature_available,
-                      basic.temperature.ToKelvin());
-  else if (StringIsEqual(name, "humidity"))
-    Lua::PushOptional(L, basic.humidity_available, basic.humidity);
-  else if (StringIsEqual(name, "voltage"))
-    Lua::PushOptional(L, basic.voltage_available, basic.voltage);
-  else if (StringIsEqual(name, "battery_level"))
-    Lua::PushOptional(L, basic.battery_level_available, basic.battery_level);
-  else if (StringIsEqual(name, "noncomp_vario"))
-    Lua::PushOptional(L, basic.noncomp_vario_available, basic.noncomp_vario);
-  else if (StringIsEqual(name, "total_energy_vario"))
-    Lua::PushOptional(L, basic.total_energy_vario_available, basic.total_energy_vario);
-  else if (StringIsEqual(name, "netto_vario"))
-    Lua::PushOptional(L, basic.netto_vario_available, basic.netto_vario);
-  else
+
+  const auto field = FindBlackboardField(name);
+  if (!field)
     return 0;
 
+  PushBlackboardValue(L, GetBlackboardValue(*field,
+                                            CommonInterface::Basic(),
+                                            CommonInterface::Calculated()));
+  return 1;
+}
+
+/**
+ * A Lua callback which gets invoked once per calculation cycle with
+ * all attributes (of a given set) which have changed since the
+ * previous invocation.  If nothing has changed, Lua is not entered
+ * at all.
+ */
+class LuaBlackboardSubscription final
+  : public IntrusiveListHook<IntrusiveHookMode::TRACK> {
+
+  struct Entry {
+    BlackboardField field;
+    BlackboardValue value;
+  };
+
+  std::vector<Entry> entries;
+
+  Lua::Value callback;
+
+  /**
+   * A LightUserData pointing to this instance.  It is only set while
+   * the subscription is active, to avoid holding a reference on an
+   * otherwise unused Lua object.
+   */
+  Lua::Value subscription;
+
+public:
+  LuaBlackboardSubscription(lua_State *L, std::vector<Entry> &&_entries,
+                            int callback_idx)
+    :entries(std::move(_entries)),
+     callback(L, Lua::StackIndex(callback_idx)), subscription(L) {}
+
+  ~LuaBlackboardSubscription() noexcept;
+
+  lua_State *GetLuaState() {
+    return callback.GetState();
+  }
+
+  void Activate(Lua::StackIndex subscription_index) noexcept;
+  void Cancel() noexcept;
+
+  /**
+   * Compare the subscribed attributes with the previous values and
+   * invoke the callback if at least one has changed.
+   */
+  void Update(const MoreData &basic, const DerivedInfo &calculated);
+
+  static int l_subscribe(lua_State *L);
+  static int l_cancel(lua_State *L);
+
+  static std::vector<Entry> ParseFields(lua_State *L, int idx);
+};
+
+/**
+ * The one #BlackboardListener shared by all Lua blackboard
+ * subscriptions.  It is registered only while there is at least one
+ * active subscription.
+ */
+class LuaBlackboardSubscriptions final : NullBlackboardListener {
+  using List = IntrusiveList<LuaBlackboardSubscription>;
+  List list;
+
+  /**
+   * The next subscription to be visited by OnCalculatedUpdate().
+   * Callbacks may cancel (and the garbage collector may destroy)
+   * arbitrary subscriptions, therefore Remove() advances this
+   * iterator if necessary.
+   */
+  List::iterator next = list.end();
+
+  bool registered = false, dispatching = false;
+
+public:
+  void Add(LuaBlackboardSubscription &s) noexcept {
+    list.push_back(s);
+
+    if (!registered) {
+      /* if this is called from within OnCalculatedUpdate(), we're
+         already registered */
+      assert(!dispatching);
+
+      CommonInterface::GetLiveBlackboard().AddListener(*this);
+      registered = true;
+    }
+  }
+
+  void Remove(LuaBlackboardSubscription &s) noexcept {
+    auto i = list.iterator_to(s);
+    if (i == next)
+      ++next;
+
+    list.erase(i);
+    CheckUnregister();
+  }
+
+private:
+  void CheckUnregister() noexcept {
+    if (registered && !dispatching && list.empty()) {
+      CommonInterface::GetLiveBlackboard().RemoveListener(*this);
+      registered = false;
+    }
+  }
+
+  /* virtual methods from class BlackboardListener */
+  void OnCalculatedUpdate(const MoreData &basic,
+                          const DerivedInfo &calculated) override {
+    dispatching = true;
+
+    for (auto i = list.begin(); i != list.end(); i = next) {
+      next = std::next(i);
+      i->Update(basic, calculated);
+    }
+
+    next = list.end();
+    dispatching = false;
+    CheckUnregister();
+  }
+};
+
+static LuaBlackboardSubscriptions blackboard_subscriptions;
+
+LuaBlackboardSubscription::~LuaBlackboardSubscription() noexcept
+{
+  if (is_linked())
+    blackboard_subscriptions.Remove(*this);
+}
+
+void
+LuaBlackboardSubscription::Activate(Lua::StackIndex subscription_index) noexcept
+{
+  const Lua::ScopeCheckStack check_stack(GetLuaState());
+
+  /* initialise with the current values; the callback gets only
+     changes */
+  for (auto &e : entries)
+    e.value = GetBlackboardValue(e.field, CommonInterface::Basic(),
+                                 CommonInterface::Calculated());
+
+  Lua::AddPersistent(GetLuaState(), this);
+  subscription.Set(subscription_index);
+  blackboard_subscriptions.Add(*this);
+}
+
+void
+LuaBlackboardSubscription::Cancel() noexcept
+{
+  if (!is_linked())
+    return;
+
+  const Lua::ScopeCheckStack check_stack(GetLuaState());
+
+  blackboard_subscriptions.Remove(*this);
+  subscription.Set(nullptr);
+  Lua::RemovePersistent(GetLuaState(), this);
+}
+
+void
+LuaBlackboardSubscription::Update(const MoreData &basic,
+                                  const DerivedInfo &calculated)
+{
+  const auto L = GetLuaState();
+  const Lua::ScopeCheckStack check_stack(L);
+
+  bool changed = false;
+
+  for (auto &e : entries) {
+    auto value = GetBlackboardValue(e.field, basic, calculated);
+    if (value == e.value)
+      continue;
+
+    if (!changed) {
+      changed = true;
+      lua_newtable(L);
+    }
+
+    /* a nil value would not be visible in the table, therefore
+       attributes which are no longer available are reported as
+       "false" */
+    if (std::holds_alternative<std::monostate>(value))
+      lua_pushboolean(L, false);
+    else
+      PushBlackboardValue(L, value);
+    lua_setfield(L, -2, blackboard_field_names[std::size_t(e.field)]);
+
+    e.value = std::move(value);
+  }
+
+  if (!changed)
+    return;
+
+  callback.Push();
+  lua_insert(L, -2);
+  subscription.Push();
+  if (lua_pcall(L, 2, 0, 0))
+    Lua::ThrowError(L, Lua::PopError(L));
+
+  Lua::CheckPersistent(L);
+}
+
+static constexpr struct luaL_Reg blackboard_subscription_methods[] = {
+  {"cancel", LuaBlackboardSubscription::l_cancel},
+  {nullptr, nullptr}
+};
+
+static constexpr char lua_blackboard_subscription_class[] =
+  "xcsoar.blackboard_subscription";
+using LuaBlackboardSubscriptionClass =
+  Lua::Class<LuaBlackboardSubscription, lua_blackboard_subscription_class>;
+
+std::vector<LuaBlackboardSubscription::Entry>
+LuaBlackboardSubscription::ParseFields(lua_State *L, int idx)
+{
+  const std::size_t n = lua_rawlen(L, idx);
+  if (n == 0)
+    luaL_argerror(L, idx, "no attributes");
+
+  /* validate all names before allocating anything, because
+     luaL_argerror() does not return */
+  std::array<BlackboardField, std::size_t(BlackboardField::COUNT)> fields;
+  std::size_t n_fields = 0;
+
+  for (std::size_t i = 1; i <= n; ++i) {
+    lua_rawgeti(L, idx, i);
+    const char *name = lua_tostring(L, -1);
+    const auto field = name != nullptr
+      ? FindBlackboardField(name)
+      : std::nullopt;
+    lua_pop(L, 1);
+
+    if (!field)
+      luaL_argerror(L, idx, "unknown blackboard attribute");
+
+    if (std::find(fields.begin(), fields.begin() + n_fields,
+                  *field) == fields.begin() + n_fields)
+      fields[n_fields++] = *field;
+  }
+
+  std::vector<Entry> result;
+  result.reserve(n_fields);
+  for (std::size_t i = 0; i < n_fields; ++i)
+    result.push_back({fields[i], std::monostate{}});
+
+  return result;
+}
+
+int
+LuaBlackboardSubscription::l_subscribe(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "Invalid parameters");
+
+  if (!lua_istable(L, 1))
+    luaL_argerror(L, 1, "table expected");
+
+  if (!lua_isfunction(L, 2))
+    luaL_argerror(L, 2, "function expected");
+
+  auto *subscription = LuaBlackboardSubscriptionClass::New(L, L,
+                                                           ParseFields(L, 1),
+                                                           2);
+  subscription->Activate(Lua::StackIndex(-2));
   return 1;
 }
 
+int
+LuaBlackboardSubscription::l_cancel(lua_State *L)
+{
+  auto &subscription = LuaBlackboardSubscriptionClass::Cast(L, 1);
+  subscription.Cancel();
+  return 0;
+}
+
+static void
+CreateBlackboardSubscriptionMetatable(lua_State *L)
+{
+  LuaBlackboardSubscriptionClass::Register(L);
+
+  /* metatable.__index = blackboard_subscription_methods */
+  luaL_newlib(L, blackboard_subscription_methods);
+  lua_setfield(L, -2, "__index");
+
+  /* pop metatable */
+  lua_pop(L, 1);
+}
+
 void
 Lua::InitBlackboard(lua_State *L)
 {
@@ -114,7 +541,12 @@ Lua::InitBlackboard(lua_State *L)
 
   MakeIndexMetaTableFor(L, RelativeStackIndex{-1}, l_blackboard_index);
 
+  SetField(L, RelativeStackIndex{-1}, "subscribe",
+           LuaBlackboardSubscription::l_subscribe);
+
   lua_setfield(L, -2, "blackboard");
 
   lua_pop(L, 1);
+
+  CreateBlackboardSubscriptionMetatable(L);
 }
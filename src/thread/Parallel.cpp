@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Parallel.hpp"
+#include "Thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <forward_list>
+
+#ifdef _WIN32
+#include <sysinfoapi.h>
+#else
+#include <unistd.h>
+#endif
+
+unsigned
+GetProcessorCount() noexcept
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return std::max(unsigned(info.dwNumberOfProcessors), 1U);
+#else
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? unsigned(n) : 1U;
+#endif
+}
+
+namespace {
+
+/**
+ * Shared state of one RunParallel() call: the threads take the next
+ * index from an atomic counter until all indices are done.
+ */
+class ParallelJob {
+  const std::function<void(unsigned)> &f;
+  const unsigned n;
+  std::atomic_uint next{0};
+
+public:
+  ParallelJob(unsigned _n,
+              const std::function<void(unsigned)> &_f) noexcept
+    :f(_f), n(_n) {}
+
+  void Work() noexcept {
+    for (unsigned i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+      f(i);
+  }
+};
+
+class ParallelThread final : public Thread {
+  ParallelJob &job;
+
+public:
+  explicit ParallelThread(ParallelJob &_job) noexcept
+    :Thread("Parallel"), job(_job) {}
+
+protected:
+  void Run() noexcept override {
+    job.Work();
+  }
+};
+
+} // anonymous namespace
+
+void
+RunParallel(unsigned n, unsigned max_threads,
+            const std::function<void(unsigned)> &f) noexcept
+{
+  ParallelJob job(n, f);
+
+  std::forward_list<ParallelThread> threads;
+  for (unsigned i = 1, n_threads = std::min(n, max_threads);
+       i < n_threads; ++i) {
+    auto &thread = threads.emplace_front(job);
+
+    try {
+      thread.Start();
+    } catch (...) {
+      threads.pop_front();
+      break;
+    }
+  }
+
+  job.Work();
+
+  for (auto &thread : threads)
+    thread.Join();
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <functional>
+
+/**
+ * Determine the number of processors which are online.  Returns at
+ * least 1.
+ */
+unsigned
+GetProcessorCount() noexcept;
+
+/**
+ * Invoke the function for each index in the range [0, n) and wait
+ * for all calls to complete.  The calls are distributed over up to
+ * #max_threads threads; the calling thread is one of them.
+ *
+ * If a thread cannot be started, the remaining work is done by the
+ * threads which are already running.
+ *
+ * @param f a thread-safe function which must not throw
+ */
+void
+RunParallel(unsigned n, unsigned max_threads,
+            const std::function<void(unsigned)> &f) noexcept;
@@ -24,7 +24,11 @@ class GLTexture;
 #include <tchar.h>
 
 #ifdef USE_FREETYPE
+#include <span>
+
 typedef struct FT_FaceRec_ *FT_Face;
+class GlyphAtlas;
+struct GlyphPosition;
 #endif
 
 class FontDescription;
@@ -37,6 +41,11 @@ class Font {
 protected:
 #ifdef USE_FREETYPE
   FT_Face face = nullptr;
+
+  /**
+   * Caches the glyphs rendered by FreeType.  Owned by this object.
+   */
+  GlyphAtlas *atlas = nullptr;
 #elif defined(ANDROID)
   TextUtil *text_util_object = nullptr;
 
@@ -106,6 +115,22 @@ public:
   [[gnu::pure]]
   PixelSize TextSize(tstring_view text) const noexcept;
 
+#ifdef USE_FREETYPE
+  GlyphAtlas &GetGlyphAtlas() const noexcept {
+    return *atlas;
+  }
+
+  /**
+   * Calculate the position of each glyph of the given text, adding
+   * missing glyphs to the #GlyphAtlas.  Glyphs without a bitmap are
+   * omitted.
+   *
+   * @return the number of glyphs written to #dest
+   */
+  std::size_t LayoutGlyphs(tstring_view text,
+                           std::span<GlyphPosition> dest) const noexcept;
+#endif
+
 #if defined(USE_FREETYPE) || defined(USE_APPKIT) || defined(USE_UIKIT)
   static constexpr std::size_t BufferSize(const PixelSize size) noexcept {
     return std::size_t(size.width) * std::size_t(size.height);
@@ -6,6 +6,7 @@
 #include "ui/canvas/custom/Files.hpp"
 #include "Look/FontDescription.hpp"
 #include "Init.hpp"
+#include "GlyphAtlas.hpp"
 #include "Asset.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "system/Path.hpp"
@@ -163,6 +164,7 @@ Font::LoadFile(const char *file, unsigned ptsize, [[maybe_unused]] bool bold, [[
   // TODO: handle bold/italic
 
   face = new_face;
+  atlas = new GlyphAtlas(height);
 }
 
 void
@@ -206,6 +208,9 @@ Font::Destroy() noexcept
 
   assert(IsScreenInitialized());
 
+  delete atlas;
+  atlas = nullptr;
+
   ::FT_Done_Face(face);
   face = nullptr;
 }
@@ -223,10 +228,102 @@ ForEachChar(tstring_view text, std::invocable<unsigned> auto f)
   }
 }
 
-template<typename T>
 static void
-ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
-             std::invocable<int, int, FT_GlyphSlot> auto f) noexcept
+ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n) noexcept
+{
+  for (; n >= 8; n -= 8, ++src) {
+    for (unsigned i = 0x80; i != 0; i >>= 1)
+      *dest++ = (*src & i) ? 0xff : 0x00;
+  }
+
+  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
+    *dest++ = (*src & i) ? 0xff : 0x00;
+}
+
+static void
+ConvertMono(FT_Bitmap &dest, const FT_Bitmap &src) noexcept
+{
+  dest = src;
+  dest.pitch = dest.width;
+  dest.buffer = new unsigned char[dest.pitch * dest.rows];
+
+  unsigned char *d = dest.buffer, *s = src.buffer;
+  for (unsigned y = 0; y < unsigned(dest.rows);
+       ++y, d += dest.pitch, s += src.pitch)
+    ConvertMono(d, s, dest.width);
+}
+
+/**
+ * Load and render a glyph with FreeType and add it to the
+ * #GlyphAtlas.
+ */
+static const GlyphAtlas::Glyph &
+LoadGlyph(const FT_Face face, unsigned ascent_height,
+          GlyphAtlas &atlas, unsigned ch) noexcept
+{
+  GlyphAtlas::Glyph glyph;
+
+  const FT_UInt i = FT_Get_Char_Index(face, ch);
+  if (i == 0)
+    return atlas.Add(ch, glyph, nullptr, 0);
+
+  FT_Error error = FT_Load_Glyph(face, i, load_flags);
+  if (error)
+    return atlas.Add(ch, glyph, nullptr, 0);
+
+  const FT_GlyphSlot slot = face->glyph;
+  const FT_Glyph_Metrics &metrics = slot->metrics;
+
+  glyph.index = i;
+  glyph.left = FT_FLOOR(metrics.horiBearingX);
+  glyph.top = ascent_height - FT_FLOOR(metrics.horiBearingY);
+  glyph.right = glyph.left + FT_CEIL(metrics.width);
+  glyph.advance = FT_CEIL(metrics.horiAdvance);
+
+  error = FT_Render_Glyph(slot, render_mode);
+  if (error)
+    /* advance the pen, but don't draw anything */
+    return atlas.Add(ch, glyph, nullptr, 0);
+
+  if (IsMono()) {
+    /* with anti-aliasing disabled, FreeType writes each pixel in one
+       bit; convert it to 1 byte per pixel */
+    FT_Bitmap bitmap;
+    ConvertMono(bitmap, slot->bitmap);
+    glyph.size = PixelSize(bitmap.width, bitmap.rows);
+    const auto &result = atlas.Add(ch, glyph, bitmap.buffer, bitmap.pitch);
+    delete[] bitmap.buffer;
+    return result;
+  } else {
+    const FT_Bitmap &bitmap = slot->bitmap;
+    glyph.size = PixelSize(bitmap.width, bitmap.rows);
+    return atlas.Add(ch, glyph, bitmap.buffer, bitmap.pitch);
+  }
+}
+
+static int
+GetKerning(const FT_Face face, GlyphAtlas &atlas,
+           unsigned left, unsigned right) noexcept
+{
+  if (const int *cached = atlas.FindKerning(left, right))
+    return *cached;
+
+  FT_Vector delta;
+  FT_Get_Kerning(face, left, right, ft_kerning_default, &delta);
+
+  const int value = delta.x >> 6;
+  atlas.AddKerning(left, right, value);
+  return value;
+}
+
+/**
+ * Invoke a function for each glyph of the text.  Glyphs are looked
+ * up in the #GlyphAtlas; only missing ones are loaded from FreeType.
+ */
+static void
+ForEachGlyph(const FT_Face face, unsigned ascent_height, GlyphAtlas &atlas,
+             tstring_view text,
+             std::invocable<int, int, const GlyphAtlas::Glyph &> auto f) noexcept
 {
   const bool use_kerning = FT_HAS_KERNING(face);
 
@@ -237,36 +334,26 @@ ForEachGlyph(const FT_Face face, unsigned ascent_height, T &&text,
   const std::lock_guard lock{freetype_mutex};
 #endif
 
-  ForEachChar(std::forward<T>(text),
-              [face, ascent_height, &f, use_kerning,
+  ForEachChar(text,
+              [face, ascent_height, &atlas, &f, use_kerning,
                &x, &prev_index](unsigned ch){
-      const FT_UInt i = FT_Get_Char_Index(face, ch);
-      if (i == 0)
-        return;
+      const GlyphAtlas::Glyph *glyph = atlas.Find(ch);
+      if (glyph == nullptr)
+        glyph = &LoadGlyph(face, ascent_height, atlas, ch);
 
-      const FT_Error error = FT_Load_Glyph(face, i, load_flags);
-      if (error)
+      if (glyph->index == 0)
         return;
 
-      const FT_GlyphSlot glyph = face->glyph;
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-
       if (use_kerning) {
-        if (prev_index != 0 && i != 0) {
-          FT_Vector delta;
-          FT_Get_Kerning(face, prev_index, i, ft_kerning_default,
-                         &delta);
-          x += delta.x >> 6;
-        }
-
-        prev_index = i;
+        if (prev_index != 0)
+          x += GetKerning(face, atlas, prev_index, glyph->index);
+
+        prev_index = glyph->index;
       }
 
-      f(x + FT_FLOOR(metrics.horiBearingX),
-        ascent_height - FT_FLOOR(metrics.horiBearingY),
-        glyph);
+      f(x + glyph->left, glyph->top, *glyph);
 
-      x += FT_CEIL(metrics.horiAdvance);
+      x += glyph->advance;
     });
 }
 
@@ -275,13 +362,10 @@ Font::TextSize(tstring_view text) const noexcept
 {
   int maxx = 0;
 
-  ForEachGlyph(face, ascent_height, text,
-               [&maxx](int x, [[maybe_unused]] int y, const FT_GlyphSlot glyph){
-      const FT_Glyph_Metrics &metrics = glyph->metrics;
-      const int glyph_minx = FT_FLOOR(metrics.horiBearingX);
-      const int glyph_maxx = glyph_minx + FT_CEIL(metrics.width);
-
-      int z = x + glyph_maxx;
+  ForEachGlyph(face, ascent_height, *atlas, text,
+               [&maxx](int x, [[maybe_unused]] int y,
+                       const GlyphAtlas::Glyph &glyph){
+      int z = x + glyph.right;
       if (z > maxx)
         maxx = z;
     });
@@ -299,11 +383,10 @@ MixLine(uint8_t *dest, const uint8_t *src, size_t n) noexcept
 
 static void
 RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
-            const FT_Bitmap &bitmap, int x, int y) noexcept
+            const uint8_t *src, unsigned pitch, PixelSize size,
+            int x, int y) noexcept
 {
-  const uint8_t *src = (const uint8_t *)bitmap.buffer;
-  int width = bitmap.width, height = bitmap.rows;
-  int pitch = bitmap.pitch;
+  int width = size.width, height = size.height;
 
   if (x < 0) {
     src -= x;
@@ -318,7 +401,7 @@ RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
     width = buffer_width - x;
 
   if (y < 0) {
-    src -= y * pitch;
+    src -= y * int(pitch);
     height += y;
     y = 0;
   }
@@ -335,50 +418,6 @@ RenderGlyph(uint8_t *buffer, unsigned buffer_width, unsigned buffer_height,
     MixLine(buffer, src, width);
 }
 
-static void
-ConvertMono(unsigned char *dest, const unsigned char *src, unsigned n) noexcept
-{
-  for (; n >= 8; n -= 8, ++src) {
-    for (unsigned i = 0x80; i != 0; i >>= 1)
-      *dest++ = (*src & i) ? 0xff : 0x00;
-  }
-
-  for (unsigned i = 0x80; n > 0; i >>= 1, --n)
-    *dest++ = (*src & i) ? 0xff : 0x00;
-}
-
-static void
-ConvertMono(FT_Bitmap &dest, const FT_Bitmap &src) noexcept
-{
-  dest = src;
-  dest.pitch = dest.width;
-  dest.buffer = new unsigned char[dest.pitch * dest.rows];
-
-  unsigned char *d = dest.buffer, *s = src.buffer;
-  for (unsigned y = 0; y < unsigned(dest.rows);
-       ++y, d += dest.pitch, s += src.pitch)
-    ConvertMono(d, s, dest.width);
-}
-
-static void
-RenderGlyph(uint8_t *buffer, size_t width, size_t height,
-            FT_GlyphSlot glyph, int x, int y) noexcept
-{
-  FT_Error error = FT_Render_Glyph(glyph, render_mode);
-  if (error)
-    return;
-
-  if (IsMono()) {
-    /* with anti-aliasing disabled, FreeType writes each pixel in one
-       bit; hack: convert it to 1 byte per pixel and then render it */
-    FT_Bitmap bitmap;
-    ConvertMono(bitmap, glyph->bitmap);
-    RenderGlyph(buffer, width, height, bitmap, x, y);
-    delete[] bitmap.buffer;
-  } else
-    RenderGlyph(buffer, width, height, glyph->bitmap, x, y);
-}
-
 void
 Font::Render(tstring_view text, const PixelSize size,
              void *_buffer) const noexcept
@@ -386,9 +425,41 @@ Font::Render(tstring_view text, const PixelSize size,
   uint8_t *buffer = (uint8_t *)_buffer;
   std::fill_n(buffer, BufferSize(size), 0);
 
-  ForEachGlyph(face, ascent_height, text,
-               [size, buffer](int x, int y, const FT_GlyphSlot glyph){
-      RenderGlyph(buffer, size.width, size.height, glyph,
-                  x, y);
+  const GlyphAtlas &_atlas = *atlas;
+  ForEachGlyph(face, ascent_height, *atlas, text,
+               [size, buffer, &_atlas](int x, int y,
+                                       const GlyphAtlas::Glyph &glyph){
+      RenderGlyph(buffer, size.width, size.height,
+                  _atlas.GetPixels(glyph.position), _atlas.GetWidth(),
+                  glyph.size, x, y);
     });
 }
+
+std::size_t
+Font::LayoutGlyphs(tstring_view text,
+                   std::span<GlyphPosition> dest) const noexcept
+{
+  std::size_t n;
+  unsigned generation;
+
+  /* if the atlas overflows while the glyphs are being loaded, the
+     positions of the first ones are stale; try again */
+  for (unsigned attempt = 0; attempt < 2; ++attempt) {
+    n = 0;
+    generation = atlas->GetGeneration();
+
+    ForEachGlyph(face, ascent_height, *atlas, text,
+                 [&dest, &n](int x, int y, const GlyphAtlas::Glyph &glyph){
+        if (glyph.size.width == 0 || glyph.size.height == 0 ||
+            n >= dest.size())
+          return;
+
+        dest[n++] = {PixelPoint(x, y), glyph.position, glyph.size};
+      });
+
+    if (atlas->GetGeneration() == generation)
+      break;
+  }
+
+  return n;
+}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "GlyphAtlas.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "ui/canvas/opengl/Texture.hpp"
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+[[gnu::const]]
+static constexpr bool
+IsEmpty(PixelSize size) noexcept
+{
+  return size.width == 0 || size.height == 0;
+}
+
+GlyphAtlas::GlyphAtlas(unsigned font_height) noexcept
+  /* room for at least 16 glyphs per row */
+  :width(std::clamp(std::bit_ceil(font_height * 16), MIN_WIDTH, MAX_SIZE))
+{
+}
+
+GlyphAtlas::~GlyphAtlas() noexcept = default;
+
+void
+GlyphAtlas::Clear() noexcept
+{
+  glyphs.clear();
+  shelf_x = shelf_y = shelf_height = 0;
+  ++generation;
+}
+
+void
+GlyphAtlas::Grow(unsigned min_height) noexcept
+{
+  if (min_height <= height)
+    return;
+
+  unsigned new_height = std::max(height * 2, 64U);
+  while (new_height < min_height)
+    new_height *= 2;
+  new_height = std::min(new_height, MAX_SIZE);
+
+  std::unique_ptr<uint8_t[]> new_pixels{new uint8_t[width * new_height]};
+  if (height > 0)
+    std::copy_n(pixels.get(), width * height, new_pixels.get());
+  std::fill_n(new_pixels.get() + width * height,
+              width * (new_height - height), 0);
+
+  pixels = std::move(new_pixels);
+  height = new_height;
+
+#ifdef ENABLE_OPENGL
+  /* the texture has the wrong size; create a new one */
+  texture.reset();
+#endif
+}
+
+bool
+GlyphAtlas::Allocate(PixelSize size, PixelPoint &p) noexcept
+{
+  if (size.width > width)
+    return false;
+
+  if (shelf_x + size.width > width) {
+    /* begin a new shelf */
+    shelf_y += shelf_height + PADDING;
+    shelf_x = 0;
+    shelf_height = 0;
+  }
+
+  if (shelf_y + size.height > MAX_SIZE)
+    return false;
+
+  Grow(shelf_y + size.height);
+
+  p = PixelPoint(shelf_x, shelf_y);
+  shelf_x += size.width + PADDING;
+  shelf_height = std::max(shelf_height, size.height);
+  return true;
+}
+
+const GlyphAtlas::Glyph &
+GlyphAtlas::Add(unsigned ch, Glyph glyph,
+                const uint8_t *src, int pitch) noexcept
+{
+  if (!IsEmpty(glyph.size)) {
+    if (!Allocate(glyph.size, glyph.position)) {
+      /* the atlas is full: start over */
+      Clear();
+
+      if (!Allocate(glyph.size, glyph.position))
+        /* too large for the atlas; don't draw it */
+        glyph.size = {0, 0};
+    }
+  }
+
+  if (!IsEmpty(glyph.size)) {
+    uint8_t *dest = pixels.get() + unsigned(glyph.position.y) * width
+      + unsigned(glyph.position.x);
+    for (unsigned y = 0; y < glyph.size.height;
+         ++y, src += pitch, dest += width)
+      std::memcpy(dest, src, glyph.size.width);
+
+#ifdef ENABLE_OPENGL
+    const unsigned top = glyph.position.y;
+    const unsigned bottom = top + glyph.size.height;
+    if (dirty_top == dirty_bottom) {
+      dirty_top = top;
+      dirty_bottom = bottom;
+    } else {
+      dirty_top = std::min(dirty_top, top);
+      dirty_bottom = std::max(dirty_bottom, bottom);
+    }
+#endif
+  }
+
+  return glyphs.insert_or_assign(ch, glyph).first->second;
+}
+
+#ifdef ENABLE_OPENGL
+
+GLTexture &
+GlyphAtlas::GetTexture() noexcept
+{
+  /* make sure there is something to upload */
+  Grow(1);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if (!texture) {
+    texture = std::make_unique<GLTexture>(GL_ALPHA, PixelSize{width, height},
+                                          GL_ALPHA, GL_UNSIGNED_BYTE,
+                                          pixels.get());
+    dirty_top = dirty_bottom = 0;
+  } else if (dirty_top != dirty_bottom) {
+    texture->Bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, dirty_top,
+                    width, dirty_bottom - dirty_top,
+                    GL_ALPHA, GL_UNSIGNED_BYTE,
+                    pixels.get() + dirty_top * width);
+    dirty_top = dirty_bottom = 0;
+  }
+
+  return *texture;
+}
+
+#endif
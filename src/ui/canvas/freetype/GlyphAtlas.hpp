@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "ui/dim/Point.hpp"
+#include "ui/dim/Size.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#ifdef ENABLE_OPENGL
+class GLTexture;
+#endif
+
+/**
+ * The position of one glyph of a laid out text.  See
+ * Font::LayoutGlyphs().
+ */
+struct GlyphPosition {
+  /**
+   * The position of the glyph's bitmap relative to the top left
+   * corner of the text.
+   */
+  PixelPoint position;
+
+  /**
+   * The position of the glyph's bitmap within the #GlyphAtlas.
+   */
+  PixelPoint atlas;
+
+  PixelSize size;
+};
+
+/**
+ * A cache of the rendered glyphs of one font.  All glyph bitmaps are
+ * packed into one 8 bit alpha bitmap (the "atlas").  Once all glyphs
+ * of a text have been seen, it can be measured and drawn without
+ * calling FreeType.
+ *
+ * On OpenGL, the atlas is mirrored in a texture, which allows drawing
+ * any text without creating a new texture.
+ *
+ * This class is not thread-safe; without OpenGL, the caller must
+ * protect it with the FreeType mutex.
+ */
+class GlyphAtlas {
+public:
+  struct Glyph {
+    /**
+     * The FreeType glyph index, used for kerning.  0 means the font
+     * does not have this character.
+     */
+    unsigned index = 0;
+
+    /**
+     * The position of the bitmap relative to the pen position and
+     * the top of the line.
+     */
+    int left = 0, top = 0;
+
+    /**
+     * The right edge of the glyph metrics, relative to #left.
+     */
+    int right = 0;
+
+    int advance = 0;
+
+    /**
+     * The position of the bitmap within the atlas.
+     */
+    PixelPoint position{0, 0};
+
+    PixelSize size{0, 0};
+  };
+
+private:
+  static constexpr unsigned MIN_WIDTH = 256, MAX_SIZE = 1024;
+
+  /**
+   * Horizontal and vertical gap between two glyphs, to avoid
+   * bleeding when the texture gets filtered.
+   */
+  static constexpr unsigned PADDING = 1;
+
+  /**
+   * The glyphs indexed by their Unicode character.
+   */
+  std::unordered_map<unsigned, Glyph> glyphs;
+
+  /**
+   * Kerning values indexed by the pair of glyph indexes.
+   */
+  std::unordered_map<uint_least64_t, int> kerning;
+
+  const unsigned width;
+
+  /**
+   * The number of allocated rows of #pixels.
+   */
+  unsigned height = 0;
+
+  std::unique_ptr<uint8_t[]> pixels;
+
+  /**
+   * The "shelf" new glyphs are appended to.
+   */
+  unsigned shelf_x = 0, shelf_y = 0, shelf_height = 0;
+
+  /**
+   * Incremented by Clear().  This allows callers to detect that
+   * previously obtained glyph positions are invalid.
+   */
+  unsigned generation = 0;
+
+#ifdef ENABLE_OPENGL
+  std::unique_ptr<GLTexture> texture;
+
+  /**
+   * The range of rows which were modified after the last upload to
+   * #texture.
+   */
+  unsigned dirty_top = 0, dirty_bottom = 0;
+#endif
+
+public:
+  explicit GlyphAtlas(unsigned font_height) noexcept;
+  ~GlyphAtlas() noexcept;
+
+  GlyphAtlas(const GlyphAtlas &) = delete;
+  GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+
+  unsigned GetGeneration() const noexcept {
+    return generation;
+  }
+
+  [[gnu::pure]]
+  const Glyph *Find(unsigned ch) const noexcept {
+    auto i = glyphs.find(ch);
+    return i != glyphs.end() ? &i->second : nullptr;
+  }
+
+  /**
+   * Add a glyph and copy its bitmap into the atlas.  If the atlas is
+   * full, it is cleared first.
+   *
+   * @param src the 8 bit bitmap with the size #glyph.size; may be
+   * nullptr if the size is empty
+   * @param pitch the distance between two rows of #src in bytes
+   */
+  const Glyph &Add(unsigned ch, Glyph glyph,
+                   const uint8_t *src, int pitch) noexcept;
+
+  [[gnu::pure]]
+  const int *FindKerning(unsigned left, unsigned right) const noexcept {
+    auto i = kerning.find(MakeKerningKey(left, right));
+    return i != kerning.end() ? &i->second : nullptr;
+  }
+
+  void AddKerning(unsigned left, unsigned right, int value) noexcept {
+    kerning.emplace(MakeKerningKey(left, right), value);
+  }
+
+  unsigned GetWidth() const noexcept {
+    return width;
+  }
+
+  const uint8_t *GetPixels(PixelPoint p) const noexcept {
+    return pixels.get() + unsigned(p.y) * width + unsigned(p.x);
+  }
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Returns the texture containing the atlas, after uploading all
+   * modifications.
+   */
+  GLTexture &GetTexture() noexcept;
+#endif
+
+private:
+  static constexpr uint_least64_t MakeKerningKey(unsigned left,
+                                                 unsigned right) noexcept {
+    return (uint_least64_t(left) << 32) | right;
+  }
+
+  /**
+   * Discard all glyphs.
+   */
+  void Clear() noexcept;
+
+  /**
+   * Find a free area for a bitmap of the given size.
+   *
+   * @return false if the atlas is full
+   */
+  bool Allocate(PixelSize size, PixelPoint &p) noexcept;
+
+  /**
+   * Ensure that #pixels has at least the given number of rows.
+   */
+  void Grow(unsigned min_height) noexcept;
+};
@@ -62,6 +62,14 @@ public:
     glBufferData(target, size, data, usage);
   }
 
+  /**
+   * Replaces a portion of the buffer's data.
+   */
+  static void SubData(GLintptr offset, GLsizeiptr size,
+                      const GLvoid *data) noexcept {
+    glBufferSubData(target, offset, size, data);
+  }
+
   void Load(GLsizeiptr size, const GLvoid *data) noexcept {
     Bind();
     Data(size, data);
@@ -10,6 +10,9 @@
 #include "Init.hpp"
 #include "Shaders.hpp"
 #include "Program.hpp"
+#include "VertexPointer.hpp"
+#include "Attribute.hpp"
+#include "ui/dim/BulkPoint.hpp"
 
 #ifdef SOFTWARE_ROTATE_DISPLAY
 #include "DisplayOrientation.hpp"
@@ -23,7 +26,7 @@ BufferCanvas::Create(PixelSize new_size) noexcept
   assert(!active);
 
   Destroy();
-  texture = new GLTexture(INTERNAL_FORMAT, new_size, FORMAT, TYPE, true);
+  texture = new GLTexture(GetFormat(), new_size, GetFormat(), TYPE, true);
 
   if (OpenGL::render_buffer_stencil) {
     frame_buffer = new GLFrameBuffer();
@@ -38,6 +41,19 @@ BufferCanvas::Create(PixelSize new_size) noexcept
   Canvas::Create(new_size);
 }
 
+void
+BufferCanvas::CreateTransparent(PixelSize new_size) noexcept
+{
+  alpha = true;
+  Create(new_size);
+}
+
+bool
+BufferCanvas::IsOffscreenSupported() noexcept
+{
+  return OpenGL::render_buffer_stencil != 0;
+}
+
 void
 BufferCanvas::Destroy() noexcept
 {
@@ -63,7 +79,7 @@ BufferCanvas::Resize(PixelSize new_size) noexcept
   if (new_size == GetSize())
     return;
 
-  texture->ResizeDiscard(INTERNAL_FORMAT, new_size, FORMAT, TYPE);
+  texture->ResizeDiscard(GetFormat(), new_size, GetFormat(), TYPE);
 
   if (stencil_buffer != nullptr) {
     /* the stencil buffer must be detached before we resize it */
@@ -82,46 +98,80 @@ BufferCanvas::Resize(PixelSize new_size) noexcept
   Canvas::Create(new_size);
 }
 
-void
-BufferCanvas::Begin(Canvas &other) noexcept
+inline void
+BufferCanvas::BindFrameBuffer() noexcept
 {
-  assert(IsDefined());
-  assert(!active);
+  assert(frame_buffer != nullptr);
 
-  Resize(other.GetSize());
+  /* activate the frame buffer */
+  frame_buffer->Bind();
+  texture->AttachFramebuffer(FBO::COLOR_ATTACHMENT0);
 
-  if (frame_buffer != nullptr) {
-    /* activate the frame buffer */
-    frame_buffer->Bind();
-    texture->AttachFramebuffer(FBO::COLOR_ATTACHMENT0);
+  if (OpenGL::render_buffer_stencil == OpenGL::render_buffer_depth_stencil)
+    /* we don't need a depth buffer, but we must attach it to the
+       FBO if the stencil Renderbuffer has one */
+    stencil_buffer->AttachFramebuffer(FBO::DEPTH_ATTACHMENT);
 
-    if (OpenGL::render_buffer_stencil == OpenGL::render_buffer_depth_stencil)
-      /* we don't need a depth buffer, but we must attach it to the
-         FBO if the stencil Renderbuffer has one */
-      stencil_buffer->AttachFramebuffer(FBO::DEPTH_ATTACHMENT);
+  stencil_buffer->AttachFramebuffer(FBO::STENCIL_ATTACHMENT);
+
+  /* save the old viewport */
+
+  glGetIntegerv(GL_VIEWPORT, old_viewport);
+
+  old_projection_matrix = OpenGL::projection_matrix;
+  OpenGL::projection_matrix = glm::mat4(1);
+
+  old_translate = OpenGL::translate;
+  old_size = OpenGL::viewport_size;
+
+#ifdef SOFTWARE_ROTATE_DISPLAY
+  old_orientation = OpenGL::display_orientation;
+  OpenGL::display_orientation = DisplayOrientation::DEFAULT;
+#endif
 
-    stencil_buffer->AttachFramebuffer(FBO::STENCIL_ATTACHMENT);
+  /* configure a new viewport */
+  OpenGL::SetupViewport({GetWidth(), GetHeight()});
+  OpenGL::translate = {0, 0};
 
-    /* save the old viewport */
+  OpenGL::UpdateShaderTranslate();
+}
+
+inline void
+BufferCanvas::UnbindFrameBuffer() noexcept
+{
+  assert(frame_buffer != nullptr);
+  assert(OpenGL::translate == PixelPoint(0, 0));
+
+  frame_buffer->Unbind();
+
+  /* restore the old viewport */
+
+  glViewport(old_viewport[0], old_viewport[1],
+             old_viewport[2], old_viewport[3]);
 
-    glGetIntegerv(GL_VIEWPORT, old_viewport);
+  OpenGL::projection_matrix = old_projection_matrix;
+  OpenGL::UpdateShaderProjectionMatrix();
 
-    old_projection_matrix = OpenGL::projection_matrix;
-    OpenGL::projection_matrix = glm::mat4(1);
+  OpenGL::translate = old_translate;
+  OpenGL::viewport_size = old_size;
 
-    old_translate = OpenGL::translate;
-    old_size = OpenGL::viewport_size;
+  OpenGL::UpdateShaderTranslate();
 
 #ifdef SOFTWARE_ROTATE_DISPLAY
-    old_orientation = OpenGL::display_orientation;
-    OpenGL::display_orientation = DisplayOrientation::DEFAULT;
+  OpenGL::display_orientation = old_orientation;
 #endif
+}
+
+void
+BufferCanvas::Begin(Canvas &other) noexcept
+{
+  assert(IsDefined());
+  assert(!active);
 
-    /* configure a new viewport */
-    OpenGL::SetupViewport({GetWidth(), GetHeight()});
-    OpenGL::translate = {0, 0};
+  Resize(other.GetSize());
 
-    OpenGL::UpdateShaderTranslate();
+  if (frame_buffer != nullptr) {
+    BindFrameBuffer();
   } else {
     offset = other.offset;
   }
@@ -140,29 +190,7 @@ BufferCanvas::Commit(Canvas &other) noexcept
   assert(GetHeight() == other.GetHeight());
 
   if (frame_buffer != nullptr) {
-    assert(OpenGL::translate.x == 0);
-    assert(OpenGL::translate.y == 0);
-
-    frame_buffer->Unbind();
-
-    /* restore the old viewport */
-
-    assert(OpenGL::translate == PixelPoint(0, 0));
-
-    glViewport(old_viewport[0], old_viewport[1],
-               old_viewport[2], old_viewport[3]);
-
-    OpenGL::projection_matrix = old_projection_matrix;
-    OpenGL::UpdateShaderProjectionMatrix();
-
-    OpenGL::translate = old_translate;
-    OpenGL::viewport_size = old_size;
-
-    OpenGL::UpdateShaderTranslate();
-
-#ifdef SOFTWARE_ROTATE_DISPLAY
-    OpenGL::display_orientation = old_orientation;
-#endif
+    UnbindFrameBuffer();
 
     /* copy frame buffer to screen */
     CopyTo(other);
@@ -178,6 +206,33 @@ BufferCanvas::Commit(Canvas &other) noexcept
 #endif
 }
 
+void
+BufferCanvas::BeginOffscreen() noexcept
+{
+  assert(IsDefined());
+  assert(!active);
+  assert(frame_buffer != nullptr);
+
+  BindFrameBuffer();
+
+#ifndef NDEBUG
+  active = true;
+#endif
+}
+
+void
+BufferCanvas::CommitOffscreen() noexcept
+{
+  assert(IsDefined());
+  assert(active);
+
+  UnbindFrameBuffer();
+
+#ifndef NDEBUG
+  active = false;
+#endif
+}
+
 void
 BufferCanvas::CopyTo(Canvas &other) noexcept
 {
@@ -189,3 +244,45 @@ BufferCanvas::CopyTo(Canvas &other) noexcept
   texture->Bind();
   texture->Draw(other.GetRect(), GetRect());
 }
+
+void
+BufferCanvas::DrawTransparentTo([[maybe_unused]] Canvas &other,
+                                const PixelPoint (&corners)[4]) const noexcept
+{
+  assert(IsDefined());
+  assert(alpha);
+  assert(!active);
+
+  const BulkPixelPoint vertices[] = {
+    corners[0], corners[1], corners[2], corners[3],
+  };
+
+  const ScopeVertexPointer vp(vertices);
+
+  OpenGL::texture_shader->Use();
+  texture->Bind();
+
+  const PixelSize allocated = texture->GetAllocatedSize();
+  const GLfloat x1 = (GLfloat)GetWidth() / allocated.width;
+  const GLfloat y1 = (GLfloat)GetHeight() / allocated.height;
+
+  /* the texture is flipped, see Create() */
+  const GLfloat coord[] = {
+    0, y1,
+    x1, y1,
+    0, 0,
+    x1, 0,
+  };
+
+  /* the colors in the buffer were multiplied with their alpha value
+     while drawing on the transparent background */
+  const GLBlend blend(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  glEnableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+  glVertexAttribPointer(OpenGL::Attribute::TEXCOORD, 2, GL_FLOAT, GL_FALSE,
+                        0, coord);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+}
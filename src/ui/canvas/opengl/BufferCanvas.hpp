@@ -22,8 +22,6 @@ class GLRenderBuffer;
  * An off-screen #Canvas implementation.
  */
 class BufferCanvas : public Canvas {
-  static constexpr GLint INTERNAL_FORMAT = GL_RGB;
-  static constexpr GLint FORMAT = GL_RGB;
   static constexpr GLint TYPE = GL_UNSIGNED_BYTE;
 
   GLTexture *texture = nullptr;
@@ -43,6 +41,11 @@ class BufferCanvas : public Canvas {
   DisplayOrientation old_orientation;
 #endif
 
+  /**
+   * Does the texture have an alpha channel?  See CreateTransparent().
+   */
+  bool alpha = false;
+
 #ifndef NDEBUG
   bool active = false;
 #endif
@@ -68,6 +71,20 @@ public:
     Create(canvas, canvas.GetSize());
   }
 
+  /**
+   * Create a buffer with an alpha channel.  Use it with
+   * BeginOffscreen() and DrawTransparentTo().
+   */
+  void CreateTransparent(PixelSize new_size) noexcept;
+
+  /**
+   * Can this buffer be drawn to without an on-screen #Canvas,
+   * i.e. is a frame buffer object available?  If not,
+   * BeginOffscreen() must not be used.
+   */
+  [[gnu::pure]]
+  static bool IsOffscreenSupported() noexcept;
+
   void Destroy() noexcept;
 
   void Resize(PixelSize new_size) noexcept;
@@ -96,5 +113,35 @@ public:
    */
   void Commit(Canvas &other) noexcept;
 
+  /**
+   * Begin painting only to the buffer, at its current size.  Call
+   * CommitOffscreen() when done.  Requires IsOffscreenSupported().
+   */
+  void BeginOffscreen() noexcept;
+
+  /**
+   * Finish painting to the buffer without copying it anywhere.
+   */
+  void CommitOffscreen() noexcept;
+
   void CopyTo(Canvas &other) noexcept;
+
+  /**
+   * Draw the buffer (which was created with CreateTransparent() and
+   * contains premultiplied colors) to the given quadrilateral,
+   * blending it with the existing contents.
+   *
+   * @param corners the screen coordinates of the buffer's top left,
+   * top right, bottom left and bottom right corners
+   */
+  void DrawTransparentTo(Canvas &other,
+                         const PixelPoint (&corners)[4]) const noexcept;
+
+private:
+  GLint GetFormat() const noexcept {
+    return alpha ? GL_RGBA : GL_RGB;
+  }
+
+  void BindFrameBuffer() noexcept;
+  void UnbindFrameBuffer() noexcept;
 };
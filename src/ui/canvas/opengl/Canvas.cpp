@@ -12,6 +12,7 @@
 #include "ExactPixelPoint.hpp"
 #include "ui/canvas/custom/Cache.hpp"
 #include "ui/canvas/Bitmap.hpp"
+#include "ui/canvas/Font.hpp"
 #include "ui/canvas/Util.hpp"
 #include "Screen/Layout.hpp"
 #include "Math/Angle.hpp"
@@ -29,6 +30,10 @@
 #include "util/ConvertString.hpp"
 #endif
 
+#ifdef USE_FREETYPE
+#include "ui/canvas/freetype/GlyphAtlas.hpp"
+#endif
+
 #ifndef NDEBUG
 #include "util/UTF8.hpp"
 #endif
@@ -571,6 +576,110 @@ PrepareColoredAlphaTexture(Color color) noexcept
   color.Bind();
 }
 
+#ifdef USE_FREETYPE
+
+static AllocatedArray<GlyphPosition> glyph_buffer;
+static AllocatedArray<BulkPixelPoint> glyph_vertex_buffer;
+static AllocatedArray<GLfloat> glyph_coord_buffer;
+
+/**
+ * Draw text with one quad per glyph from the font's #GlyphAtlas
+ * texture.  Unlike a texture per string, this does not need to
+ * render and upload anything for text which was not drawn before.
+ *
+ * The caller is responsible for selecting the shader and the color.
+ *
+ * @param clip only the part of the text inside this rectangle is
+ * drawn
+ */
+static void
+DrawGlyphs(const Font &font, PixelPoint p, std::string_view text,
+           const PixelRect &clip) noexcept
+{
+  glyph_buffer.GrowDiscard(text.size());
+  const std::size_t n = font.LayoutGlyphs(text, {glyph_buffer.data(),
+                                                 text.size()});
+  if (n == 0)
+    return;
+
+  GLTexture &texture = font.GetGlyphAtlas().GetTexture();
+  const PixelSize allocated = texture.GetAllocatedSize();
+
+  glyph_vertex_buffer.GrowDiscard(n * 6);
+  glyph_coord_buffer.GrowDiscard(n * 12);
+
+  BulkPixelPoint *vertices = glyph_vertex_buffer.data();
+  GLfloat *coord = glyph_coord_buffer.data();
+  unsigned count = 0;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const GlyphPosition &glyph = glyph_buffer[i];
+    PixelRect dest(p + glyph.position, glyph.size);
+    PixelRect src(glyph.atlas, glyph.size);
+
+    if (dest.left < clip.left) {
+      src.left += clip.left - dest.left;
+      dest.left = clip.left;
+    }
+
+    if (dest.top < clip.top) {
+      src.top += clip.top - dest.top;
+      dest.top = clip.top;
+    }
+
+    if (dest.right > clip.right) {
+      src.right -= dest.right - clip.right;
+      dest.right = clip.right;
+    }
+
+    if (dest.bottom > clip.bottom) {
+      src.bottom -= dest.bottom - clip.bottom;
+      dest.bottom = clip.bottom;
+    }
+
+    if (dest.left >= dest.right || dest.top >= dest.bottom)
+      continue;
+
+    const GLfloat x0 = (GLfloat)src.left / allocated.width;
+    const GLfloat y0 = (GLfloat)src.top / allocated.height;
+    const GLfloat x1 = (GLfloat)src.right / allocated.width;
+    const GLfloat y1 = (GLfloat)src.bottom / allocated.height;
+
+    /* two triangles per glyph */
+    *vertices++ = dest.GetTopLeft();
+    *vertices++ = dest.GetTopRight();
+    *vertices++ = dest.GetBottomLeft();
+    *vertices++ = dest.GetTopRight();
+    *vertices++ = dest.GetBottomRight();
+    *vertices++ = dest.GetBottomLeft();
+
+    const GLfloat c[] = {
+      x0, y0,  x1, y0,  x0, y1,
+      x1, y0,  x1, y1,  x0, y1,
+    };
+    coord = std::copy(std::begin(c), std::end(c), coord);
+
+    count += 6;
+  }
+
+  if (count == 0)
+    return;
+
+  texture.Bind();
+
+  const ScopeVertexPointer vp(glyph_vertex_buffer.data());
+
+  glEnableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+  glVertexAttribPointer(OpenGL::Attribute::TEXCOORD, 2, GL_FLOAT, GL_FALSE,
+                        0, glyph_coord_buffer.data());
+
+  glDrawArrays(GL_TRIANGLES, 0, count);
+
+  glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+}
+
+#endif
+
 void
 Canvas::DrawText(PixelPoint p, tstring_view text) noexcept
 {
@@ -590,6 +699,17 @@ Canvas::DrawText(PixelPoint p, tstring_view text) noexcept
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  if (background_mode == OPAQUE)
+    DrawFilledRectangle({p, TextCache::GetSize(*font, text3)},
+                        background_color);
+
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  DrawGlyphs(*font, p, text3, PixelRect{size});
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -603,6 +723,7 @@ Canvas::DrawText(PixelPoint p, tstring_view text) noexcept
 
   texture->Bind();
   texture->Draw(p);
+#endif
 }
 
 void
@@ -624,6 +745,13 @@ Canvas::DrawTransparentText(PixelPoint p, tstring_view text) noexcept
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  DrawGlyphs(*font, p, text3, PixelRect{size});
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -634,6 +762,7 @@ Canvas::DrawTransparentText(PixelPoint p, tstring_view text) noexcept
 
   texture->Bind();
   texture->Draw(p);
+#endif
 }
 
 void
@@ -656,6 +785,13 @@ Canvas::DrawClippedText(PixelPoint p, PixelSize size,
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  DrawGlyphs(*font, p, text3, PixelRect{p, size});
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -671,6 +807,7 @@ Canvas::DrawClippedText(PixelPoint p, PixelSize size,
 
   texture->Bind();
   texture->Draw({p, size}, PixelRect{size});
+#endif
 }
 
 void
@@ -37,6 +37,12 @@ extern bool texture_non_power_of_two;
  */
 extern bool mapbuffer;
 
+/**
+ * The maximum width of lines drawn with GL_LINES, see
+ * GL_ALIASED_LINE_WIDTH_RANGE.
+ */
+extern GLfloat max_line_width;
+
 /**
  * Which depth+stencil internalFormat is supported by the
  * Renderbuffer?
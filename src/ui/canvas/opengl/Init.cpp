@@ -120,6 +120,10 @@ OpenGL::SetupContext()
 
   mapbuffer = IsExtensionSupported("GL_OES_mapbuffer");
 
+  GLfloat line_width_range[2] = {1, 1};
+  glGetFloatv(GL_ALIASED_LINE_WIDTH_RANGE, line_width_range);
+  max_line_width = line_width_range[1];
+
 #ifdef HAVE_DYNAMIC_MAPBUFFER
   if (mapbuffer) {
     GLExt::map_buffer = (PFNGLMAPBUFFEROESPROC)
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * A priority queue implemented as a d-ary heap.  With D=4, the tree
+ * is half as deep as a binary heap, and the children of a node share
+ * one cache line, which makes sifting down (i.e. pop()) cheaper.
+ *
+ * The interface is a subset of std::priority_queue, with the same
+ * meaning of the #Compare parameter: top() is the element which is
+ * not "less" than any other.  The container keeps its capacity when
+ * the heap is cleared.
+ */
+template<typename T, typename Compare, std::size_t D=4>
+class DaryHeap {
+  static_assert(D >= 2);
+
+  std::vector<T> c;
+
+  [[no_unique_address]] Compare compare;
+
+public:
+  using size_type = std::size_t;
+
+  explicit DaryHeap(size_type capacity=0) noexcept {
+    reserve(capacity);
+  }
+
+  void reserve(size_type capacity) noexcept {
+    c.reserve(capacity);
+  }
+
+  [[gnu::pure]]
+  size_type capacity() const noexcept {
+    return c.capacity();
+  }
+
+  [[gnu::pure]]
+  bool empty() const noexcept {
+    return c.empty();
+  }
+
+  [[gnu::pure]]
+  size_type size() const noexcept {
+    return c.size();
+  }
+
+  void clear() noexcept {
+    c.clear();
+  }
+
+  [[gnu::pure]]
+  const T &top() const noexcept {
+    assert(!c.empty());
+    return c.front();
+  }
+
+  void push(const T &value) noexcept {
+    c.push_back(value);
+    SiftUp(c.size() - 1);
+  }
+
+  template<typename... Args>
+  void emplace(Args&&... args) noexcept {
+    c.emplace_back(std::forward<Args>(args)...);
+    SiftUp(c.size() - 1);
+  }
+
+  void pop() noexcept {
+    assert(!c.empty());
+
+    if (c.size() > 1) {
+      c.front() = std::move(c.back());
+      c.pop_back();
+      SiftDown(0);
+    } else
+      c.pop_back();
+  }
+
+private:
+  void SiftUp(size_type i) noexcept {
+    T value = std::move(c[i]);
+
+    while (i > 0) {
+      const size_type parent = (i - 1) / D;
+      if (!compare(c[parent], value))
+        break;
+
+      c[i] = std::move(c[parent]);
+      i = parent;
+    }
+
+    c[i] = std::move(value);
+  }
+
+  void SiftDown(size_type i) noexcept {
+    const size_type n = c.size();
+    T value = std::move(c[i]);
+
+    while (true) {
+      const size_type first = i * D + 1;
+      if (first >= n)
+        break;
+
+      /* find the "greatest" child */
+      size_type best = first;
+      const size_type last = std::min(first + D, n);
+      for (size_type child = first + 1; child < last; ++child)
+        if (compare(c[best], c[child]))
+          best = child;
+
+      if (!compare(value, c[best]))
+        break;
+
+      c[i] = std::move(c[best]);
+      i = best;
+    }
+
+    c[i] = std::move(value);
+  }
+};
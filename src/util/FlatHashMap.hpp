@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A hash map with open addressing (linear probing), designed for
+ * search algorithms which fill a map, throw it away and fill it
+ * again, many times.
+ *
+ * The entries are stored contiguously in insertion order, and the
+ * hash table only contains indices into this array.  Entry indices
+ * are therefore stable until clear() is called, even if the table
+ * grows; this allows other data structures (e.g. a priority queue) to
+ * refer to entries by index.  Iterators (pointers) are invalidated by
+ * insertions.
+ *
+ * Both arrays keep their capacity, and clear() only bumps a
+ * generation counter instead of erasing the table, so clearing is
+ * O(1) and a warmed-up map does not allocate memory.  Keys and values
+ * must therefore be trivially destructible.
+ *
+ * Erasing single entries is not supported.
+ */
+template<typename Key, typename T,
+         typename Hash=std::hash<Key>,
+         typename KeyEqual=std::equal_to<Key>>
+class FlatHashMap {
+public:
+  /**
+   * Mimics std::pair, so code written for std::unordered_map can
+   * access "first" and "second".
+   */
+  struct value_type {
+    Key first;
+    T second;
+
+    template<typename... Args>
+    constexpr value_type(const Key &_first, Args&&... args) noexcept
+      :first(_first), second(std::forward<Args>(args)...) {}
+  };
+
+  static_assert(std::is_trivially_destructible_v<value_type>);
+
+  using size_type = std::size_t;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+  static constexpr size_type MIN_TABLE_SIZE = 64;
+
+  struct Slot {
+    /**
+     * The slot is only occupied if this equals
+     * FlatHashMap::generation.
+     */
+    uint32_t generation;
+
+    uint32_t index;
+  };
+
+  std::vector<value_type> entries;
+  std::vector<Slot> table;
+
+  /**
+   * The number of bits used from the hash; the table size is
+   * 2^#table_bits.
+   */
+  unsigned table_bits = 0;
+
+  uint32_t generation = 1;
+
+  [[no_unique_address]] Hash hash;
+  [[no_unique_address]] KeyEqual equal;
+
+public:
+  FlatHashMap() noexcept = default;
+
+  explicit FlatHashMap(size_type n) noexcept {
+    reserve(n);
+  }
+
+  [[gnu::pure]]
+  bool empty() const noexcept {
+    return entries.empty();
+  }
+
+  [[gnu::pure]]
+  size_type size() const noexcept {
+    return entries.size();
+  }
+
+  iterator begin() noexcept {
+    return entries.begin();
+  }
+
+  const_iterator begin() const noexcept {
+    return entries.begin();
+  }
+
+  iterator end() noexcept {
+    return entries.end();
+  }
+
+  const_iterator end() const noexcept {
+    return entries.end();
+  }
+
+  /**
+   * Remove all entries, but keep the allocated memory.
+   */
+  void clear() noexcept {
+    entries.clear();
+
+    if (++generation == 0) {
+      /* the counter has wrapped around (after 4 billion calls);
+         erase the table once, and start again */
+      std::fill(table.begin(), table.end(), Slot{0, 0});
+      generation = 1;
+    }
+  }
+
+  /**
+   * Make room for at least the given number of entries without
+   * allocating.
+   */
+  void reserve(size_type n) noexcept {
+    entries.reserve(n);
+
+    if (GetTableSizeFor(n) > table.size())
+      Rehash(GetTableSizeFor(n));
+  }
+
+  /**
+   * Look up an entry by its index (0 = the first one which was
+   * inserted after clear()).
+   */
+  value_type &GetEntry(size_type index) noexcept {
+    assert(index < entries.size());
+    return entries[index];
+  }
+
+  [[gnu::pure]]
+  const value_type &GetEntry(size_type index) const noexcept {
+    assert(index < entries.size());
+    return entries[index];
+  }
+
+  [[gnu::pure]]
+  size_type GetIndex(const_iterator i) const noexcept {
+    return std::distance(entries.begin(), i);
+  }
+
+  iterator find(const Key &key) noexcept {
+    const auto *slot = Find(key);
+    return slot != nullptr
+      ? std::next(entries.begin(), slot->index)
+      : entries.end();
+  }
+
+  [[gnu::pure]]
+  const_iterator find(const Key &key) const noexcept {
+    const auto *slot = Find(key);
+    return slot != nullptr
+      ? std::next(entries.begin(), slot->index)
+      : entries.end();
+  }
+
+  /**
+   * Insert a new entry, unless one with the same key exists already.
+   *
+   * @return an iterator to the (new or existing) entry and a flag
+   * specifying whether it was inserted
+   */
+  template<typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key,
+                                        Args&&... args) noexcept {
+    if ((entries.size() + 1) * 2 > table.size())
+      Rehash(GetTableSizeFor(entries.size() + 1));
+
+    const size_type mask = table.size() - 1;
+    for (size_type i = GetBucket(key);; i = (i + 1) & mask) {
+      Slot &slot = table[i];
+      if (slot.generation != generation) {
+        /* empty slot: insert here */
+        slot.generation = generation;
+        slot.index = entries.size();
+        entries.emplace_back(key, std::forward<Args>(args)...);
+        return {std::prev(entries.end()), true};
+      }
+
+      if (equal(entries[slot.index].first, key))
+        return {std::next(entries.begin(), slot.index), false};
+    }
+  }
+
+private:
+  /**
+   * Calculate the table size for the given number of entries; the
+   * load factor is kept at or below 50%.
+   */
+  static constexpr size_type GetTableSizeFor(size_type n) noexcept {
+    size_type size = MIN_TABLE_SIZE;
+    while (size < n * 2)
+      size *= 2;
+    return size;
+  }
+
+  /**
+   * Spread the hash over the table with Fibonacci hashing, because
+   * the hash functions used by the search algorithms are trivial.
+   */
+  [[gnu::pure]]
+  size_type GetBucket(const Key &key) const noexcept {
+    assert(table_bits > 0);
+
+    const uint64_t h = uint64_t(hash(key)) * 0x9e3779b97f4a7c15ULL;
+    return size_type(h >> (64 - table_bits));
+  }
+
+  [[gnu::pure]]
+  const Slot *Find(const Key &key) const noexcept {
+    if (entries.empty())
+      return nullptr;
+
+    const size_type mask = table.size() - 1;
+    for (size_type i = GetBucket(key);; i = (i + 1) & mask) {
+      const Slot &slot = table[i];
+      if (slot.generation != generation)
+        return nullptr;
+
+      if (equal(entries[slot.index].first, key))
+        return &slot;
+    }
+  }
+
+  void Rehash(size_type new_size) noexcept {
+    table.assign(new_size, Slot{0, 0});
+    table_bits = 0;
+    while ((size_type(1) << table_bits) < new_size)
+      ++table_bits;
+
+    /* all slots are empty now; the existing entries are inserted
+       again */
+    generation = 1;
+
+    const size_type mask = new_size - 1;
+    for (size_type index = 0; index < entries.size(); ++index) {
+      size_type i = GetBucket(entries[index].first);
+      while (table[i].generation == generation)
+        i = (i + 1) & mask;
+
+      table[i] = Slot{generation, uint32_t(index)};
+    }
+  }
+};
+
+/**
+ * A set built on #FlatHashMap, see there.
+ */
+template<typename Key,
+         typename Hash=std::hash<Key>,
+         typename KeyEqual=std::equal_to<Key>>
+class FlatHashSet {
+  struct Empty {};
+
+  FlatHashMap<Key, Empty, Hash, KeyEqual> map;
+
+public:
+  FlatHashSet() noexcept = default;
+
+  explicit FlatHashSet(std::size_t n) noexcept
+    :map(n) {}
+
+  [[gnu::pure]]
+  bool empty() const noexcept {
+    return map.empty();
+  }
+
+  [[gnu::pure]]
+  std::size_t size() const noexcept {
+    return map.size();
+  }
+
+  void clear() noexcept {
+    map.clear();
+  }
+
+  void reserve(std::size_t n) noexcept {
+    map.reserve(n);
+  }
+
+  [[gnu::pure]]
+  bool contains(const Key &key) const noexcept {
+    return map.find(key) != map.end();
+  }
+
+  /**
+   * @return true if the key was inserted, false if it already existed
+   */
+  bool insert(const Key &key) noexcept {
+    return map.try_emplace(key).second;
+  }
+};
@@ -0,0 +1,528 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * A static spatial index for points on a plane: a packed R-tree which
+ * is bulk-loaded with the "Sort-Tile-Recursive" algorithm, plus a
+ * small unsorted "overlay" for values added after that.  It is meant
+ * as a replacement for #QuadTree in containers which are loaded once
+ * and then modified only rarely.
+ *
+ * Values and their positions are stored in two contiguous arrays; the
+ * first part is sorted in tree order, and the rest is the overlay.
+ * The tree consists of one bounding box per node, and has no
+ * pointers: node i of one level contains the nodes (or values) i *
+ * #NODE_SIZE to (i + 1) * #NODE_SIZE - 1 of the level below.
+ *
+ * Like #QuadTree, the container needs to know its bounds, which are
+ * calculated by Optimise().  Values may be added at any time; but if
+ * a value is outside of the bounds, the caller should call
+ * ClearBounds() and Optimise() (after updating the positions, if
+ * necessary).  Values which are erased or replaced are removed from
+ * the tree immediately; the bounding boxes are grown as necessary,
+ * but never shrunk until the next Optimise() call.
+ *
+ * The Accessor type must provide GetX() and GetY() methods which
+ * return the integer coordinates of a value.
+ */
+template<typename T, typename Accessor>
+class PackedRTree {
+  /**
+   * The number of entries per tree node.
+   */
+  static constexpr std::size_t NODE_SIZE = 16;
+
+  /**
+   * Optimise() packs the overlay into the tree only if it contains
+   * more values than this.
+   */
+  static constexpr std::size_t MAX_OVERLAY = NODE_SIZE * NODE_SIZE;
+
+public:
+  using position_type = int;
+  using distance_type = unsigned;
+
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  static constexpr distance_type max_distance() noexcept {
+    return std::numeric_limits<distance_type>::max();
+  }
+
+  static constexpr distance_type Square(distance_type x) noexcept {
+    return x * x;
+  }
+
+  static constexpr distance_type Square(position_type x) noexcept {
+    return Square(distance_type(x < 0 ? -x : x));
+  }
+
+  /**
+   * A location on the plane.
+   */
+  struct Point {
+    position_type x, y;
+
+    Point() noexcept = default;
+
+    constexpr Point(position_type _x, position_type _y) noexcept
+      :x(_x), y(_y) {}
+
+    constexpr distance_type SquareDistanceTo(Point other) const noexcept {
+      return Square(other.x - x) + Square(other.y - y);
+    }
+  };
+
+private:
+  /**
+   * A bounding box of a tree node.
+   */
+  struct Rectangle {
+    position_type left, top, right, bottom;
+
+    Rectangle() noexcept = default;
+
+    explicit constexpr Rectangle(Point p) noexcept
+      :left(p.x), top(p.y), right(p.x), bottom(p.y) {}
+
+    constexpr bool IsInside(Point p) const noexcept {
+      return p.x >= left && p.x <= right && p.y >= top && p.y <= bottom;
+    }
+
+    constexpr void Extend(Point p) noexcept {
+      left = std::min(left, p.x);
+      right = std::max(right, p.x);
+      top = std::min(top, p.y);
+      bottom = std::max(bottom, p.y);
+    }
+
+    constexpr void Extend(const Rectangle &other) noexcept {
+      left = std::min(left, other.left);
+      right = std::max(right, other.right);
+      top = std::min(top, other.top);
+      bottom = std::max(bottom, other.bottom);
+    }
+
+    /**
+     * Calculate the square distance from the specified point to the
+     * nearest point of this rectangle (0 if the point is inside).
+     */
+    constexpr distance_type SquareDistanceTo(Point p) const noexcept {
+      const position_type dx = std::max({left - p.x, 0, p.x - right});
+      const position_type dy = std::max({top - p.y, 0, p.y - bottom});
+      return Square(dx) + Square(dy);
+    }
+  };
+
+  /**
+   * One level of the tree; level 0 contains the leaf nodes.
+   */
+  struct Level {
+    /**
+     * The index of the first node of this level in #boxes.
+     */
+    std::size_t offset;
+
+    /**
+     * The number of nodes of this level.
+     */
+    std::size_t size;
+  };
+
+  std::vector<T> values;
+
+  /**
+   * The position of each element of #values.
+   */
+  std::vector<Point> positions;
+
+  /**
+   * The number of values in the tree; all values after these are
+   * in the overlay.
+   */
+  std::size_t n_packed = 0;
+
+  std::vector<Rectangle> boxes;
+  std::vector<Level> levels;
+
+  /**
+   * The bounds of all values, calculated by Optimise().
+   */
+  Rectangle bounds;
+  bool have_bounds = false;
+
+public:
+  [[gnu::pure]]
+  static Point GetPosition(const T &value) noexcept {
+    const Accessor accessor;
+    return Point(accessor.GetX(value), accessor.GetY(value));
+  }
+
+  [[gnu::pure]]
+  bool IsEmpty() const noexcept {
+    return values.empty();
+  }
+
+  [[gnu::pure]]
+  std::size_t size() const noexcept {
+    return values.size();
+  }
+
+  const_iterator begin() const noexcept {
+    return values.begin();
+  }
+
+  const_iterator end() const noexcept {
+    return values.end();
+  }
+
+  void clear() noexcept {
+    values.clear();
+    positions.clear();
+    n_packed = 0;
+    boxes.clear();
+    levels.clear();
+    have_bounds = false;
+  }
+
+  [[gnu::pure]]
+  bool HaveBounds() const noexcept {
+    return have_bounds;
+  }
+
+  /**
+   * Forget the bounds; the next Optimise() call will re-read all
+   * positions and rebuild the tree.
+   */
+  void ClearBounds() noexcept {
+    have_bounds = false;
+  }
+
+  [[gnu::pure]]
+  bool IsWithinBounds(Point position) const noexcept {
+    return have_bounds && bounds.IsInside(position);
+  }
+
+  [[gnu::pure]]
+  bool IsWithinBounds(const T &value) const noexcept {
+    return IsWithinBounds(GetPosition(value));
+  }
+
+  /**
+   * Add a value to the overlay.
+   */
+  void Add(T value) noexcept {
+    positions.push_back(GetPosition(value));
+    values.push_back(std::move(value));
+  }
+
+  /**
+   * Rebuild the tree if the bounds are unknown or if the overlay has
+   * grown too large.  This re-reads the positions of all values.
+   */
+  void Optimise() noexcept {
+    if (have_bounds && values.size() - n_packed <= MAX_OVERLAY)
+      return;
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+      positions[i] = GetPosition(values[i]);
+
+    Pack();
+  }
+
+  /**
+   * Find the nearest value within the specified range which matches
+   * the predicate.
+   *
+   * @return the value (or end() if none was found) and its square
+   * distance
+   */
+  template<typename P>
+  [[gnu::pure]]
+  std::pair<const_iterator, distance_type>
+  FindNearestIf(Point location, distance_type range,
+                const P &predicate) const noexcept {
+    Nearest nearest{Square(range)};
+
+    if (!levels.empty())
+      FindNearestIf(levels.size() - 1, 0, location, predicate, nearest);
+
+    ScanNearestIf(n_packed, values.size(), location, predicate, nearest);
+
+    if (!nearest.found)
+      return {end(), max_distance()};
+
+    return {std::next(begin(), nearest.index), nearest.square_distance};
+  }
+
+  [[gnu::pure]]
+  std::pair<const_iterator, distance_type>
+  FindNearest(Point location, distance_type range) const noexcept {
+    return FindNearestIf(location, range, [](const T &){ return true; });
+  }
+
+  /**
+   * Invoke the visitor for all values within the specified range,
+   * in no particular order.
+   */
+  template<typename V>
+  void VisitWithinRange(Point location, distance_type range,
+                        V &visitor) const {
+    const distance_type square_range = Square(range);
+
+    if (!levels.empty())
+      VisitWithinRange(levels.size() - 1, 0, location, square_range,
+                       visitor);
+
+    for (std::size_t i = n_packed; i < values.size(); ++i)
+      if (positions[i].SquareDistanceTo(location) <= square_range)
+        visitor(values[i]);
+  }
+
+  void erase(const_iterator it) noexcept {
+    Erase(std::distance(begin(), it));
+  }
+
+  template<typename P>
+  void EraseIf(const P &predicate) noexcept {
+    /* walk backwards, because Erase() moves values from behind the
+       erased one */
+    for (std::size_t i = values.size(); i-- > 0;)
+      if (predicate(values[i]))
+        Erase(i);
+  }
+
+  /**
+   * Replace a value with a new one, which may be at a different
+   * position.
+   */
+  void Replace(const_iterator it, T value) noexcept {
+    const std::size_t i = std::distance(begin(), it);
+    positions[i] = GetPosition(value);
+    values[i] = std::move(value);
+
+    if (i < n_packed)
+      GrowBoxes(i);
+  }
+
+private:
+  struct Nearest {
+    distance_type square_distance;
+    std::size_t index = 0;
+    bool found = false;
+
+    void Check(std::size_t i, distance_type d) noexcept {
+      if (d <= square_distance && (!found || d < square_distance)) {
+        square_distance = d;
+        index = i;
+        found = true;
+      }
+    }
+  };
+
+  /**
+   * Returns the range of children (nodes of the level below, or
+   * values for level 0) of the specified node.
+   */
+  [[gnu::pure]]
+  std::pair<std::size_t, std::size_t>
+  GetChildren(std::size_t level, std::size_t node) const noexcept {
+    const std::size_t n_children = level > 0
+      ? levels[level - 1].size
+      : n_packed;
+    const std::size_t first = std::min(node * NODE_SIZE, n_children);
+    return {first, std::min(first + NODE_SIZE, n_children)};
+  }
+
+  [[gnu::pure]]
+  const Rectangle &GetBox(std::size_t level, std::size_t node) const noexcept {
+    return boxes[levels[level].offset + node];
+  }
+
+  template<typename P>
+  void ScanNearestIf(std::size_t first, std::size_t last, Point location,
+                     const P &predicate, Nearest &nearest) const noexcept {
+    for (std::size_t i = first; i < last; ++i) {
+      const distance_type d = positions[i].SquareDistanceTo(location);
+      if (d <= nearest.square_distance && predicate(values[i]))
+        nearest.Check(i, d);
+    }
+  }
+
+  template<typename P>
+  void FindNearestIf(std::size_t level, std::size_t node, Point location,
+                     const P &predicate, Nearest &nearest) const noexcept {
+    const auto [first, last] = GetChildren(level, node);
+
+    if (level == 0) {
+      ScanNearestIf(first, last, location, predicate, nearest);
+      return;
+    }
+
+    /* visit the nearest children first, to narrow down the search
+       range quickly */
+    std::array<std::pair<distance_type, std::size_t>, NODE_SIZE> children;
+    std::size_t n = 0;
+    for (std::size_t i = first; i < last; ++i) {
+      const distance_type d = GetBox(level - 1, i).SquareDistanceTo(location);
+      if (d <= nearest.square_distance)
+        children[n++] = {d, i};
+    }
+
+    std::sort(children.begin(), std::next(children.begin(), n));
+
+    for (std::size_t i = 0; i < n; ++i) {
+      if (children[i].first > nearest.square_distance)
+        break;
+
+      FindNearestIf(level - 1, children[i].second, location,
+                    predicate, nearest);
+    }
+  }
+
+  template<typename V>
+  void VisitWithinRange(std::size_t level, std::size_t node, Point location,
+                        distance_type square_range, V &visitor) const {
+    const auto [first, last] = GetChildren(level, node);
+
+    if (level == 0) {
+      for (std::size_t i = first; i < last; ++i)
+        if (positions[i].SquareDistanceTo(location) <= square_range)
+          visitor(values[i]);
+      return;
+    }
+
+    for (std::size_t i = first; i < last; ++i)
+      if (GetBox(level - 1, i).SquareDistanceTo(location) <= square_range)
+        VisitWithinRange(level - 1, i, location, square_range, visitor);
+  }
+
+  /**
+   * Grow the boxes of all nodes containing the specified value, so
+   * they include its (new) position.
+   */
+  void GrowBoxes(std::size_t i) noexcept {
+    const Point p = positions[i];
+    std::size_t node = i / NODE_SIZE;
+    for (const auto &level : levels) {
+      boxes[level.offset + node].Extend(p);
+      node /= NODE_SIZE;
+    }
+  }
+
+  void Erase(std::size_t i) noexcept {
+    if (i < n_packed) {
+      /* fill the hole with the last packed value, so the tree
+         layout remains valid */
+      const std::size_t last = --n_packed;
+      if (i != last) {
+        values[i] = std::move(values[last]);
+        positions[i] = positions[last];
+        GrowBoxes(i);
+      }
+
+      i = last;
+    }
+
+    values.erase(std::next(values.begin(), i));
+    positions.erase(std::next(positions.begin(), i));
+  }
+
+  /**
+   * Sort all values in "Sort-Tile-Recursive" order and build the
+   * tree.
+   */
+  void Pack() noexcept {
+    const std::size_t n = values.size();
+
+    n_packed = n;
+    boxes.clear();
+    levels.clear();
+
+    if (n == 0) {
+      have_bounds = false;
+      return;
+    }
+
+    /* sort by x, cut into vertical slices and sort each slice by y;
+       consecutive runs of NODE_SIZE values are then close to each
+       other */
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+
+    const auto by_x = [this](std::size_t a, std::size_t b){
+      return std::pair(positions[a].x, positions[a].y) <
+        std::pair(positions[b].x, positions[b].y);
+    };
+
+    const auto by_y = [this](std::size_t a, std::size_t b){
+      return std::pair(positions[a].y, positions[a].x) <
+        std::pair(positions[b].y, positions[b].x);
+    };
+
+    std::sort(order.begin(), order.end(), by_x);
+
+    const std::size_t n_leaves = (n + NODE_SIZE - 1) / NODE_SIZE;
+    std::size_t n_slices = 1;
+    while (n_slices * n_slices < n_leaves)
+      ++n_slices;
+
+    const std::size_t slice_size =
+      ((n_leaves + n_slices - 1) / n_slices) * NODE_SIZE;
+    for (std::size_t i = 0; i < n; i += slice_size)
+      std::sort(std::next(order.begin(), i),
+                std::next(order.begin(), std::min(i + slice_size, n)),
+                by_y);
+
+    std::vector<T> sorted_values;
+    std::vector<Point> sorted_positions;
+    sorted_values.reserve(n);
+    sorted_positions.reserve(n);
+    for (const std::size_t i : order) {
+      sorted_values.push_back(std::move(values[i]));
+      sorted_positions.push_back(positions[i]);
+    }
+
+    values = std::move(sorted_values);
+    positions = std::move(sorted_positions);
+
+    /* build the leaf level */
+    levels.push_back({0, n_leaves});
+    for (std::size_t node = 0; node < n_leaves; ++node) {
+      const auto [first, last] = GetChildren(0, node);
+      Rectangle box(positions[first]);
+      for (std::size_t i = first + 1; i < last; ++i)
+        box.Extend(positions[i]);
+      boxes.push_back(box);
+    }
+
+    /* build the upper levels until there is only one root node */
+    while (levels.back().size > 1) {
+      const std::size_t level = levels.size();
+      const std::size_t size =
+        (levels.back().size + NODE_SIZE - 1) / NODE_SIZE;
+      levels.push_back({boxes.size(), size});
+
+      for (std::size_t node = 0; node < size; ++node) {
+        const auto [first, last] = GetChildren(level, node);
+        Rectangle box = GetBox(level - 1, first);
+        for (std::size_t i = first + 1; i < last; ++i)
+          box.Extend(GetBox(level - 1, i));
+        boxes.push_back(box);
+      }
+    }
+
+    bounds = boxes.back();
+    have_bounds = true;
+  }
+};
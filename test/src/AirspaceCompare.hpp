@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "util/StringAPI.hxx"
+
+#include <algorithm>
+
+[[gnu::pure]]
+static inline bool
+IsSameAltitude(const AirspaceAltitude &a, const AirspaceAltitude &b) noexcept
+{
+  if (a.reference != b.reference || a.altitude != b.altitude)
+    return false;
+
+  switch (a.reference) {
+  case AltitudeReference::STD:
+    return a.flight_level == b.flight_level;
+
+  case AltitudeReference::AGL:
+    return a.altitude_above_terrain == b.altitude_above_terrain;
+
+  default:
+    return true;
+  }
+}
+
+static constexpr bool
+IsSameRadioFrequency(RadioFrequency a, RadioFrequency b) noexcept
+{
+  return a.IsDefined() == b.IsDefined() &&
+    (!a.IsDefined() || a.GetKiloHertz() == b.GetKiloHertz());
+}
+
+/**
+ * Compare the attributes and the border of two airspaces, e.g. the
+ * results of two different parsers.
+ */
+[[gnu::pure]]
+static inline bool
+IsSameAirspace(const AbstractAirspace &a, const AbstractAirspace &b) noexcept
+{
+  return StringIsEqual(a.GetName(), b.GetName()) &&
+    a.GetClass() == b.GetClass() && a.GetType() == b.GetType() &&
+    a.GetShape() == b.GetShape() &&
+    IsSameRadioFrequency(a.GetRadioFrequency(), b.GetRadioFrequency()) &&
+    IsSameAltitude(a.GetBase(), b.GetBase()) &&
+    IsSameAltitude(a.GetTop(), b.GetTop()) &&
+    std::ranges::equal(*a.GetPoints(), *b.GetPoints(),
+                       [](const SearchPoint &x, const SearchPoint &y){
+                         return x.GetLocation() == y.GetLocation();
+                       });
+}
+
+/**
+ * Compare two (optimised) airspace databases which were built from
+ * the same input in the same order.
+ */
+[[gnu::pure]]
+static inline bool
+IsSameAirspaces(const Airspaces &a, const Airspaces &b) noexcept
+{
+  return a.GetSize() == b.GetSize() &&
+    std::ranges::equal(a.QueryAll(), b.QueryAll(),
+                       [](const Airspace &x, const Airspace &y){
+                         return IsSameAirspace(x.GetAirspace(),
+                                               y.GetAirspace());
+                       });
+}
@@ -3,6 +3,7 @@
 
 #include "Engine/Trace/Trace.hpp"
 #include "Contest/ContestManager.hpp"
+#include "thread/Parallel.hpp"
 #include "system/Args.hpp"
 #include "Computer/CirclingComputer.hpp"
 #include "DebugReplay.hpp"
@@ -163,6 +164,7 @@ SolveContest(Contest contest,
              Trace &sprint_trace) noexcept
 {
   ContestManager manager(contest, full_trace, triangle_trace, sprint_trace);
+  manager.SetThreads(GetProcessorCount());
   manager.SolveExhaustive();
   return manager.GetStats();
 }
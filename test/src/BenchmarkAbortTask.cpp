@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Flies a synthetic path diagonally across the bounds of a waypoint
+ * file, updating an #AlternateTask (abort list plus alternates) once
+ * per second.  This is meant to be run with a dense file of
+ * landables (e.g. all European airfields and outlandings).
+ */
+
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/Factory.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Task/Unordered/AlternateTask.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "system/Args.hpp"
+#include "Operation/ConsoleOperationEnvironment.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static constexpr unsigned N_SAMPLES = 20000;
+
+static void
+LoadWaypoints(Path path, Waypoints &waypoints)
+{
+  ConsoleOperationEnvironment operation;
+  ReadWaypointFile(path, waypoints,
+                   WaypointFactory(WaypointOrigin::NONE),
+                   operation);
+}
+
+/**
+ * A saw-tooth altitude profile: 20 minutes of gliding from 2500 m
+ * down to 700 m, then climbing back up within 10 minutes.
+ */
+static double
+GetAltitude(unsigned second) noexcept
+{
+  const unsigned t = second % 1800;
+  return t < 1200
+    ? 2500 - 1.5 * t
+    : 700 + 3.0 * (t - 1200);
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  Waypoints waypoints;
+  LoadWaypoints(path, waypoints);
+  waypoints.Optimise();
+
+  GeoBounds bounds = GeoBounds::Invalid();
+  for (const auto &wp : waypoints)
+    bounds.Extend(wp->location);
+
+  if (!bounds.IsValid()) {
+    fprintf(stderr, "No waypoints\n");
+    return EXIT_FAILURE;
+  }
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  const GlidePolar glide_polar(1);
+
+  AlternateTask task(task_behaviour, waypoints);
+  task.SetTaskDestination(bounds.GetCenter());
+
+  const GeoPoint start = bounds.GetNorthWest();
+  const GeoPoint end = bounds.GetSouthEast();
+
+  AircraftState state, state_last;
+  state.Reset();
+  state.flying = true;
+  state.wind = SpeedVector(Angle::Degrees(270), 5);
+  state_last = state;
+
+  unsigned checksum = 0, n_alternates = 0, n_abort = 0;
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < N_SAMPLES; ++i) {
+    state.time = TimeStamp{std::chrono::seconds{i}};
+    state.location = start.Interpolate(end, double(i) / N_SAMPLES);
+    state.altitude = GetAltitude(i);
+
+    task.Update(state, state_last, glide_polar);
+    state_last = state;
+
+    for (unsigned j = 0; j < task.TaskSize(); ++j)
+      checksum = checksum * 31 + task.GetAlternate(j).GetWaypoint().id;
+    n_abort += task.TaskSize();
+
+    for (const auto &alternate : task.GetAlternates())
+      checksum = checksum * 17 + alternate.waypoint->id;
+    n_alternates += task.GetAlternates().size();
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+  const std::chrono::duration<double, std::milli> elapsed = t1 - t0;
+
+  printf("%u waypoints, %u updates: %.1f ms (%.3f ms per update)\n",
+         waypoints.size(), N_SAMPLES, elapsed.count(),
+         elapsed.count() / N_SAMPLES);
+  printf("abort %u alternates %u checksum %08x\n",
+         n_abort, n_alternates, checksum);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
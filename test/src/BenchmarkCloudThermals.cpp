@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Load generator for the thermal database of the cloud server: a
+ * busy day with many clients submitting thermals in a small region
+ * and requesting the thermals around them.  Prints the throughput
+ * of submissions and requests.
+ */
+
+#include "Cloud/Thermal.hpp"
+#include "system/Args.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using Clock = std::chrono::steady_clock;
+
+/* the contest area: 3x3 degrees in the Alps */
+static constexpr GeoPoint AREA_ORIGIN{Angle::Degrees(9), Angle::Degrees(46)};
+static constexpr double AREA_SIZE = 3;
+
+static constexpr unsigned N_CLIENTS = 2000;
+
+/**
+ * Each client submits a thermal every few minutes and requests
+ * thermals once per minute.
+ */
+static constexpr unsigned REQUESTS_PER_SUBMISSION = 3;
+
+class LoadGenerator {
+  std::mt19937 random;
+  std::uniform_real_distribution<double> position{0, AREA_SIZE};
+  std::uniform_real_distribution<double> lift{0.5, 4};
+
+  /* real thermals are at a limited number of places */
+  std::vector<GeoPoint> hotspots;
+
+public:
+  LoadGenerator() noexcept {
+    for (unsigned i = 0; i < 500; ++i)
+      hotspots.push_back(RandomLocation());
+  }
+
+  GeoPoint RandomLocation() noexcept {
+    return {
+      AREA_ORIGIN.longitude + Angle::Degrees(position(random)),
+      AREA_ORIGIN.latitude + Angle::Degrees(position(random)),
+    };
+  }
+
+  void Submit(CloudThermalContainer &thermals, uint64_t client_key,
+              Clock::time_point now) noexcept {
+    /* scatter the submissions within a few hundred meters around
+       one of the hotspots */
+    const auto &hotspot = hotspots[random() % hotspots.size()];
+    const GeoPoint bottom{
+      hotspot.longitude + Angle::Degrees(double(random() % 64) / 10000),
+      hotspot.latitude + Angle::Degrees(double(random() % 64) / 10000),
+    };
+    const GeoPoint top{
+      bottom.longitude + Angle::Degrees(0.002),
+      bottom.latitude + Angle::Degrees(0.001),
+    };
+
+    thermals.Submit(client_key,
+                    AGeoPoint(bottom, 800 + random() % 500),
+                    AGeoPoint(top, 1800 + random() % 1000),
+                    lift(random), now);
+  }
+
+  uint64_t RandomClient() noexcept {
+    return 1 + random() % N_CLIENTS;
+  }
+};
+
+[[gnu::const]]
+static double
+ToSeconds(Clock::duration d) noexcept
+{
+  return std::chrono::duration<double>(d).count();
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "[N_SUBMISSIONS]");
+  const unsigned n_submissions = args.IsEmpty()
+    ? 200000
+    : strtoul(args.ExpectNext(), nullptr, 10);
+  args.ExpectEnd();
+
+  LoadGenerator generator;
+  CloudThermalContainer thermals;
+
+  /* simulate 8 hours; the clock is virtual, so the benchmark runs
+     as fast as possible */
+  const auto day_start = Clock::now();
+  const auto step =
+    Clock::duration{std::chrono::hours(8)} / n_submissions;
+
+  Clock::duration submit_duration{}, request_duration{};
+  unsigned n_requests = 0;
+  std::size_t n_response_items = 0;
+
+  auto now = day_start;
+  auto next_expire = now + std::chrono::minutes(5);
+
+  for (unsigned i = 0; i < n_submissions; ++i) {
+    now += step;
+
+    const auto t0 = Clock::now();
+    generator.Submit(thermals, generator.RandomClient(), now);
+    const auto t1 = Clock::now();
+    submit_duration += t1 - t0;
+
+    for (unsigned j = 0; j < REQUESTS_PER_SUBMISSION; ++j) {
+      const auto location = generator.RandomLocation();
+      const auto client_key = generator.RandomClient();
+
+      for (const auto &item : thermals.GetResponse(location, now))
+        if (item.client_key != client_key)
+          ++n_response_items;
+
+      ++n_requests;
+    }
+
+    request_duration += Clock::now() - t1;
+
+    if (now >= next_expire) {
+      thermals.Expire(now);
+      next_expire = now + std::chrono::minutes(5);
+    }
+  }
+
+  printf("%u submissions in %.1f ms, %.0f/s\n",
+         n_submissions, 1000 * ToSeconds(submit_duration),
+         n_submissions / ToSeconds(submit_duration));
+  printf("%u requests in %.1f ms, %.0f/s, %.1f thermals per response\n",
+         n_requests, 1000 * ToSeconds(request_duration),
+         n_requests / ToSeconds(request_duration),
+         double(n_response_items) / n_requests);
+  printf("%zu hotspots at the end\n", thermals.size());
+
+  return EXIT_SUCCESS;
+}
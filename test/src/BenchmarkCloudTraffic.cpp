@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Load generator for the traffic responses of the cloud server: many
+ * clients flying in a small region, each one sending a fix and
+ * requesting the traffic around it every second.  Prints the cost of
+ * a request with the indexed #CloudTrafficSnapshot and with a linear
+ * scan of the snapshot.
+ */
+
+#include "Cloud/Client.hpp"
+#include "Cloud/Grid.hpp"
+#include "Cloud/TrafficSnapshot.hpp"
+#include "net/IPv4Address.hxx"
+#include "system/Args.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+using Clock = std::chrono::steady_clock;
+
+/* the contest area: 1x1 degree in the Alps */
+static constexpr GeoPoint AREA_ORIGIN{Angle::Degrees(9), Angle::Degrees(46)};
+static constexpr double AREA_SIZE = 1;
+
+static constexpr double TRAFFIC_RANGE = 50000;
+static constexpr std::size_t MAX_TRAFFIC_RESPONSE = 64;
+
+static constexpr unsigned N_SECONDS = 10;
+
+/**
+ * What CloudTrafficSnapshot::FindNearest() did before the snapshot
+ * was indexed.
+ */
+static std::size_t
+ScanNearest(const CloudTrafficSnapshot &snapshot, uint64_t client_key,
+            GeoPoint location) noexcept
+{
+  std::vector<std::pair<double, const CloudTrafficSnapshot::Item *>> candidates;
+  for (const auto &i : snapshot.items) {
+    if (i.client_key == client_key)
+      continue;
+
+    const double distance = location.DistanceS(i.location);
+    if (distance <= TRAFFIC_RANGE)
+      candidates.emplace_back(distance, &i);
+  }
+
+  const std::size_t n = std::min(candidates.size(), MAX_TRAFFIC_RESPONSE);
+  std::partial_sort(candidates.begin(), std::next(candidates.begin(), n),
+                    candidates.end(),
+                    [](const auto &a, const auto &b){
+                      return a.first < b.first;
+                    });
+  return n;
+}
+
+[[gnu::const]]
+static double
+ToMicroseconds(Clock::duration d) noexcept
+{
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "[N_CLIENTS]");
+  const unsigned n_clients = args.IsEmpty()
+    ? 5000
+    : strtoul(args.ExpectNext(), nullptr, 10);
+  args.ExpectEnd();
+
+  std::mt19937 random;
+  std::uniform_real_distribution<double> position{0, AREA_SIZE};
+  std::uniform_real_distribution<double> step{-0.0005, 0.0005};
+
+  const IPv4Address address(127, 0, 0, 1, 5597);
+  const auto clients = std::make_unique<CloudClientContainer>();
+
+  std::vector<GeoPoint> locations;
+  for (unsigned i = 0; i < n_clients; ++i)
+    locations.emplace_back(AREA_ORIGIN.longitude + Angle::Degrees(position(random)),
+                           AREA_ORIGIN.latitude + Angle::Degrees(position(random)));
+
+  CloudTrafficSnapshots snapshots;
+
+  /* the clock is virtual, so the benchmark runs as fast as
+     possible */
+  auto now = Clock::now();
+
+  Clock::duration request_duration{}, scan_duration{};
+  unsigned n_requests = 0;
+  std::size_t n_items = 0, n_scan_items = 0;
+
+  for (unsigned second = 0; second < N_SECONDS; ++second) {
+    now += std::chrono::seconds(1);
+
+    for (unsigned i = 0; i < n_clients; ++i) {
+      auto &location = locations[i];
+      location.longitude += Angle::Degrees(step(random));
+      location.latitude += Angle::Degrees(step(random));
+      clients->Make(address, 1 + i, location, 1000);
+    }
+
+    for (unsigned i = 0; i < n_clients; ++i) {
+      const uint64_t key = 1 + i;
+      const auto &location = locations[i];
+
+      const auto t0 = Clock::now();
+      const auto &snapshot =
+        snapshots.Get(CloudGrid::TileKey(location), *clients, TRAFFIC_RANGE,
+                      Clock::time_point::min(), now);
+      n_items += snapshot.FindNearest(key, location, TRAFFIC_RANGE,
+                                      MAX_TRAFFIC_RESPONSE).size();
+      const auto t1 = Clock::now();
+      n_scan_items += ScanNearest(snapshot, key, location);
+      const auto t2 = Clock::now();
+
+      request_duration += t1 - t0;
+      scan_duration += t2 - t1;
+      ++n_requests;
+    }
+  }
+
+  printf("%u clients, %u requests, %.1f traffic per response\n",
+         n_clients, n_requests, double(n_items) / n_requests);
+  printf("indexed: %.2f us per request (including snapshot rebuilds)\n",
+         ToMicroseconds(request_duration) / n_requests);
+  printf("linear scan: %.2f us per request\n",
+         ToMicroseconds(scan_duration) / n_requests);
+
+  return n_items == n_scan_items ? EXIT_SUCCESS : EXIT_FAILURE;
+}
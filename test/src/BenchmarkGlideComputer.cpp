@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays a flight through the #GlideComputer as fast as possible and
+ * reports how much time each of its sub-computers needs, how many
+ * heap allocations were made and how many fixes per second can be
+ * processed.  Unlike RunAnalysis, this program does not need a
+ * display.
+ */
+
+#include "DebugReplay.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/ComputerProfile.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Task/LoadFile.hpp"
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/Factory.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceGlue.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "io/FileReader.hxx"
+#include "io/BufferedReader.hxx"
+#include "Operation/ConsoleOperationEnvironment.hpp"
+#include "system/Args.hpp"
+#include "system/ConvertPathName.hpp"
+#include "util/PrintException.hxx"
+#include "util/StringCompare.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <stdio.h>
+
+/* fake symbols: */
+
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Dialogs/Dialogs.h"
+#include "Dialogs/Airspace/AirspaceWarningDialog.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void dlgBasicSettingsShowModal() {}
+void ShowWindSettingsDialog() {}
+
+void
+dlgAirspaceWarningsShowModal([[maybe_unused]] ProtectedAirspaceWarningManager &warnings,
+                             [[maybe_unused]] bool auto_close)
+{
+}
+
+void
+dlgStatusShowModal([[maybe_unused]] int page)
+{
+}
+
+void
+ConditionMonitors::Update([[maybe_unused]] const NMEAInfo &basic,
+                          [[maybe_unused]] const DerivedInfo &calculated,
+                          [[maybe_unused]] const ComputerSettings &settings) noexcept
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogPoint([[maybe_unused]] const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+/* count all heap allocations; the GlideComputer may use worker
+   threads, so the counters are atomic */
+
+static std::atomic<std::size_t> n_allocations, allocated_bytes;
+
+void *
+operator new(std::size_t size)
+{
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  void *p = std::malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc{};
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void *p, [[maybe_unused]] std::size_t size) noexcept
+{
+  std::free(p);
+}
+
+using Clock = std::chrono::steady_clock;
+
+[[gnu::const]]
+static double
+ToMilliseconds(Clock::duration d) noexcept
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+static void
+LoadWaypoints(Path path, Waypoints &way_points)
+{
+  ConsoleOperationEnvironment operation;
+  ReadWaypointFile(path, way_points,
+                   WaypointFactory(WaypointOrigin::NONE),
+                   operation);
+  way_points.Optimise();
+}
+
+static void
+LoadAirspaces(Path path, Airspaces &airspaces)
+{
+  FileReader file_reader{path};
+  BufferedReader buffered_reader{file_reader};
+  ParseAirspaceFile(airspaces, buffered_reader);
+  airspaces.Optimise();
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "[--waypoints=FILE] [--task=FILE.tsk] [--airspace=FILE] [--terrain=FILE.xcm]\n"
+            "  DRIVER FILE | FILE.igc");
+
+  const char *waypoints_path = nullptr, *task_path = nullptr;
+  const char *airspace_path = nullptr, *terrain_path = nullptr;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--waypoints=")) != nullptr)
+      waypoints_path = value;
+    else if ((value = StringAfterPrefix(arg, "--task=")) != nullptr)
+      task_path = value;
+    else if ((value = StringAfterPrefix(arg, "--airspace=")) != nullptr)
+      airspace_path = value;
+    else if ((value = StringAfterPrefix(arg, "--terrain=")) != nullptr)
+      terrain_path = value;
+    else
+      args.UsageError();
+  }
+
+  std::unique_ptr<DebugReplay> replay(CreateDebugReplay(args));
+  if (!replay)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  Waypoints way_points;
+  if (waypoints_path != nullptr)
+    LoadWaypoints(PathName(waypoints_path), way_points);
+
+  TaskManager task_manager(settings.task, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  if (task_path != nullptr) {
+    auto task = LoadTask(PathName(task_path), settings.task, &way_points);
+    if (task)
+      protected_task_manager.TaskCommit(*task);
+  }
+
+  std::unique_ptr<RasterTerrain> terrain;
+  if (terrain_path != nullptr) {
+    ConsoleOperationEnvironment operation;
+    terrain = RasterTerrain::OpenTerrain(nullptr, PathName(terrain_path),
+                                         operation);
+  }
+
+  Airspaces airspaces;
+  if (airspace_path != nullptr) {
+    LoadAirspaces(PathName(airspace_path), airspaces);
+    if (terrain)
+      SetAirspaceGroundLevels(airspaces, *terrain);
+  }
+
+  GlideComputer glide_computer(settings, way_points, airspaces,
+                               protected_task_manager,
+                               task_events);
+  glide_computer.SetTerrain(terrain.get());
+  glide_computer.SetContestIncremental(false);
+  glide_computer.Initialise();
+
+  ComputerProfile profile;
+  glide_computer.SetProfile(&profile);
+
+  /* don't count the setup */
+  const std::size_t setup_allocations = n_allocations;
+  const std::size_t setup_bytes = allocated_bytes;
+
+  Clock::duration replay_duration{}, gps_duration{}, idle_duration{};
+  unsigned n_fixes = 0, i = 0;
+
+  const auto start_cpu = std::clock();
+  const auto start = Clock::now();
+
+  while (true) {
+    const auto t0 = Clock::now();
+    if (!replay->Next())
+      break;
+
+    const auto t1 = Clock::now();
+    replay_duration += t1 - t0;
+
+    glide_computer.ReadBlackboard(replay->Basic());
+    glide_computer.ProcessGPS();
+    ++n_fixes;
+
+    const auto t2 = Clock::now();
+    gps_duration += t2 - t1;
+
+    if (++i == 8) {
+      i = 0;
+      glide_computer.ProcessIdle();
+      idle_duration += Clock::now() - t2;
+    }
+  }
+
+  {
+    const auto t0 = Clock::now();
+    glide_computer.ProcessExhaustive();
+    idle_duration += Clock::now() - t0;
+  }
+
+  const auto duration = Clock::now() - start;
+  const auto cpu = std::clock() - start_cpu;
+
+  const std::size_t replay_allocations = n_allocations - setup_allocations;
+  const std::size_t replay_bytes = allocated_bytes - setup_bytes;
+
+  printf("%u fixes in %.1f ms (%.1f ms CPU), %.0f fixes/s\n",
+         n_fixes, ToMilliseconds(duration),
+         1000. * cpu / CLOCKS_PER_SEC,
+         n_fixes / std::chrono::duration<double>(duration).count());
+  printf("%zu allocations (%zu bytes), %.1f per fix\n",
+         replay_allocations, replay_bytes,
+         n_fixes > 0 ? double(replay_allocations) / n_fixes : 0.);
+
+  printf("\n%-20s %10s %10s %12s\n", "section", "ms", "calls", "us/call");
+  printf("%-20s %10.1f\n", "replay", ToMilliseconds(replay_duration));
+  printf("%-20s %10.1f\n", "ProcessGPS", ToMilliseconds(gps_duration));
+  printf("%-20s %10.1f\n", "ProcessIdle", ToMilliseconds(idle_duration));
+
+  for (std::size_t s = 0; s < ComputerProfile::N_SECTIONS; ++s) {
+    const auto section = ComputerProfile::Section(s);
+    const auto &c = profile.counters[s];
+    printf("  %-18s %10.1f %10u %12.2f\n",
+           ComputerProfile::GetName(section),
+           ToMilliseconds(c.duration), c.n,
+           c.n > 0 ? 1000. * ToMilliseconds(c.duration) / c.n : 0.);
+  }
+
+  glide_computer.SetProfile(nullptr);
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
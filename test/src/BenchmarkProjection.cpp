@@ -4,8 +4,14 @@
 #include "Projection/Projection.hpp"
 #include "Screen/Layout.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstdio>
+
 unsigned Layout::scale_1024 = 1024;
 
+using std::chrono::steady_clock;
+
 class TestProjection : public Projection {
 public:
   TestProjection() {
@@ -16,20 +22,49 @@ public:
   }
 };
 
+static constexpr unsigned N_POINTS = 1024;
+static constexpr unsigned N_ITERATIONS = 64 * 1024;
+
 int main()
 {
   TestProjection projection;
 
-  GeoPoint gp = GeoPoint(Angle::Degrees(7.7061111111111114),
-                         Angle::Degrees(51.051944444444445));
+  std::array<GeoPoint, N_POINTS> src;
+  for (unsigned i = 0; i < N_POINTS; ++i)
+    src[i] = GeoPoint(Angle::Degrees(7.7061111111111114 + 0.001 * (i % 37)),
+                      Angle::Degrees(51.051944444444445 + 0.001 * (i % 41)));
+
+  std::array<PixelPoint, N_POINTS> dest;
+
   long x = 0, y = 0;
-  for (unsigned i = 64 * 1024 * 1024; i-- > 0;) {
-    auto rp = projection.GeoToScreen(gp);
+
+  const auto t0 = steady_clock::now();
+  for (unsigned j = 0; j < N_ITERATIONS; ++j) {
+    for (unsigned i = 0; i < N_POINTS; ++i)
+      dest[i] = projection.GeoToScreen(src[i]);
 
     /* prevent gcc from optimizing this loop away */
-    x += rp.x;
-    y += rp.y;
+    x += dest[j % N_POINTS].x;
+    y += dest[j % N_POINTS].y;
   }
 
-  return x + y;
+  const auto t1 = steady_clock::now();
+  for (unsigned j = 0; j < N_ITERATIONS; ++j) {
+    projection.GeoToScreen(src, dest);
+
+    x += dest[j % N_POINTS].x;
+    y += dest[j % N_POINTS].y;
+  }
+
+  const auto t2 = steady_clock::now();
+
+  using Nanos = std::chrono::duration<double, std::nano>;
+  constexpr double n = double(N_POINTS) * N_ITERATIONS;
+
+  printf("scalar: %.2f ns per point\n", Nanos(t1 - t0).count() / n);
+  printf("batch: %.2f ns per point, speedup %.2f\n",
+         Nanos(t2 - t1).count() / n,
+         double((t1 - t0).count()) / (t2 - t1).count());
+
+  return (x + y) == 0;
 }
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Solves the routes of test_route through terrain and airspace
+ * several times with the same planner, and prints the number of heap
+ * allocations and the time per RoutePlanner::Solve() call.  The
+ * optional argument is the start height above terrain [m]; the lower
+ * it is, the more nodes the search visits.
+ */
+
+#include "harness_airspace.hpp"
+#include "Route/AirspaceRoute.hpp"
+#include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Operation/Operation.hpp"
+#include "util/PrintException.hxx"
+
+#include <zzip/zzip.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using std::chrono::steady_clock;
+
+static constexpr unsigned NUM_SOL = 15;
+static constexpr unsigned NUM_PASSES = 3;
+
+static double start_height = 100;
+
+static std::size_t n_allocations;
+
+void *
+operator new(std::size_t size)
+{
+  ++n_allocations;
+
+  void *p = malloc(size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, std::size_t) noexcept
+{
+  free(p);
+}
+
+static void
+BenchmarkRoute(const RasterMap &map)
+{
+  Airspaces airspaces;
+  setup_airspaces(airspaces, map.GetMapCenter(), 28);
+
+  GeoPoint p_start(Angle::Degrees(-0.3), Angle::Degrees(0.0));
+  p_start += map.GetMapCenter();
+
+  const AGeoPoint loc_start(p_start,
+                            map.GetHeight(p_start).GetValueOr0() + start_height);
+
+  SpeedVector wind(Angle::Degrees(0), 0);
+  GlidePolar polar(1);
+
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::BOTH;
+
+  AirspaceRoute route;
+  route.UpdatePolar(settings, config, polar, polar, wind);
+  route.SetTerrain(&map);
+
+  for (unsigned pass = 0; pass < NUM_PASSES; ++pass) {
+    GeoPoint p_dest(Angle::Degrees(0.8), Angle::Degrees(-0.7));
+    p_dest += map.GetMapCenter();
+    AGeoPoint loc_end(p_dest, 0);
+
+    std::size_t allocations = 0;
+    steady_clock::duration duration{};
+    unsigned n_solutions = 0;
+
+    for (unsigned i = 0; i < NUM_SOL; i++) {
+      loc_end.latitude += Angle::Degrees(0.1);
+      loc_end.altitude = map.GetHeight(loc_end).GetValueOr0() + 100;
+      route.Synchronise(airspaces, AirspacePredicateTrue, loc_start, loc_end);
+
+      const std::size_t a0 = n_allocations;
+      const auto t0 = steady_clock::now();
+      if (route.Solve(loc_start, loc_end, config))
+        ++n_solutions;
+      duration += steady_clock::now() - t0;
+      allocations += n_allocations - a0;
+    }
+
+    using Millis = std::chrono::duration<double, std::milli>;
+    printf("pass %u: %u/%u solved, %.1f allocations, %.2f ms per solve\n",
+           pass, n_solutions, NUM_SOL, double(allocations) / NUM_SOL,
+           Millis(duration).count() / NUM_SOL);
+  }
+}
+
+int
+main(int argc, char **argv)
+try {
+  if (argc > 1)
+    start_height = atof(argv[1]);
+
+  static const char map_path[] = "tmp/map.xcm";
+
+  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
+  if (dir == nullptr) {
+    fprintf(stderr, "Failed to open %s\n", map_path);
+    return EXIT_FAILURE;
+  }
+
+  RasterMap map;
+
+  {
+    NullOperationEnvironment operation;
+    LoadTerrainOverview(dir, map.GetTileCache(), operation);
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+  zzip_dir_close(dir);
+
+  BenchmarkRoute(map);
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
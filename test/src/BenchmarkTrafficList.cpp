@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Merges a synthetic OGN or ADS-B feed with a smaller FLARM feed, the
+ * way the #DeviceBlackboard does, and looks up the nearest targets
+ * the way the traffic radar does.  The feed is as dense as an OGN
+ * feed at a large competition site.
+ */
+
+#include "FLARM/List.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using std::chrono::steady_clock;
+
+static constexpr unsigned N_TARGETS = 500;
+static constexpr unsigned N_FLARM_TARGETS = 10;
+
+static FlarmId ids[N_TARGETS];
+
+static void
+Receive(TrafficList &list, FlarmId id, unsigned i, TimeStamp clock) noexcept
+{
+  FlarmTraffic *traffic = list.FindTraffic(id);
+  if (traffic == nullptr) {
+    traffic = list.AllocateTraffic(id);
+    if (traffic == nullptr)
+      return;
+
+    list.new_traffic.Update(clock);
+  }
+
+  traffic->valid.Update(clock);
+  traffic->relative_north = double(i % 97) * 100;
+  traffic->relative_east = double(i % 89) * 100;
+  traffic->relative_altitude = double(i % 13) * 10;
+  traffic->distance = std::hypot(traffic->relative_north,
+                                 traffic->relative_east);
+  list.modified.Update(clock);
+}
+
+int
+main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+  for (unsigned i = 0; i < N_TARGETS; ++i) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%06X", 0xDD0000 + i * 7);
+    ids[i] = FlarmId::Parse(buffer, nullptr);
+  }
+
+  TrafficList flarm, ogn, merged;
+  flarm.Clear();
+  ogn.Clear();
+
+  unsigned total = 0, total_nearest = 0;
+  steady_clock::duration merge_duration{}, nearest_duration{};
+
+  static constexpr unsigned N_SECONDS = 64 * 1024;
+  for (unsigned second = 0; second < N_SECONDS; ++second) {
+    const TimeStamp clock{std::chrono::seconds{second}};
+
+    /* every ten minutes, a third of the targets land and fall
+       silent for a while, which lets them expire */
+    const unsigned silent = (second / 600) % 3;
+
+    for (unsigned i = 0; i < N_TARGETS; ++i)
+      if (i % 3 != silent || (second / 300) % 2 == 0)
+        Receive(ogn, ids[i], i + second, clock);
+
+    for (unsigned i = 0; i < N_FLARM_TARGETS; ++i)
+      Receive(flarm, ids[i * 3], i + second, clock);
+
+    flarm.Expire(clock);
+    ogn.Expire(clock);
+
+    const auto t0 = steady_clock::now();
+    merged = flarm;
+    merged.Complement(ogn);
+    const auto t1 = steady_clock::now();
+
+    uint16_t nearest[32];
+    total_nearest += merged.FindNearest(nearest, 5000);
+    const auto t2 = steady_clock::now();
+
+    merge_duration += t1 - t0;
+    nearest_duration += t2 - t1;
+    total += merged.GetActiveTrafficCount();
+  }
+
+  using Micros = std::chrono::duration<double, std::micro>;
+  printf("%.1f targets, %.1f nearest on average\n",
+         double(total) / N_SECONDS, double(total_nearest) / N_SECONDS);
+  printf("merge: %.2f us, nearest: %.2f us\n",
+         Micros(merge_duration).count() / N_SECONDS,
+         Micros(nearest_duration).count() / N_SECONDS);
+  return 0;
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compiles FlarmNet.org files (*.fln) and OGN device database CSV
+ * exports (*.csv) into one binary database which can be mapped into
+ * memory by FlarmNetDatabase::Map().  Records which appear in more
+ * than one input file are taken from the first one.
+ */
+
+#include "FLARM/FlarmNetBinary.hpp"
+#include "FLARM/FlarmNetDatabase.hpp"
+#include "FLARM/FlarmNetReader.hpp"
+#include "FLARM/OgnDdbReader.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "OUTPUT INPUT.fln|INPUT.csv ...");
+  const auto output_path = args.ExpectNextPath();
+
+  FlarmNetDatabase database;
+
+  do {
+    const auto path = args.ExpectNextPath();
+    const unsigned n = Path{path}.EndsWithIgnoreCase(_T(".csv"))
+      ? OgnDdbReader::LoadFile(path, database)
+      : FlarmNetReader::LoadFile(path, database);
+    fprintf(stderr, "%u records in %s\n", n, Path{path}.ToUTF8().c_str());
+  } while (!args.IsEmpty());
+
+  FileOutputStream file(output_path);
+  FlarmNetBinary::Write(file, database);
+  file.Commit();
+
+  fprintf(stderr, "%zu records written\n", database.size());
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
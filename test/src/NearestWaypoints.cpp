@@ -9,7 +9,9 @@
 #include "Operation/ConsoleOperationEnvironment.hpp"
 #include "util/PrintException.hxx"
 
+#include <chrono>
 #include <cstdint>
+#include <vector>
 #include <stdio.h>
 #include <tchar.h>
 
@@ -20,6 +22,7 @@ LoadWaypoints(Path path, Waypoints &waypoints)
   ReadWaypointFile(path, waypoints,
                    WaypointFactory(WaypointOrigin::NONE),
                    operation);
+  waypoints.Optimise();
 }
 
 static bool
@@ -105,6 +108,7 @@ int main(int argc, char **argv)
 try {
   WaypointType type = WaypointType::ALL;
   double range = 100000;
+  unsigned benchmark_iterations = 0;
 
   Args args(argc, argv,
             "PATH\n\nPATH is expected to be any compatible waypoint file.\n"
@@ -114,7 +118,9 @@ try {
             "2.12343 34.38432\n"
             "65.18234 -173.48307\n\n"
             "Output is in the format: LAT LON ELEV (in m) NAME\n\ne.g.\n"
-            "50.823055 6.186384 189 Aachen Merzbruc");
+            "50.823055 6.186384 189 Aachen Merzbruc\n\n"
+            "--benchmark[=N] repeats all queries N times (default 1000)\n"
+            "and prints the duration to stderr");
 
   const char *arg;
   while ((arg = args.PeekNext()) != NULL && *arg == '-') {
@@ -129,6 +135,12 @@ try {
       type = WaypointType::AIRPORT;
     } else if (StringStartsWith(arg, "--landables-only")) {
       type = WaypointType::LANDABLE;
+    } else if ((value = StringAfterPrefix(arg, "--benchmark=")) != NULL) {
+      benchmark_iterations = strtoul(value, NULL, 10);
+      if (benchmark_iterations == 0)
+        args.UsageError();
+    } else if (StringIsEqual(arg, "--benchmark")) {
+      benchmark_iterations = 1000;
     } else {
       args.UsageError();
     }
@@ -140,18 +152,40 @@ try {
   Waypoints waypoints;
   LoadWaypoints(path, waypoints);
 
+  std::vector<GeoPoint> locations;
+
   char buffer[1024];
   const char *line;
   while ((line = fgets(buffer, sizeof(buffer) - 3, stdin)) != NULL) {
     GeoPoint location;
-    if (!ParseGeopoint(line, location))
-      continue;
+    if (ParseGeopoint(line, location))
+      locations.push_back(location);
+  }
 
+  for (const auto &location : locations) {
     const auto waypoint = GetNearestWaypoint(location, waypoints,
                                              range, type);
     PrintWaypoint(waypoint.get());
   }
 
+  if (benchmark_iterations > 0 && !locations.empty()) {
+    using std::chrono::steady_clock;
+
+    unsigned n_found = 0;
+    const auto start = steady_clock::now();
+    for (unsigned i = 0; i < benchmark_iterations; ++i)
+      for (const auto &location : locations)
+        if (GetNearestWaypoint(location, waypoints, range, type))
+          ++n_found;
+
+    const std::chrono::duration<double, std::micro> duration =
+      steady_clock::now() - start;
+    fprintf(stderr, "%u waypoints, %zu queries x %u: %.3f us per query (%u found)\n",
+            waypoints.size(), locations.size(), benchmark_iterations,
+            duration.count() / (locations.size() * benchmark_iterations),
+            n_found);
+  }
+
   return EXIT_SUCCESS;
 } catch (...) {
   PrintException(std::current_exception());
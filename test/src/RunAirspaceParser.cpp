@@ -3,17 +3,110 @@
 
 #include "Airspace/AirspaceParser.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
 #include "system/Args.hpp"
 #include "io/FileLineReader.hpp"
 #include "Operation/ConsoleOperationEnvironment.hpp"
 #include "util/PrintException.hxx"
+#include "util/StringAPI.hxx"
+
+#include <chrono>
 
 #include <stdio.h>
 #include <tchar.h>
 
+using std::chrono::steady_clock;
+
+/**
+ * Print the number of airspaces and an estimate of the memory they
+ * use (excluding the rtree).
+ */
+static void
+PrintMemoryUsage(const Airspaces &airspaces)
+{
+  std::size_t n_points = 0, n_bytes = 0;
+  unsigned n_compressed = 0;
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    n_points += airspace.GetPoints()->size();
+    if (airspace.IsBorderCompressed())
+      ++n_compressed;
+    n_bytes += airspace.GetMemoryUsage() +
+      (airspace.GetShape() == AbstractAirspace::Shape::CIRCLE
+       ? sizeof(AirspaceCircle)
+       : sizeof(AirspacePolygon));
+  }
+
+  const unsigned n_airspaces = airspaces.GetSize();
+  printf("%u airspaces (%u compressed), %zu vertices, %zu bytes, "
+         "%zu bytes per airspace\n",
+         n_airspaces, n_compressed, n_points, n_bytes,
+         n_airspaces > 0 ? n_bytes / n_airspaces : 0);
+}
+
+/**
+ * Simulate drawing the map: get the borders of all airspaces within
+ * the specified range of the database's center, like the renderer
+ * does for each frame, and print the time per frame.
+ */
+static void
+BenchmarkFrames(const Airspaces &airspaces, double range)
+{
+  const GeoPoint center = airspaces.GetProjection().GetCenter();
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  constexpr unsigned n_frames = 10;
+  unsigned n_airspaces = 0;
+  std::size_t n_bytes = 0;
+  double first = 0, rest = 0;
+
+  for (unsigned frame = 0; frame < n_frames; ++frame) {
+    const auto t0 = steady_clock::now();
+
+    for (const auto &i : airspaces.QueryWithinRange(center, range)) {
+      const auto border = i.GetAirspace().GetPoints();
+      if (frame == 0) {
+        ++n_airspaces;
+        n_bytes += border->size() * sizeof(SearchPoint);
+      }
+    }
+
+    const double t = Milliseconds(steady_clock::now() - t0).count();
+    if (frame == 0)
+      first = t;
+    else
+      rest += t;
+  }
+
+  printf("%.0f km: %u airspaces, %zu bytes decoded; "
+         "first frame %.2f ms, next frames %.2f ms\n",
+         range / 1000, n_airspaces, n_bytes,
+         first, rest / (n_frames - 1));
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
+  Args args(argc, argv,
+            "[--compress] [--sequential] PATH\n\n"
+            "--compress compresses the airspace borders, prints the\n"
+            "memory usage before and after and the time to get the\n"
+            "borders of the airspaces near the center\n"
+            "--sequential uses the line-by-line parser instead of the\n"
+            "parallel one");
+
+  bool compress = false, parallel = true;
+  while (const char *arg = args.PeekNext()) {
+    if (StringIsEqual(arg, "--compress"))
+      compress = true;
+    else if (StringIsEqual(arg, "--sequential"))
+      parallel = false;
+    else
+      break;
+
+    args.Skip();
+  }
+
   const auto path = args.ExpectNextPath();
   args.ExpectEnd();
 
@@ -22,9 +115,32 @@ try {
 
   Airspaces airspaces;
 
-  ParseAirspaceFile(airspaces, buffered_reader);
-
+  const auto t0 = steady_clock::now();
+  ParseAirspaceFile(airspaces, buffered_reader, parallel);
+  const auto t1 = steady_clock::now();
   airspaces.Optimise();
+  const auto t2 = steady_clock::now();
+
+  using Seconds = std::chrono::duration<double>;
+  const double parse_seconds = Seconds(t1 - t0).count();
+  printf("parse: %.3f s, %.1f MB/s; optimise: %.3f s\n",
+         parse_seconds,
+         file_reader.GetSize() / parse_seconds / (1024 * 1024),
+         Seconds(t2 - t1).count());
+
+  if (compress) {
+    static constexpr double ranges[] = {100e3, 300e3, 1000e3};
+
+    PrintMemoryUsage(airspaces);
+    for (const double range : ranges)
+      BenchmarkFrames(airspaces, range);
+
+    airspaces.CompressBorders(16);
+
+    PrintMemoryUsage(airspaces);
+    for (const double range : ranges)
+      BenchmarkFrames(airspaces, range);
+  }
 
   printf("OK\n");
 
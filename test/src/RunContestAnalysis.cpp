@@ -6,7 +6,9 @@
 #include "Printing.hpp"
 #include "system/Args.hpp"
 #include "DebugReplay.hpp"
+#include "thread/Parallel.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <stdio.h>
 
@@ -48,6 +50,61 @@ static ContestManager weglide_free(Contest::WEGLIDE_FREE,
 static ContestManager charron(Contest::CHARRON,
                               full_trace, triangle_trace, sprint_trace);
 
+/**
+ * The managers which are solved exhaustively after the replay.  This
+ * does not include #olc_league, because resetting it would discard
+ * the result of the incremental solver.
+ */
+static ContestManager *const exhaustive_managers[] = {
+  &olc_classic,
+  &olc_fai,
+  &olc_plus,
+  &dmst,
+  &xcontest,
+  &sis_at,
+  &olc_netcoupe,
+  &weglide_free,
+  &charron,
+};
+
+static duration<double>
+SolveExhaustive(unsigned n_threads) noexcept
+{
+  const auto start = steady_clock::now();
+
+  for (auto *manager : exhaustive_managers) {
+    manager->Reset();
+    manager->SetThreads(n_threads);
+    manager->SolveExhaustive();
+  }
+
+  return steady_clock::now() - start;
+}
+
+/**
+ * Solve all contests exhaustively with 1, 2, 4, ... threads, up to
+ * the number of processors, and print the durations.
+ */
+static void
+SolveExhaustive() noexcept
+{
+  const unsigned n_processors = GetProcessorCount();
+
+  duration<double> single{};
+  for (unsigned n_threads = 1;; n_threads = std::min(n_threads * 2,
+                                                     n_processors)) {
+    const auto d = SolveExhaustive(n_threads);
+    if (n_threads == 1)
+      single = d;
+
+    printf("%u threads: %.3f s, speedup %.2f\n",
+           n_threads, d.count(), single / d);
+
+    if (n_threads >= n_processors)
+      break;
+  }
+}
+
 static int
 TestContest(DebugReplay &replay)
 {
@@ -81,19 +138,11 @@ TestContest(DebugReplay &replay)
     olc_league.UpdateIdle();
   }
 
-  olc_classic.SolveExhaustive();
-  olc_fai.SolveExhaustive();
-  olc_league.SolveExhaustive();
-  olc_plus.SolveExhaustive();
-  dmst.SolveExhaustive();
-  xcontest.SolveExhaustive();
-  sis_at.SolveExhaustive();
-  olc_netcoupe.SolveExhaustive();
-  weglide_free.SolveExhaustive();
-  charron.SolveExhaustive();
-
   putchar('\n');
 
+  olc_league.SolveExhaustive();
+  SolveExhaustive();
+
   std::cout << "classic\n";
   PrintHelper::print(olc_classic.GetStats().GetResult());
   std::cout << "league\n";
@@ -11,11 +11,18 @@
 #include "util/StringAPI.hxx"
 #include "util/PrintException.hxx"
 #include "io/FileLineReader.hpp"
+#include "io/MemoryReader.hxx"
+#include "util/SpanCast.hxx"
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
+#include "AirspaceCompare.hpp"
 
 #include <tchar.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
 struct AirspaceClassTestCouple
 {
   const TCHAR* name;
@@ -23,13 +30,14 @@ struct AirspaceClassTestCouple
 };
 
 static bool
-ParseFile(Path path, Airspaces &airspaces)
+ParseFile(Path path, Airspaces &airspaces, bool parallel=true,
+          std::size_t chunk_size=OPENAIR_CHUNK_SIZE)
 {
   FileReader file_reader{path};
   BufferedReader buffered_reader{file_reader};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, buffered_reader, parallel, chunk_size);
     ok1(true);
   } catch (...) {
     ok1(false);
@@ -84,7 +92,8 @@ TestOpenAir()
         continue;
 
       const AirspacePolygon &polygon = (const AirspacePolygon &)airspace;
-      const SearchPointVector &points = polygon.GetPoints();
+      const auto border = polygon.GetPoints();
+      const SearchPointVector &points = *border;
 
       ok1(points.size() == 33);
     } else if (StringIsEqual(_T("Polygon-Test"), airspace.GetName())) {
@@ -92,7 +101,8 @@ TestOpenAir()
         continue;
 
       const AirspacePolygon &polygon = (const AirspacePolygon &)airspace;
-      const SearchPointVector &points = polygon.GetPoints();
+      const auto border = polygon.GetPoints();
+      const SearchPointVector &points = *border;
 
       if (!ok1(points.size() == 5))
         continue;
@@ -200,7 +210,8 @@ TestTNP()
         continue;
 
       const AirspacePolygon &polygon = (const AirspacePolygon &)airspace;
-      const SearchPointVector &points = polygon.GetPoints();
+      const auto border = polygon.GetPoints();
+      const SearchPointVector &points = *border;
 
       if (!ok1(points.size() == 5))
         continue;
@@ -288,13 +299,136 @@ TestOpenAirExtended()
   }
 }
 
+/**
+ * Compress all borders and compare them with the original ones.
+ */
+static void
+TestCompressedBorders()
+{
+  Airspaces airspaces;
+  if (!ParseFile(Path(_T("test/data/airspace/openair.txt")), airspaces)) {
+    skip(52, 0, "Failed to parse input file");
+    return;
+  }
+
+  std::map<const AbstractAirspace *, SearchPointVector> expected;
+  for (const auto &i : airspaces.QueryAll())
+    expected.emplace(&i.GetAirspace(), *i.GetAirspace().GetPoints());
+
+  airspaces.CompressBorders(0);
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    ok1(airspace.IsBorderCompressed());
+
+    const auto border = airspace.GetPoints();
+    const SearchPointVector &e = expected[&airspace];
+
+    bool same = border->size() == e.size();
+    for (std::size_t j = 0; same && j < e.size(); ++j) {
+      const auto &a = (*border)[j], &b = e[j];
+      const FlatGeoPoint delta = a.GetFlatLocation() - b.GetFlatLocation();
+      same = equals(a.GetLocation(), b.GetLocation()) &&
+        std::abs(delta.x) <= 1 && std::abs(delta.y) <= 1;
+    }
+
+    ok1(same);
+  }
+}
+
+/**
+ * Parse a file with the parallel and with the line-by-line parser
+ * and compare the results.
+ */
+static void
+TestParallel(Path path, std::size_t chunk_size=OPENAIR_CHUNK_SIZE)
+{
+  Airspaces parallel, sequential;
+  const bool parallel_ok = ParseFile(path, parallel, true, chunk_size);
+  const bool sequential_ok = ParseFile(path, sequential, false);
+  if (!parallel_ok || !sequential_ok) {
+    skip(1, 0, "Failed to parse input file");
+    return;
+  }
+
+  ok1(IsSameAirspaces(parallel, sequential));
+}
+
+static void
+ParseString(std::string_view input, Airspaces &airspaces,
+            bool parallel, std::size_t chunk_size=OPENAIR_CHUNK_SIZE)
+{
+  MemoryReader memory_reader{AsBytes(input)};
+  BufferedReader buffered_reader{memory_reader};
+  ParseAirspaceFile(airspaces, buffered_reader, parallel, chunk_size);
+  airspaces.Optimise();
+}
+
+/**
+ * The first airspace name is not valid UTF-8, which switches the
+ * parser to ISO-Latin-1.  The parallel parser must notice that the
+ * following blocks were parsed with the wrong charset, and the
+ * following chunks must begin with ISO-Latin-1.
+ */
+static void
+TestParallelCharset(std::size_t chunk_size)
+{
+  static constexpr std::string_view input =
+    "AC R\n"
+    "AN Caf\xE9 1\n"
+    "AL GND\n"
+    "AH FL100\n"
+    "DP 45:00:00 N 010:00:00 E\n"
+    "DP 45:10:00 N 010:00:00 E\n"
+    "DP 45:10:00 N 010:10:00 E\n"
+    "AC R\n"
+    "AN Caf\xC3\xA9 2\n"
+    "AL GND\n"
+    "AH FL100\n"
+    "DP 46:00:00 N 010:00:00 E\n"
+    "DP 46:10:00 N 010:00:00 E\n"
+    "DP 46:10:00 N 010:10:00 E\n"
+    "AC R\n"
+    "AN Caf\xC3\xA9 3\n"
+    "AL GND\n"
+    "AH FL100\n"
+    "DP 47:00:00 N 010:00:00 E\n"
+    "DP 47:10:00 N 010:00:00 E\n"
+    "DP 47:10:00 N 010:10:00 E\n";
+
+  Airspaces parallel, sequential;
+  ParseString(input, parallel, true, chunk_size);
+  ParseString(input, sequential, false);
+
+  ok1(parallel.GetSize() == 3);
+  ok1(IsSameAirspaces(parallel, sequential));
+
+  /* the UTF-8 sequence has been decoded as ISO-Latin-1 */
+  ok1(std::ranges::any_of(parallel.QueryAll(), [](const Airspace &i){
+    return StringIsEqual(i.GetAirspace().GetName(),
+                         _T("Caf\u00C3\u00A9 3"));
+  }));
+}
+
 int main()
 try {
-  plan_tests(113);
+  plan_tests(187);
 
   TestOpenAir();
   TestTNP();
   TestOpenAirExtended();
+  TestCompressedBorders();
+  TestParallel(Path(_T("test/data/airspace/openair.txt")));
+  TestParallel(Path(_T("test/data/airspace/openair_extended.txt")));
+
+  /* a tiny chunk size: each airspace is parsed in its own chunk */
+  TestParallel(Path(_T("test/data/airspace/openair.txt")), 1);
+  TestParallel(Path(_T("test/data/airspace/openair_extended.txt")), 1);
+
+  TestParallel(Path(_T("test/data/airspace/openair.txt")), 1024);
+
+  TestParallelCharset(OPENAIR_CHUNK_SIZE);
+  TestParallelCharset(1);
 
   return exit_status();
 } catch (const std::runtime_error &e) {
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "util/DaryHeap.hpp"
+#include "TestUtil.hpp"
+
+#include <functional>
+#include <queue>
+#include <random>
+
+static void
+TestBasic()
+{
+  /* like std::priority_queue, std::less puts the largest element on
+     top */
+  DaryHeap<int, std::less<int>> heap;
+  ok1(heap.empty());
+
+  for (int i : {5, 1, 9, 3, 7})
+    heap.push(i);
+
+  ok1(heap.size() == 5);
+  ok1(heap.top() == 9);
+  heap.pop();
+  ok1(heap.top() == 7);
+  heap.pop();
+  heap.emplace(8);
+  ok1(heap.top() == 8);
+  heap.pop();
+  ok1(heap.top() == 5);
+  heap.pop();
+  ok1(heap.top() == 3);
+  heap.pop();
+  ok1(heap.top() == 1);
+  heap.pop();
+  ok1(heap.empty());
+}
+
+/**
+ * Compare with std::priority_queue, interleaving push() and pop().
+ */
+template<std::size_t D>
+static bool
+CompareRandom(unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<unsigned> dist(0, 1000);
+
+  DaryHeap<unsigned, std::greater<unsigned>, D> heap;
+  std::priority_queue<unsigned, std::vector<unsigned>,
+                      std::greater<unsigned>> reference;
+
+  bool equal = true;
+  for (unsigned i = 0; i < 20000; ++i) {
+    /* push more often than pop, so the heap grows */
+    if (reference.empty() || dist(gen) < 600) {
+      const unsigned value = dist(gen);
+      heap.push(value);
+      reference.push(value);
+    } else {
+      equal &= heap.top() == reference.top();
+      heap.pop();
+      reference.pop();
+    }
+
+    equal &= heap.size() == reference.size();
+  }
+
+  /* drain; the order must be sorted */
+  while (!reference.empty()) {
+    equal &= !heap.empty() && heap.top() == reference.top();
+    heap.pop();
+    reference.pop();
+  }
+
+  return equal && heap.empty();
+}
+
+static void
+TestClear()
+{
+  DaryHeap<int, std::less<int>> heap(100);
+  for (int i = 0; i < 50; ++i)
+    heap.push(i);
+
+  const auto capacity = heap.capacity();
+  heap.clear();
+  ok1(heap.empty());
+  ok1(heap.capacity() == capacity);
+
+  heap.push(-1);
+  heap.push(-2);
+  ok1(heap.top() == -1);
+}
+
+int
+main()
+{
+  plan_tests(14);
+
+  TestBasic();
+
+  ok1(CompareRandom<2>(1));
+  ok1(CompareRandom<4>(2));
+
+  TestClear();
+
+  return exit_status();
+}
@@ -3,19 +3,18 @@
 
 #include "FLARM/FlarmNetDatabase.hpp"
 #include "FLARM/FlarmNetReader.hpp"
+#include "FLARM/FlarmNetBinary.hpp"
+#include "FLARM/OgnDdbReader.hpp"
 #include "FLARM/FlarmNetRecord.hpp"
 #include "FLARM/Id.hpp"
 #include "system/Path.hpp"
+#include "io/StringOutputStream.hxx"
+#include "util/SpanCast.hxx"
 #include "TestUtil.hpp"
 
-int main()
+static void
+TestDatabase(const FlarmNetDatabase &db)
 {
-  plan_tests(15);
-
-  FlarmNetDatabase db;
-  int count = FlarmNetReader::LoadFile(Path(_T("test/data/flarmnet/data.fln")),
-                                       db);
-  ok1(count == 6);
 
   FlarmId id = FlarmId::Parse("DDA85C", NULL);
 
@@ -59,5 +58,49 @@ int main()
   ok1(foundDDA85C);
   ok1(foundDDA896);
 
+  ok1(db.FindIdsByCallSign(_T("TH"), ids, 1) == 1);
+  ok1(db.FindFirstRecordByCallSign(_T("T")) == nullptr);
+}
+
+static void
+TestOgnDdb()
+{
+  FlarmNetDatabase db;
+  ok1(OgnDdbReader::LoadFile(Path(_T("test/data/flarmnet/ddb.csv")), db) == 2);
+
+  const FlarmNetRecord *record =
+    db.FindRecordById(FlarmId::Parse("DD1234", nullptr));
+  ok1(record != nullptr);
+  ok1(StringIsEqual(record->plane_type, _T("ASK-21")));
+  ok1(StringIsEqual(record->registration, _T("D-1234")));
+  ok1(StringIsEqual(record->callsign, _T("K1")));
+
+  /* not identified */
+  ok1(db.FindRecordById(FlarmId::Parse("DD5678", nullptr)) == nullptr);
+}
+
+int main()
+{
+  plan_tests(2 * 16 + 9);
+
+  FlarmNetDatabase db;
+  int count = FlarmNetReader::LoadFile(Path(_T("test/data/flarmnet/data.fln")),
+                                       db);
+  ok1(count == 6);
+
+  TestDatabase(db);
+
+  StringOutputStream os;
+  FlarmNetBinary::Write(os, db);
+  const std::string &binary = os.GetValue();
+
+  FlarmNetDatabase mapped;
+  ok1(mapped.Load(AsBytes(binary)));
+  ok1(mapped.size() == 6);
+
+  TestDatabase(mapped);
+
+  TestOgnDdb();
+
   return exit_status();
 }
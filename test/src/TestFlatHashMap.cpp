@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "util/FlatHashMap.hpp"
+#include "TestUtil.hpp"
+
+#include <random>
+#include <unordered_map>
+
+/**
+ * All keys collide, which makes every lookup walk the probe
+ * sequence.
+ */
+struct CollidingHash {
+  std::size_t operator()(unsigned) const noexcept {
+    return 42;
+  }
+};
+
+static void
+TestInsertFind()
+{
+  FlatHashMap<unsigned, int> map;
+  ok1(map.empty());
+  ok1(map.find(1) == map.end());
+
+  auto [i, inserted] = map.try_emplace(1, 10);
+  ok1(inserted);
+  ok1(i->first == 1 && i->second == 10);
+
+  /* an existing entry is not overwritten */
+  std::tie(i, inserted) = map.try_emplace(1, 20);
+  ok1(!inserted);
+  ok1(i->second == 10);
+
+  map.try_emplace(2, 20);
+  ok1(map.size() == 2);
+  ok1(map.find(2) != map.end() && map.find(2)->second == 20);
+  ok1(map.find(3) == map.end());
+
+  /* entries are indexed in insertion order */
+  ok1(map.GetEntry(0).first == 1);
+  ok1(map.GetEntry(1).first == 2);
+  ok1(map.GetIndex(map.find(2)) == 1);
+}
+
+/**
+ * Grow the table several times; the entry indices must survive.
+ */
+static void
+TestRehash()
+{
+  FlatHashMap<unsigned, unsigned> map;
+
+  constexpr unsigned n = 10000;
+  for (unsigned i = 0; i < n; ++i)
+    map.try_emplace(i * 7919, i);
+
+  ok1(map.size() == n);
+
+  bool found = true, indexed = true;
+  for (unsigned i = 0; i < n; ++i) {
+    const auto j = map.find(i * 7919);
+    found &= j != map.end() && j->second == i;
+    indexed &= map.GetEntry(i).first == i * 7919;
+  }
+
+  ok1(found);
+  ok1(indexed);
+  ok1(map.find(1) == map.end());
+}
+
+static void
+TestCollisions()
+{
+  FlatHashMap<unsigned, unsigned, CollidingHash> map;
+
+  /* more than the minimum table size, so the table grows while all
+     entries share one probe sequence */
+  constexpr unsigned n = 100;
+  for (unsigned i = 0; i < n; ++i)
+    map.try_emplace(i, i * 2);
+
+  ok1(map.size() == n);
+
+  bool found = true;
+  for (unsigned i = 0; i < n; ++i) {
+    const auto j = map.find(i);
+    found &= j != map.end() && j->second == i * 2;
+  }
+
+  ok1(found);
+  ok1(map.find(n) == map.end());
+  ok1(!map.try_emplace(n / 2, 0).second);
+}
+
+/**
+ * clear() removes all entries without erasing the table; entries of
+ * the previous generation must not be found.
+ */
+static void
+TestClear()
+{
+  FlatHashMap<unsigned, unsigned> map;
+  for (unsigned i = 0; i < 100; ++i)
+    map.try_emplace(i, i);
+
+  map.clear();
+  ok1(map.empty());
+
+  bool found = false;
+  for (unsigned i = 0; i < 100; ++i)
+    found |= map.find(i) != map.end();
+  ok1(!found);
+
+  /* insert again, overlapping with the old keys */
+  for (unsigned i = 50; i < 120; ++i)
+    map.try_emplace(i, i + 1);
+
+  ok1(map.size() == 70);
+  ok1(map.find(49) == map.end());
+  ok1(map.find(50) != map.end() && map.find(50)->second == 51);
+  ok1(map.GetEntry(0).first == 50);
+}
+
+/**
+ * Compare with std::unordered_map, with several clear() cycles.
+ */
+static void
+TestRandom()
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<unsigned> dist(0, 5000);
+
+  FlatHashMap<unsigned, unsigned> map;
+  std::unordered_map<unsigned, unsigned> reference;
+
+  bool equal = true;
+  for (unsigned cycle = 0; cycle < 10; ++cycle) {
+    map.clear();
+    reference.clear();
+
+    const unsigned n = 100 + cycle * 500;
+    for (unsigned i = 0; i < n; ++i) {
+      const unsigned key = dist(gen);
+      const bool inserted = map.try_emplace(key, i).second;
+      equal &= inserted == reference.try_emplace(key, i).second;
+    }
+
+    equal &= map.size() == reference.size();
+
+    for (unsigned key = 0; key <= 5000; ++key) {
+      const auto i = map.find(key);
+      const auto j = reference.find(key);
+      if (j == reference.end())
+        equal &= i == map.end();
+      else
+        equal &= i != map.end() && i->second == j->second;
+    }
+  }
+
+  ok1(equal);
+}
+
+static void
+TestSet()
+{
+  FlatHashSet<unsigned> set;
+  ok1(set.insert(3));
+  ok1(!set.insert(3));
+  ok1(set.contains(3));
+  ok1(!set.contains(4));
+
+  set.clear();
+  ok1(!set.contains(3));
+}
+
+int
+main()
+{
+  plan_tests(32);
+
+  TestInsertFind();
+  TestRehash();
+  TestCollisions();
+  TestClear();
+  TestRandom();
+  TestSet();
+
+  return exit_status();
+}
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "IGC/IGCWriter.hpp"
+#include "Logger/LoggerThread.hpp"
 #include "system/FileUtil.hpp"
 #include "NMEA/Info.hpp"
 #include "io/FileLineReader.hpp"
@@ -10,6 +11,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <memory>
 
 static void
 CheckTextFile(Path path, const char *const* expect)
@@ -67,15 +69,14 @@ static const char *const expect[] = {
   NULL
 };
 
+static const GeoPoint home(Angle::Degrees(7.7061111111111114),
+                           Angle::Degrees(51.051944444444445));
+static const GeoPoint tp(Angle::Degrees(10.726111111111111),
+                         Angle::Degrees(50.6322));
+
 static void
-Run(IGCWriter &writer)
+MakeInfo(NMEAInfo &i)
 {
-  static const GeoPoint home(Angle::Degrees(7.7061111111111114),
-                             Angle::Degrees(51.051944444444445));
-  static const GeoPoint tp(Angle::Degrees(10.726111111111111),
-                           Angle::Degrees(50.6322));
-
-  static NMEAInfo i;
   i.clock = i.time = TimeStamp{std::chrono::seconds{1}};
   i.time_available.Update(i.clock);
   i.date_time_utc.year = 2010;
@@ -90,7 +91,11 @@ Run(IGCWriter &writer)
   i.gps_altitude_available.Update(i.clock);
   i.ProvidePressureAltitude(490);
   i.ProvideBaroAltitudeTrue(400);
+}
 
+static void
+WriteHeader(IGCWriter &writer, const NMEAInfo &i)
+{
   writer.WriteHeader(i.date_time_utc, _T("Pilot Name"), _T("CoPilot Name"), _T("ASK-21"),
                      _T("D-1234"), _T("34"), "FOO", _T("bar"), false);
   writer.StartDeclaration(i.date_time_utc, 3);
@@ -98,7 +103,15 @@ Run(IGCWriter &writer)
   writer.AddDeclaration(tp, _T("Suhl"));
   writer.AddDeclaration(home, _T("Bergneustadt"));
   writer.EndDeclaration();
+}
 
+/**
+ * Log fixes, events and notes to an #IGCWriter or a #LoggerThread.
+ */
+template<typename W>
+static void
+LogRecords(W &writer, NMEAInfo &i)
+{
   writer.LogEmptyFRecord(i.date_time_utc);
 
   i.date_time_utc.second += 5;
@@ -122,6 +135,17 @@ Run(IGCWriter &writer)
   i.location = GeoPoint(Angle::Degrees(-7.7061111111111114),
                         Angle::Degrees(-51.051944444444445));
   writer.LogPoint(i);
+}
+
+static void
+Run(Path path)
+{
+  static NMEAInfo i;
+  MakeInfo(i);
+
+  IGCWriter writer(path);
+  WriteHeader(writer, i);
+  LogRecords(writer, i);
 
   writer.Flush();
   writer.Sign();
@@ -129,26 +153,46 @@ Run(IGCWriter &writer)
 }
 
 static void
-Run(Path path)
+RunAsync(Path path)
 {
-  IGCWriter writer(path);
-  Run(writer);
-}
+  static NMEAInfo i;
+  MakeInfo(i);
 
-int main()
-try {
-  plan_tests(51);
+  auto writer = std::make_unique<IGCWriter>(path);
+  WriteHeader(*writer, i);
 
-  const Path path(_T("output/test/test.igc"));
-  File::Delete(path);
+  LoggerThread thread(std::move(writer));
+  LogRecords(thread, i);
+  ok1(thread.Finish(true));
 
-  Run(path);
+  const auto statistics = thread.GetStatistics();
+  ok1(statistics.n_records == 7);
+  ok1(statistics.max_queue_depth >= 1);
+}
 
+static void
+Check(Path path)
+{
   CheckTextFile(path, expect);
 
   GRecord grecord;
   grecord.Initialize();
   grecord.VerifyGRecordInFile(path);
+}
+
+int main()
+try {
+  plan_tests(2 * 51 + 3);
+
+  const Path path(_T("output/test/test.igc"));
+  File::Delete(path);
+  Run(path);
+  Check(path);
+
+  const Path async_path(_T("output/test/test_async.igc"));
+  File::Delete(async_path);
+  RunAsync(async_path);
+  Check(async_path);
 
   return exit_status();
 } catch (...) {
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "util/PackedRTree.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct Item {
+  int x, y;
+  unsigned id;
+};
+
+struct ItemAccessor {
+  int GetX(const Item &item) const noexcept {
+    return item.x;
+  }
+
+  int GetY(const Item &item) const noexcept {
+    return item.y;
+  }
+};
+
+using Tree = PackedRTree<Item, ItemAccessor>;
+
+static unsigned
+SquareDistance(const Item &item, Tree::Point p) noexcept
+{
+  return Tree::GetPosition(item).SquareDistanceTo(p);
+}
+
+static std::vector<unsigned>
+VisitIds(const Tree &tree, Tree::Point p, unsigned range)
+{
+  std::vector<unsigned> ids;
+  auto visitor = [&ids](const Item &item){ ids.push_back(item.id); };
+  tree.VisitWithinRange(p, range, visitor);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+static std::vector<unsigned>
+BruteForceIds(const Tree &tree, Tree::Point p, unsigned range)
+{
+  std::vector<unsigned> ids;
+  for (const auto &item : tree)
+    if (SquareDistance(item, p) <= range * range)
+      ids.push_back(item.id);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/**
+ * Compare range and nearest queries with a brute force search over
+ * all items.
+ */
+static bool
+CheckQueries(const Tree &tree, std::mt19937 &rng)
+{
+  std::uniform_int_distribution<int> coordinate(-1200, 1200);
+  std::uniform_int_distribution<unsigned> range(0, 300);
+
+  for (unsigned i = 0; i < 200; ++i) {
+    const Tree::Point p(coordinate(rng), coordinate(rng));
+    const unsigned r = range(rng);
+
+    if (VisitIds(tree, p, r) != BruteForceIds(tree, p, r))
+      return false;
+
+    /* nearest item with an odd id */
+    const auto predicate = [](const Item &item){ return item.id % 2 != 0; };
+    const auto nearest = tree.FindNearestIf(p, r, predicate);
+
+    unsigned best = Tree::max_distance();
+    for (const auto &item : tree)
+      if (predicate(item) && SquareDistance(item, p) <= r * r)
+        best = std::min(best, SquareDistance(item, p));
+
+    if (best == Tree::max_distance()) {
+      if (nearest.first != tree.end())
+        return false;
+    } else if (nearest.first == tree.end() ||
+               !predicate(*nearest.first) ||
+               nearest.second != best ||
+               SquareDistance(*nearest.first, p) != best)
+      return false;
+  }
+
+  return true;
+}
+
+int
+main()
+{
+  plan_tests(6);
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> coordinate(-1000, 1000);
+
+  Tree tree;
+  unsigned next_id = 0;
+  for (unsigned i = 0; i < 5000; ++i)
+    tree.Add({coordinate(rng), coordinate(rng), next_id++});
+
+  /* before Optimise(), all items are in the overlay */
+  ok1(CheckQueries(tree, rng));
+
+  tree.Optimise();
+  ok1(tree.HaveBounds() && tree.size() == 5000);
+  ok1(CheckQueries(tree, rng));
+
+  /* modify the tree: add to the overlay, replace and erase */
+  for (unsigned i = 0; i < 100; ++i)
+    tree.Add({coordinate(rng), coordinate(rng), next_id++});
+
+  for (unsigned i = 0; i < 200; ++i) {
+    const auto it = std::next(tree.begin(), rng() % tree.size());
+    tree.Replace(it, {coordinate(rng), coordinate(rng), it->id});
+  }
+
+  for (unsigned i = 0; i < 300; ++i)
+    tree.erase(std::next(tree.begin(), rng() % tree.size()));
+
+  tree.EraseIf([](const Item &item){ return item.id % 7 == 0; });
+
+  ok1(CheckQueries(tree, rng));
+
+  /* a large overlay is packed by Optimise() */
+  for (unsigned i = 0; i < 1000; ++i)
+    tree.Add({coordinate(rng), coordinate(rng), next_id++});
+
+  const std::size_t size = tree.size();
+  tree.Optimise();
+  ok1(tree.size() == size);
+  ok1(CheckQueries(tree, rng));
+
+  return exit_status();
+}
@@ -4,6 +4,8 @@
 #include "Projection/Projection.hpp"
 #include "TestUtil.hpp"
 
+#include <array>
+
 static void
 TestGeoScreenCouple(const Projection prj, const GeoPoint geo,
                     int x, int y)
@@ -27,11 +29,43 @@ test_simple()
                                     Angle::Zero()), 0, 0);
 }
 
+/**
+ * Verify that the batch GeoToScreen() returns the same results as
+ * the scalar one.
+ */
+static void
+test_batch()
+{
+  Projection prj;
+  prj.SetScale(640. / (100 * 2));
+  prj.SetScreenOrigin(320, 240);
+  prj.SetScreenAngle(Angle::Degrees(33));
+  prj.SetGeoLocation(GeoPoint(Angle::Degrees(179.5),
+                              Angle::Degrees(51.05)));
+
+  /* an odd number of points, some of which cross the date line */
+  std::array<GeoPoint, 101> src;
+  for (unsigned i = 0; i < src.size(); ++i)
+    src[i] = GeoPoint(Angle::Degrees(179 + 0.01 * i),
+                      Angle::Degrees(50.5 + 0.0123 * i)).Normalize();
+
+  std::array<PixelPoint, src.size()> dest;
+  prj.GeoToScreen(src, dest);
+
+  bool equal = true;
+  for (unsigned i = 0; i < src.size(); ++i)
+    if (dest[i] != prj.GeoToScreen(src[i]))
+      equal = false;
+
+  ok1(equal);
+}
+
 int main()
 {
-  plan_tests(4);
+  plan_tests(5);
 
   test_simple();
+  test_batch();
 
   return exit_status();
 }
@@ -14,27 +14,52 @@
 
 #include <windef.h>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 
 #include <tchar.h>
 
 using namespace std::chrono;
 
+static steady_clock::duration push_back_duration, copy_duration;
+
 static void
 OnAdvance(Trace &trace, const GeoPoint &loc, const double alt,
           const TimeStamp t) noexcept
 {
+  const auto start = steady_clock::now();
+
   if (t.IsDefined()) {
     const TracePoint point(loc, t.Cast<duration<unsigned>>(),
                            alt, 0, 0);
     trace.push_back(point);
   }
+
+  const auto pushed = steady_clock::now();
+  push_back_duration += pushed - start;
+
 // get the trace, just so it's included in timing
   TracePointVector v;
   trace.GetPoints(v);
   if (trace.size()>1) {
 //    assert(abs(v.size()-trace.size())<2);
   }
+
+  copy_duration += steady_clock::now() - pushed;
+}
+
+/**
+ * A checksum of the remaining points, to compare the results of
+ * different thinning implementations.
+ */
+[[gnu::pure]]
+static unsigned
+Checksum(const Trace &trace) noexcept
+{
+  unsigned result = 0;
+  for (const auto &i : trace)
+    result = result * 31 + i.GetTime().count();
+  return result;
 }
 
 static bool
@@ -45,6 +70,8 @@ TestTrace(Path filename, unsigned ntrace, bool output=false)
   printf("# %d", ntrace);  
   Trace trace(seconds{1000}, Trace::null_time, ntrace);
 
+  push_back_duration = copy_duration = {};
+
   IGCExtensions extensions;
   extensions.clear();
 
@@ -67,6 +94,12 @@ TestTrace(Path filename, unsigned ntrace, bool output=false)
   }
   putchar('\n');
   printf("# samples %d\n", i);
+
+  using FloatDuration = std::chrono::duration<double, std::milli>;
+  printf("# points %u checksum %08x push_back %.3f ms copy %.3f ms\n",
+         trace.size(), Checksum(trace),
+         FloatDuration(push_back_duration).count(),
+         FloatDuration(copy_duration).count());
   return true;
 }
 
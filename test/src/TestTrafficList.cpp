@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FLARM/List.hpp"
+#include "TestUtil.hpp"
+
+#include <span>
+#include <vector>
+
+static void
+Receive(TrafficList &list, FlarmId id, TimeStamp clock) noexcept
+{
+  FlarmTraffic *traffic = list.FindTraffic(id);
+  if (traffic == nullptr) {
+    traffic = list.AllocateTraffic(id);
+    if (traffic == nullptr)
+      return;
+  }
+
+  traffic->valid.Update(clock);
+}
+
+/**
+ * Returns ids whose lookup begins at the given #TrafficList::index
+ * slot.
+ */
+static std::vector<FlarmId>
+FindIdsWithHash(std::size_t hash, unsigned n)
+{
+  std::vector<FlarmId> ids;
+  for (uint32_t value = 1; ids.size() < n; ++value) {
+    const auto id = FlarmId::FromValue(value);
+    if (TrafficList::GetIndexHash(id) == hash)
+      ids.push_back(id);
+  }
+
+  return ids;
+}
+
+static void
+TestInsertFind()
+{
+  TrafficList list;
+  list.Clear();
+
+  const TimeStamp clock{std::chrono::seconds{1}};
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i)
+    Receive(list, FlarmId::FromValue(0xDD0000 + i), clock);
+
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+
+  bool found = true;
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i) {
+    const auto *traffic = list.FindTraffic(FlarmId::FromValue(0xDD0000 + i));
+    found &= traffic != nullptr &&
+      traffic->id == FlarmId::FromValue(0xDD0000 + i);
+  }
+
+  ok1(found);
+  ok1(list.FindTraffic(FlarmId::FromValue(0xDE0000)) == nullptr);
+
+  /* the list is full */
+  ok1(list.AllocateTraffic(FlarmId::FromValue(0xDE0000)) == nullptr);
+}
+
+static void
+TestExpire()
+{
+  TrafficList list;
+  list.Clear();
+
+  /* odd ids are received later than even ids, so they survive */
+  const TimeStamp clock0{std::chrono::seconds{1}};
+  const TimeStamp clock1{std::chrono::seconds{3}};
+  for (unsigned i = 0; i < 20; ++i)
+    Receive(list, FlarmId::FromValue(0xDD0000 + i), i % 2 ? clock1 : clock0);
+
+  list.Expire(TimeStamp{std::chrono::seconds{4}});
+  ok1(list.GetActiveTrafficCount() == 10);
+
+  bool ok = true;
+  for (unsigned i = 0; i < 20; ++i)
+    ok &= (list.FindTraffic(FlarmId::FromValue(0xDD0000 + i)) != nullptr) ==
+      (i % 2 == 1);
+  ok1(ok);
+
+  /* the order is preserved */
+  ok = true;
+  for (unsigned i = 0; i < 10; ++i)
+    ok &= list.list[i].id == FlarmId::FromValue(0xDD0000 + 2 * i + 1);
+  ok1(ok);
+
+  /* the freed room can be used again */
+  for (unsigned i = 20; i < 35; ++i)
+    Receive(list, FlarmId::FromValue(0xDD0000 + i), clock1);
+  ok1(list.GetActiveTrafficCount() == 25);
+  ok1(list.FindTraffic(FlarmId::FromValue(0xDD0000 + 34)) != nullptr);
+}
+
+/**
+ * Fill the last slots of the index, so the probe sequence wraps
+ * around to the beginning, then remove some of the ids.
+ */
+static void
+TestWrapAround()
+{
+  const auto ids = FindIdsWithHash(TrafficList::INDEX_SIZE - 1, 4);
+
+  TrafficList list;
+  list.Clear();
+
+  const TimeStamp clock0{std::chrono::seconds{1}};
+  const TimeStamp clock1{std::chrono::seconds{3}};
+  for (unsigned i = 0; i < ids.size(); ++i)
+    Receive(list, ids[i], i < 2 ? clock0 : clock1);
+
+  ok1(list.GetActiveTrafficCount() == ids.size());
+
+  bool found = true;
+  for (const auto id : ids)
+    found &= list.FindTraffic(id) != nullptr &&
+      list.FindTraffic(id)->id == id;
+  ok1(found);
+
+  /* erase the first two, which occupy the slots before the wrap */
+  list.Expire(TimeStamp{std::chrono::seconds{4}});
+  ok1(list.GetActiveTrafficCount() == 2);
+  ok1(list.FindTraffic(ids[0]) == nullptr);
+  ok1(list.FindTraffic(ids[1]) == nullptr);
+  ok1(list.FindTraffic(ids[2]) != nullptr &&
+      list.FindTraffic(ids[2])->id == ids[2]);
+  ok1(list.FindTraffic(ids[3]) != nullptr &&
+      list.FindTraffic(ids[3])->id == ids[3]);
+
+  /* insert again after the removal */
+  Receive(list, ids[0], clock1);
+  ok1(list.GetActiveTrafficCount() == 3);
+  ok1(list.FindTraffic(ids[0]) != nullptr &&
+      list.FindTraffic(ids[0])->id == ids[0]);
+}
+
+static void
+TestComplement()
+{
+  TrafficList a, b;
+  a.Clear();
+  b.Clear();
+
+  const TimeStamp clock{std::chrono::seconds{1}};
+  for (unsigned i = 0; i < 10; ++i)
+    Receive(a, FlarmId::FromValue(0xDD0000 + i), clock);
+  for (unsigned i = 5; i < 15; ++i)
+    Receive(b, FlarmId::FromValue(0xDD0000 + i), clock);
+
+  a.Complement(b);
+  ok1(a.GetActiveTrafficCount() == 15);
+
+  bool found = true;
+  for (unsigned i = 0; i < 15; ++i)
+    found &= a.FindTraffic(FlarmId::FromValue(0xDD0000 + i)) != nullptr;
+  ok1(found);
+
+  /* copying into an empty list copies the index, too */
+  TrafficList c;
+  c.Clear();
+  c.Complement(b);
+  ok1(c.FindTraffic(FlarmId::FromValue(0xDD0000 + 14)) != nullptr);
+}
+
+static void
+TestFindNearest()
+{
+  TrafficList list;
+  list.Clear();
+
+  const TimeStamp clock{std::chrono::seconds{1}};
+  for (unsigned i = 0; i < 10; ++i) {
+    Receive(list, FlarmId::FromValue(0xDD0000 + i), clock);
+    list.list[i].distance = (10 - i) * 100;
+  }
+
+  Receive(list, FlarmId::FromValue(0xDE0000), clock);
+  list.list[10].distance = 5000;
+
+  /* only the nearest ones fit */
+  uint16_t nearest[16];
+  ok1(list.FindNearest(std::span{nearest}.first(4), 2000) == 4);
+  ok1(nearest[0] == 9 && nearest[1] == 8 &&
+      nearest[2] == 7 && nearest[3] == 6);
+
+  /* the distance limit applies */
+  ok1(list.FindNearest(nearest, 2000) == 10);
+  bool sorted = true;
+  for (unsigned i = 0; i < 10; ++i)
+    sorted &= nearest[i] == 9 - i;
+  ok1(sorted);
+
+  ok1(list.FindNearest(nearest, 5000) == 11);
+  ok1(nearest[10] == 10);
+}
+
+int
+main()
+{
+  plan_tests(27);
+
+  TestInsertFind();
+  TestExpire();
+  TestWrapAround();
+  TestComplement();
+  TestFindNearest();
+
+  return exit_status();
+}